@@ -42,6 +42,7 @@
 
 #include "cst_wave.h"
 #include "cst_hrg.h"
+#include "cst_stats.h"
 
 #ifdef CST_AUDIO_WIN32
 #define CST_AUDIOBUFFSIZE 8092
@@ -100,6 +101,44 @@ int mimic_audio_write_file(cst_audiodev *ad, void *buff, int num_bytes);
 int mimic_audio_drain_file(cst_audiodev *ad);
 int mimic_audio_flush_file(cst_audiodev *ad);
 
+/* Buffered audio player: writes go into a single-producer/single-consumer */
+/* lock-free ring and a dedicated thread feeds the device, so synthesis   */
+/* is never stalled by a slow device (src/audio/au_player.c)              */
+#define CST_AUDIO_PLAYER_DEFAULT_LATENCY 250  /* ms of buffered audio */
+
+#define CST_AUDIO_WATERMARK_LOW 0
+#define CST_AUDIO_WATERMARK_HIGH 1
+#define CST_AUDIO_UNDERRUN 2
+
+typedef struct cst_audio_player_struct cst_audio_player;
+
+/* Called with the fill level in frames; LOW and UNDERRUN come from the */
+/* playback thread, HIGH from the writer's thread                        */
+typedef void (*cst_audio_watermark_callback) (cst_audio_player *ap,
+                                              int event, int fill,
+                                              void *userdata);
+
+typedef struct cst_audio_player_stats_struct {
+    long frames_written;
+    long frames_played;
+    int underruns;              /* ring ran dry while playing */
+    int writer_waits;           /* ring was full, the writer waited */
+    int capacity;               /* in frames */
+} cst_audio_player_stats;
+
+cst_audio_player *mimic_audio_player_open(int sps, int channels,
+                                          cst_audiofmt fmt, int latency_ms);
+int mimic_audio_player_write(cst_audio_player *ap, const void *buff,
+                             int num_bytes);
+int mimic_audio_player_drain(cst_audio_player *ap); /* wait until played */
+int mimic_audio_player_close(cst_audio_player *ap);
+void mimic_audio_player_set_watermarks(cst_audio_player *ap,
+                                       int low_ms, int high_ms,
+                                       cst_audio_watermark_callback cb,
+                                       void *userdata);
+void mimic_audio_player_get_stats(cst_audio_player *ap,
+                                  cst_audio_player_stats *stats);
+
 /* For audio streaming */
 #define CST_AUDIO_STREAM_STOP -1
 #define CST_AUDIO_STREAM_CONT 0
@@ -112,6 +151,14 @@ typedef struct cst_audio_streaming_info_struct {
     const cst_item *item;       /* because you'll probably want this */
     /* But this is *not* updated automatically */
     void *userdata;
+
+    /* If set, vocoders that support it write straight into the sink */
+    /* and never build the full waveform, see below                  */
+    struct cst_audio_sink_struct *sink;
+
+    /* Start of the utterance's synthesis while cst_stats are on, */
+    /* cleared when its first chunk is handed on                  */
+    double stats_start;
 } cst_audio_streaming_info;
 cst_audio_streaming_info *new_audio_streaming_info();
 void delete_audio_streaming_info(cst_audio_streaming_info *asi);
@@ -120,9 +167,60 @@ typedef int (*cst_audio_stream_callback) (const cst_wave *w, int start,
                                           int size, int last,
                                           cst_audio_streaming_info *asi);
 
+/* Vocoders call this before handing on each chunk, for the */
+/* "first_chunk" latency in cst_stats                         */
+#define audio_stream_stats_chunk(asi) \
+    do { if ((asi)->stats_start > 0.0) { \
+            cst_stats_add_time("first_chunk", \
+                               cst_stats_now() - (asi)->stats_start); \
+            (asi)->stats_start = 0.0; } \
+    } while (0)
+
 /* An example audio streaming callback function src/audio/au_streaming.c */
 int audio_stream_chunk(const cst_wave *w, int start, int size,
                        int last, cst_audio_streaming_info *asi);
 
+/* Streaming into caller supplied fixed size buffers.  Samples are       */
+/* converted into buff as they are produced and flush is called each     */
+/* time it is full, and once more with last set at the end.  flush may   */
+/* point buff at another buffer of buff_frames frames before returning.  */
+/* Memory use is constant whatever the length of the utterance.          */
+#define CST_AUDIO_SINK_INT16 0
+#define CST_AUDIO_SINK_FLOAT32 1
+
+typedef struct cst_audio_sink_struct {
+    void *buff;
+    int buff_frames;
+    int fmt;                    /* CST_AUDIO_SINK_INT16 or _FLOAT32 */
+    int channels;               /* 1, or 2 for interleaved stereo */
+    int fill;                   /* frames in buff so far */
+    long total_frames;          /* since the sink was created */
+    int sample_rate;            /* set before the first flush */
+    int (*flush) (struct cst_audio_sink_struct *sink, int num_frames,
+                  int last);
+    void *userdata;
+} cst_audio_sink;
+
+cst_audio_sink *new_audio_sink(void *buff, int buff_frames, int fmt,
+                               int channels,
+                               int (*flush) (cst_audio_sink *sink,
+                                             int num_frames, int last),
+                               void *userdata);
+void delete_audio_sink(cst_audio_sink *sink);
+int audio_sink_write(cst_audio_sink *sink, const short *samples,
+                     int num_samples, int last);
+/* Streaming callback that forwards chunks to asi->sink, for vocoders */
+/* that can't write to the sink directly                              */
+int audio_stream_sink_chunk(const cst_wave *w, int start, int size,
+                            int last, cst_audio_streaming_info *asi);
+/* Streaming callback that codes chunks with the cst_wave_encoder in */
+/* asi->userdata, e.g. for 8kHz mu-law straight onto a socket        */
+int audio_stream_encode_chunk(const cst_wave *w, int start, int size,
+                              int last, cst_audio_streaming_info *asi);
+/* Streaming callback that writes chunks into the cst_wave_writer in */
+/* asi->userdata, so the whole wave is never held for the file       */
+int audio_stream_writer_chunk(const cst_wave *w, int start, int size,
+                              int last, cst_audio_streaming_info *asi);
+
 void mimic_audio_shutdown(int signum);
 #endif
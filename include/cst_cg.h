@@ -128,14 +128,49 @@ CST_VAL_USER_TYPE_DCLS(cg_db, cst_cg_db);
 void delete_cg_db(cst_cg_db *db);
 
 cst_utterance *cg_synth(cst_utterance *utt);
+/* Segment durations only, the voices' alignment_func */
+cst_utterance *cg_durations(cst_utterance *utt);
 cst_wave *mlsa_resynthesis(const cst_track *t,
                            const cst_track *str,
                            cst_cg_db *cg_db,
                            cst_audio_streaming_info *asc);
+/* The same with the noise started from noise_seed rather than rand() */
+cst_wave *mlsa_resynthesis_seed(const cst_track *t,
+                                const cst_track *str,
+                                cst_cg_db *cg_db,
+                                cst_audio_streaming_info *asc,
+                                unsigned long noise_seed);
 cst_track *mlpg(const cst_track *param_track, cst_cg_db *cg_db);
 
 cst_voice *cst_cg_load_voice(const char *voxdir,
                              const cst_lang lang_table[]);
 int cst_cg_dump_voice(const cst_voice *v, const cst_string *filename);
 
+/* Phrase level parameter cache (src/cg/cst_cg_cache.c).  When the     */
+/* voice has one as its "cg_param_cache" feature, cg_synth() reuses the */
+/* predicted and mlpg smoothed frames of phrases it has already seen   */
+/* in the same context, and only predicts the phrases that differ.     */
+#define CST_CG_PARAM_CACHE_DEFAULT (32 * 1024 * 1024)
+
+typedef struct cst_cg_param_cache_struct cst_cg_param_cache;
+
+typedef struct cst_cg_param_cache_stats_struct {
+    long hits;                  /* phrases */
+    long misses;
+    long stores;
+    long evictions;
+    long frames_reused;
+    long frames_predicted;
+    long bytes;
+    long max_bytes;
+    int entries;
+} cst_cg_param_cache_stats;
+
+cst_cg_param_cache *new_cg_param_cache(long max_bytes);
+void delete_cg_param_cache(cst_cg_param_cache *c);
+void cg_param_cache_clear(cst_cg_param_cache *c);
+void cg_param_cache_get_stats(cst_cg_param_cache *c,
+                              cst_cg_param_cache_stats *stats);
+CST_VAL_USER_TYPE_DCLS(cg_param_cache, cst_cg_param_cache);
+
 #endif
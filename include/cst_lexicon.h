@@ -70,6 +70,7 @@ typedef struct lexicon_struct {
     cst_utterance *(*postlex) (cst_utterance *u);
 
     cst_val *lex_addenda;       /* For pronunciations added at run time */
+    int addenda_generation;     /* bumped whenever lex_addenda changes */
 
 } cst_lexicon;
 
@@ -90,6 +90,23 @@
  */
 #define	CST_REGMAGIC	0234
 
+/* Match-only automata built from the programs (src/regex/cst_regex_dfa.c) */
+/* so matching is one table lookup per character with no backtracking.   */
+/* A DFA can be built from several regexes at once: accept[s] has bit k  */
+/* set if regex k has matched by the time state s is reached, and        */
+/* accept_end[s] if it matches when the string ends in state s (as for   */
+/* those ending in $).  State 0 is the start, -1 in trans is a dead end. */
+typedef struct cst_regex_dfa_struct {
+    int num_states;
+    int num_classes;
+    const unsigned char *classmap;      /* byte to class */
+    const short *trans;                 /* [state * num_classes + class] */
+    const unsigned int *accept;
+    const unsigned int *accept_end;
+} cst_regex_dfa;
+
+#define CST_REGEX_DFA_MAX_REGEXES 32
+
 typedef struct cst_regex_struct {
     char regstart;              /* Internal use only. */
     char reganch;               /* Internal use only. */
@@ -97,6 +114,7 @@ typedef struct cst_regex_struct {
     int regmlen;                /* Internal use only. */
     int regsize;
     char *program;
+    const cst_regex_dfa *dfa;   /* NULL if it has no DFA, e.g. uses \< */
 } cst_regex;
 
 #define CST_NSUBEXP  10
@@ -116,8 +134,18 @@ cst_regstate *cst_regex_match_return(const cst_regex *r, const char *str);
 /* Internal functions from original HS code */
 cst_regex *hs_regcomp(const char *);
 cst_regstate *hs_regexec(const cst_regex *, const char *);
+int hs_regexec_state(const cst_regex *, const char *, cst_regstate *);
 void hs_regdelete(cst_regex *);
 
+/* Builds one DFA for num regexes (at most CST_REGEX_DFA_MAX_REGEXES), */
+/* NULL if one of them can't be done this way or it gets too big       */
+cst_regex_dfa *new_cst_regex_dfa(const cst_regex *const *rxs, int num);
+void delete_cst_regex_dfa(cst_regex_dfa *d);
+/* Returns the mask of the regexes that match str.  Unless all is set */
+/* it stops at the first match, which is all a single regex needs     */
+unsigned int cst_regex_dfa_match(const cst_regex_dfa *d, const char *str,
+                                 int all);
+
 /* Works similarly to snprintf(3), in that at most max characters are
    written to out, including the trailing NUL, and the return value is
    the number of characters written, *excluding* the trailing NUL.
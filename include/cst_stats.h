@@ -0,0 +1,88 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*  Timing and counters for the synthesis stages                         */
+/*                                                                       */
+/*  Off until cst_stats_enable(1).  When off, timing a stage costs one   */
+/*  test of cst_stats_enabled.                                           */
+/*                                                                       */
+/*************************************************************************/
+#ifndef _CST_STATS_H__
+#define _CST_STATS_H__
+
+#include "cst_file.h"
+
+/* Durations go in power of two buckets of microseconds: bucket 0 is   */
+/* under 1us and bucket i is [2^(i-1),2^i)us, the last takes the rest  */
+#define CST_STATS_BUCKETS 32
+#define CST_STATS_MAX 128       /* distinct names */
+
+#define CST_STATS_TIMER 0
+#define CST_STATS_COUNTER 1
+
+typedef struct cst_stat_struct {
+    const char *name;
+    int type;                   /* CST_STATS_TIMER or _COUNTER */
+    long count;                 /* timings, or additions to a counter */
+    double total;               /* seconds, or the counter's value */
+    double min, max;
+    long hist[CST_STATS_BUCKETS];
+} cst_stat;
+
+extern int cst_stats_enabled;
+
+void cst_stats_enable(int on);
+double cst_stats_now(void);     /* seconds, monotonic */
+void cst_stats_add_time(const char *name, double seconds);
+void cst_stats_add_count(const char *name, double value);
+void cst_stats_reset(void);
+
+/* Copies of the stats, in the order they were first seen */
+int cst_stats_num(void);
+int cst_stats_get(int n, cst_stat *st);
+int cst_stats_find(const char *name, cst_stat *st);
+/* The time below which fraction q (0..1) of the timings fell, to the */
+/* bucket's upper bound                                               */
+double cst_stats_quantile(const cst_stat *st, double q);
+
+int cst_stats_dump_json(cst_file fd);
+
+/* start = cst_stats_start(); ... cst_stats_end("stage", start);  */
+#define cst_stats_start() (cst_stats_enabled ? cst_stats_now() : 0.0)
+#define cst_stats_end(name, start) \
+    do { if (cst_stats_enabled) \
+            cst_stats_add_time((name), cst_stats_now() - (start)); \
+    } while (0)
+
+#endif
@@ -56,6 +56,7 @@ cst_utterance *utt_init(cst_utterance *u, cst_voice *vox);
 cst_utterance *utt_synth(cst_utterance *u);
 cst_utterance *utt_synth_phones(cst_utterance *u);
 cst_utterance *utt_synth_tokens(cst_utterance *u);
+cst_utterance *utt_synth_alignment(cst_utterance *u);
 cst_utterance *utt_synth_wave(cst_wave *w, cst_voice *v);
 
 typedef struct cst_dur_stats_struct {
@@ -70,6 +71,66 @@ cst_utterance *default_segmentanalysis(cst_utterance *u);
 cst_utterance *default_tokenization(cst_utterance *u);
 cst_utterance *default_textanalysis(cst_utterance *u);
 cst_val *default_tokentowords(cst_item *i);
+/* Bounded, thread safe cache in front of a tokentowords function      */
+/* (src/synth/cst_ttw_cache.c).  context_feats are the ffeature paths   */
+/* the expansion depends on, including "name", token_feats the token    */
+/* features it may set.  Both lists are NULL terminated and must        */
+/* outlive the cache, as must the cache any utterance it has served.   */
+/* Entries are dropped when the utterance lexicon's addenda change.     */
+typedef struct cst_ttw_cache_struct cst_ttw_cache;
+
+typedef struct cst_ttw_cache_stats_struct {
+    long hits;
+    long misses;
+    long uncached;              /* keys too long to keep */
+    long evictions;
+    long invalidated;           /* dropped after a lexicon change */
+    int entries;
+    int max_entries;
+} cst_ttw_cache_stats;
+
+cst_ttw_cache *new_ttw_cache(int max_entries,
+                             const char *const *context_feats,
+                             const char *const *token_feats);
+void delete_ttw_cache(cst_ttw_cache *c);
+cst_val *ttw_cache_tokentowords(cst_ttw_cache *c, cst_item *token,
+                                cst_itemfunc ttw);
+void ttw_cache_clear(cst_ttw_cache *c);
+void ttw_cache_get_stats(cst_ttw_cache *c, cst_ttw_cache_stats *stats);
+
+/* Whole utterance waveform cache (src/synth/cst_wave_cache.c), in     */
+/* memory and optionally in a directory of mmapped files, each tier     */
+/* LRU under its own byte limit.  mimic_text_to_wave() and friends use  */
+/* the one in the voice's "wave_cache" feature.  Keys come from          */
+/* wave_cache_key(): the voice name, the voice features that change the */
+/* samples and the text, trimmed.                                       */
+typedef struct cst_wave_cache_struct cst_wave_cache;
+#define CST_WAVE_CACHE_DEFAULT_MEM (64L * 1024 * 1024)
+#define CST_WAVE_CACHE_DEFAULT_DISK (1024L * 1024 * 1024)
+
+typedef struct cst_wave_cache_stats_struct {
+    long mem_hits;
+    long disk_hits;
+    long misses;
+    long stores;
+    long mem_evictions;
+    long disk_evictions;
+    long mem_bytes;
+    long disk_bytes;
+    int mem_entries;
+    int disk_entries;
+} cst_wave_cache_stats;
+
+cst_wave_cache *new_wave_cache(long max_mem_bytes, const char *dir,
+                               long max_disk_bytes);
+void delete_wave_cache(cst_wave_cache *wc);
+char *wave_cache_key(const cst_voice *v, const char *text);
+/* A new wave the caller owns, or NULL */
+cst_wave *wave_cache_get(cst_wave_cache *wc, const char *key);
+void wave_cache_put(cst_wave_cache *wc, const char *key, const cst_wave *w);
+void wave_cache_get_stats(cst_wave_cache *wc, cst_wave_cache_stats *stats);
+CST_VAL_USER_TYPE_DCLS(wave_cache, cst_wave_cache);
+
 cst_utterance *default_phrasing(cst_utterance *u);
 cst_utterance *default_pos_tagger(cst_utterance *u);
 cst_utterance *default_lexical_insertion(cst_utterance *u);
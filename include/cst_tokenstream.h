@@ -102,6 +102,12 @@ typedef struct cst_tokenstream_struct {
     int (*tell) (struct cst_tokenstream_struct *ts);
     int (*size) (struct cst_tokenstream_struct *ts);
     int (*getc) (struct cst_tokenstream_struct *ts);
+
+    /* Files are read a block at a time, runs of ASCII in the block are */
+    /* copied into the token buffers without going through getc         */
+    unsigned char *fd_buffer;
+    int fd_buffer_len;
+    int fd_buffer_pos;
 } cst_tokenstream;
 
 #define TS_CHARCLASS_NONE        0
@@ -182,6 +188,10 @@ void set_charclasses(cst_tokenstream *ts,
                      const cst_string *prepunctuation,
                      const cst_string *postpunctuation);
 
+/* Raw bytes from where the tokens have got to, e.g. binary data after */
+/* a header.  Returns the number of items of size bytes read.          */
+int ts_read(void *buff, int size, int num, cst_tokenstream *ts);
+
 int ts_set_stream_pos(cst_tokenstream *ts, int pos);
 int ts_get_stream_pos(cst_tokenstream *ts);
 int ts_get_stream_size(cst_tokenstream *ts);
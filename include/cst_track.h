@@ -47,20 +47,46 @@
 #include "cst_file.h"
 #include "cst_val.h"
 
+/* The values are held in one aligned block.  Row major (the default) */
+/* keeps each frame's channels together and frames[i] points at frame  */
+/* i.  Channel major keeps each channel's frames together, for code    */
+/* that works along time, and frames is NULL.  Either way               */
+/* cst_track_val() addresses a value.                                   */
+#define CST_TRACK_ROW_MAJOR 0
+#define CST_TRACK_CHANNEL_MAJOR 1
+#define CST_TRACK_ALIGN 32      /* bytes, for rows/channels and the block */
+
 typedef struct cst_track_struct {
     const char *type;
     int num_frames;
     int num_channels;
     float *times;
-    float **frames;
+    float **frames;             /* into data, row major only */
+    float *data;
+    int frame_step;             /* floats from one frame to the next */
+    int channel_step;           /* floats from one channel to the next */
+    int layout;
+    void *block;                /* data's allocation, NULL for a view */
 } cst_track;
 
+#define cst_track_val(t,f,c) \
+    ((t)->data[((f) * (t)->frame_step) + ((c) * (t)->channel_step)])
+/* Channel c's frames, contiguous in a channel major track */
+#define cst_track_channel(t,c) ((t)->data + ((c) * (t)->channel_step))
+
 cst_track *new_track();
 void delete_track(cst_track *val);
 
 float track_frame_shift(cst_track *t, int frame);
 void cst_track_resize(cst_track *t, int num_frames, int num_channels);
+void cst_track_set_layout(cst_track *t, int layout);
 cst_track *cst_track_copy(const cst_track *t);
+/* A track over part of t's frames and channels, sharing t's storage, */
+/* so it must be deleted before t.  Resizing a view gives it storage   */
+/* of its own.                                                         */
+cst_track *cst_track_view(const cst_track *t, int first_frame,
+                          int num_frames, int first_channel,
+                          int num_channels);
 
 int cst_track_save_est(cst_track *t, const char *filename);
 int cst_track_save_est_binary(cst_track *t, const char *filename);
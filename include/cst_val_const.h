@@ -124,6 +124,8 @@
 #define DEF_CONST_VAL_STRING(N,S) const cst_val N = {{.a={.type=CST_VAL_TYPE_STRING,.ref_count=-1,.v={.vval= (void *)S}}}}
 #define DEF_CONST_VAL_FLOAT(N,F) const cst_val N = {{.a={.type=CST_VAL_TYPE_FLOAT,.ref_count=-1,.v={.fval=F}}}}
 #define DEF_CONST_VAL_CONS(N,A,D) const cst_val N = {{.cc={.car=A,.cdr=D }}}
+#define CST_CONST_VAL_INT_INIT(V) {{.a={.type=CST_VAL_TYPE_INT,.ref_count=-1,.v={.ival=V}}}}
+typedef cst_val cst_val_small_int;
 
 extern const cst_val val_int_0;
 extern const cst_val val_int_1;
@@ -255,6 +257,12 @@ typedef struct cst_val_atom_struct_void {
 #define DEF_CONST_VAL_FLOAT(N,F) const cst_val_float N={CST_VAL_TYPE_FLOAT,-1,(float)F}
 #endif
 #define DEF_CONST_VAL_CONS(N,A,D) const cst_val_cons N={A,D}
+#ifdef WORDS_BIGENDIAN
+#define CST_CONST_VAL_INT_INIT(V) {-1, CST_VAL_TYPE_INT, V}
+#else
+#define CST_CONST_VAL_INT_INIT(V) {CST_VAL_TYPE_INT, -1, V}
+#endif
+typedef cst_val_int cst_val_small_int;
 
 /* in the non-union intialization version we these consts have to be */
 /* more typed than need, we'll cast the back later                   */
@@ -377,4 +385,12 @@ const cst_val *val_int_n(int n);
 
 const cst_val *val_string_n(int n);
 
+/* int_val() returns these for ints in this range rather than allocating */
+/* (they are in the text segment, so never write into an int_val)       */
+#define CST_VAL_SMALL_INT_MIN (-128)
+#define CST_VAL_SMALL_INT_MAX 1023
+extern const cst_val_small_int cst_val_small_ints[];
+#define CST_VAL_SMALL_INT(I) \
+    ((cst_val *)&cst_val_small_ints[(I) - CST_VAL_SMALL_INT_MIN])
+
 #endif
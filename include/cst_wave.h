@@ -106,7 +106,8 @@ typedef struct cst_rateconv_struct {
 
     double gain;                /* output gain */
     int lag;                    /* lag time (in samples) */
-    int *sin, *sout, *coep;     /* filter buffers, coefficients */
+    short *sin, *sout;          /* filter buffers */
+    const short *coep;          /* coefficients, shared between filters */
 
     /* n.b. outsize is the minimum buffer size for
        cst_rateconv_out() when streaming */
@@ -121,17 +122,26 @@ typedef struct cst_rateconv_struct {
 } cst_rateconv;
 
 cst_rateconv *new_rateconv(int up, int down, int channels);
+/* Uses the exact ratio between the rates, e.g. 160/441 for 44.1k to 16k */
+cst_rateconv *new_rateconv_rates(int in_rate, int out_rate, int channels);
 void delete_rateconv(cst_rateconv *filt);
 int cst_rateconv_in(cst_rateconv *filt, const short *inptr, int max);
 int cst_rateconv_leadout(cst_rateconv *filt);
 int cst_rateconv_out(cst_rateconv *filt, short *outptr, int max);
+/* Streaming helpers: run() pushes a whole chunk through, max_out() is */
+/* the output buffer size it needs                                     */
+int cst_rateconv_run(cst_rateconv *filt, const short *in, int insize,
+                     short *out, int outsize, int last);
+int cst_rateconv_max_out(const cst_rateconv *filt, int insize);
+/* Filter banks are cached per ratio, this releases them */
+void cst_rateconv_free_banks(void);
 
 /* File format cruft. */
 
 #define RIFF_FORMAT_PCM    0x0001
 #define RIFF_FORMAT_ADPCM  0x0002
-#define RIFF_FORMAT_MULAW  0x0006
-#define RIFF_FORMAT_ALAW   0x0007
+#define RIFF_FORMAT_ALAW   0x0006
+#define RIFF_FORMAT_MULAW  0x0007
 
 /* Sun/Next header, short and sweet, note its always BIG_ENDIAN though */
 typedef struct {
@@ -151,6 +161,8 @@ typedef struct {
 /* Convertion functions */
 unsigned char cst_short_to_ulaw(int16_t sample);
 int16_t cst_ulaw_to_short(unsigned char ulawbyte);
+unsigned char cst_short_to_alaw(int16_t sample);
+int16_t cst_alaw_to_short(unsigned char alawbyte);
 
 #define CST_G721_LEADIN 8
 unsigned char *cst_g721_decode(int *actual_size, int size,
@@ -158,5 +170,73 @@ unsigned char *cst_g721_decode(int *actual_size, int size,
 unsigned char *cst_g721_encode(int *packed_size, int actual_size,
                                const unsigned char *unpacked_residual);
 
+/* Output encoders: mono linear samples in, rate converted and coded */
+/* bytes out through the write callback (src/speech/cst_wave_encode.c) */
+/* G.721 packs two codes per byte, first one in the high nibble, as    */
+/* cst_g721_encode() does.                                             */
+#define CST_WAVE_ENC_LINEAR16 0
+#define CST_WAVE_ENC_ULAW 1
+#define CST_WAVE_ENC_ALAW 2
+#define CST_WAVE_ENC_G721 3
+#define CST_WAVE_ENC_TELEPHONY_RATE 8000
+
+typedef struct cst_wave_encoder_struct {
+    int encoding;               /* CST_WAVE_ENC_* */
+    int in_rate;                /* set by the first write */
+    int out_rate;               /* 0 keeps the input rate */
+    cst_rateconv *rateconv;     /* NULL when no conversion is needed */
+    void *g72x;                 /* G.721 predictor state */
+    int nibble;                 /* G.721 code waiting for its pair, or -1 */
+    short *sbuf;
+    int sbuf_size;
+    unsigned char *obuf;
+    int obuf_size;
+    long bytes_out;
+    int (*write) (struct cst_wave_encoder_struct *enc,
+                  const unsigned char *bytes, int num_bytes);
+    void *userdata;
+} cst_wave_encoder;
+
+/* Maps "ulaw", "alaw", "g721" or "linear16" to CST_WAVE_ENC_*, or -1 */
+int cst_wave_encoding_id(const char *name);
+cst_wave_encoder *new_wave_encoder(int encoding, int out_rate,
+                                   int (*write) (cst_wave_encoder *enc,
+                                                 const unsigned char *bytes,
+                                                 int num_bytes),
+                                   void *userdata);
+void delete_wave_encoder(cst_wave_encoder *enc);
+/* last flushes the resampler and any half filled G.721 byte, the next */
+/* write starts a new signal                                          */
+int cst_wave_encoder_write(cst_wave_encoder *enc, const short *samples,
+                           int num_samples, int sample_rate, int last);
+/* Encodes a whole wave to a headerless file, appending if asked */
+int cst_wave_save_encoded(const cst_wave *w, const char *filename,
+                          int encoding, int out_rate, int append);
+
+/* Incremental wave file writer (src/speech/cst_wave_writer.c): the file */
+/* stays open, writes are buffered and the riff header sizes are set at   */
+/* close.  A sample_rate of 0 takes the rate of the first write, later    */
+/* writes at other rates are converted.  riff writes a wave header, for   */
+/* linear16, ulaw or alaw; without it the file is headerless.             */
+#define CST_WAVE_WRITER_BUFFSIZE (256 * 1024)
+
+typedef struct cst_wave_writer_struct {
+    cst_file fd;
+    int riff;
+    int sample_rate;
+    long data_bytes;
+    cst_wave_encoder *enc;
+    unsigned char *buff;
+    int buff_size;
+    int fill;
+} cst_wave_writer;
+
+cst_wave_writer *cst_wave_writer_open(const char *filename, int encoding,
+                                      int sample_rate, int riff);
+int cst_wave_writer_write(cst_wave_writer *ww, const short *samples,
+                          int num_samples, int sample_rate);
+int cst_wave_writer_write_wave(cst_wave_writer *ww, const cst_wave *w);
+int cst_wave_writer_close(cst_wave_writer *ww);
+
 CST_VAL_USER_TYPE_DCLS(wave, cst_wave);
 #endif
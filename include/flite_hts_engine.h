@@ -73,10 +73,21 @@ void delete_flitehtsengine(Flite_HTS_Engine * f);
 FLITE_HTS_ENGINE_H_START;
 
 #include "HTS_engine.h"
-
+#include "cst_file.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/* engine holds the voice, read only once loaded; each utterance is */
+/* synthesized by an HTS_Engine of its own sharing its models, so     */
+/* utterances can be synthesized at the same time                     */
 typedef struct _Flite_HTS_Engine {
     HTS_Engine engine;
     int is_engine_loaded;
+    cst_filemap *map;           /* the mapped voice file, if it is */
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_t lock;       /* for loading and the engine's settings */
+#endif
 } Flite_HTS_Engine;
 
 #include "cst_val.h"
@@ -88,7 +99,7 @@ void delete_flitehtsengine(Flite_HTS_Engine * f);
 /* Flite_HTS_Engine_initialize: initialize system */
 void Flite_HTS_Engine_initialize(Flite_HTS_Engine * f);
 
-/* Flite_HTS_Engine_load: load HTS voice */
+/* Flite_HTS_Engine_load: load HTS voice, mapping the file if possible */
 HTS_Boolean Flite_HTS_Engine_load(Flite_HTS_Engine * f, const char *fn);
 
 /* Flite_HTS_Engine_set_sampling_frequency: set sampling frequency */
@@ -136,6 +147,8 @@ size_t Flite_HTS_Engine_get_sampling_frequency(Flite_HTS_Engine * f);
 
 /* Generate wave for utt */
 cst_utterance *hts_synth(cst_utterance *utt);
+/* Segment durations only, the voice's alignment_func */
+cst_utterance *hts_durations(cst_utterance *utt);
 
 /* Find .htsvoice file path for voice v */
 char *mimic_hts_get_voice_file(const cst_voice *const v);
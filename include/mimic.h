@@ -88,6 +88,11 @@ extern "C" {
     int mimic_ssml_text_to_speech(const char *text, cst_voice *voice,
                                     const char *outtype, float *dur);
     int mimic_voice_add_lex_addenda(cst_voice *v, const cst_string *lexfile);
+/* Fill the cst_wave_cache in the voice's "wave_cache" feature with the */
+/* prompts in listfile, one per line.  Lines already cached are only    */
+/* looked up.  Returns the number of prompts, set it up before any      */
+/* streaming_info as the prompts are synthesized as usual.              */
+    int mimic_wave_cache_warmup(cst_voice *voice, const char *listfile);
 
 /* Lower lever user functions */
     cst_wave *mimic_text_to_wave(const char *text, cst_voice *voice);
@@ -96,11 +101,45 @@ extern "C" {
 
     int mimic_ts_to_speech(cst_tokenstream *ts, cst_voice *voice,
                            const char *outtype, float *dur);
+/* Utterances are cut from tokens as they are added and synthesized by  */
+/* up to num_threads threads (the voice's "synth_threads" feature for    */
+/* mimic_ts_to_speech()), output stays in order.  Used by the plain text */
+/* and ssml readers.                                                     */
+    typedef struct cst_synth_pipeline_struct cst_synth_pipeline;
+    cst_synth_pipeline *new_synth_pipeline(cst_voice *voice,
+                                           const char *outtype,
+                                           int num_threads);
+    void synth_pipeline_set_voice(cst_synth_pipeline *p, cst_voice *voice);
+    cst_item *synth_pipeline_token(cst_synth_pipeline *p,
+                                   cst_tokenstream *ts, const char *token);
+    cst_item *synth_pipeline_last_token(cst_synth_pipeline *p);
+    int synth_pipeline_break(cst_synth_pipeline *p);
+    int synth_pipeline_wave(cst_synth_pipeline *p, cst_wave *w);
+    int synth_pipeline_close(cst_synth_pipeline *p, float *dur);
     cst_utterance *mimic_do_synth(cst_utterance *u,
                                   cst_voice *voice, cst_uttfunc synth);
     int mimic_process_output(cst_utterance *u,
                              const char *outtype, int append, float *dur);
 
+/* Phone timing only, no parameters or audio (src/synth/cst_alignment.c). */
+/* Each non empty line of a file is aligned and written to outfile as    */
+/* one record; files_to_alignments writes <file>.align.json (or .align)  */
+/* next to each input, spread over num_threads threads, and returns the  */
+/* number of files that failed.                                           */
+#define MIMIC_ALIGN_JSON 0
+#define MIMIC_ALIGN_BINARY 1
+    int mimic_alignment_format(const char *name);
+    cst_utterance *mimic_text_to_alignment(const char *text,
+                                           cst_voice *voice);
+    int mimic_alignment_write_header(cst_file fd, int format);
+    int mimic_alignment_write(cst_file fd, const cst_utterance *u,
+                              int format, int line);
+    int mimic_file_to_alignments(const char *filename, cst_voice *voice,
+                                 const char *outfile, int format);
+    int mimic_files_to_alignments(const char *const *filenames,
+                                  int num_files, cst_voice *voice,
+                                  int format, int num_threads);
+
 /* for voices with external voxdata */
     int mimic_mmap_clunit_voxdata(const char *voxdir, cst_voice *voice);
     int mimic_munmap_clunit_voxdata(cst_voice *voice);
@@ -79,6 +79,7 @@ cst_voice *register_cmu_us_rms(const char *voxdir)
 
     /* Waveform synthesis */
     mimic_feat_set(vox->features,"wave_synth_func",uttfunc_val(&cg_synth));
+    mimic_feat_set(vox->features,"alignment_func",uttfunc_val(&cg_durations));
     mimic_feat_set(vox->features,"cg_db",cg_db_val(&cmu_us_rms_cg_db));
     mimic_feat_set_int(vox->features,"sample_rate",cmu_us_rms_cg_db.sample_rate);
 
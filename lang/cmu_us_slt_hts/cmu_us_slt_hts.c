@@ -97,6 +97,7 @@ cst_voice *register_cmu_us_slt_hts(const char *voxdir)
 
     /* Waveform synthesis */
     mimic_feat_set(vox->features, "wave_synth_func", uttfunc_val(&hts_synth));
+    mimic_feat_set(vox->features, "alignment_func", uttfunc_val(&hts_durations));
     mimic_feat_set_int(vox->features, "sample_rate",
                        Flite_HTS_Engine_get_sampling_frequency(flite_hts));
 
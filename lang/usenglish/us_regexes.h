@@ -9,9 +9,52 @@ static const unsigned char ordinal_number_rxprog[] = {
    6, 0, 9, 8, 0, 15, 114, 100, 0, 6, 0, 9, 8, 0, 6, 82, 
    68, 0, 31, 0, 3, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char ordinal_number_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 
+   2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 3, 0, 0, 0, 4, 0, 0, 0, 0, 0, 5, 0, 
+   0, 0, 6, 7, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 9, 0, 0, 0, 10, 0, 0, 0, 0, 0, 11, 0, 
+   0, 0, 12, 13, 14, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short ordinal_number_rxtrans[] = {
+   -1, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   1, 1, -1, -1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, -1, -1, 
+   -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 10, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, 
+};
+static const unsigned int ordinal_number_rxaccept[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+};
+static const unsigned int ordinal_number_rxaccept_end[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 
+};
+static const cst_regex_dfa ordinal_number_rxdfa = {
+   11, 15,
+   ordinal_number_rxclassmap, ordinal_number_rxtrans, ordinal_number_rxaccept, ordinal_number_rxaccept_end
+};
 static const cst_regex ordinal_number_rx = {
    0, 1, NULL, 0, 123,
-   (char *)ordinal_number_rxprog
+   (char *)ordinal_number_rxprog,
+   &ordinal_number_rxdfa
 };
 const cst_regex * const ordinal_number = &ordinal_number_rx;
 
@@ -20,9 +63,42 @@ static const unsigned char hasvowel_rxprog[] = {
    97, 101, 105, 111, 117, 65, 69, 73, 79, 85, 0, 10, 0, 6, 3, 0, 
    0, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char hasvowel_rxclassmap[] = {
+   0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 2, 1, 1, 1, 2, 1, 1, 1, 2, 1, 1, 1, 1, 1, 2, 
+   1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 2, 1, 1, 1, 2, 1, 1, 1, 2, 1, 1, 1, 1, 1, 2, 
+   1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   
+};
+static const short hasvowel_rxtrans[] = {
+   -1, 0, 1, -1, 1, 1, 
+};
+static const unsigned int hasvowel_rxaccept[] = {
+   0, 0, 
+};
+static const unsigned int hasvowel_rxaccept_end[] = {
+   0, 1, 
+};
+static const cst_regex_dfa hasvowel_rxdfa = {
+   2, 3,
+   hasvowel_rxclassmap, hasvowel_rxtrans, hasvowel_rxaccept, hasvowel_rxaccept_end
+};
 static const cst_regex hasvowel_rx = {
    0, 1, NULL, 0, 39,
-   (char *)hasvowel_rxprog
+   (char *)hasvowel_rxprog,
+   &hasvowel_rxdfa
 };
 const cst_regex * const hasvowel = &hasvowel_rx;
 
@@ -33,9 +109,43 @@ static const unsigned char usmoney_rxprog[] = {
    0, 0, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 0, 31, 0, 6, 
    6, 0, 3, 9, 0, 3, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char usmoney_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 2, 0, 3, 0, 
+   4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short usmoney_rxtrans[] = {
+   -1, 1, -1, -1, -1, -1, -1, 2, -1, 2, -1, -1, 2, 3, 2, -1, 
+   -1, -1, -1, 4, -1, -1, -1, -1, 4, 
+};
+static const unsigned int usmoney_rxaccept[] = {
+   0, 0, 0, 0, 0, 
+};
+static const unsigned int usmoney_rxaccept_end[] = {
+   0, 0, 1, 0, 1, 
+};
+static const cst_regex_dfa usmoney_rxdfa = {
+   5, 5,
+   usmoney_rxclassmap, usmoney_rxtrans, usmoney_rxaccept, usmoney_rxaccept_end
+};
 static const cst_regex usmoney_rx = {
    0, 1, NULL, 0, 76,
-   (char *)usmoney_rxprog
+   (char *)usmoney_rxprog,
+   &usmoney_rxdfa
 };
 const cst_regex * const usmoney = &usmoney_rx;
 
@@ -43,9 +153,44 @@ static const unsigned char illion_rxprog[] = {
    156, 6, 0, 25, 1, 0, 3, 10, 0, 6, 3, 0, 0, 8, 0, 10, 
    105, 108, 108, 105, 111, 110, 0, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char illion_rxclassmap[] = {
+   0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 3, 1, 4, 5, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   
+};
+static const short illion_rxtrans[] = {
+   -1, 0, 1, 0, 0, 0, -1, 0, 1, 2, 0, 0, -1, 0, 1, 3, 
+   0, 0, -1, 0, 4, 0, 0, 0, -1, 0, 1, 2, 0, 5, -1, 0, 
+   1, 0, 6, 0, -1, 0, 1, 0, 0, 0, 
+};
+static const unsigned int illion_rxaccept[] = {
+   0, 0, 0, 0, 0, 0, 0, 
+};
+static const unsigned int illion_rxaccept_end[] = {
+   0, 0, 0, 0, 0, 0, 1, 
+};
+static const cst_regex_dfa illion_rxdfa = {
+   7, 6,
+   illion_rxclassmap, illion_rxtrans, illion_rxaccept, illion_rxaccept_end
+};
 static const cst_regex illion_rx = {
    0, 1, NULL, 0, 29,
-   (char *)illion_rxprog
+   (char *)illion_rxprog,
+   &illion_rxdfa
 };
 const cst_regex * const illion = &illion_rx;
 
@@ -60,9 +205,44 @@ static const unsigned char romannums_rxprog[] = {
    88, 0, 6, 0, 18, 8, 0, 5, 88, 0, 10, 0, 10, 4, 0, 0, 
    86, 73, 88, 0, 31, 0, 3, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char romannums_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 2, 0, 3, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short romannums_rxtrans[] = {
+   -1, 1, 2, 3, -1, 4, 5, 5, -1, 6, -1, -1, -1, 3, 3, 3, 
+   -1, 5, -1, -1, -1, -1, -1, -1, -1, 7, -1, -1, -1, 5, -1, -1, 
+   
+};
+static const unsigned int romannums_rxaccept[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 
+};
+static const unsigned int romannums_rxaccept_end[] = {
+   0, 1, 1, 1, 1, 1, 1, 1, 
+};
+static const cst_regex_dfa romannums_rxdfa = {
+   8, 4,
+   romannums_rxclassmap, romannums_rxtrans, romannums_rxaccept, romannums_rxaccept_end
+};
 static const cst_regex romannums_rx = {
    0, 1, NULL, 0, 141,
-   (char *)romannums_rxprog
+   (char *)romannums_rxprog,
+   &romannums_rxdfa
 };
 const cst_regex * const romannums = &romannums_rx;
 
@@ -72,9 +252,43 @@ static const unsigned char drst_rxprog[] = {
    115, 0, 4, 0, 6, 116, 84, 0, 31, 0, 3, 2, 0, 3, 0, 0, 
    0, 
 };
+static const unsigned char drst_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 2, 3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 2, 3, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short drst_rxtrans[] = {
+   -1, 1, -1, 2, -1, -1, -1, 3, -1, -1, -1, -1, -1, -1, 3, -1, 
+   -1, -1, -1, -1, 
+};
+static const unsigned int drst_rxaccept[] = {
+   0, 0, 0, 0, 
+};
+static const unsigned int drst_rxaccept_end[] = {
+   0, 0, 0, 1, 
+};
+static const cst_regex_dfa drst_rxdfa = {
+   4, 5,
+   drst_rxclassmap, drst_rxtrans, drst_rxaccept, drst_rxaccept_end
+};
 static const cst_regex drst_rx = {
    0, 1, NULL, 0, 49,
-   (char *)drst_rxprog
+   (char *)drst_rxprog,
+   &drst_rxdfa
 };
 const cst_regex * const drst = &drst_rx;
 
@@ -83,9 +297,42 @@ static const unsigned char numess_rxprog[] = {
    51, 52, 53, 54, 55, 56, 57, 0, 8, 0, 5, 115, 0, 2, 0, 3, 
    0, 0, 0, 
 };
+static const unsigned char numess_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short numess_rxtrans[] = {
+   -1, 1, -1, -1, 1, 2, -1, -1, -1, 
+};
+static const unsigned int numess_rxaccept[] = {
+   0, 0, 0, 
+};
+static const unsigned int numess_rxaccept_end[] = {
+   0, 0, 1, 
+};
+static const cst_regex_dfa numess_rxdfa = {
+   3, 3,
+   numess_rxclassmap, numess_rxtrans, numess_rxaccept, numess_rxaccept_end
+};
 static const cst_regex numess_rx = {
    0, 1, NULL, 0, 35,
-   (char *)numess_rxprog
+   (char *)numess_rxprog,
+   &numess_rxdfa
 };
 const cst_regex * const numess = &numess_rx;
 
@@ -99,9 +346,43 @@ static const unsigned char sevenphonenumber_rxprog[] = {
    4, 0, 14, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 0, 2, 0, 
    3, 0, 0, 0, 
 };
+static const unsigned char sevenphonenumber_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 
+   2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short sevenphonenumber_rxtrans[] = {
+   -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, 4, -1, -1, -1, 5, -1, 
+   -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, -1, 
+};
+static const unsigned int sevenphonenumber_rxaccept[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 
+};
+static const unsigned int sevenphonenumber_rxaccept_end[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 1, 
+};
+static const cst_regex_dfa sevenphonenumber_rxdfa = {
+   9, 3,
+   sevenphonenumber_rxclassmap, sevenphonenumber_rxtrans, sevenphonenumber_rxaccept, sevenphonenumber_rxaccept_end
+};
 static const cst_regex sevenphonenumber_rx = {
    0, 1, NULL, 0, 116,
-   (char *)sevenphonenumber_rxprog
+   (char *)sevenphonenumber_rxprog,
+   &sevenphonenumber_rxdfa
 };
 const cst_regex * const sevenphonenumber = &sevenphonenumber_rx;
 
@@ -112,9 +393,42 @@ static const unsigned char fourdigits_rxprog[] = {
    0, 4, 0, 14, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 0, 2, 
    0, 3, 0, 0, 0, 
 };
+static const unsigned char fourdigits_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short fourdigits_rxtrans[] = {
+   -1, 1, -1, 2, -1, 3, -1, 4, -1, -1, 
+};
+static const unsigned int fourdigits_rxaccept[] = {
+   0, 0, 0, 0, 0, 
+};
+static const unsigned int fourdigits_rxaccept_end[] = {
+   0, 0, 0, 0, 1, 
+};
+static const cst_regex_dfa fourdigits_rxdfa = {
+   5, 2,
+   fourdigits_rxclassmap, fourdigits_rxtrans, fourdigits_rxaccept, fourdigits_rxaccept_end
+};
 static const cst_regex fourdigits_rx = {
    0, 1, NULL, 0, 69,
-   (char *)fourdigits_rxprog
+   (char *)fourdigits_rxprog,
+   &fourdigits_rxdfa
 };
 const cst_regex * const fourdigits = &fourdigits_rx;
 
@@ -124,9 +438,42 @@ static const unsigned char threedigits_rxprog[] = {
    56, 57, 0, 4, 0, 14, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 
    0, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char threedigits_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short threedigits_rxtrans[] = {
+   -1, 1, -1, 2, -1, 3, -1, -1, 
+};
+static const unsigned int threedigits_rxaccept[] = {
+   0, 0, 0, 0, 
+};
+static const unsigned int threedigits_rxaccept_end[] = {
+   0, 0, 0, 1, 
+};
+static const cst_regex_dfa threedigits_rxdfa = {
+   4, 2,
+   threedigits_rxclassmap, threedigits_rxtrans, threedigits_rxaccept, threedigits_rxaccept_end
+};
 static const cst_regex threedigits_rx = {
    0, 1, NULL, 0, 55,
-   (char *)threedigits_rxprog
+   (char *)threedigits_rxprog,
+   &threedigits_rxdfa
 };
 const cst_regex * const threedigits = &threedigits_rx;
 
@@ -137,9 +484,43 @@ static const unsigned char numbertime_rxprog[] = {
    0, 4, 0, 10, 48, 49, 50, 51, 52, 53, 0, 4, 0, 14, 48, 49, 
    50, 51, 52, 53, 54, 55, 56, 57, 0, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char numbertime_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short numbertime_rxtrans[] = {
+   -1, 1, 1, -1, -1, 2, 2, 3, -1, -1, -1, 3, -1, 4, -1, -1, 
+   -1, 5, 5, -1, -1, -1, -1, -1, 
+};
+static const unsigned int numbertime_rxaccept[] = {
+   0, 0, 0, 0, 0, 0, 
+};
+static const unsigned int numbertime_rxaccept_end[] = {
+   0, 0, 0, 0, 0, 1, 
+};
+static const cst_regex_dfa numbertime_rxdfa = {
+   6, 4,
+   numbertime_rxclassmap, numbertime_rxtrans, numbertime_rxaccept, numbertime_rxaccept_end
+};
 static const cst_regex numbertime_rx = {
    0, 1, NULL, 0, 79,
-   (char *)numbertime_rxprog
+   (char *)numbertime_rxprog,
+   &numbertime_rxdfa
 };
 const cst_regex * const numbertime = &numbertime_rx;
 
@@ -151,9 +532,45 @@ static const unsigned char numbertimexm_rxprog[] = {
    49, 50, 51, 52, 53, 54, 55, 56, 57, 0, 4, 0, 6, 97, 112, 0, 
    8, 0, 5, 109, 0, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char numbertimexm_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 
+   2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 1, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 
+   4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short numbertimexm_rxtrans[] = {
+   -1, -1, 1, 1, -1, -1, -1, 2, 3, 3, -1, -1, -1, -1, 4, -1, 
+   -1, -1, -1, 2, -1, -1, -1, -1, -1, -1, 5, 5, -1, -1, -1, -1, 
+   -1, -1, 6, -1, -1, -1, -1, -1, -1, 7, -1, -1, -1, -1, -1, -1, 
+   
+};
+static const unsigned int numbertimexm_rxaccept[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 
+};
+static const unsigned int numbertimexm_rxaccept_end[] = {
+   0, 0, 0, 0, 0, 0, 0, 1, 
+};
+static const cst_regex_dfa numbertimexm_rxdfa = {
+   8, 6,
+   numbertimexm_rxclassmap, numbertimexm_rxtrans, numbertimexm_rxaccept, numbertimexm_rxaccept_end
+};
 static const cst_regex numbertimexm_rx = {
    0, 1, NULL, 0, 91,
-   (char *)numbertimexm_rxprog
+   (char *)numbertimexm_rxprog,
+   &numbertimexm_rxdfa
 };
 const cst_regex * const numbertimexm = &numbertimexm_rx;
 
@@ -170,9 +587,42 @@ static const unsigned char dottedabbrevs_rxprog[] = {
    0, 6, 0, 8, 8, 0, 8, 46, 0, 6, 0, 3, 9, 0, 3, 2, 
    0, 3, 0, 0, 0, 
 };
+static const unsigned char dottedabbrevs_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 
+   2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 
+   0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 
+   2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short dottedabbrevs_rxtrans[] = {
+   -1, -1, 1, -1, 2, -1, -1, -1, 3, -1, 4, -1, -1, -1, 3, 
+};
+static const unsigned int dottedabbrevs_rxaccept[] = {
+   0, 0, 0, 0, 0, 
+};
+static const unsigned int dottedabbrevs_rxaccept_end[] = {
+   0, 0, 0, 1, 1, 
+};
+static const cst_regex_dfa dottedabbrevs_rxdfa = {
+   5, 3,
+   dottedabbrevs_rxclassmap, dottedabbrevs_rxtrans, dottedabbrevs_rxaccept, dottedabbrevs_rxaccept_end
+};
 static const cst_regex dottedabbrevs_rx = {
    0, 1, NULL, 0, 165,
-   (char *)dottedabbrevs_rxprog
+   (char *)dottedabbrevs_rxprog,
+   &dottedabbrevs_rxdfa
 };
 const cst_regex * const dottedabbrevs = &dottedabbrevs_rx;
 
@@ -182,9 +632,42 @@ static const unsigned char digitsslashdigits_rxprog[] = {
    4, 0, 0, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 0, 2, 0, 
    3, 0, 0, 0, 
 };
+static const unsigned char digitsslashdigits_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 
+   2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short digitsslashdigits_rxtrans[] = {
+   -1, -1, 1, -1, 2, 1, -1, -1, 3, -1, -1, 3, 
+};
+static const unsigned int digitsslashdigits_rxaccept[] = {
+   0, 0, 0, 0, 
+};
+static const unsigned int digitsslashdigits_rxaccept_end[] = {
+   0, 0, 0, 1, 
+};
+static const cst_regex_dfa digitsslashdigits_rxdfa = {
+   4, 3,
+   digitsslashdigits_rxclassmap, digitsslashdigits_rxtrans, digitsslashdigits_rxaccept, digitsslashdigits_rxaccept_end
+};
 static const cst_regex digitsslashdigits_rx = {
    0, 1, NULL, 0, 52,
-   (char *)digitsslashdigits_rxprog
+   (char *)digitsslashdigits_rxprog,
+   &digitsslashdigits_rxdfa
 };
 const cst_regex * const digitsslashdigits = &digitsslashdigits_rx;
 
@@ -195,9 +678,43 @@ static const unsigned char digits2dash_rxprog[] = {
    0, 3, 9, 0, 3, 11, 0, 17, 4, 0, 0, 48, 49, 50, 51, 52, 
    53, 54, 55, 56, 57, 0, 2, 0, 3, 0, 0, 0, 
 };
+static const unsigned char digits2dash_rxclassmap[] = {
+   0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 1, 1, 
+   3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+   
+};
+static const short digits2dash_rxtrans[] = {
+   -1, -1, -1, 1, -1, -1, 2, 1, -1, 3, 3, 3, -1, -1, -1, 4, 
+   -1, -1, 2, 4, 
+};
+static const unsigned int digits2dash_rxaccept[] = {
+   0, 0, 0, 0, 0, 
+};
+static const unsigned int digits2dash_rxaccept_end[] = {
+   0, 0, 0, 0, 1, 
+};
+static const cst_regex_dfa digits2dash_rxdfa = {
+   5, 4,
+   digits2dash_rxclassmap, digits2dash_rxtrans, digits2dash_rxaccept, digits2dash_rxaccept_end
+};
 static const cst_regex digits2dash_rx = {
    0, 1, NULL, 0, 76,
-   (char *)digits2dash_rxprog
+   (char *)digits2dash_rxprog,
+   &digits2dash_rxdfa
 };
 const cst_regex * const digits2dash = &digits2dash_rx;
 
@@ -220,9 +737,78 @@ static const unsigned char wandm_rxprog[] = {
    0, 9, 8, 0, 6, 84, 66, 0, 31, 0, 3, 2, 0, 3, 0, 0, 
    0, 
 };
+static const unsigned char wandm_rxclassmap[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 
+   2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0, 0, 
+   0, 0, 3, 0, 0, 0, 4, 5, 6, 0, 0, 7, 8, 9, 0, 0, 
+   0, 0, 0, 10, 11, 0, 0, 0, 0, 0, 12, 0, 0, 0, 0, 0, 
+   0, 0, 13, 14, 0, 0, 15, 16, 17, 0, 0, 18, 19, 20, 0, 21, 
+   0, 0, 0, 22, 23, 0, 0, 0, 0, 0, 24, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   
+};
+static const short wandm_rxtrans[] = {
+   -1, 0, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1, -1, 2, 3, 4, 
+   5, 6, 7, -1, 8, -1, -1, 9, 10, -1, 11, 12, 13, 14, 15, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, 
+   -1, 17, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   16, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, -1, 
+   16, -1, -1, 18, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, 19, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, 16, -1, -1, 20, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, 16, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, 16, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, -1, 
+   16, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, 21, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, 16, 16, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, 16, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, 16, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 16, -1, -1, -1, 
+   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 
+   -1, -1, -1, 16, -1, -1, 
+};
+static const unsigned int wandm_rxaccept[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   0, 0, 0, 0, 0, 0, 
+};
+static const unsigned int wandm_rxaccept_end[] = {
+   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+   1, 0, 0, 1, 0, 1, 
+};
+static const cst_regex_dfa wandm_rxdfa = {
+   22, 25,
+   wandm_rxclassmap, wandm_rxtrans, wandm_rxaccept, wandm_rxaccept_end
+};
 static const cst_regex wandm_rx = {
    0, 1, NULL, 0, 257,
-   (char *)wandm_rxprog
+   (char *)wandm_rxprog,
+   &wandm_rxdfa
 };
 const cst_regex * const wandm = &wandm_rx;
 
@@ -50,6 +50,94 @@ static cst_val *state_name(const char *name,cst_item *t);
 /* compiled us regexes */
 #include "us_regexes.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/* The regexes us_tokentowords_one() tries on the token name, they are */
+/* all matched in a single pass over the name with one combined DFA    */
+enum {
+    US_RX_DOTTEDABBREVS,
+    US_RX_COMMAINT,
+    US_RX_SEVENPHONENUMBER,
+    US_RX_THREEDIGITS,
+    US_RX_FOURDIGITS,
+    US_RX_NUMBERTIME,
+    US_RX_NUMBERTIMEXM,
+    US_RX_DIGITS2DASH,
+    US_RX_DIGITS,
+    US_RX_ROMANNUMS,
+    US_RX_DRST,
+    US_RX_DOUBLE,
+    US_RX_ORDINAL_NUMBER,
+    US_RX_ILLION,
+    US_RX_USMONEY,
+    US_RX_NUMESS,
+    US_RX_DIGITSSLASHDIGITS,
+    US_RX_WANDM,
+    US_RX_ALPHA,
+    US_RX_NUM
+};
+
+static const cst_regex *us_name_rxs[US_RX_NUM];
+static cst_regex_dfa *us_name_dfa = NULL;
+
+static void us_name_dfa_build(void)
+{
+    us_name_rxs[US_RX_DOTTEDABBREVS] = dottedabbrevs;
+    us_name_rxs[US_RX_COMMAINT] = cst_rx_commaint;
+    us_name_rxs[US_RX_SEVENPHONENUMBER] = sevenphonenumber;
+    us_name_rxs[US_RX_THREEDIGITS] = threedigits;
+    us_name_rxs[US_RX_FOURDIGITS] = fourdigits;
+    us_name_rxs[US_RX_NUMBERTIME] = numbertime;
+    us_name_rxs[US_RX_NUMBERTIMEXM] = numbertimexm;
+    us_name_rxs[US_RX_DIGITS2DASH] = digits2dash;
+    us_name_rxs[US_RX_DIGITS] = cst_rx_digits;
+    us_name_rxs[US_RX_ROMANNUMS] = romannums;
+    us_name_rxs[US_RX_DRST] = drst;
+    us_name_rxs[US_RX_DOUBLE] = cst_rx_double;
+    us_name_rxs[US_RX_ORDINAL_NUMBER] = ordinal_number;
+    us_name_rxs[US_RX_ILLION] = illion;
+    us_name_rxs[US_RX_USMONEY] = usmoney;
+    us_name_rxs[US_RX_NUMESS] = numess;
+    us_name_rxs[US_RX_DIGITSSLASHDIGITS] = digitsslashdigits;
+    us_name_rxs[US_RX_WANDM] = wandm;
+    us_name_rxs[US_RX_ALPHA] = cst_rx_alpha;
+    us_name_dfa = new_cst_regex_dfa(us_name_rxs, US_RX_NUM);
+}
+
+#ifdef HAVE_PTHREAD_H
+static pthread_once_t us_name_dfa_once = PTHREAD_ONCE_INIT;
+#else
+static int us_name_dfa_built = 0;
+#endif
+
+static unsigned int us_name_matches(const char *name)
+{
+    unsigned int m;
+    int i;
+
+#ifdef HAVE_PTHREAD_H
+    pthread_once(&us_name_dfa_once, us_name_dfa_build);
+#else
+    if (!us_name_dfa_built)
+    {
+        us_name_dfa_build();
+        us_name_dfa_built = 1;
+    }
+#endif
+    if (us_name_dfa)
+        return cst_regex_dfa_match(us_name_dfa, name, 1);
+
+    /* Too many states for a DFA, test them one by one */
+    for (m = 0, i = 0; i < US_RX_NUM; i++)
+        if (cst_regex_match(us_name_rxs[i], name))
+            m |= 1u << i;
+    return m;
+}
+
+#define NAME_MATCHES(m, rx) ((m) & (1u << (rx)))
+
 /* Note you need to also update the wandm regex in make_us_regeses too */
 static const char * const wandm_abbrevs[99][2] =
 {
@@ -184,11 +272,68 @@ cst_utterance *us_textanalysis(cst_utterance *u)
 }
 
 static cst_val *us_tokentowords_one(cst_item *token, const char *name);
-cst_val *us_tokentowords(cst_item *token)
+
+static cst_val *us_tokentowords_uncached(cst_item *token)
 {
     return us_tokentowords_one(token, item_feat_string(token, "name"));
 }
 
+/* Everything us_tokentowords_one() looks at, and the token features */
+/* it may change                                                      */
+static const char *const us_ttw_context_feats[] = {
+    "name", "punc", "nsw", "p.name", "p.p.name", "p.punc",
+    "n.name", "n.n.name", "n.whitespace", NULL
+};
+static const char *const us_ttw_token_feats[] = {
+    "name", "punc", "nsw", NULL
+};
+
+static cst_ttw_cache *us_ttw_cache = NULL;
+
+static void us_ttw_cache_init(void)
+{
+    us_ttw_cache = new_ttw_cache(US_TTW_CACHE_SIZE, us_ttw_context_feats,
+                                 us_ttw_token_feats);
+}
+
+#ifdef HAVE_PTHREAD_H
+static pthread_once_t us_ttw_cache_once = PTHREAD_ONCE_INIT;
+#endif
+
+static cst_ttw_cache *us_get_ttw_cache(void)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_once(&us_ttw_cache_once, us_ttw_cache_init);
+#else
+    if (us_ttw_cache == NULL)
+        us_ttw_cache_init();
+#endif
+    return us_ttw_cache;
+}
+
+void us_tokentowords_cache_clear(void)
+{
+    ttw_cache_clear(us_get_ttw_cache());
+}
+
+void us_tokentowords_cache_stats(cst_ttw_cache_stats *stats)
+{
+    ttw_cache_get_stats(us_get_ttw_cache(), stats);
+}
+
+cst_val *us_tokentowords(cst_item *token)
+{
+    /* Explicit pronunciations, SSML substitutions and comments depend */
+    /* on more than the token, so they always go the long way          */
+    if (item_feat_present(token, "phones") ||
+        item_feat_present(token, "ssml_alias") ||
+        item_feat_present(token, "ssml_comment"))
+        return us_tokentowords_uncached(token);
+
+    return ttw_cache_tokentowords(us_get_ttw_cache(), token,
+                                  us_tokentowords_uncached);
+}
+
 static cst_val *add_break(cst_val *l)
 {
     /* add feature (break 1) to last item in this list */
@@ -260,6 +405,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
     const char *token_name = "";
     cst_lexicon *lex;
     cst_utterance *utt;
+    unsigned int m;
     /* printf("token_name %s name %s\n",item_name(token),name); */
     /* FIXME: For SAPI and friends, any tokens with explicit
        pronunciations need to be passed through as-is.  This should be
@@ -289,6 +435,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
         }
     }
 
+    m = us_name_matches(name);
     utt = item_utt(token);
     lex = val_lexicon(feat_val(utt->features,"lexicon"));
 
@@ -303,7 +450,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
     }
     else if (cst_strlen(name) == 0)
         r = NULL;
-    else if (cst_regex_match(dottedabbrevs,name))
+    else if (NAME_MATCHES(m, US_RX_DOTTEDABBREVS))
     {   /* X.X.X */
 	aaa = cst_strdup(name);
 	for (i=j=0; aaa[i]; i++)
@@ -316,7 +463,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	r = en_exp_letters(aaa);
 	cst_free(aaa);
     }
-    else if (cst_regex_match(cst_rx_commaint,name))
+    else if (NAME_MATCHES(m, US_RX_COMMAINT))
     {   /* 99,999,999 */
 	aaa = cst_strdup(name);
 	for (j=i=0; i < cst_strlen(name); i++)
@@ -329,7 +476,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	r = en_exp_real(aaa);
 	cst_free(aaa);
     }
-    else if (cst_regex_match(sevenphonenumber,name))
+    else if (NAME_MATCHES(m, US_RX_SEVENPHONENUMBER))
     {   /* 234-3434 telephone numbers */
 	p=strchr(name,'-');
 	aaa = cst_strdup(name);
@@ -341,7 +488,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	cst_free(bbb);
     }
     else if 
-     ((cst_regex_match(threedigits,name) &&
+     ((NAME_MATCHES(m, US_RX_THREEDIGITS) &&
       ((!cst_regex_match(cst_rx_digits,ffeature_string(token,"p.name"))
 	&& cst_regex_match(threedigits,ffeature_string(token,"n.name"))
 	&& cst_regex_match(fourdigits,ffeature_string(token,"n.n.name"))) ||
@@ -349,7 +496,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
        (!cst_regex_match(cst_rx_digits,ffeature_string(token,"p.p.name"))
 	&& cst_regex_match(threedigits,ffeature_string(token,"p.name"))
 	&& cst_regex_match(fourdigits,ffeature_string(token,"n.name"))))) ||
-      (cst_regex_match(fourdigits,name) &&
+      (NAME_MATCHES(m, US_RX_FOURDIGITS) &&
        (!cst_regex_match(cst_rx_digits,ffeature_string(token,"n.name"))
 	&& cst_regex_match(threedigits,ffeature_string(token,"p.name"))
 	&& cst_regex_match(threedigits,ffeature_string(token,"p.p.name")))))
@@ -359,7 +506,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	    item_set_string(token,"punc",",");
 	r = add_break(en_exp_digits(name));
     }
-    else if (cst_regex_match(numbertime,name))
+    else if (NAME_MATCHES(m, US_RX_NUMBERTIME))
     {
 	p=strchr(name,':');
 	aaa = cst_strdup(name);
@@ -374,7 +521,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	cst_free(aaa);
 	cst_free(bbb);
     }
-    else if (cst_regex_match(numbertimexm,name))
+    else if (NAME_MATCHES(m, US_RX_NUMBERTIMEXM))
     {
 	p=strchr(name,':');
         if (!p) p=strchr(name,'.');
@@ -395,7 +542,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	cst_free(bbb);
 	cst_free(ccc);
     }
-    else if (cst_regex_match(digits2dash,name))
+    else if (NAME_MATCHES(m, US_RX_DIGITS2DASH))
     {   /* 999-999-999 etc */
 	bbb = cst_strdup(name);
 	for (ss=0,aaa=p=bbb; *p; p++)
@@ -431,7 +578,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
         delete_val(ss);
 	cst_free(bbb);
     }
-    else if (cst_regex_match(cst_rx_digits,name))
+    else if (NAME_MATCHES(m, US_RX_DIGITS))
     {   /* string of digits (use cart to disambiguate) */
 	if (cst_streq("nide",nsw))
 	    r = en_exp_id(name);
@@ -461,7 +608,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 		r = en_exp_number(name);
 	}
     }
-    else if (cst_regex_match(romannums,name))
+    else if (NAME_MATCHES(m, US_RX_ROMANNUMS))
     {   /* Roman numerals */
 	if (cst_streq("",ffeature_string(token,"p.punc")))
 	{   /* no preceeding punc */
@@ -478,7 +625,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	else
 	    r = en_exp_letters(name);
     }
-    else if (cst_regex_match(drst,name))  
+    else if (NAME_MATCHES(m, US_RX_DRST))  
     {   /* St Andrew's St, Dr King Dr */
 	const char *street;
 	const char *saint;
@@ -579,24 +726,24 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	    r = cons_val(string_val(aaa),0);
 	cst_free(aaa);
     }
-    else if (cst_regex_match(cst_rx_double,name))
+    else if (NAME_MATCHES(m, US_RX_DOUBLE))
     {   /* real numbers */
 	r = en_exp_real(name);
     }
-    else if (cst_regex_match(ordinal_number,name))
+    else if (NAME_MATCHES(m, US_RX_ORDINAL_NUMBER))
     {   /* explicit ordinals */
 	aaa = cst_strdup(name);
 	aaa[cst_strlen(name)-2] = '\0';
 	r = en_exp_ordinal(aaa);
 	cst_free(aaa);
     }
-    else if ((cst_regex_match(illion,name)) &&
+    else if ((NAME_MATCHES(m, US_RX_ILLION)) &&
 	     (cst_regex_match(usmoney,ffeature_string(token,"p.name"))))
     {
 	r = cons_val(string_val(name),
 		     cons_val(string_val("dollars"),NULL));
     }
-    else if (cst_regex_match(usmoney,name))
+    else if (NAME_MATCHES(m, US_RX_USMONEY))
     {
 	/* US money */
 /*	printf("money, money, money %s\n", name); */
@@ -662,7 +809,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	cst_free(aaa);
 
     }
-    else if (cst_regex_match(numess,name)) 
+    else if (NAME_MATCHES(m, US_RX_NUMESS)) 
     {   /* 60s and 7s and 9s */
 	aaa = cst_strdup(name);
 	aaa[cst_strlen(name)-1] = '\0';
@@ -709,7 +856,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	}
 	cst_free(bbb);
     }
-    else if ((cst_regex_match(digitsslashdigits,name)) &&
+    else if ((NAME_MATCHES(m, US_RX_DIGITSSLASHDIGITS)) &&
 	     (cst_streq(name,item_name(token))))
     {   /* might be fraction, or not */
 	p=strchr(name,'/');
@@ -760,7 +907,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	cst_free(aaa);
 	cst_free(bbb);
     }
-    else if (cst_regex_match(wandm,name))
+    else if (NAME_MATCHES(m, US_RX_WANDM))
     {   /* weights and measures */
         for (j=cst_strlen(name)-1; j > 0; j--)
             if (cst_strchr("0123456789",name[j]))
@@ -787,7 +934,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 
         cst_free(aaa);
     }
-    else if ((cst_strlen(name) > 1) && (!cst_regex_match(cst_rx_alpha,name)))
+    else if ((cst_strlen(name) > 1) && (!NAME_MATCHES(m, US_RX_ALPHA)))
     {   /* its not just alphas */
 	for (i=0; name[i] != '\0'; i++)
 	    if (text_splitable(name,i))
@@ -806,7 +953,7 @@ static cst_val *us_tokentowords_one(cst_item *token, const char *name)
 	r = s;
     }
     else if ((cst_strlen(name) > 1) && 
-	     (cst_regex_match(cst_rx_alpha,name)) &&
+	     (NAME_MATCHES(m, US_RX_ALPHA)) &&
              (!in_lex(lex,name,NULL,NULL)) &&  // AUP: Added 4th argument (voice feats) as NULL, needs to be revisited later.
 	     (!us_aswd(name)))
         /* Still not quiet right, if there is a user_lex we need to check */
@@ -43,6 +43,7 @@
 #include "cst_val.h"
 #include "cst_hrg.h"
 #include "cst_cart.h"
+#include "cst_synth.h"
 
 cst_val *en_exp_number(const char *numstring);
 cst_val *en_exp_digits(const char *numstring);
@@ -57,6 +58,11 @@ extern const cst_cart us_nums_cart;
 cst_utterance *us_textanalysis(cst_utterance *u);
 cst_val *us_tokentowords(cst_item *token);
 
+/* us_tokentowords() caches expansions of recently seen tokens */
+#define US_TTW_CACHE_SIZE 4096
+void us_tokentowords_cache_clear(void);
+void us_tokentowords_cache_stats(cst_ttw_cache_stats *stats);
+
 int us_aswd(const char *w);
 
 #endif
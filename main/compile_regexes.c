@@ -56,6 +56,42 @@ static void compregex_usage()
     exit(0);
 }
 
+static void print_table(const char *type, const char *name,
+                        const char *suffix, const void *table, int n)
+{
+    int i;
+
+    printf("static const %s %s_%s[] = {\n   ", type, name, suffix);
+    for (i = 0; i < n; i++)
+    {
+        if (cst_streq(type, "short"))
+            printf("%d, ", ((const short *) table)[i]);
+        else if (cst_streq(type, "unsigned int"))
+            printf("%u, ", ((const unsigned int *) table)[i]);
+        else
+            printf("%d, ", ((const unsigned char *) table)[i]);
+        if (i % 16 == 15)
+            printf("\n   ");
+    }
+    printf("\n};\n");
+}
+
+static void regex_dfa_to_C(const char *name, const cst_regex_dfa *dfa)
+{
+    print_table("unsigned char", name, "rxclassmap", dfa->classmap, 256);
+    print_table("short", name, "rxtrans", dfa->trans,
+                dfa->num_states * dfa->num_classes);
+    print_table("unsigned int", name, "rxaccept", dfa->accept,
+                dfa->num_states);
+    print_table("unsigned int", name, "rxaccept_end", dfa->accept_end,
+                dfa->num_states);
+    printf("static const cst_regex_dfa %s_rxdfa = {\n   ", name);
+    printf("%d, %d,\n   ", dfa->num_states, dfa->num_classes);
+    printf("%s_rxclassmap, %s_rxtrans, %s_rxaccept, %s_rxaccept_end\n",
+           name, name, name, name);
+    printf("};\n");
+}
+
 static void regex_to_C(const char *name, const cst_regex *rgx)
 {
     int i;
@@ -68,6 +104,8 @@ static void regex_to_C(const char *name, const cst_regex *rgx)
             printf("\n   ");
     }
     printf("\n};\n");
+    if (rgx->dfa)
+        regex_dfa_to_C(name, rgx->dfa);
     printf("static const cst_regex %s_rx = {\n   ", name);
     printf("%d, ", rgx->regstart);
     printf("%d, ", rgx->reganch);
@@ -78,8 +116,10 @@ static void regex_to_C(const char *name, const cst_regex *rgx)
                (long int) (rgx->regmust - rgx->program));
     printf("%d, ", rgx->regmlen);
     printf("%d,\n   ", rgx->regsize);
-    printf("(char *)%s_rxprog\n", name);
-    printf("};\n");
+    printf("(char *)%s_rxprog", name);
+    if (rgx->dfa)
+        printf(",\n   &%s_rxdfa", name);
+    printf("\n};\n");
 
     printf("const cst_regex * const %s = &%s_rx;\n\n", name, name);
 }
@@ -0,0 +1,551 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*  Benchmark: a fixed corpus through each voice, results as JSON        */
+/*                                                                       */
+/*  For each voice (all the built in ones by default): the time to load  */
+/*  it, the first (cold) synthesis, repeated (warm) synthesis of short   */
+/*  prompts, paragraphs, number heavy text and ssml, the per stage       */
+/*  cst_stats timings, throughput with 1, 2, 4 ... synthesis threads     */
+/*  and the peak RSS.  Each voice runs in a process of its own so load,  */
+/*  cold and RSS numbers don't depend on the voices before it.           */
+/*                                                                       */
+/*  The output is one JSON object, meant to be kept and diffed between   */
+/*  builds.                                                              */
+/*                                                                       */
+/*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#endif
+
+#include "mimic.h"
+
+void mimic_set_lang_list(void);
+
+#if ENABLE_CMU_TIME_AWB
+cst_voice *register_cmu_time_awb(const char *voxdir);
+#endif
+#if ENABLE_CMU_US_AWB
+cst_voice *register_cmu_us_awb(const char *voxdir);
+#endif
+#if ENABLE_CMU_US_KAL
+cst_voice *register_cmu_us_kal(const char *voxdir);
+#endif
+#if ENABLE_CMU_US_KAL16
+cst_voice *register_cmu_us_kal16(const char *voxdir);
+#endif
+#if ENABLE_CMU_US_RMS
+cst_voice *register_cmu_us_rms(const char *voxdir);
+#endif
+#if ENABLE_CMU_US_SLT
+cst_voice *register_cmu_us_slt(const char *voxdir);
+#endif
+#if ENABLE_CMU_US_SLT_HTS
+cst_voice *register_cmu_us_slt_hts(const char *voxdir);
+#endif
+#if ENABLE_VID_GB_AP
+cst_voice *register_vid_gb_ap(const char *voxdir);
+#endif
+
+typedef struct bench_voice_struct {
+    const char *name;
+    const char *type;
+    cst_voice *(*reg) (const char *voxdir);
+} bench_voice;
+
+static const bench_voice bench_voices[] = {
+#if ENABLE_CMU_US_SLT
+    {"slt", "clustergen", register_cmu_us_slt},
+#endif
+#if ENABLE_CMU_US_RMS
+    {"rms", "clustergen", register_cmu_us_rms},
+#endif
+#if ENABLE_CMU_US_AWB
+    {"awb", "clustergen", register_cmu_us_awb},
+#endif
+#if ENABLE_VID_GB_AP
+    {"ap", "clustergen", register_vid_gb_ap},
+#endif
+#if ENABLE_CMU_US_KAL
+    {"kal", "diphone", register_cmu_us_kal},
+#endif
+#if ENABLE_CMU_US_KAL16
+    {"kal16", "diphone", register_cmu_us_kal16},
+#endif
+#if ENABLE_CMU_TIME_AWB
+    {"time_awb", "clunits", register_cmu_time_awb},
+#endif
+#if ENABLE_CMU_US_SLT_HTS
+    {"slt_hts", "hts", register_cmu_us_slt_hts},
+#endif
+    {NULL, NULL, NULL}
+};
+
+/* The corpus.  Change it and the numbers aren't comparable any more, */
+/* so bump BENCH_CORPUS_VERSION when it does                          */
+#define BENCH_CORPUS_VERSION 1
+
+static const char *const corpus_short[] = {
+    "Hello.",
+    "Yes, please.",
+    "Your call is important to us.",
+    "The next train leaves from platform four.",
+    "Turn left in two hundred meters.",
+    "Battery low.",
+    "I didn't catch that, could you say it again?",
+    "Goodbye!",
+    NULL
+};
+
+static const char *const corpus_paragraph[] = {
+    "Alice was beginning to get very tired of sitting by her sister on "
+    "the bank, and of having nothing to do: once or twice she had peeped "
+    "into the book her sister was reading, but it had no pictures or "
+    "conversations in it, and what is the use of a book, thought Alice, "
+    "without pictures or conversations? So she was considering in her "
+    "own mind, as well as she could, for the hot day made her feel very "
+    "sleepy and stupid, whether the pleasure of making a daisy-chain "
+    "would be worth the trouble of getting up and picking the daisies, "
+    "when suddenly a White Rabbit with pink eyes ran close by her.",
+    "There was nothing so very remarkable in that; nor did Alice think "
+    "it so very much out of the way to hear the Rabbit say to itself, "
+    "\"Oh dear! Oh dear! I shall be late!\" But when the Rabbit actually "
+    "took a watch out of its waistcoat-pocket, and looked at it, and then "
+    "hurried on, Alice started to her feet.",
+    NULL
+};
+
+static const char *const corpus_numbers[] = {
+    "On 12/03/2024 at 10:45 the account was charged $1,234.56, "
+    "leaving a balance of $78,901.23.",
+    "Call 555-0123 or 1-800-555-0199 before 5:30pm on Friday the 13th.",
+    "The 3rd quarter grew 4.7% to 2,048,576 units, up from 1,999,999 "
+    "in Q2 of 1999.",
+    "Flight BA2490 departs gate 17B at 06:15 and lands at 09:40, "
+    "a distance of 1,203 km.",
+    NULL
+};
+
+static const char *const corpus_ssml[] = {
+    "<speak>Welcome back. <break size=\"2\"/> You have "
+    "<prosody rate=\"slow\">three</prosody> new messages. "
+    "<sub alias=\"World Wide Web Consortium\">W3C</sub> says hello. "
+    "<prosody volume=\"60\" pitch=\"140\">This part is quieter.</prosody>"
+    "</speak>",
+    "<speak><prosody rate=\"fast\">Terms and conditions apply, see the "
+    "website for details.</prosody> <break/> Say "
+    "<phoneme ph=\"t ax m ey t ow\">tomato</phoneme> once more.</speak>",
+    NULL
+};
+
+typedef struct bench_corpus_struct {
+    const char *name;
+    const char *const *texts;
+    int ssml;
+} bench_corpus;
+
+static const bench_corpus bench_corpora[] = {
+    {"short", corpus_short, FALSE},
+    {"paragraph", corpus_paragraph, FALSE},
+    {"numbers", corpus_numbers, FALSE},
+    {"ssml", corpus_ssml, TRUE},
+    {NULL, NULL, FALSE}
+};
+
+typedef struct bench_options_struct {
+    const char *voicedir;
+    int iterations;
+    int threads[16];
+    int num_threads;
+    int scaling_copies;         /* times the scaling text is repeated */
+    cst_features *feats;        /* -s F=V, set on each voice */
+} bench_options;
+
+static double now(void)
+{
+    return cst_stats_now();
+}
+
+static long peak_rss_kb(void)
+{
+#ifndef _WIN32
+    struct rusage ru;
+
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+        return ru.ru_maxrss;    /* kilobytes on Linux, bytes on macOS */
+#endif
+    return -1;
+}
+
+static int num_cpus(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+    return sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    return 1;
+#endif
+}
+
+static int synth_text(cst_voice *v, const char *text, int ssml,
+                      float *audio)
+{
+    float dur = 0.0;
+    int err;
+
+    srand(1);                   /* the same noise each run */
+    if (ssml)
+        err = mimic_ssml_text_to_speech(text, v, "none", &dur);
+    else
+        err = mimic_text_to_speech(text, v, "none", &dur);
+    *audio += dur;
+    return err;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x < y) ? -1 : (x > y) ? 1 : 0;
+}
+
+static void bench_corpus_run(cst_voice *v, const bench_corpus *c,
+                             const bench_options *o, FILE *out)
+{
+    /* Each iteration says the whole of c, the median is reported */
+    double *times, start;
+    float audio = 0.0;
+    int i, t, errors = 0, chars = 0;
+
+    times = cst_alloc(double, o->iterations);
+    for (t = 0; c->texts[t]; t++)
+        chars += cst_strlen(c->texts[t]);
+    for (i = 0; i < o->iterations; i++)
+    {
+        audio = 0.0;
+        start = now();
+        for (t = 0; c->texts[t]; t++)
+            if (synth_text(v, c->texts[t], c->ssml, &audio) != 0)
+                errors++;
+        times[i] = now() - start;
+    }
+    qsort(times, o->iterations, sizeof(double), cmp_double);
+
+    fprintf(out, "\"%s\":{\"texts\":%d,\"chars\":%d,\"audio_seconds\":%.3f,"
+            "\"seconds_median\":%.6f,\"seconds_min\":%.6f,"
+            "\"seconds_max\":%.6f,\"xrt\":%.2f,\"errors\":%d}",
+            c->name, t, chars, audio, times[o->iterations / 2], times[0],
+            times[o->iterations - 1],
+            (times[o->iterations / 2] > 0.0) ?
+            audio / times[o->iterations / 2] : 0.0, errors);
+    cst_free(times);
+}
+
+static void bench_scaling(cst_voice *v, const bench_options *o, FILE *out)
+{
+    /* The paragraphs and numbers, repeated, as one document through */
+    /* the synthesis pipeline with more and more threads             */
+    cst_tokenstream *ts;
+    char *text;
+    double start, secs;
+    float audio;
+    int i, n, len;
+
+    for (len = 0, n = 0; corpus_paragraph[n]; n++)
+        len += cst_strlen(corpus_paragraph[n]) + 1;
+    for (n = 0; corpus_numbers[n]; n++)
+        len += cst_strlen(corpus_numbers[n]) + 1;
+    text = cst_alloc(char, (len * o->scaling_copies) + 1);
+    for (i = 0; i < o->scaling_copies; i++)
+    {
+        for (n = 0; corpus_paragraph[n]; n++)
+            strcat(strcat(text, corpus_paragraph[n]), "\n");
+        for (n = 0; corpus_numbers[n]; n++)
+            strcat(strcat(text, corpus_numbers[n]), "\n");
+    }
+
+    fprintf(out, "\"scaling\":[");
+    for (i = 0; i < o->num_threads; i++)
+    {
+        feat_set_int(v->features, "synth_threads", o->threads[i]);
+        ts = ts_open_string(text,
+                            get_param_string(v->features, "text_whitespace",
+                                             NULL),
+                            get_param_string(v->features,
+                                             "text_singlecharsymbols", NULL),
+                            get_param_string(v->features,
+                                             "text_prepunctuation", NULL),
+                            get_param_string(v->features,
+                                             "text_postpunctuation", NULL),
+                            get_param_int(v->features,
+                                          "text_emoji_as_singlecharsymbols",
+                                          0));
+        audio = 0.0;
+        srand(1);
+        start = now();
+        mimic_ts_to_speech(ts, v, "none", &audio);  /* closes ts */
+        secs = now() - start;
+        fprintf(out, "%s{\"threads\":%d,\"seconds\":%.6f,"
+                "\"audio_seconds\":%.3f,\"xrt\":%.2f}",
+                i ? "," : "", o->threads[i], secs, audio,
+                (secs > 0.0) ? audio / secs : 0.0);
+    }
+    fprintf(out, "]");
+    feat_remove(v->features, "synth_threads");
+    cst_free(text);
+}
+
+static void bench_voice_run(const char *name, const char *type,
+                            const bench_voice *bv, const bench_options *o,
+                            FILE *out)
+{
+    cst_voice *v;
+    double start, load;
+    float audio = 0.0;
+    int i;
+
+    start = now();
+    if (bv)
+        v = (*bv->reg) (o->voicedir);
+    else
+        v = mimic_voice_load(name);
+    load = now() - start;
+
+    fprintf(out, "{\"name\":\"%s\",\"type\":\"%s\",", name, type);
+    if (v == NULL)
+    {
+        fprintf(out, "\"error\":\"failed to load\"}");
+        return;
+    }
+    feat_copy_into(o->feats, v->features);
+    fprintf(out, "\"load_seconds\":%.6f,", load);
+
+    /* Cold: the first synthesis, with whatever is loaded on demand */
+    start = now();
+    synth_text(v, corpus_short[0], FALSE, &audio);
+    fprintf(out, "\"cold\":{\"seconds\":%.6f,\"audio_seconds\":%.3f},",
+            now() - start, audio);
+
+    /* Warm, with the stages timed */
+    cst_stats_reset();
+    cst_stats_enable(TRUE);
+    fprintf(out, "\"corpus\":{");
+    for (i = 0; bench_corpora[i].name; i++)
+    {
+        fprintf(out, "%s", i ? "," : "");
+        bench_corpus_run(v, &bench_corpora[i], o, out);
+    }
+    fprintf(out, "},\"stats\":");
+    cst_stats_dump_json(out);
+    cst_stats_enable(FALSE);
+    fprintf(out, ",");
+
+    bench_scaling(v, o, out);
+    fprintf(out, ",\"peak_rss_kb\":%ld}", peak_rss_kb());
+}
+
+static void bench_one_voice(const char *name, const bench_options *o, FILE *out)
+{
+    const bench_voice *bv = NULL;
+    const char *type = "clustergen";    /* voice files are cg */
+    int i;
+#ifndef _WIN32
+    pid_t pid = -1;
+    int status;
+    FILE *tmp;
+    char buf[4096];
+    size_t n;
+#endif
+
+    for (i = 0; bench_voices[i].name; i++)
+        if (cst_streq(name, bench_voices[i].name))
+        {
+            bv = &bench_voices[i];
+            type = bv->type;
+        }
+
+#ifndef _WIN32
+    /* The child writes to a temporary file, copied out only if it */
+    /* finishes, so one that dies part way leaves no partial JSON   */
+    fflush(out);
+    if ((tmp = tmpfile()) != NULL && (pid = fork()) == 0)
+    {
+        bench_voice_run(name, type, bv, o, tmp);
+        _exit((fflush(tmp) == 0 && !ferror(tmp)) ? 0 : 1);
+    }
+    if ((pid < 0) || (waitpid(pid, &status, 0) != pid) ||
+        !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        fprintf(out, "{\"name\":\"%s\",\"type\":\"%s\","
+                "\"error\":\"benchmark process failed\"}", name, type);
+    else
+    {
+        rewind(tmp);
+        while ((n = fread(buf, 1, sizeof(buf), tmp)) > 0)
+            fwrite(buf, 1, n, out);
+    }
+    if (tmp)
+        fclose(tmp);
+#else
+    bench_voice_run(name, type, bv, o, out);
+#endif
+}
+
+static void bench_usage(void)
+{
+    int i;
+
+    printf("mimic_bench: time voices over a fixed corpus, JSON out\n"
+           "usage: mimic_bench [options]\n"
+           "  -voice NAME   Benchmark NAME (repeatable), a built in voice\n"
+           "                or a .flitevox file, default all built in ones\n"
+           "  -voicedir DIR Directory for voice data\n"
+           "  -iter N       Warm runs over the corpus (default 5)\n"
+           "  -threads N,.. Thread counts for scaling (default 1,2,4..CPUs)\n"
+           "  -copies N     Scaling document is the corpus N times (default 4)\n"
+           "  -s F=V        Set voice feature F to string V\n"
+           "  -o FILE       Write the results to FILE (default stdout)\n"
+           "Built in voices:");
+    for (i = 0; bench_voices[i].name; i++)
+        printf(" %s", bench_voices[i].name);
+    printf("\n");
+    exit(0);
+}
+
+int main(int argc, char **argv)
+{
+    bench_options o;
+    const char *voices[64];
+    int num_voices = 0;
+    const char *outfile = NULL;
+    FILE *out = stdout;
+    char *fv, *eq;
+    const char *p;
+    int i, n;
+
+    memset(&o, 0, sizeof(o));
+    o.iterations = 5;
+    o.scaling_copies = 4;
+    o.feats = new_features();
+
+    mimic_init();
+    mimic_set_lang_list();
+
+    for (i = 1; i < argc; i++)
+    {
+        if (cst_streq(argv[i], "-h") || cst_streq(argv[i], "--help"))
+            bench_usage();
+        else if (cst_streq(argv[i], "-voice") && (i + 1 < argc) &&
+                 (num_voices < 64))
+            voices[num_voices++] = argv[++i];
+        else if (cst_streq(argv[i], "-voicedir") && (i + 1 < argc))
+            o.voicedir = argv[++i];
+        else if (cst_streq(argv[i], "-iter") && (i + 1 < argc))
+            o.iterations = atoi(argv[++i]);
+        else if (cst_streq(argv[i], "-copies") && (i + 1 < argc))
+            o.scaling_copies = atoi(argv[++i]);
+        else if (cst_streq(argv[i], "-threads") && (i + 1 < argc))
+        {
+            for (p = argv[++i]; *p && o.num_threads < 16; p++)
+            {
+                if ((n = atoi(p)) > 0)
+                    o.threads[o.num_threads++] = n;
+                while (p[1] && p[1] != ',')
+                    p++;
+                if (p[1] == ',')
+                    p++;
+            }
+        }
+        else if (cst_streq(argv[i], "-s") && (i + 1 < argc))
+        {
+            /* types guessed as mimic's -s does */
+            fv = cst_strdup(argv[++i]);
+            if ((eq = strchr(fv, '=')) != NULL)
+            {
+                *eq++ = '\0';
+                p = feat_own_string(o.feats, fv);
+                if (cst_regex_match(cst_rx_int, eq))
+                    feat_set_int(o.feats, p, atoi(eq));
+                else if (cst_regex_match(cst_rx_double, eq))
+                    feat_set_float(o.feats, p, atof(eq));
+                else
+                    feat_set_string(o.feats, p, eq);
+            }
+            cst_free(fv);
+        }
+        else if (cst_streq(argv[i], "-o") && (i + 1 < argc))
+            outfile = argv[++i];
+        else
+        {
+            fprintf(stderr, "mimic_bench: unknown option \"%s\"\n", argv[i]);
+            return 1;
+        }
+    }
+    if (o.iterations < 1)
+        o.iterations = 1;
+    if (o.scaling_copies < 1)
+        o.scaling_copies = 1;
+    if (o.num_threads == 0)
+        for (n = 1; (n <= num_cpus()) && (o.num_threads < 16); n *= 2)
+            o.threads[o.num_threads++] = n;
+    if (num_voices == 0)
+        for (n = 0; bench_voices[n].name && num_voices < 64; n++)
+            voices[num_voices++] = bench_voices[n].name;
+    if (outfile && (out = fopen(outfile, "w")) == NULL)
+    {
+        fprintf(stderr, "mimic_bench: can't write \"%s\"\n", outfile);
+        return 1;
+    }
+
+    fprintf(out, "{\"mimic_bench\":%d,\"version\":\"%s\",\"cpus\":%d,"
+            "\"iterations\":%d,\"voices\":[\n",
+            BENCH_CORPUS_VERSION, PACKAGE_VERSION, num_cpus(),
+            o.iterations);
+    for (i = 0; i < num_voices; i++)
+    {
+        fprintf(out, "%s", i ? ",\n" : "");
+        bench_one_voice(voices[i], &o, out);
+    }
+    fprintf(out, "\n]}\n");
+
+    if (out != stdout)
+        fclose(out);
+    delete_features(o.feats);
+    mimic_exit();
+    return 0;
+}
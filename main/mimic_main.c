@@ -49,6 +49,7 @@
 #endif
 
 #include "mimic.h"
+#include "cst_cg.h"
 
 cst_val *mimic_set_voice_list(const char *voxdir);
 void *mimic_set_lang_list(void);
@@ -107,6 +108,8 @@ static void mimic_usage()
            "  --seti F=V  Set int feature\n"
            "  --setf F=V  Set float feature\n"
            "  --sets F=V  Set string feature\n"
+           "  -encoding ENC Write WAVEFILE headerless as ulaw, alaw or g721\n"
+           "              at 8kHz (same as --sets output_encoding=ENC)\n"
            "  -ssml       Read input text/file in ssml mode\n"
            "  -b          Benchmark mode\n"
            "  -l          Loop endlessly\n"
@@ -114,6 +117,21 @@ static void mimic_usage()
            "  -voicedir NAME Directory contain voice data\n"
            "  -lv         List voices available\n"
            "  -add_lex FILENAME add lex addenda from FILENAME\n"
+           "  -wavecache DIR Cache synthesized prompts in memory and in DIR\n"
+           "              (\"-\" for memory only)\n"
+           "  -wavecache_warmup FILENAME Synthesize the prompts in FILENAME,\n"
+           "              one per line, into the cache first\n"
+           "  -phrasecache Reuse the parameters of repeated phrases\n"
+           "              (clustergen voices)\n"
+           "  -alignments FORMAT Write phone timings only, no audio, as\n"
+           "              json or bin: one record per line of each TEXTFILE\n"
+           "              into TEXTFILE.align.json (or .align); -t TEXT goes\n"
+           "              to stdout or the -o file\n"
+           "  -threads N  Synthesis threads for files and ssml, utterances\n"
+           "              are synthesized in parallel and output in order\n"
+           "              (default 1, or one per CPU for -alignments)\n"
+           "  -stats FILE Time each synthesis stage, write the stats as JSON\n"
+           "              to FILE (\"-\" for stdout) at the end\n"
            "  -pw         Print words\n"
            "  -ps         Print segments\n"
            "  -psdur      Print segments and their durations (end-time)\n"
@@ -204,6 +222,74 @@ static void ef_set(cst_features *f, const char *fv, const char *type)
     }
 }
 
+static void mimic_stats_dump(const char *filename)
+{
+    cst_file fd;
+
+    if (cst_streq(filename, "-"))
+        fd = stdout;
+    else if ((fd = cst_fopen(filename, CST_OPEN_WRITE)) == NULL)
+    {
+        fprintf(stderr, "failed to open \"%s\" for writing\n", filename);
+        return;
+    }
+    cst_stats_dump_json(fd);
+    if (fd != stdout)
+        cst_fclose(fd);
+}
+
+/* -alignments: a single -t text to stdout (or the -o file), otherwise */
+/* each input file to its own output file, a file per thread at a time */
+static int mimic_align_main(cst_voice *v, int format, int num_threads,
+                            const char *text, const char *outfile,
+                            const char **files, int num_files)
+{
+    cst_utterance *u;
+    cst_file fd;
+    int err;
+
+    if (text)
+    {
+        if (outfile && !cst_streq(outfile, "play"))
+            fd = cst_fopen(outfile, CST_OPEN_WRITE | CST_OPEN_BINARY);
+        else
+            fd = stdout;
+        if (fd == NULL)
+        {
+            fprintf(stderr, "failed to open \"%s\" for writing\n", outfile);
+            return 1;
+        }
+        err = 1;
+        if ((u = mimic_text_to_alignment(text, v)) != NULL)
+        {
+            if (mimic_alignment_write_header(fd, format) == 0 &&
+                mimic_alignment_write(fd, u, format, 1) == 0)
+                err = 0;
+            delete_utterance(u);
+        }
+        if (fd != stdout)
+            cst_fclose(fd);
+        return err;
+    }
+
+    if (num_files == 0)
+    {
+        fprintf(stderr, "-alignments needs input files or -t TEXT\n");
+        return 1;
+    }
+    if (num_threads <= 0)
+    {
+#ifdef _SC_NPROCESSORS_ONLN
+        num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (num_threads <= 0)
+            num_threads = 1;
+    }
+
+    return (mimic_files_to_alignments(files, num_files, v, format,
+                                      num_threads) == 0) ? 0 : 1;
+}
+
 int main(int argc, char **argv)
 {
     struct timeval tv;
@@ -223,7 +309,17 @@ int main(int argc, char **argv)
     cst_features *extra_feats;
     const char *lex_addenda_file = NULL;
     const char *voicedumpfile = NULL;
+    const char *wave_cache_dir = NULL;
+    const char *wave_cache_warmup = NULL;
+    cst_wave_cache *wave_cache = NULL;
+    int phrase_cache = 0;
+    cst_cg_param_cache *cg_param_cache = NULL;
     cst_audio_streaming_info *asi;
+    int align_format = -1;
+    int synth_threads = 0;
+    const char **align_files;
+    const char *stats_file = NULL;
+    int num_align_files = 0;
 
     // Set signal handler to shutdown any playing audio on SIGINT
 #ifdef _WIN32
@@ -239,6 +335,7 @@ int main(int argc, char **argv)
     explicit_text = explicit_filename = explicit_phones = FALSE;
     ssml_mode = FALSE;
     extra_feats = new_features();
+    align_files = cst_alloc(const char *, argc);
 
     mimic_init();
     mimic_set_lang_list();      /* defined at compilation time */
@@ -293,8 +390,43 @@ int main(int argc, char **argv)
             lex_addenda_file = argv[i + 1];
             i++;
         }
+        else if ((cst_streq(argv[i], "-wavecache")) && (i + 1 < argc))
+        {
+            wave_cache_dir = argv[i + 1];
+            i++;
+        }
+        else if ((cst_streq(argv[i], "-wavecache_warmup")) && (i + 1 < argc))
+        {
+            wave_cache_warmup = argv[i + 1];
+            i++;
+        }
+        else if (cst_streq(argv[i], "-phrasecache"))
+            phrase_cache = 1;
+        else if (cst_streq(argv[i], "-alignments") && (i + 1 < argc))
+        {
+            if ((align_format = mimic_alignment_format(argv[i + 1])) < 0)
+            {
+                fprintf(stderr, "unknown alignment format \"%s\"\n",
+                        argv[i + 1]);
+                return 1;
+            }
+            i++;
+        }
+        else if (cst_streq(argv[i], "-stats") && (i + 1 < argc))
+        {
+            stats_file = argv[i + 1];
+            cst_stats_enable(TRUE);
+            i++;
+        }
+        else if (cst_streq(argv[i], "-threads") && (i + 1 < argc))
+        {
+            synth_threads = atoi(argv[i + 1]);
+            feat_set_int(extra_feats, "synth_threads", synth_threads);
+            i++;
+        }
         else if (cst_streq(argv[i], "-f") && (i + 1 < argc))
         {
+            align_files[num_align_files++] = argv[i + 1];
             filename = argv[i + 1];
             explicit_filename = TRUE;
             i++;
@@ -357,6 +489,11 @@ int main(int argc, char **argv)
             ef_set(extra_feats, argv[i + 1], "string");
             i++;
         }
+        else if (cst_streq(argv[i], "-encoding") && (i + 1 < argc))
+        {
+            feat_set_string(extra_feats, "output_encoding", argv[i + 1]);
+            i++;
+        }
         else if (cst_streq(argv[i], "-p") && (i + 1 < argc))
         {
             filename = argv[i + 1];
@@ -369,10 +506,15 @@ int main(int argc, char **argv)
             explicit_text = TRUE;
             i++;
         }
-        else if (filename)
-            outtype = argv[i];
         else
-            filename = argv[i];
+        {
+            /* With -alignments every plain argument is an input file */
+            align_files[num_align_files++] = argv[i];
+            if (filename)
+                outtype = argv[i];
+            else
+                filename = argv[i];
+        }
     }
 
     if (filename == NULL)
@@ -400,6 +542,44 @@ int main(int argc, char **argv)
     if (lex_addenda_file)
         mimic_voice_add_lex_addenda(v, lex_addenda_file);
 
+    if (align_format >= 0)
+    {
+        err = mimic_align_main(v, align_format, synth_threads,
+                               explicit_text ? filename : NULL,
+                               explicit_text ? outtype : NULL,
+                               align_files, num_align_files);
+        if (stats_file)
+            mimic_stats_dump(stats_file);
+        cst_free(align_files);
+        delete_features(extra_feats);
+        delete_val(mimic_voice_list);
+        mimic_voice_list = 0;
+        mimic_exit();
+        return err;
+    }
+    cst_free(align_files);
+
+    /* Alignments make no parameters, so only synthesis gets the cache */
+    if (phrase_cache)
+    {
+        cg_param_cache = new_cg_param_cache(CST_CG_PARAM_CACHE_DEFAULT);
+        feat_set(v->features, "cg_param_cache",
+                 cg_param_cache_val(cg_param_cache));
+    }
+
+    if (wave_cache_dir || wave_cache_warmup)
+    {
+        wave_cache = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM,
+                                    (wave_cache_dir &&
+                                     !cst_streq(wave_cache_dir, "-")) ?
+                                    wave_cache_dir : NULL,
+                                    CST_WAVE_CACHE_DEFAULT_DISK);
+        feat_set(v->features, "wave_cache", wave_cache_val(wave_cache));
+        if (wave_cache_warmup &&
+            mimic_wave_cache_warmup(v, wave_cache_warmup) < 0)
+            return 1;
+    }
+
     if (cst_streq("stream", outtype))
     {
         asi = new_audio_streaming_info();
@@ -449,7 +629,20 @@ int main(int argc, char **argv)
 			&& err == 0)
         goto loop;
 
+    if (stats_file)
+        mimic_stats_dump(stats_file);
+
     delete_features(extra_feats);
+    if (wave_cache)
+    {
+        feat_remove(v->features, "wave_cache");
+        delete_wave_cache(wave_cache);
+    }
+    if (cg_param_cache)
+    {
+        feat_remove(v->features, "cg_param_cache");
+        delete_cg_param_cache(cg_param_cache);
+    }
     delete_val(mimic_voice_list);
     mimic_voice_list = 0;
     /*    cst_alloc_debug_summary(); */
@@ -0,0 +1,401 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*  Buffered audio player                                                */
+/*                                                                       */
+/*  Synthesis writes into a single-producer/single-consumer ring and a   */
+/*  dedicated thread feeds the audio device.  The ring indices are       */
+/*  atomics so the data path never takes a lock, the mutex/condvar is    */
+/*  only used to sleep when one side has to wait for the other.          */
+/*                                                                       */
+/*  Without pthreads the player degrades to direct synchronous writes.   */
+/*                                                                       */
+/*************************************************************************/
+
+#include "cst_string.h"
+#include "cst_wave.h"
+#include "cst_audio.h"
+
+#if defined(HAVE_PTHREAD_H) && !defined(__STDC_NO_ATOMICS__)
+#define CST_AUDIO_PLAYER_THREADS
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+extern volatile int shutdown_request;
+
+/* Largest single write to the device, in frames */
+#define CST_AUDIO_PLAYER_PERIOD 1024
+
+struct cst_audio_player_struct {
+    cst_audiodev *ad;
+    int sps;
+    int frame_bytes;            /* bytes in one frame of all channels */
+
+    cst_audio_watermark_callback watermark_cb;
+    void *userdata;
+    size_t low_watermark;       /* in bytes */
+    size_t high_watermark;
+
+    long frames_written;
+    int writer_waits;
+
+    /* ring is NULL when playing synchronously */
+    unsigned char *ring;
+#ifdef CST_AUDIO_PLAYER_THREADS
+    size_t size;                /* whole periods, in bytes */
+    size_t period_bytes;
+    size_t head_off;            /* where head is in ring, writer only */
+    size_t start_level;         /* prefill before playback (re)starts */
+    atomic_size_t head;         /* only moved by the writer */
+    atomic_size_t tail;         /* only moved by the playback thread */
+    atomic_int draining;        /* writer has no more data for now */
+    atomic_int stopping;
+    atomic_int idle;            /* playback thread has run dry */
+    atomic_int waiting;         /* threads sleeping on cond */
+    atomic_int underruns;
+    atomic_long frames_played;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+#endif
+};
+
+#ifdef CST_AUDIO_PLAYER_THREADS
+
+static size_t player_fill(cst_audio_player *ap)
+{
+    return atomic_load(&ap->head) - atomic_load(&ap->tail);
+}
+
+static int player_has_space(cst_audio_player *ap)
+{
+    return player_fill(ap) < ap->size;
+}
+
+static int player_has_data(cst_audio_player *ap)
+{
+    return player_fill(ap) > 0 || atomic_load(&ap->stopping);
+}
+
+static int player_primed(cst_audio_player *ap)
+{
+    return player_fill(ap) >= ap->start_level ||
+        atomic_load(&ap->draining) || atomic_load(&ap->stopping);
+}
+
+static int player_is_idle(cst_audio_player *ap)
+{
+    return player_fill(ap) == 0 && atomic_load(&ap->idle);
+}
+
+static void player_wake(cst_audio_player *ap)
+{
+    /* Only take the lock when the other side actually sleeps */
+    if (atomic_load(&ap->waiting))
+    {
+        pthread_mutex_lock(&ap->lock);
+        pthread_cond_broadcast(&ap->cond);
+        pthread_mutex_unlock(&ap->lock);
+    }
+}
+
+static void player_wait(cst_audio_player *ap,
+                        int (*ready) (cst_audio_player *ap))
+{
+    /* We announce ourselves before checking ready() under the lock so a */
+    /* wake up between the check and the wait can't be lost              */
+    pthread_mutex_lock(&ap->lock);
+    atomic_fetch_add(&ap->waiting, 1);
+    while (!ready(ap))
+        pthread_cond_wait(&ap->cond, &ap->lock);
+    atomic_fetch_sub(&ap->waiting, 1);
+    pthread_mutex_unlock(&ap->lock);
+}
+
+static void *player_thread(void *arg)
+{
+    cst_audio_player *ap = (cst_audio_player *) arg;
+    size_t tail, fill, n;
+    size_t off = 0;             /* where tail is in ring */
+    int playing = 0;
+    int below_low = 0;
+
+    while (1)
+    {
+        fill = player_fill(ap);
+        if (fill == 0)
+        {
+            if (atomic_load(&ap->stopping))
+                break;
+            if (playing && !atomic_load(&ap->draining))
+            {
+                atomic_fetch_add(&ap->underruns, 1);
+                if (ap->watermark_cb)
+                    (*ap->watermark_cb) (ap, CST_AUDIO_UNDERRUN, 0,
+                                         ap->userdata);
+            }
+            playing = 0;
+            atomic_store(&ap->idle, 1);
+            player_wake(ap);    /* a drain may be waiting for this */
+            player_wait(ap, player_has_data);
+            continue;
+        }
+        atomic_store(&ap->idle, 0);
+        if (!playing && !player_primed(ap))
+        {
+            /* Prefill so ordinary synthesis jitter doesn't underrun */
+            player_wait(ap, player_primed);
+            continue;
+        }
+        playing = 1;
+
+        tail = atomic_load(&ap->tail);
+        n = fill;
+        if (n > ap->period_bytes)
+            n = ap->period_bytes;
+        if (n > ap->size - off)
+            n = ap->size - off;
+
+        /* On shutdown we keep consuming so the writer can't block */
+        if (!shutdown_request)
+            mimic_audio_write(ap->ad, ap->ring + off, (int) n);
+
+        atomic_store(&ap->tail, tail + n);
+        off += n;
+        if (off == ap->size)
+            off = 0;
+        atomic_fetch_add(&ap->frames_played, (long) (n / ap->frame_bytes));
+        player_wake(ap);
+
+        fill -= n;
+        if (ap->watermark_cb && fill <= ap->low_watermark && !below_low)
+            (*ap->watermark_cb) (ap, CST_AUDIO_WATERMARK_LOW,
+                                 (int) (fill / ap->frame_bytes),
+                                 ap->userdata);
+        below_low = (fill <= ap->low_watermark);
+    }
+
+    return NULL;
+}
+
+static int player_start(cst_audio_player *ap, int latency_ms)
+{
+    size_t want;
+
+    ap->period_bytes = CST_AUDIO_PLAYER_PERIOD * ap->frame_bytes;
+    want = (size_t) ap->sps * latency_ms / 1000 * ap->frame_bytes;
+    if (want < 2 * ap->period_bytes)
+        want = 2 * ap->period_bytes;
+    /* A frame may not be a power of two bytes, so the ring can't be */
+    /* either; being whole periods means reads and writes never split */
+    /* a frame at the wrap                                            */
+    for (ap->size = ap->period_bytes; ap->size < want; ap->size *= 2);
+    ap->head_off = 0;
+    ap->start_level = want / 2;
+    ap->low_watermark = 0;
+    ap->high_watermark = ap->size;
+
+    atomic_init(&ap->head, 0);
+    atomic_init(&ap->tail, 0);
+    atomic_init(&ap->draining, 0);
+    atomic_init(&ap->stopping, 0);
+    atomic_init(&ap->idle, 1);
+    atomic_init(&ap->waiting, 0);
+    atomic_init(&ap->underruns, 0);
+    atomic_init(&ap->frames_played, 0);
+
+    ap->ring = cst_alloc(unsigned char, ap->size);
+    pthread_mutex_init(&ap->lock, NULL);
+    pthread_cond_init(&ap->cond, NULL);
+    if (pthread_create(&ap->thread, NULL, player_thread, ap) != 0)
+    {
+        pthread_cond_destroy(&ap->cond);
+        pthread_mutex_destroy(&ap->lock);
+        cst_free(ap->ring);
+        ap->ring = NULL;
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+cst_audio_player *mimic_audio_player_open(int sps, int channels,
+                                          cst_audiofmt fmt, int latency_ms)
+{
+    cst_audio_player *ap;
+    cst_audiodev *ad;
+
+    if ((ad = mimic_audio_open(sps, channels, fmt)) == NULL)
+        return NULL;
+
+    ap = cst_alloc(cst_audio_player, 1);
+    ap->ad = ad;
+    ap->sps = sps;
+    ap->frame_bytes = mimic_audio_bps(fmt) * channels;
+    if (latency_ms <= 0)
+        latency_ms = CST_AUDIO_PLAYER_DEFAULT_LATENCY;
+
+#ifdef CST_AUDIO_PLAYER_THREADS
+    if (player_start(ap, latency_ms) != 0)
+        cst_errmsg("mimic_audio_player_open: can't start playback thread, "
+                   "playing synchronously\n");
+#endif
+
+    return ap;
+}
+
+int mimic_audio_player_write(cst_audio_player *ap, const void *buff,
+                             int num_bytes)
+{
+    /* num_bytes should be a whole number of frames */
+#ifdef CST_AUDIO_PLAYER_THREADS
+    const unsigned char *p = (const unsigned char *) buff;
+    size_t left, head, off, n, fill;
+#endif
+
+    if (num_bytes <= 0)
+        return 0;
+    ap->frames_written += num_bytes / ap->frame_bytes;
+
+    if (ap->ring == NULL)
+        return mimic_audio_write(ap->ad, (void *) buff, num_bytes);
+
+#ifdef CST_AUDIO_PLAYER_THREADS
+    for (left = num_bytes; left > 0; )
+    {
+        fill = player_fill(ap);
+        if (fill == ap->size)
+        {
+            ap->writer_waits++;
+            player_wait(ap, player_has_space);
+            continue;
+        }
+        head = atomic_load(&ap->head);
+        off = ap->head_off;
+        n = ap->size - fill;
+        if (n > left)
+            n = left;
+        if (n > ap->size - off)
+            n = ap->size - off;
+        memmove(ap->ring + off, p, n);
+        atomic_store(&ap->head, head + n);
+        ap->head_off = (off + n == ap->size) ? 0 : off + n;
+        player_wake(ap);
+
+        p += n;
+        left -= n;
+        if (ap->watermark_cb && fill < ap->high_watermark &&
+            fill + n >= ap->high_watermark)
+            (*ap->watermark_cb) (ap, CST_AUDIO_WATERMARK_HIGH,
+                                 (int) ((fill + n) / ap->frame_bytes),
+                                 ap->userdata);
+    }
+#endif
+
+    return num_bytes;
+}
+
+int mimic_audio_player_drain(cst_audio_player *ap)
+{
+#ifdef CST_AUDIO_PLAYER_THREADS
+    if (ap->ring)
+    {
+        /* Lets the thread play out a partial prefill and not count the */
+        /* end of the data as an underrun                               */
+        atomic_store(&ap->draining, 1);
+        player_wake(ap);
+        player_wait(ap, player_is_idle);
+        atomic_store(&ap->draining, 0);
+    }
+#endif
+    return mimic_audio_flush(ap->ad);
+}
+
+int mimic_audio_player_close(cst_audio_player *ap)
+{
+    int rv;
+
+    if (ap == NULL)
+        return 0;
+
+    mimic_audio_player_drain(ap);
+#ifdef CST_AUDIO_PLAYER_THREADS
+    if (ap->ring)
+    {
+        atomic_store(&ap->stopping, 1);
+        player_wake(ap);
+        pthread_join(ap->thread, NULL);
+        pthread_cond_destroy(&ap->cond);
+        pthread_mutex_destroy(&ap->lock);
+        cst_free(ap->ring);
+    }
+#endif
+    rv = mimic_audio_close(ap->ad);
+    cst_free(ap);
+
+    return rv;
+}
+
+void mimic_audio_player_set_watermarks(cst_audio_player *ap,
+                                       int low_ms, int high_ms,
+                                       cst_audio_watermark_callback cb,
+                                       void *userdata)
+{
+    /* Set before writing, the playback thread reads these unlocked */
+    ap->watermark_cb = cb;
+    ap->userdata = userdata;
+    ap->low_watermark = (size_t) ap->sps * low_ms / 1000 * ap->frame_bytes;
+    ap->high_watermark = (size_t) ap->sps * high_ms / 1000 * ap->frame_bytes;
+}
+
+void mimic_audio_player_get_stats(cst_audio_player *ap,
+                                  cst_audio_player_stats *stats)
+{
+    stats->frames_written = ap->frames_written;
+    stats->writer_waits = ap->writer_waits;
+#ifdef CST_AUDIO_PLAYER_THREADS
+    if (ap->ring)
+    {
+        stats->frames_played = atomic_load(&ap->frames_played);
+        stats->underruns = atomic_load(&ap->underruns);
+        stats->capacity = (int) (ap->size / ap->frame_bytes);
+        return;
+    }
+#endif
+    stats->frames_played = ap->frames_written;
+    stats->underruns = 0;
+    stats->capacity = 0;
+}
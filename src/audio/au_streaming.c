@@ -54,6 +54,7 @@ cst_audio_streaming_info *new_audio_streaming_info(void)
     asi->min_buffsize = 256;
     asi->asc = NULL;
     asi->userdata = NULL;
+    asi->sink = NULL;
 
     return asi;
 }
@@ -73,20 +74,144 @@ int audio_stream_chunk(const cst_wave *w, int start, int size,
     /* This is really just and example that you can copy for you streaming */
     /* function */
     /* This particular example is *not* thread safe */
+    /* Samples go through the buffered player so a slow audio device */
+    /* doesn't hold up the synthesis of the following chunks         */
     (void) asi;
-    static cst_audiodev *ad = 0;
+    static cst_audio_player *ap = 0;
 
     if (start == 0)
-        ad = mimic_audio_open(w->sample_rate, w->num_channels, CST_AUDIO_LINEAR16);
+        ap = mimic_audio_player_open(w->sample_rate, w->num_channels,
+                                     CST_AUDIO_LINEAR16,
+                                     CST_AUDIO_PLAYER_DEFAULT_LATENCY);
+    if (ap == NULL)
+        return CST_AUDIO_STREAM_STOP;
 
-    mimic_audio_write(ad, &w->samples[start], size * sizeof(short));
+    mimic_audio_player_write(ap, &w->samples[start], size * sizeof(short));
 
     if (last == 1)
     {
-        mimic_audio_close(ad);
-        ad = NULL;
+        mimic_audio_player_close(ap);
+        ap = NULL;
     }
 
     /* if you want to stop return CST_AUDIO_STREAM_STOP */
     return CST_AUDIO_STREAM_CONT;
 }
+
+cst_audio_sink *new_audio_sink(void *buff, int buff_frames, int fmt,
+                               int channels,
+                               int (*flush) (cst_audio_sink *sink,
+                                             int num_frames, int last),
+                               void *userdata)
+{
+    cst_audio_sink *sink;
+
+    if ((buff == NULL) || (buff_frames <= 0) || (flush == NULL) ||
+        ((fmt != CST_AUDIO_SINK_INT16) && (fmt != CST_AUDIO_SINK_FLOAT32)) ||
+        ((channels != 1) && (channels != 2)))
+    {
+        cst_errmsg("new_audio_sink: invalid buffer description\n");
+        return NULL;
+    }
+
+    sink = cst_alloc(cst_audio_sink, 1);
+    sink->buff = buff;
+    sink->buff_frames = buff_frames;
+    sink->fmt = fmt;
+    sink->channels = channels;
+    sink->flush = flush;
+    sink->userdata = userdata;
+
+    return sink;
+}
+
+void delete_audio_sink(cst_audio_sink *sink)
+{
+    if (sink)
+        cst_free(sink);
+    return;
+}
+
+int audio_sink_write(cst_audio_sink *sink, const short *samples,
+                     int num_samples, int last)
+{
+    int i, n, c;
+    short *sbuff;
+    float *fbuff;
+
+    for (i = 0; i < num_samples; i += n)
+    {
+        n = sink->buff_frames - sink->fill;
+        if (n > num_samples - i)
+            n = num_samples - i;
+
+        if (sink->fmt == CST_AUDIO_SINK_INT16)
+        {
+            sbuff = (short *) sink->buff + sink->fill * sink->channels;
+            if (sink->channels == 1)
+                memmove(sbuff, &samples[i], n * sizeof(short));
+            else
+                for (c = 0; c < n; c++)
+                    sbuff[2 * c] = sbuff[2 * c + 1] = samples[i + c];
+        }
+        else
+        {
+            fbuff = (float *) sink->buff + sink->fill * sink->channels;
+            for (c = 0; c < n; c++)
+            {
+                fbuff[c * sink->channels] = samples[i + c] / 32768.0f;
+                if (sink->channels == 2)
+                    fbuff[2 * c + 1] = fbuff[2 * c];
+            }
+        }
+        sink->fill += n;
+        sink->total_frames += n;
+
+        if ((sink->fill == sink->buff_frames) &&
+            ((i + n < num_samples) || !last))
+        {
+            if ((*sink->flush) (sink, sink->fill, 0) != CST_AUDIO_STREAM_CONT)
+                return CST_AUDIO_STREAM_STOP;
+            sink->fill = 0;
+        }
+    }
+
+    if (last)
+    {
+        n = sink->fill;
+        sink->fill = 0;
+        return (*sink->flush) (sink, n, 1);
+    }
+
+    return CST_AUDIO_STREAM_CONT;
+}
+
+int audio_stream_sink_chunk(const cst_wave *w, int start, int size,
+                            int last, cst_audio_streaming_info *asi)
+{
+    asi->sink->sample_rate = w->sample_rate;
+    return audio_sink_write(asi->sink, &w->samples[start], size, last);
+}
+
+int audio_stream_encode_chunk(const cst_wave *w, int start, int size,
+                              int last, cst_audio_streaming_info *asi)
+{
+    cst_wave_encoder *enc = (cst_wave_encoder *) asi->userdata;
+
+    if (cst_wave_encoder_write(enc, &w->samples[start], size,
+                               w->sample_rate, last) < 0)
+        return CST_AUDIO_STREAM_STOP;
+    return CST_AUDIO_STREAM_CONT;
+}
+
+int audio_stream_writer_chunk(const cst_wave *w, int start, int size,
+                              int last, cst_audio_streaming_info *asi)
+{
+    cst_wave_writer *ww = (cst_wave_writer *) asi->userdata;
+
+    (void) last;                /* the file is finished by closing ww */
+    if (cst_wave_writer_write(ww, &w->samples[start], size,
+                              w->sample_rate) < 0)
+        return CST_AUDIO_STREAM_STOP;
+    return CST_AUDIO_STREAM_CONT;
+}
@@ -70,17 +70,13 @@ int mimic_audio_bps(cst_audiofmt fmt)
 cst_audiodev *mimic_audio_open(int sps, int channels, cst_audiofmt fmt)
 {
     cst_audiodev *ad;
-    int up, down;
 
     ad = AUDIO_OPEN_NATIVE(sps, channels, fmt);
     if (ad == NULL)
         return NULL;
 
-    down = sps / 1000;
-    up = ad->real_sps / 1000;
-
-    if (up != down)
-        ad->rateconv = new_rateconv(up, down, channels);
+    if (ad->real_sps != sps)
+        ad->rateconv = new_rateconv_rates(sps, ad->real_sps, channels);
 
     return ad;
 }
@@ -100,27 +96,14 @@ int mimic_audio_write(cst_audiodev *ad, void *buff, int num_bytes)
 
     if (ad->rateconv)
     {
-        short *in, *out;
-        int insize, outsize, n;
+        int insize, outsize;
 
         insize = real_num_bytes / 2;
-        in = (short *) buff;
-
-        outsize = ad->rateconv->outsize;
-        nbuf = out = cst_alloc(short, outsize);
-        real_num_bytes = outsize * 2;
-
-        while ((n = cst_rateconv_in(ad->rateconv, in, insize)) > 0)
-        {
-            in += n;
-            insize -= n;
-            while ((n = cst_rateconv_out(ad->rateconv, out, outsize)) > 0)
-            {
-                out += n;
-                outsize -= n;
-            }
-        }
-        real_num_bytes -= outsize * 2;
+        outsize = cst_rateconv_max_out(ad->rateconv, insize);
+        nbuf = cst_alloc(short, outsize);
+        real_num_bytes = 2 * cst_rateconv_run(ad->rateconv, (short *) buff,
+                                              insize, (short *) nbuf,
+                                              outsize, 0);
         if (abuf != buff)
             cst_free(abuf);
         abuf = nbuf;
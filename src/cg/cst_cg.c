@@ -54,12 +54,20 @@
 #include "cst_hrg.h"
 #include "cst_utt_utils.h"
 #include "cst_audio.h"
+#include "cst_cg_cache.h"
 
 CST_VAL_REGISTER_TYPE(cg_db, cst_cg_db);
 static cst_utterance *cg_make_hmmstates(cst_utterance *utt);
-static cst_utterance *cg_make_params(cst_utterance *utt);
-static cst_utterance *cg_predict_params(cst_utterance *utt);
-static cst_utterance *cg_resynth(cst_utterance *utt);
+typedef struct cg_frames_struct cg_frames;
+static cg_frames *cg_make_params(cst_utterance *utt, int with_frames);
+static void delete_cg_frames(cg_frames *fr);
+typedef struct cg_splice_struct cg_splice;
+static cg_splice *new_cg_splice(cst_utterance *utt, cst_cg_db *cg_db,
+                                const cg_frames *fr);
+static void delete_cg_splice(cg_splice *sp);
+static cst_utterance *cg_predict_params(cst_utterance *utt, cg_frames *fr,
+                                        cg_splice *sp);
+static cst_utterance *cg_resynth(cst_utterance *utt, cg_splice *sp);
 
 void delete_cg_db(cst_cg_db *db)
 {
@@ -144,16 +152,28 @@ void delete_cg_db(cst_cg_db *db)
 cst_utterance *cg_synth(cst_utterance *utt)
 {
     cst_cg_db *cg_db;
+    cg_frames *fr;
+    cg_splice *sp;
+    double start;
     cg_db = val_cg_db(utt_feat_val(utt, "cg_db"));
 
+    start = cst_stats_start();
     cg_make_hmmstates(utt);
-    cg_make_params(utt);
-    cg_predict_params(utt);
+    cst_stats_end("cg_make_hmmstates", start);
+    start = cst_stats_start();
+    fr = cg_make_params(utt, 1);
+    cst_stats_end("cg_make_params", start);
+    start = cst_stats_start();
+    sp = new_cg_splice(utt, cg_db, fr);
+    cg_predict_params(utt, fr, sp);
     if (cg_db->spamf0)
     {
         cst_spamf0(utt);
     }
-    cg_resynth(utt);
+    cst_stats_end("cg_predict_params", start);
+    cg_resynth(utt, sp);
+    delete_cg_splice(sp);
+    delete_cg_frames(fr);
 
     return utt;
 }
@@ -226,23 +246,68 @@ static cst_utterance *cg_make_hmmstates(cst_utterance *utt)
     return utt;
 }
 
-static cst_utterance *cg_make_params(cst_utterance *utt)
+cst_utterance *cg_durations(cst_utterance *utt)
+{
+    /* The Segment ends cg_synth() would give, without any frames */
+    cg_make_hmmstates(utt);
+    cg_make_params(utt, 0);
+
+    return utt;
+}
+
+/* The frames the parameters are predicted for.  Rather than an item */
+/* per 5ms frame, each HMM state with frames gets a single view item  */
+/* below it in mcep_link, and the trees are asked about a frame by    */
+/* setting the view's frame_number to it.  States and segments get    */
+/* first_frame and last_frame features for the feature functions.     */
+/* Only when the utterance has "cg_mcep_relation" set is the mcep     */
+/* relation built, an item per frame as it used to be, and then view  */
+/* holds those items and what is predicted is set on them too.        */
+struct cg_frames_struct {
+    int num_frames;
+    cst_item **state;           /* in mcep_link */
+    cst_item **view;            /* to interpret the trees with */
+    float *voicing;
+    int *param_frame;           /* cluster of the last param model */
+    int items;                  /* view is the mcep relation */
+};
+
+static void delete_cg_frames(cg_frames *fr)
+{
+    if (fr == NULL)
+        return;
+    cst_free(fr->state);
+    cst_free(fr->view);
+    cst_free(fr->voicing);
+    cst_free(fr->param_frame);
+    cst_free(fr);
+}
+
+static cg_frames *cg_make_params(cst_utterance *utt, int with_frames)
 {
     /* puts in the frame items */
     /* historically called "mcep" but can actually be any random vectors */
     cst_cg_db *cg_db;
-    cst_relation *mcep, *mcep_link;
-    cst_item *s, *mcep_parent, *mcep_frame;
-    int num_frames;
+    cst_relation *mcep = NULL, *mcep_link;
+    cst_item *s, *mcep_parent, *mcep_frame, *state;
+    cg_frames *fr;
+    int num_frames, last_frame, whole_frames, first_frame, items, f;
     float start, end;
     float dur_stretch, tok_stretch, rdur;
 
     cg_db = val_cg_db(utt_feat_val(utt, "cg_db"));
-    mcep = utt_relation_create(utt, "mcep");
+    items = with_frames &&
+        (get_param_val(utt->features, "cg_mcep_relation", NULL) != NULL);
+    if (items)
+        mcep = utt_relation_create(utt, "mcep");
     mcep_link = utt_relation_create(utt, "mcep_link");
     end = 0.0;
-    num_frames = 0;
+    num_frames = last_frame = 0;
     dur_stretch = get_param_float(utt->features, "duration_stretch", 1.0);
+    /* With the phrase cache each state gets a whole number of frames, */
+    /* otherwise a phrase's frames depend on where in time it starts   */
+    whole_frames =
+        (get_param_val(utt->features, "cg_param_cache", NULL) != NULL);
 
     for (s = utt_rel_head(utt, "HMMstate"); s; s = item_next(s))
     {
@@ -254,28 +319,93 @@ static cst_utterance *cg_make_params(cst_utterance *utt)
             tok_stretch = 1.0;
         rdur = tok_stretch * dur_stretch * cg_state_duration(s, cg_db);
         /* Guarantee duration to be alt least one frame */
-        if (rdur < cg_db->frame_advance)
+        if (whole_frames)
+        {
+            last_frame = num_frames +
+                (int) ((rdur / cg_db->frame_advance) + 0.5) - 1;
+            if (last_frame < num_frames)
+                last_frame = num_frames;
+            end = last_frame * cg_db->frame_advance;
+            item_set_int(s, "end_frame", last_frame);
+        }
+        else if (rdur < cg_db->frame_advance)
             end = start + cg_db->frame_advance;
         else
             end = start + rdur;
         item_set_float(s, "end", end);
         mcep_parent = relation_append(mcep_link, s);
-        for (; (num_frames * cg_db->frame_advance) <= end; num_frames++)
+        first_frame = num_frames;
+        for (; whole_frames ? (num_frames <= last_frame) :
+             ((num_frames * cg_db->frame_advance) <= end); num_frames++)
         {
+            if (!items)
+                continue;
             mcep_frame = relation_append(mcep, NULL);
             item_add_daughter(mcep_parent, mcep_frame);
             item_set_int(mcep_frame, "frame_number", num_frames);
             item_set(mcep_frame, "name", item_feat(mcep_parent, "name"));
         }
+        if (with_frames && num_frames > first_frame)
+        {
+            item_set_int(mcep_parent, "first_frame", first_frame);
+            item_set_int(mcep_parent, "last_frame", num_frames - 1);
+            if (!items)
+            {
+                mcep_frame = item_add_daughter(mcep_parent, NULL);
+                item_set(mcep_frame, "name", item_feat(mcep_parent, "name"));
+            }
+        }
     }
 
     /* Copy duration up onto Segment relation */
     for (s = utt_rel_head(utt, "Segment"); s; s = item_next(s))
+    {
         item_set(s, "end", ffeature(s, "R:segstate.daughtern.end"));
+        if (whole_frames)
+            item_set(s, "end_frame",
+                     ffeature(s, "R:segstate.daughtern.end_frame"));
+        if (!with_frames)
+            continue;
+        state = item_daughter(item_as(s, "segstate"));
+        if (state && item_feat_present(state, "first_frame"))
+            item_set(s, "first_frame", item_feat(state, "first_frame"));
+        state = item_last_daughter(item_as(s, "segstate"));
+        if (state && item_feat_present(state, "last_frame"))
+            item_set(s, "last_frame", item_feat(state, "last_frame"));
+    }
 
     utt_set_feat_int(utt, "param_track_num_frames", num_frames);
 
-    return utt;
+    if (!with_frames)
+        return NULL;
+
+    fr = cst_alloc(cg_frames, 1);
+    fr->num_frames = num_frames;
+    fr->state = cst_alloc(cst_item *, num_frames);
+    fr->view = cst_alloc(cst_item *, num_frames);
+    fr->voicing = cst_alloc(float, num_frames);
+    fr->param_frame = cst_alloc(int, num_frames);
+    fr->items = items;
+    for (s = relation_head(mcep_link); s; s = item_next(s))
+    {
+        if (!item_feat_present(s, "first_frame"))
+            continue;
+        mcep_frame = item_daughter(s);
+        for (f = item_feat_int(s, "first_frame");
+             f <= item_feat_int(s, "last_frame"); f++)
+        {
+            fr->state[f] = s;
+            if (items)
+            {
+                fr->view[f] = item_as(mcep_frame, "mcep");
+                mcep_frame = item_next(mcep_frame);
+            }
+            else
+                fr->view[f] = mcep_frame;
+        }
+    }
+
+    return fr;
 }
 
 #if CG_OLD
@@ -295,25 +425,120 @@ static int voiced_frame(cst_item *m)
 }
 #endif
 
-static int voiced_frame(cst_item *m)
+/* Voicing of a segment's frames: 0 unvoiced, 1 voiced, or -1 when */
+/* it is up to each frame's predicted voicing                       */
+static int voiced_segment(cst_item *seg)
 {
     const char *ph_vc;
     const char *ph_name;
 
-    ph_vc = ffeature_string(m, "R:mcep_link.parent.R:segstate.parent.ph_vc");
-    ph_name = ffeature_string(m, "R:mcep_link.parent.R:segstate.parent.name");
+    ph_vc = ffeature_string(seg, "ph_vc");
+    ph_name = item_feat_string(seg, "name");
 
     if (cst_streq(ph_name, "pau"))
         return 0;               /* unvoiced */
     else if (cst_streq("+", ph_vc))
         return 1;               /* voiced */
-    else if (item_feat_float(m, "voicing") > 0.5)
+    else
+        return -1;
+}
+
+static int voiced_frame(int seg_voiced, float voicing)
+{
+    if (seg_voiced >= 0)
+        return seg_voiced;
+    else if (voicing > 0.5)
         /* Even though the range is 0-10, I *do* mean 0.5 */
         return 1;               /* voiced */
     else
         return 0;               /* unvoiced */
 }
 
+/* The F0 post-processing reads everything it needs about each frame */
+/* from these arrays, filled in one walk over the segments rather    */
+/* than with relation paths from every frame                         */
+typedef struct cg_f0_frames_struct {
+    int num_frames;
+    char *voiced;
+    float *mean;                /* the token's local_f0_mean, or the default */
+    float *stddev;              /* from its local_f0_range, or the default */
+    int num_syls;
+    int *syl_start;             /* first and last frame of each syllable */
+    int *syl_end;
+} cg_f0_frames;
+
+static cg_f0_frames *new_cg_f0_frames(cst_utterance *utt,
+                                      const cg_frames *fr, int num_frames,
+                                      float base_mean, float base_stddev)
+{
+    cg_f0_frames *ff;
+    cst_item *seg, *syl;
+    float mean, stddev, local_f0_mean, local_f0_range;
+    int seg_voiced, f, last;
+
+    ff = cst_alloc(cg_f0_frames, 1);
+    ff->num_frames = num_frames;
+    ff->voiced = cst_alloc(char, num_frames);
+    ff->mean = cst_alloc(float, num_frames);
+    ff->stddev = cst_alloc(float, num_frames);
+
+    for (seg = utt_rel_head(utt, "Segment"); seg; seg = item_next(seg))
+    {
+        seg_voiced = voiced_segment(seg);
+        mean = base_mean;
+        stddev = base_stddev;
+        local_f0_mean =
+            ffeature_float(seg,
+                           "R:SylStructure.parent.parent.R:Token.parent.local_f0_mean");
+        if (local_f0_mean != 0.0)
+            mean = local_f0_mean;
+        local_f0_range =
+            ffeature_float(seg,
+                           "R:SylStructure.parent.parent.R:Token.parent.local_f0_range");
+        if (local_f0_range > 0.0)
+            /* feature_float returns 0 by default, shifted to allow 0 to be passed. */
+            stddev = local_f0_range - 1.0;
+
+        if (!item_feat_present(seg, "first_frame") ||
+            !item_feat_present(seg, "last_frame"))
+            continue;
+        last = item_feat_int(seg, "last_frame");
+        for (f = item_feat_int(seg, "first_frame");
+             f <= last && f < num_frames; f++)
+        {
+            ff->voiced[f] = voiced_frame(seg_voiced, fr->voicing[f]);
+            ff->mean[f] = mean;
+            ff->stddev[f] = stddev;
+        }
+    }
+
+    for (ff->num_syls = 0, syl = utt_rel_head(utt, "Syllable"); syl;
+         syl = item_next(syl))
+        ff->num_syls++;
+    ff->syl_start = cst_alloc(int, ff->num_syls);
+    ff->syl_end = cst_alloc(int, ff->num_syls);
+    for (f = 0, syl = utt_rel_head(utt, "Syllable"); syl;
+         f++, syl = item_next(syl))
+    {
+        ff->syl_start[f] =
+            ffeature_int(syl, "R:SylStructure.daughter1.first_frame");
+        ff->syl_end[f] =
+            ffeature_int(syl, "R:SylStructure.daughtern.last_frame");
+    }
+
+    return ff;
+}
+
+static void delete_cg_f0_frames(cg_f0_frames *ff)
+{
+    cst_free(ff->voiced);
+    cst_free(ff->mean);
+    cst_free(ff->stddev);
+    cst_free(ff->syl_start);
+    cst_free(ff->syl_end);
+    cst_free(ff);
+}
+
 static float catmull_rom_spline(float p, float p0, float p1, float p2,
                                 float p3)
 /* http://www.mvps.org/directx/articles/ */
@@ -334,27 +559,23 @@ static float catmull_rom_spline(float p, float p0, float p1, float p2,
     return q;
 }
 
-static void cg_F0_interpolate_spline(cst_utterance *utt,
+static void cg_F0_interpolate_spline(const cg_f0_frames *ff,
                                      cst_track *param_track)
 {
     float start_f0, mid_f0, end_f0;
     int start_index, end_index, mid_index;
     int nsi, nei, nmi;          /* next syllable indices */
     float nmid_f0, pmid_f0;
-    cst_item *syl;
+    int syl;
     int i;
     float m;
 
     start_f0 = mid_f0 = end_f0 = -1.0;
 
-    for (syl = utt_rel_head(utt, "Syllable"); syl; syl = item_next(syl))
+    for (syl = 0; syl < ff->num_syls; syl++)
     {
-        start_index =
-            ffeature_int(syl,
-                         "R:SylStructure.daughter1.R:segstate.daughter1.R:mcep_link.daughter1.frame_number");
-        end_index =
-            ffeature_int(syl,
-                         "R:SylStructure.daughtern.R:segstate.daughtern.R:mcep_link.daughtern.frame_number");
+        start_index = ff->syl_start[syl];
+        end_index = ff->syl_end[syl];
         mid_index = (int) ((start_index + end_index) / 2.0);
 
         start_f0 = param_track->frames[start_index][0];
@@ -365,21 +586,17 @@ static void cg_F0_interpolate_spline(cst_utterance *utt,
         else
             pmid_f0 = mid_f0;
         mid_f0 = param_track->frames[mid_index][0];
-        if (item_next(syl))     /* not last syllable */
+        if (syl + 1 < ff->num_syls)     /* not last syllable */
             end_f0 = (param_track->frames[end_index - 1][0] +
                       param_track->frames[end_index][0]) / 2.0;
         else
             end_f0 = param_track->frames[end_index - 1][0];
         nmid_f0 = end_f0;       /* in case there is no next syl */
 
-        if (item_next(syl))
+        if (syl + 1 < ff->num_syls)
         {
-            nsi =
-                ffeature_int(syl,
-                             "n.R:SylStructure.daughter1.R:segstate.daughter1.R:mcep_link.daughter1.frame_number");
-            nei =
-                ffeature_int(syl,
-                             "n.R:SylStructure.daughtern.R:segstate.daughtern.R:mcep_link.daughtern.frame_number");
+            nsi = ff->syl_start[syl + 1];
+            nei = ff->syl_end[syl + 1];
             nmi = (int) ((nsi + nei) / 2.0);
             nmid_f0 = param_track->frames[nmi][0];
         }
@@ -433,17 +650,14 @@ static void cg_smooth_F0_naive(cst_track *param_track)
 }
 #endif
 
-static void cg_smooth_F0(cst_utterance *utt, cst_cg_db *cg_db,
-                         cst_track *param_track)
+static void cg_smooth_F0(cst_utterance *utt, const cg_frames *fr,
+                         cst_cg_db *cg_db, cst_track *param_track)
 {
     /* Smooth F0 and mark unvoice frames as 0.0 */
-    cst_item *mcep;
+    cg_f0_frames *ff;
     int i;
     float base_mean, base_stddev;
-
-    /* cg_smooth_F0_naive(param_track); */
-
-    cg_F0_interpolate_spline(utt, param_track);
+    float *f0;
 
     base_mean =
         get_param_float(utt->features, "int_f0_target_mean", cg_db->f0_mean);
@@ -451,59 +665,506 @@ static void cg_smooth_F0(cst_utterance *utt, cst_cg_db *cg_db,
     base_stddev =
         get_param_float(utt->features, "int_f0_target_stddev",
                         cg_db->f0_stddev);
+    ff = new_cg_f0_frames(utt, fr, param_track->num_frames,
+                          base_mean, base_stddev);
+
+    /* cg_smooth_F0_naive(param_track); */
 
-    for (i = 0, mcep = utt_rel_head(utt, "mcep"); mcep;
-         i++, mcep = item_next(mcep))
+    cg_F0_interpolate_spline(ff, param_track);
+
+    for (i = 0; i < ff->num_frames; i++)
     {
-        if (voiced_frame(mcep))
+        f0 = &param_track->frames[i][0];
+        if (ff->voiced[i])
         {
-            float mean = base_mean;
-            float stddev = base_stddev;
-            float local_f0_mean =
-            ffeature_float(mcep,
-                "R:mcep_link.parent.R:segstate.parent.R:SylStructure.parent.parent.R:Token.parent.local_f0_mean"
-            );
-            if (local_f0_mean != 0.0)
-            {
-                mean = local_f0_mean;
-            }
-            float local_f0_range =
-            ffeature_float(mcep,
-                "R:mcep_link.parent.R:segstate.parent.R:SylStructure.parent.parent.R:Token.parent.local_f0_range"
-            );
-            if (local_f0_range > 0.0)
-            {
-                /* feature_float returns 0 by default, shifted to allow 0 to be passed. */
-                stddev = local_f0_range - 1.0;
-            }
             /* scale the F0 -- which normally wont change it at all */
-            param_track->frames[i][0] =
-                (((param_track->frames[i][0] -
-                   cg_db->f0_mean) / cg_db->f0_stddev) * stddev) + mean;
+            *f0 = (((*f0 - cg_db->f0_mean) / cg_db->f0_stddev) *
+                   ff->stddev[i]) + ff->mean[i];
             /* Some safety checks */
-            if (param_track->frames[i][0] < 50)
-                param_track->frames[i][0] = 50;
-            if (param_track->frames[i][0] > 700)
-                param_track->frames[i][0] = 700;
+            if (*f0 < 50)
+                *f0 = 50;
+            if (*f0 > 700)
+                *f0 = 700;
         }
         else                    /* Unvoice it */
-            param_track->frames[i][0] = 0.0;
+            *f0 = 0.0;
     }
 
+    delete_cg_f0_frames(ff);
+
     return;
 }
 
-static cst_utterance *cg_predict_params(cst_utterance *utt)
+/* Phrase splicing with the parameter cache (src/cg/cst_cg_cache.c).    */
+/* The frames are cut in the middle of the pauses between phrases and   */
+/* each span is looked up by its states, their frame counts and the    */
+/* segment features the trees ask about, with a hash of the segments   */
+/* either side.  Hits are copied in, misses are predicted as usual.    */
+/* mlpg is run over the runs of new spans plus some spliced frames     */
+/* either side, so the trajectories meet at the joins, and the vocoder */
+/* always runs over the whole utterance.                               */
+#define CG_SPLICE_MARGIN 20     /* frames */
+
+typedef struct cg_chunk_struct {
+    int start, end;             /* frames */
+    char *key;
+    cg_span *span;              /* from the cache, or the new prediction */
+    int hit;
+} cg_chunk;
+
+struct cg_splice_struct {
+    cst_cg_param_cache *cache;
+    const cg_frames *fr;
+    int num_chunks;
+    cg_chunk *chunks;
+    int hits;
+};
+
+static const char *const cg_splice_seg_feats[] = {
+    "name",
+    "R:SylStructure.parent.stress",
+    "R:SylStructure.parent.accented",
+    "R:SylStructure.parent.syl_break",
+    "R:SylStructure.parent.parent.name",
+    "R:SylStructure.parent.parent.gpos",
+    "R:SylStructure.parent.parent.R:Token.parent.local_gain",
+    NULL
+};
+
+static const char *const cg_splice_prev_feats[] = {
+    "p.name",
+    "p.p.name",
+    "p.p.p.name",
+    "p.R:SylStructure.parent.parent.name",
+    NULL
+};
+
+static const char *const cg_splice_next_feats[] = {
+    "n.name",
+    "n.n.name",
+    "n.n.n.name",
+    "n.R:SylStructure.parent.parent.name",
+    NULL
+};
+
+typedef struct cg_key_struct {
+    char *s;
+    int len, size;
+} cg_key;
+
+static void cg_key_add(cg_key *k, const char *s)
+{
+    int n = cst_strlen(s);
+
+    if (k->len + n + 2 > k->size)
+    {
+        k->size = (k->len + n + 2) * 2;
+        k->s = cst_realloc(k->s, char, k->size);
+    }
+    memmove(k->s + k->len, s, n);
+    k->len += n;
+    k->s[k->len++] = '\037';
+    k->s[k->len] = '\0';
+}
+
+static unsigned int cg_hash_feats(unsigned int h, cst_item *seg,
+                                  const char *const *feats)
+{
+    const char *v;
+    int i;
+
+    for (i = 0; feats[i]; i++)
+    {
+        for (v = ffeature_string(seg, feats[i]); *v; v++)
+            h = (h ^ (unsigned char) *v) * 16777619u;
+        h = (h ^ 0x1f) * 16777619u;
+    }
+    return h;
+}
+
+/* First or last segment of a phrase, NULL if its words have none */
+static cst_item *cg_phrase_edge(const cst_item *phrase, int last)
+{
+    cst_item *i;
+
+    i = last ? item_last_daughter(phrase) : item_daughter(phrase);
+    i = item_as(i, "SylStructure");
+    i = last ? item_last_daughter(i) : item_daughter(i);
+    i = last ? item_last_daughter(i) : item_daughter(i);
+    return item_as(i, "Segment");
+}
+
+/* First or last frame number of a segment, -1 if it has none */
+static int cg_seg_frame(const cst_item *seg, int last)
+{
+    const char *f = last ? "last_frame" : "first_frame";
+
+    if (seg == NULL || !item_feat_present(seg, f))
+        return -1;
+    return item_feat_int(seg, f);
+}
+
+static char *cg_splice_key(const cg_splice *sp, const cg_chunk *ch,
+                           int phrase, int num_phrases)
+{
+    cg_key k;
+    char b[64];
+    cst_item *state, *seg, *lseg = NULL, *fseg = NULL;
+    int i, first, last;
+    unsigned int h = 2166136261u;
+
+    k.size = 256;
+    k.len = 0;
+    k.s = cst_alloc(char, k.size);
+    /* Some trees ask about the position of the phrase in the utterance */
+    cst_sprintf(b, "%d/%d", phrase, num_phrases);
+    cg_key_add(&k, b);
+
+    for (state = sp->fr->state[ch->start]; state; state = item_next(state))
+    {
+        if (!item_feat_present(state, "first_frame"))
+            continue;
+        first = item_feat_int(state, "first_frame");
+        last = item_feat_int(state, "last_frame");
+        if (first >= ch->end)
+            break;
+        if (first < ch->start)
+            first = ch->start;
+        if (last >= ch->end)
+            last = ch->end - 1;
+        seg = item_parent(item_as(state, "segstate"));
+        if (seg != lseg)
+        {
+            for (i = 0; cg_splice_seg_feats[i]; i++)
+                cg_key_add(&k, ffeature_string(seg, cg_splice_seg_feats[i]));
+            if (fseg == NULL)
+                fseg = seg;
+            lseg = seg;
+        }
+        cst_sprintf(b, "%s:%d", item_feat_string(state, "name"),
+                    last - first + 1);
+        cg_key_add(&k, b);
+    }
+
+    if (fseg)
+        h = cg_hash_feats(h, fseg, cg_splice_prev_feats);
+    if (lseg)
+        h = cg_hash_feats(h, lseg, cg_splice_next_feats);
+    cst_sprintf(b, "%08x", h);
+    cg_key_add(&k, b);
+
+    return k.s;
+}
+
+static void delete_cg_splice(cg_splice *sp)
+{
+    int i;
+
+    if (sp == NULL)
+        return;
+    for (i = 0; i < sp->num_chunks; i++)
+    {
+        cst_free(sp->chunks[i].key);
+        delete_cg_span(sp->chunks[i].span);
+    }
+    cst_free(sp->chunks);
+    cst_free(sp);
+}
+
+/* Cuts the utterance into phrase spans and looks them up, NULL if the */
+/* voice has no cache or the utterance can't be cut                    */
+static cg_splice *new_cg_splice(cst_utterance *utt, cst_cg_db *cg_db,
+                                const cg_frames *fr)
+{
+    const cst_val *v;
+    cg_splice *sp;
+    cst_item *phrase;
+    int i, num_frames, num_phrases, start, end, pend;
+
+    v = get_param_val(utt->features, "cg_param_cache", NULL);
+    if (v == NULL || fr == NULL)
+        return NULL;
+    num_frames = fr->num_frames;
+    for (num_phrases = 0, phrase = utt_rel_head(utt, "Phrase"); phrase;
+         phrase = item_next(phrase))
+        num_phrases++;
+    if (num_phrases == 0 || num_frames == 0)
+        return NULL;
+
+    sp = cst_alloc(cg_splice, 1);
+    sp->cache = val_cg_param_cache(v);
+    sp->fr = fr;
+    sp->chunks = cst_alloc(cg_chunk, num_phrases);
+
+    for (i = 0, pend = 0, phrase = utt_rel_head(utt, "Phrase"); phrase;
+         i++, phrase = item_next(phrase))
+    {
+        start = cg_seg_frame(cg_phrase_edge(phrase, 0), 0);
+        end = cg_seg_frame(cg_phrase_edge(phrase, 1), 1) + 1;
+        if (start < pend || end <= start)
+        {
+            /* a phrase with no frames of its own */
+            delete_cg_splice(sp);
+            return NULL;
+        }
+        if (i > 0)
+        {
+            sp->chunks[i].start = (pend + start) / 2;
+            sp->chunks[i - 1].end = sp->chunks[i].start;
+        }
+        pend = end;
+    }
+    sp->chunks[num_phrases - 1].end = num_frames;
+    sp->num_chunks = num_phrases;
+
+    for (i = 0; i < sp->num_chunks; i++)
+    {
+        sp->chunks[i].key = cg_splice_key(sp, &sp->chunks[i], i, num_phrases);
+        sp->chunks[i].span =
+            cg_param_cache_get(sp->cache, cg_db, sp->chunks[i].key);
+    }
+
+    return sp;
+}
+
+static void cg_predict_frame(cst_cg_db *cg_db, cg_frames *fr, int i,
+                             int fff, cst_track *param_track,
+                             cst_track *str_track)
 {
-    cst_cg_db *cg_db;
-    cst_track *param_track;
-    cst_track *str_track = NULL;
-    cst_item *mcep;
     const cst_cart *mcep_tree, *f0_tree;
-    int i, j, f, p, o, pm;
+    cst_item *mcep;
+    int j, f, p, o, pm;
     const char *mname;
     float f0_val;
     float local_gain, voicing;
+
+    mcep = fr->view[i];
+    if (!fr->items)
+        item_set_int(mcep, "frame_number", i);
+    mname = item_feat_string(mcep, "name");
+    local_gain =
+        ffeature_float(mcep,
+                       "R:mcep_link.parent.R:segstate.parent.R:SylStructure.parent.parent.R:Token.parent.local_gain");
+    if (local_gain == 0.0)
+        local_gain = 1.0;
+    for (p = 0; cg_db->types[p]; p++)
+        if (cst_streq(mname, cg_db->types[p]))
+            break;
+    if (cg_db->types[p] == NULL)
+        p = 0;                  /* if there isn't a matching tree, use the first one */
+
+    /* Predict F0 */
+    f0_tree = cg_db->f0_trees[p];
+    f0_val = val_float(cart_interpret(mcep, f0_tree));
+    param_track->frames[i][0] = f0_val;
+    /* what about stddev ? */
+
+    /* We only have multiple models now, but the default is one model */
+    /* Predict spectral coeffs */
+    voicing = 0.0;
+    for (pm = 0; pm < cg_db->num_param_models; pm++)
+    {
+        mcep_tree = cg_db->param_trees[pm][p];
+        f = val_int(cart_interpret(mcep, mcep_tree));
+        /* If there is one model this will be fine, if there are */
+        /* multiple models this will be the nth model */
+        fr->param_frame[i] = f;
+        if (fr->items)
+            item_set_int(mcep, "clustergen_param_frame", f);
+
+        /* Old code used to average in param[0] with F0 too (???) */
+
+        for (j = 2; j < param_track->num_channels; j++)
+        {
+            if (pm == 0)
+                param_track->frames[i][j] = 0.0;
+            param_track->frames[i][j] +=
+                CG_MODEL_VECTOR(cg_db, model_vectors[pm], f, (j) * fff) /
+                (float) cg_db->num_param_models;
+        }
+
+        if (cg_db->mixed_excitation)
+        {
+            o = j;
+            for (j = 0; j < 5; j++)
+            {
+                if (pm == 0)
+                    str_track->frames[i][j] = 0.0;
+                str_track->frames[i][j] +=
+                    CG_MODEL_VECTOR(cg_db, model_vectors[pm], f,
+                                    (o +
+                                     (2 * j)) * fff) /
+                    (float) cg_db->num_param_models;
+            }
+        }
+
+        /* last coefficient is average voicing for cluster */
+        voicing /= (float) (pm + 1);
+        voicing +=
+            CG_MODEL_VECTOR(cg_db, model_vectors[pm], f,
+                            cg_db->num_channels[pm] - 2) / (float) (pm + 1);
+    }
+    fr->voicing[i] = voicing;
+    if (fr->items)
+        item_set_float(mcep, "voicing", voicing);
+    /* Apply local gain to c0 */
+    param_track->frames[i][2] *= local_gain;
+
+    param_track->times[i] = i * cg_db->frame_advance;
+}
+
+/* Copies in the spans the cache had and predicts the rest, keeping */
+/* the new predictions for cg_splice_store()                        */
+static void cg_splice_predict(cg_splice *sp, cg_frames *fr,
+                              cst_cg_db *cg_db, int fff,
+                              cst_track *param_track, cst_track *str_track)
+{
+    cg_chunk *c;
+    cg_span *s;
+    int i, f, n, num_str, num_smoothed;
+    long reused = 0, predicted = 0;
+
+    num_str = str_track ? str_track->num_channels : 0;
+    num_smoothed =
+        cg_db->do_mlpg ? ((param_track->num_channels / 2) - 1) / 2 : 0;
+
+    for (c = sp->chunks; c < sp->chunks + sp->num_chunks; c++)
+    {
+        n = c->end - c->start;
+        s = c->span;
+        if (s && (s->num_frames != n ||
+                  s->num_params != param_track->num_channels ||
+                  s->num_str != num_str || s->num_smoothed != num_smoothed))
+        {
+            delete_cg_span(s);
+            s = c->span = NULL;
+        }
+
+        if (s)
+        {
+            c->hit = 1;
+            sp->hits++;
+            reused += n;
+            for (i = 0, f = c->start; i < n; i++, f++)
+            {
+                memmove(param_track->frames[f], s->params + (i * s->num_params),
+                        sizeof(float) * s->num_params);
+                if (num_str)
+                    memmove(str_track->frames[f], s->str + (i * num_str),
+                            sizeof(float) * num_str);
+                fr->voicing[f] = s->voicing[i];
+                fr->param_frame[f] = s->param_frame[i];
+                if (fr->items)
+                {
+                    item_set_float(fr->view[f], "voicing", s->voicing[i]);
+                    item_set_int(fr->view[f], "clustergen_param_frame",
+                                 s->param_frame[i]);
+                }
+                param_track->times[f] = f * cg_db->frame_advance;
+            }
+        }
+        else
+        {
+            s = c->span = new_cg_span(n, param_track->num_channels, num_str,
+                                      num_smoothed);
+            predicted += n;
+            for (i = 0, f = c->start; i < n; i++, f++)
+            {
+                cg_predict_frame(cg_db, fr, f, fff, param_track, str_track);
+                memmove(s->params + (i * s->num_params), param_track->frames[f],
+                        sizeof(float) * s->num_params);
+                if (num_str)
+                    memmove(s->str + (i * num_str), str_track->frames[f],
+                            sizeof(float) * num_str);
+                s->voicing[i] = fr->voicing[f];
+                s->param_frame[i] = fr->param_frame[f];
+            }
+        }
+    }
+
+    cg_param_cache_count_frames(sp->cache, reused, predicted);
+}
+
+/* mlpg over the runs of new spans, the spans that were hits already */
+/* have their smoothed frames                                         */
+static cst_track *cg_splice_mlpg(const cg_splice *sp,
+                                 const cst_track *param_track,
+                                 cst_cg_db *cg_db)
+{
+    cst_track *smoothed, *part, *window;
+    const cg_span *s;
+    int i, j, f, start, end, ws, we;
+
+    smoothed = new_track();
+    cst_track_resize(smoothed, param_track->num_frames,
+                     sp->chunks[0].span->num_smoothed + 1);
+
+    for (i = 0; i < sp->num_chunks; i = j)
+    {
+        if (sp->chunks[i].hit)
+        {
+            s = sp->chunks[i].span;
+            for (f = sp->chunks[i].start; f < sp->chunks[i].end; f++)
+            {
+                smoothed->frames[f][0] = param_track->frames[f][0];
+                memmove(smoothed->frames[f] + 1,
+                        s->smoothed +
+                        ((f - sp->chunks[i].start) * s->num_smoothed),
+                        sizeof(float) * s->num_smoothed);
+            }
+            j = i + 1;
+            continue;
+        }
+        for (j = i + 1; j < sp->num_chunks && !sp->chunks[j].hit; j++);
+        start = sp->chunks[i].start;
+        end = sp->chunks[j - 1].end;
+        ws = (start > CG_SPLICE_MARGIN) ? start - CG_SPLICE_MARGIN : 0;
+        we = end + CG_SPLICE_MARGIN;
+        if (we > param_track->num_frames)
+            we = param_track->num_frames;
+
+        window = cst_track_view(param_track, ws, we - ws, 0,
+                                param_track->num_channels);
+        part = mlpg(window, cg_db);
+        delete_track(window);
+        for (f = start; f < end; f++)
+            memmove(smoothed->frames[f], part->frames[f - ws],
+                    sizeof(float) * smoothed->num_channels);
+        delete_track(part);
+    }
+    for (f = 0; f < param_track->num_frames; f++)
+        smoothed->times[f] = param_track->times[f];
+
+    return smoothed;
+}
+
+static void cg_splice_store(const cg_splice *sp, const cst_cg_db *cg_db,
+                            const cst_track *smoothed)
+{
+    const cg_chunk *c;
+    cg_span *s;
+    int i;
+
+    for (c = sp->chunks; c < sp->chunks + sp->num_chunks; c++)
+    {
+        if (c->hit)
+            continue;
+        s = c->span;
+        for (i = 0; smoothed && i < s->num_frames; i++)
+            memmove(s->smoothed + (i * s->num_smoothed),
+                    smoothed->frames[c->start + i] + 1,
+                    sizeof(float) * s->num_smoothed);
+        cg_param_cache_put(sp->cache, cg_db, c->key, s);
+    }
+}
+
+static cst_utterance *cg_predict_params(cst_utterance *utt, cg_frames *fr,
+                                        cg_splice *sp)
+{
+    cst_cg_db *cg_db;
+    cst_track *param_track;
+    cst_track *str_track = NULL;
+    int i;
     int fff;
     int extra_feats = 0;
 
@@ -524,80 +1185,13 @@ static cst_utterance *cg_predict_params(cst_utterance *utt)
     }
 
     cst_track_resize(param_track, utt_feat_int(utt, "param_track_num_frames"), (cg_db->num_channels[0] / fff) - (2 * extra_feats));     /* no voicing or str */
-    f = 0;
-    for (i = 0, mcep = utt_rel_head(utt, "mcep"); mcep;
-         i++, mcep = item_next(mcep))
-    {
-        mname = item_feat_string(mcep, "name");
-        local_gain =
-            ffeature_float(mcep,
-                           "R:mcep_link.parent.R:segstate.parent.R:SylStructure.parent.parent.R:Token.parent.local_gain");
-        if (local_gain == 0.0)
-            local_gain = 1.0;
-        for (p = 0; cg_db->types[p]; p++)
-            if (cst_streq(mname, cg_db->types[p]))
-                break;
-        if (cg_db->types[p] == NULL)
-            p = 0;              /* if there isn't a matching tree, use the first one */
-
-        /* Predict F0 */
-        f0_tree = cg_db->f0_trees[p];
-        f0_val = val_float(cart_interpret(mcep, f0_tree));
-        param_track->frames[i][0] = f0_val;
-        /* what about stddev ? */
-
-        /* We only have multiple models now, but the default is one model */
-        /* Predict spectral coeffs */
-        voicing = 0.0;
-        for (pm = 0; pm < cg_db->num_param_models; pm++)
-        {
-            mcep_tree = cg_db->param_trees[pm][p];
-            f = val_int(cart_interpret(mcep, mcep_tree));
-            /* If there is one model this will be fine, if there are */
-            /* multiple models this will be the nth model */
-            item_set_int(mcep, "clustergen_param_frame", f);
-
-            /* Old code used to average in param[0] with F0 too (???) */
-
-            for (j = 2; j < param_track->num_channels; j++)
-            {
-                if (pm == 0)
-                    param_track->frames[i][j] = 0.0;
-                param_track->frames[i][j] +=
-                    CG_MODEL_VECTOR(cg_db, model_vectors[pm], f, (j) * fff) /
-                    (float) cg_db->num_param_models;
-            }
-
-            if (cg_db->mixed_excitation)
-            {
-                o = j;
-                for (j = 0; j < 5; j++)
-                {
-                    if (pm == 0)
-                        str_track->frames[i][j] = 0.0;
-                    str_track->frames[i][j] +=
-                        CG_MODEL_VECTOR(cg_db, model_vectors[pm], f,
-                                        (o +
-                                         (2 * j)) * fff) /
-                        (float) cg_db->num_param_models;
-                }
-            }
-
-            /* last coefficient is average voicing for cluster */
-            voicing /= (float) (pm + 1);
-            voicing +=
-                CG_MODEL_VECTOR(cg_db, model_vectors[pm], f,
-                                cg_db->num_channels[pm] - 2) / (float) (pm +
-                                                                        1);
-        }
-        item_set_float(mcep, "voicing", voicing);
-        /* Apply local gain to c0 */
-        param_track->frames[i][2] *= local_gain;
-
-        param_track->times[i] = i * cg_db->frame_advance;
-    }
+    if (sp)
+        cg_splice_predict(sp, fr, cg_db, fff, param_track, str_track);
+    else
+        for (i = 0; i < fr->num_frames; i++)
+            cg_predict_frame(cg_db, fr, i, fff, param_track, str_track);
 
-    cg_smooth_F0(utt, cg_db, param_track);
+    cg_smooth_F0(utt, fr, cg_db, param_track);
 
     utt_set_feat(utt, "param_track", track_val(param_track));
     if (cg_db->mixed_excitation)
@@ -606,7 +1200,7 @@ static cst_utterance *cg_predict_params(cst_utterance *utt)
     return utt;
 }
 
-static cst_utterance *cg_resynth(cst_utterance *utt)
+static cst_utterance *cg_resynth(cst_utterance *utt, cg_splice *sp)
 {
     cst_cg_db *cg_db;
     cst_wave *w;
@@ -615,6 +1209,15 @@ static cst_utterance *cg_resynth(cst_utterance *utt)
     cst_track *smoothed_track;
     const cst_val *streaming_info_val;
     cst_audio_streaming_info *asi = NULL;
+    unsigned long noise_seed;
+    double start;
+
+    /* The synthesis pipeline seeds each utterance in order, so the */
+    /* noise doesn't depend on which thread gets to it first        */
+    if (feat_present(utt->features, "noise_seed"))
+        noise_seed = (unsigned long) utt_feat_int(utt, "noise_seed");
+    else
+        noise_seed = (unsigned long) rand();
 
     streaming_info_val = get_param_val(utt->features, "streaming_info", NULL);
     if (streaming_info_val)
@@ -630,12 +1233,29 @@ static cst_utterance *cg_resynth(cst_utterance *utt)
 
     if (cg_db->do_mlpg)
     {
-        smoothed_track = mlpg(param_track, cg_db);
-        w = mlsa_resynthesis(smoothed_track, str_track, cg_db, asi);
+        start = cst_stats_start();
+        if (sp && sp->hits > 0)
+            smoothed_track = cg_splice_mlpg(sp, param_track, cg_db);
+        else
+            smoothed_track = mlpg(param_track, cg_db);
+        if (sp)
+            cg_splice_store(sp, cg_db, smoothed_track);
+        cst_stats_end("cg_mlpg", start);
+        start = cst_stats_start();
+        w = mlsa_resynthesis_seed(smoothed_track, str_track, cg_db, asi,
+                                  noise_seed);
+        cst_stats_end("cg_mlsa_resynthesis", start);
         delete_track(smoothed_track);
     }
     else
-        w = mlsa_resynthesis(param_track, str_track, cg_db, asi);
+    {
+        if (sp)
+            cg_splice_store(sp, cg_db, NULL);
+        start = cst_stats_start();
+        w = mlsa_resynthesis_seed(param_track, str_track, cg_db, asi,
+                                  noise_seed);
+        cst_stats_end("cg_mlsa_resynthesis", start);
+    }
 
     if (w == NULL)
     {
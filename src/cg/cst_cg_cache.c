@@ -0,0 +1,334 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*  Phrase level cache of predicted CG parameter frames                  */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Templated prompts repeat whole phrases ("your balance is",           */
+/*  "press one") around a few variable words.  cg_synth() cuts the       */
+/*  frames of an utterance at its phrase breaks and asks this cache for  */
+/*  each span, by a key naming the phrase's states, their frame counts,  */
+/*  the segment features the trees ask about and a hash of the           */
+/*  neighbouring segments.  A span holds the predicted frames before F0  */
+/*  smoothing, the strengths, voicing and the mlpg output, so a hit      */
+/*  skips both the tree walks and the trajectory solve for the span.     */
+/*                                                                       */
+/*  Spans are copied in and out under a mutex, nothing is shared with    */
+/*  the utterance.  Entries are evicted least recently used first under  */
+/*  a byte limit.                                                        */
+/*                                                                       */
+/*************************************************************************/
+
+#include <string.h>
+#include "cst_alloc.h"
+#include "cst_string.h"
+#include "cst_cg.h"
+#include "cst_cg_cache.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#define CG_CACHE_BUCKETS 1024
+
+typedef struct cg_cache_entry_struct {
+    char *key;
+    int key_len;
+    unsigned int hash;
+    const cst_cg_db *cg_db;
+    cg_span *span;
+    long bytes;
+    struct cg_cache_entry_struct *hnext;
+    struct cg_cache_entry_struct *prev, *next;  /* LRU, head is newest */
+} cg_cache_entry;
+
+struct cst_cg_param_cache_struct {
+    long max_bytes;
+    cg_cache_entry *buckets[CG_CACHE_BUCKETS];
+    cg_cache_entry *head, *tail;
+    cst_cg_param_cache_stats stats;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_t lock;
+#endif
+};
+
+CST_VAL_REGISTER_TYPE_NODEL(cg_param_cache, cst_cg_param_cache);
+
+static void cgc_lock(cst_cg_param_cache *c)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&c->lock);
+#endif
+}
+
+static void cgc_unlock(cst_cg_param_cache *c)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&c->lock);
+#endif
+}
+
+cg_span *new_cg_span(int num_frames, int num_params, int num_str,
+                     int num_smoothed)
+{
+    cg_span *s = cst_alloc(cg_span, 1);
+
+    s->num_frames = num_frames;
+    s->num_params = num_params;
+    s->num_str = num_str;
+    s->num_smoothed = num_smoothed;
+    s->params = cst_alloc(float, num_frames *
+                          (num_params + num_str + num_smoothed + 1));
+    s->str = s->params + (num_frames * num_params);
+    s->smoothed = s->str + (num_frames * num_str);
+    s->voicing = s->smoothed + (num_frames * num_smoothed);
+    s->param_frame = cst_alloc(int, num_frames);
+
+    return s;
+}
+
+void delete_cg_span(cg_span *s)
+{
+    if (s == NULL)
+        return;
+    cst_free(s->params);
+    cst_free(s->param_frame);
+    cst_free(s);
+}
+
+static long cg_span_bytes(const cg_span *s)
+{
+    return sizeof(cg_span) + s->num_frames *
+        (sizeof(int) + sizeof(float) *
+         (s->num_params + s->num_str + s->num_smoothed + 1));
+}
+
+static cg_span *copy_cg_span(const cg_span *s)
+{
+    cg_span *n;
+
+    n = new_cg_span(s->num_frames, s->num_params, s->num_str,
+                    s->num_smoothed);
+    memmove(n->params, s->params, sizeof(float) * s->num_frames *
+            (s->num_params + s->num_str + s->num_smoothed + 1));
+    memmove(n->param_frame, s->param_frame, sizeof(int) * s->num_frames);
+
+    return n;
+}
+
+cst_cg_param_cache *new_cg_param_cache(long max_bytes)
+{
+    cst_cg_param_cache *c = cst_alloc(cst_cg_param_cache, 1);
+
+    c->max_bytes = max_bytes;
+    c->stats.max_bytes = max_bytes;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_init(&c->lock, NULL);
+#endif
+
+    return c;
+}
+
+static void delete_cg_cache_entry(cg_cache_entry *e)
+{
+    delete_cg_span(e->span);
+    cst_free(e->key);
+    cst_free(e);
+}
+
+static void cgc_lru_unlink(cst_cg_param_cache *c, cg_cache_entry *e)
+{
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        c->head = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        c->tail = e->prev;
+}
+
+static void cgc_push_front(cst_cg_param_cache *c, cg_cache_entry *e)
+{
+    e->prev = NULL;
+    e->next = c->head;
+    if (c->head)
+        c->head->prev = e;
+    else
+        c->tail = e;
+    c->head = e;
+}
+
+static void cgc_remove(cst_cg_param_cache *c, cg_cache_entry *e)
+{
+    cg_cache_entry **h;
+
+    for (h = &c->buckets[e->hash & (CG_CACHE_BUCKETS - 1)]; *h != e;
+         h = &(*h)->hnext);
+    *h = e->hnext;
+    cgc_lru_unlink(c, e);
+    c->stats.bytes -= e->bytes;
+    c->stats.entries--;
+    delete_cg_cache_entry(e);
+}
+
+static unsigned int cgc_hash(const char *key, int len)
+{
+    unsigned int h = 2166136261u;
+    int i;
+
+    for (i = 0; i < len; i++)
+        h = (h ^ (unsigned char) key[i]) * 16777619u;
+    return h;
+}
+
+static cg_cache_entry *cgc_find(cst_cg_param_cache *c,
+                                const cst_cg_db *cg_db, const char *key,
+                                int key_len, unsigned int hash)
+{
+    cg_cache_entry *e;
+
+    for (e = c->buckets[hash & (CG_CACHE_BUCKETS - 1)]; e; e = e->hnext)
+        if (e->hash == hash && e->cg_db == cg_db && e->key_len == key_len
+            && memcmp(e->key, key, key_len) == 0)
+            return e;
+    return NULL;
+}
+
+void cg_param_cache_clear(cst_cg_param_cache *c)
+{
+    cg_cache_entry *e, *n;
+
+    cgc_lock(c);
+    for (e = c->head; e; e = n)
+    {
+        n = e->next;
+        delete_cg_cache_entry(e);
+    }
+    memset(c->buckets, 0, sizeof(c->buckets));
+    c->head = c->tail = NULL;
+    c->stats.entries = 0;
+    c->stats.bytes = 0;
+    cgc_unlock(c);
+}
+
+void delete_cg_param_cache(cst_cg_param_cache *c)
+{
+    if (c == NULL)
+        return;
+    cg_param_cache_clear(c);
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_destroy(&c->lock);
+#endif
+    cst_free(c);
+}
+
+void cg_param_cache_get_stats(cst_cg_param_cache *c,
+                              cst_cg_param_cache_stats *stats)
+{
+    cgc_lock(c);
+    *stats = c->stats;
+    cgc_unlock(c);
+}
+
+cg_span *cg_param_cache_get(cst_cg_param_cache *c, const cst_cg_db *cg_db,
+                            const char *key)
+{
+    cg_cache_entry *e;
+    cg_span *s = NULL;
+    int key_len = cst_strlen(key);
+    unsigned int hash = cgc_hash(key, key_len);
+
+    cgc_lock(c);
+    e = cgc_find(c, cg_db, key, key_len, hash);
+    if (e)
+    {
+        cgc_lru_unlink(c, e);
+        cgc_push_front(c, e);
+        s = copy_cg_span(e->span);
+        c->stats.hits++;
+    }
+    else
+        c->stats.misses++;
+    cgc_unlock(c);
+
+    return s;
+}
+
+void cg_param_cache_put(cst_cg_param_cache *c, const cst_cg_db *cg_db,
+                        const char *key, const cg_span *s)
+{
+    cg_cache_entry *e;
+    int key_len = cst_strlen(key);
+    unsigned int hash = cgc_hash(key, key_len);
+    long bytes = cg_span_bytes(s) + key_len;
+
+    if (bytes > c->max_bytes)
+        return;
+
+    e = cst_alloc(cg_cache_entry, 1);
+    e->key = cst_strdup(key);
+    e->key_len = key_len;
+    e->hash = hash;
+    e->cg_db = cg_db;
+    e->span = copy_cg_span(s);
+    e->bytes = bytes;
+
+    cgc_lock(c);
+    /* Another thread may have got there first, the newer one wins */
+    if (cgc_find(c, cg_db, key, key_len, hash))
+        cgc_remove(c, cgc_find(c, cg_db, key, key_len, hash));
+    e->hnext = c->buckets[hash & (CG_CACHE_BUCKETS - 1)];
+    c->buckets[hash & (CG_CACHE_BUCKETS - 1)] = e;
+    cgc_push_front(c, e);
+    c->stats.bytes += bytes;
+    c->stats.entries++;
+    c->stats.stores++;
+    while (c->stats.bytes > c->max_bytes && c->tail != e)
+    {
+        cgc_remove(c, c->tail);
+        c->stats.evictions++;
+    }
+    cgc_unlock(c);
+}
+
+void cg_param_cache_count_frames(cst_cg_param_cache *c, long reused,
+                                 long predicted)
+{
+    cgc_lock(c);
+    c->stats.frames_reused += reused;
+    c->stats.frames_predicted += predicted;
+    cgc_unlock(c);
+}
@@ -0,0 +1,68 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*  Phrase spans shared between cst_cg.c and cst_cg_cache.c              */
+/*                                                                       */
+/*************************************************************************/
+#ifndef _CST_CG_CACHE_H__
+#define _CST_CG_CACHE_H__
+
+#include "cst_cg.h"
+
+/* The frames of one phrase, rows packed one after the other */
+typedef struct cg_span_struct {
+    int num_frames;
+    int num_params;             /* param_track channels */
+    int num_str;                /* 0 without mixed excitation */
+    int num_smoothed;           /* mlpg channels less F0, 0 without mlpg */
+    float *params;              /* as predicted, before F0 smoothing */
+    float *str;
+    float *smoothed;
+    float *voicing;
+    int *param_frame;           /* clustergen_param_frame */
+} cg_span;
+
+cg_span *new_cg_span(int num_frames, int num_params, int num_str,
+                     int num_smoothed);
+void delete_cg_span(cg_span *s);
+
+/* Returns a copy the caller deletes, or NULL */
+cg_span *cg_param_cache_get(cst_cg_param_cache *c, const cst_cg_db *cg_db,
+                            const char *key);
+void cg_param_cache_put(cst_cg_param_cache *c, const cst_cg_db *cg_db,
+                        const char *key, const cg_span *s);
+void cg_param_cache_count_frames(cst_cg_param_cache *c, long reused,
+                                 long predicted);
+
+#endif
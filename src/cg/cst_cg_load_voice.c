@@ -145,6 +145,7 @@ cst_voice *cst_cg_load_voice(const char *filename,
 
     /* Waveform synthesis */
     mimic_feat_set(vox->features, "wave_synth_func", uttfunc_val(&cg_synth));
+    mimic_feat_set(vox->features, "alignment_func", uttfunc_val(&cg_durations));
     mimic_feat_set(vox->features, "cg_db", cg_db_val(cg_db));
     mimic_feat_set_int(vox->features, "sample_rate", cg_db->sample_rate);
 
@@ -94,6 +94,7 @@
 #define mlpg_alloc(X,Y) (cst_alloc(Y,X))
 #define mlpg_free cst_free
 
+#if 0
 static MLPGPARA xmlpgpara_init(int dim, int dim2, int dnum, int clsnum)
 {
     MLPGPARA param;
@@ -354,7 +355,7 @@ static void get_dltmat(DMATRIX mat, DWin * dw, int dno, DMATRIX dmat)
 
     return;
 }
-
+#endif
 
 static double *dcalloc(int x, int xoff)
 {
@@ -458,6 +459,7 @@ static void InitPStreamChol(PStreamChol * pst, const float *dynwin, int fsize,
     return;
 }
 
+#if 0
 static void mlgparaChol(DMATRIX pdf, PStreamChol * pst, DMATRIX mlgp)
 {
     int t, d;
@@ -489,6 +491,7 @@ static void mlgparaChol(DMATRIX pdf, PStreamChol * pst, DMATRIX mlgp)
 
     return;
 }
+#endif
 
 // generate parameter sequence from pdf sequence using Choleski decomposition
 static void mlpgChol(PStreamChol * pst)
@@ -789,7 +792,6 @@ static void calc_vargrad(PStreamChol * pst, const int m, double alpha,
 
     return;
 }
-#endif
 
 // diagonal covariance
 static DVECTOR xget_detvec_diamat2inv(DMATRIX covmat)   // [num class][dim]
@@ -936,6 +938,7 @@ static double get_gauss_dia(long clsidx, DVECTOR vec,   // [dim]
 
     return gauss;
 }
+#endif
 
 static void pst_free(PStreamChol * pst)
 {
@@ -973,12 +976,14 @@ static void pst_free(PStreamChol * pst)
 cst_track *mlpg(const cst_track *param_track, cst_cg_db *cg_db)
 {
     /* Generate an (mcep) track using Maximum Likelihood Parameter Generation */
-    MLPGPARA param = NODATA;
+    /* The means and stddevs go straight from the track into the stream's  */
+    /* U^{-1}*M and U^{-1}, and the answer straight into the output track   */
     cst_track *out;
     int dim, dim_st;
-    //    float like;
     int i, j;
     int nframes;
+    float sd;
+    double ivar;
     PStreamChol pst;
 
     nframes = param_track->num_frames;
@@ -987,64 +992,44 @@ cst_track *mlpg(const cst_track *param_track, cst_cg_db *cg_db)
     out = new_track();
     cst_track_resize(out, nframes, dim_st + 1);
 
-    param = xmlpgpara_init(dim, dim_st, nframes, nframes);
-
-    // mixture-index sequence
-    param->clsidxv = xlvalloc(nframes);
-    for (i = 0; i < nframes; i++)
-        param->clsidxv->data[i] = i;
-
-    // initial static feature sequence
-    param->stm = xdmalloc(nframes, dim_st);
-    for (i = 0; i < nframes; i++)
+    InitPStreamChol(&pst, cg_db->dynwin, cg_db->dynwinsize, dim_st - 1,
+                    nframes);
+    if (pst.vSize != dim)
     {
-        for (j = 0; j < dim_st; j++)
-            param->stm->data[i][j] = param_track->frames[i][(j + 1) * 2];
+        cst_errmsg("Error mlpg: Different dimension\n");
+        cst_error();
     }
 
-    /* Load cluster means */
-    for (i = 0; i < nframes; i++)
-        for (j = 0; j < dim_st; j++)
-            param->mean->data[i][j] = param_track->frames[i][(j + 1) * 2];
-
     /* GMM parameters diagonal covariance */
-    InitPStreamChol(&pst, cg_db->dynwin, cg_db->dynwinsize, dim_st - 1,
-                    nframes);
-    param->pdf = xdmalloc(nframes, dim * 2);
-    param->cov = xdmalloc(nframes, dim);
     for (i = 0; i < nframes; i++)
         for (j = 0; j < dim; j++)
-            param->cov->data[i][j] =
-                param_track->frames[i][(j + 1) * 2 +
-                                       1] * param_track->frames[i][(j +
-                                                                    1) * 2 +
-                                                                   1];
-    param->detvec = xget_detvec_diamat2inv(param->cov);
+        {
+            sd = cst_track_val(param_track, i, ((j + 1) * 2) + 1);
+            if (sd * sd <= 0.0)
+            {
+                cst_errmsg("error:(class %d) variance <= 0\n", i);
+                cst_error();
+            }
+            ivar = 1.0 / (sd * sd);
+            pst.mseq[i][j] =
+                ivar * cst_track_val(param_track, i, (j + 1) * 2);
+            pst.ivseq[i][j] = ivar;
+        }
 
     /* global variance parameters */
     /* TBD get_gv_mlpgpara(param, vmfile, vvfile, dim2, msg_flag); */
 
-    get_dltmat(param->stm, &pst.dw, 1, param->dltm);
-
-    //like = 
-    get_like_pdfseq_vit(dim, dim_st, nframes, nframes, param,
-                        param_track->frames, XTRUE);
-
-    /* vlike = get_like_gv(dim2, dnum, param); */
-
-    mlgparaChol(param->pdf, &pst, param->stm);
+    mlpgChol(&pst);
 
     /* Put the answer back into the output track */
     for (i = 0; i < nframes; i++)
     {
         out->times[i] = param_track->times[i];
-        out->frames[i][0] = param_track->frames[i][0];  /* F0 */
+        out->frames[i][0] = cst_track_val(param_track, i, 0);   /* F0 */
         for (j = 0; j < dim_st; j++)
-            out->frames[i][j + 1] = param->stm->data[i][j];
+            out->frames[i][j + 1] = pst.c[i][j];
     }
 
-    // memory free
-    xmlpgparafree(param);
     pst_free(&pst);
 
     return out;
@@ -156,16 +156,16 @@ typedef struct MLPGPARA_STRUCT {
     DVECTOR var;
 } *MLPGPARA;
 
+#if 0
 static MLPGPARA xmlpgpara_init(int dim, int dim2, int dnum, int clsnum);
 static void xmlpgparafree(MLPGPARA param);
 static double get_like_pdfseq_vit(int dim, int dim2, int dnum, int clsnum,
                                   MLPGPARA param,
                                   float **model, XBOOL dia_flag);
-#if 0
 static double get_like_gv(long dim2, long dnum, MLPGPARA param);
 static void sm_mvav(DMATRIX mat, long hlen);
-#endif
 static void get_dltmat(DMATRIX mat, DWin * dw, int dno, DMATRIX dmat);
+#endif
 
 
 static double *dcalloc(int x, int xoff);
@@ -178,7 +178,6 @@ static double **ddcalloc(int x, int y, int xoff, int yoff);
 static void InitDWin(PStreamChol * pst, const float *dynwin, int fsize);
 static void InitPStreamChol(PStreamChol * pst, const float *dynwin, int fsize,
                             int order, int T);
-static void mlgparaChol(DMATRIX pdf, PStreamChol * pst, DMATRIX mlgp);
 static void mlpgChol(PStreamChol * pst);
 static void calc_R_and_r(PStreamChol * pst, const int m);
 static void Choleski(PStreamChol * pst);
@@ -216,8 +215,7 @@ static void calc_vargrad(PStreamChol * pst, const int m, double alpha,
 static double get_gauss_dia5(double det, double weight, DVECTOR vec,    // dim
                              DVECTOR meanvec,   // dim
                              DVECTOR invcovvec);        // dim
-#endif
-
+static void mlgparaChol(DMATRIX pdf, PStreamChol * pst, DMATRIX mlgp);
 static double get_gauss_full(long clsidx, DVECTOR vec,  // [dim]
                              DVECTOR detvec,    // [clsnum]
                              DMATRIX weightmat, // [clsnum][1]
@@ -230,8 +228,6 @@ static double get_gauss_dia(long clsidx, DVECTOR vec,   // [dim]
                             DMATRIX invcovmat); // [clsnum][dim]
 static double cal_xmcxmc(long clsidx, DVECTOR x, DMATRIX mm,    // [num class][dim]
                          DMATRIX cm);   // [num class * dim][dim]
-
-#if 0
 static void get_gv_mlpgpara(MLPGPARA param, char *vmfile, char *vvfile,
                             long dim2, XBOOL msg_flag);
 #endif
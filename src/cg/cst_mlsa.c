@@ -67,6 +67,9 @@
 #include "cst_cg.h"
 #include "cst_mlsa.h"
 
+/* Frames of samples buffered before writing to a streaming sink */
+#define CG_SINK_FRAMES 16
+
 /* Bellbird optimized mlsa routines */
 #include "../filter/bb_mlsacore.c"
 
@@ -74,13 +77,25 @@ static cst_wave *synthesis_body(const cst_track *params,
                                 const cst_track *str,
                                 double fs, double framem,
                                 cst_cg_db *cg_db,
-                                cst_audio_streaming_info *asi);
+                                cst_audio_streaming_info *asi,
+                                unsigned long noise_seed);
 
 cst_wave *mlsa_resynthesis(const cst_track *params,
                            const cst_track *str, cst_cg_db *cg_db,
                            cst_audio_streaming_info *asi)
 {
-    /* Resynthesizes a wave from given track */
+    /* The noise follows srand(), as it always has */
+    return mlsa_resynthesis_seed(params, str, cg_db, asi,
+                                 (unsigned long) rand());
+}
+
+cst_wave *mlsa_resynthesis_seed(const cst_track *params,
+                                const cst_track *str, cst_cg_db *cg_db,
+                                cst_audio_streaming_info *asi,
+                                unsigned long noise_seed)
+{
+    /* Resynthesizes a wave from given track, the excitation noise */
+    /* comes from its own generator started at noise_seed          */
     cst_wave *wave = 0;
     int sr = cg_db->sample_rate;
     double shift;
@@ -90,7 +105,7 @@ cst_wave *mlsa_resynthesis(const cst_track *params,
     else
         shift = 5.0;
 
-    wave = synthesis_body(params, str, sr, shift, cg_db, asi);
+    wave = synthesis_body(params, str, sr, shift, cg_db, asi, noise_seed);
 
     return wave;
 }
@@ -99,7 +114,8 @@ static cst_wave *synthesis_body(const cst_track *params,        /* f0 + mcep */
                                 const cst_track *str, double fs,        /* sampling frequency (Hz) */
                                 double framem,  /* frame size */
                                 cst_cg_db *cg_db,
-                                cst_audio_streaming_info *asi)
+                                cst_audio_streaming_info *asi,
+                                unsigned long noise_seed)
 {
     long t, pos;
     int framel, i;
@@ -111,24 +127,32 @@ static cst_wave *synthesis_body(const cst_track *params,        /* f0 + mcep */
     int rc = CST_AUDIO_STREAM_CONT;
     int num_mcep;
     double ffs = fs;
+    cst_audio_sink *sink;
 
     num_mcep = params->num_channels - 1;
     /* For SPEED_HACK we could reduce num_mcep, and it will run faster */
     /* num_mcep -= 10; */
     framel = (int) (0.5 + (framem * ffs / 1000.0));     /* 80 for 16KHz */
     init_vocoder(ffs, framel, num_mcep, &vs, cg_db);
+    vs.noise_next = noise_seed;
 
     if (str != NULL)
         vs.gauss = MFALSE;
 
     /* synthesize waveforms by MLSA filter */
+    /* When streaming to a sink the wave is only a small reusable buffer */
+    /* and the utterance gets an empty wave back                          */
+    sink = (asi && asi->sink) ? asi->sink : NULL;
     wave = new_wave();
-    if (cst_wave_resize(wave, params->num_frames * framel, 1) < 0)
+    if (cst_wave_resize(wave, (sink ? CG_SINK_FRAMES : params->num_frames)
+                        * framel, 1) < 0)
     {
         delete_wave(wave);
         return NULL;
     }
     wave->sample_rate = fs;
+    if (sink)
+        sink->sample_rate = fs;
 
     mcep = cst_alloc(double, num_mcep + 1);
 
@@ -146,16 +170,35 @@ static cst_wave *synthesis_body(const cst_track *params,        /* f0 + mcep */
         else
             vocoder(f0, mcep, NULL, num_mcep, cg_db, &vs, wave, &pos);
 
-        if (asi && (pos - stream_mark > asi->min_buffsize))
+        if (sink)
         {
+            if (pos + framel > wave->num_samples)
+            {
+                audio_stream_stats_chunk(asi);
+                rc = audio_sink_write(sink, wave->samples, pos, 0);
+                pos = 0;
+            }
+        }
+        else if (asi && (pos - stream_mark > asi->min_buffsize))
+        {
+            audio_stream_stats_chunk(asi);
             rc = (*asi->asc) (wave, stream_mark, pos - stream_mark, 0, asi);
             stream_mark = pos;
         }
     }
+
+    if (sink)
+    {
+        audio_stream_stats_chunk(asi);
+        if (rc == CST_AUDIO_STREAM_CONT)
+            audio_sink_write(sink, wave->samples, pos, 1);
+        pos = 0;
+    }
     wave->num_samples = pos;
 
-    if (asi && (rc == CST_AUDIO_STREAM_CONT))
+    if (!sink && asi && (rc == CST_AUDIO_STREAM_CONT))
     {                           /* drain the last part of the waveform */
+        audio_stream_stats_chunk(asi);
         (*asi->asc) (wave, stream_mark, pos - stream_mark, 1, asi);
     }
 
@@ -215,52 +258,111 @@ static void init_vocoder(double fs, int framel, int m, VocoderSetup *vs,
     // for MIXED EXCITATION
     vs->ME_order = cg_db->ME_order;
     vs->ME_num = cg_db->ME_num;
-    vs->hpulse = cst_alloc(double, vs->ME_order);
-    vs->hnoise = cst_alloc(double, vs->ME_order);
-    vs->xpulsesig = cst_alloc(double, vs->ME_order);
-    vs->xnoisesig = cst_alloc(double, vs->ME_order);
+    vs->me_taps = cst_alloc(double, 2 * vs->ME_order);
+    vs->me_hist = cst_alloc(double, 4 * vs->ME_order);
+    vs->me_pos = 0;
+    vs->me_noise = cst_alloc(double, framel);
     vs->h = cg_db->me_h;
 
     return;
 }
 
-static double plus_or_minus_one()
+static double plus_or_minus_one(VocoderSetup *vs)
 {
-    /* Randomly return 1 or -1 */
-    /* not sure rand() is portable */
-    if (rand() > RAND_MAX / 2.0)
+    /* Randomly return 1 or -1, from this synthesis' own generator so */
+    /* utterances on other threads don't change each other's noise    */
+    if (rnd(&vs->noise_next) > 0.5)
         return 1.0;
     else
         return -1.0;
 }
 
+/* The pulse and noise shaping filters run together.  The taps are   */
+/* interleaved pulse then noise, as are the histories, which are kept */
+/* twice over in a circular buffer so the last ME_order pairs always  */
+/* follow me_pos contiguously.  With SSE2 the pulse and noise sums    */
+/* are the two lanes, each added up in the same order as the scalar   */
+/* loop.                                                              */
+static void me_frame_taps(VocoderSetup *vs, const float *str)
+{
+    int i, j;
+    double hpulse, hnoise;
+
+    for (i = 0; i < vs->ME_order; i++)
+    {
+        hpulse = hnoise = 0.0;
+        for (j = 0; j < vs->ME_num; j++)
+        {
+            hpulse += str[j] * vs->h[j][i];
+            hnoise += (1 - str[j]) * vs->h[j][i];
+        }
+        vs->me_taps[2 * i] = hpulse;
+        vs->me_taps[(2 * i) + 1] = hnoise;
+    }
+}
+
+static double me_filter(VocoderSetup *vs, double xpulse, double xnoise)
+{
+    /* Excitation for this sample, the taps after the first are applied */
+    /* to the history from the sample before last back                   */
+    const double *h = vs->me_taps;
+    double *x = vs->me_hist + (2 * vs->me_pos);
+    int n = vs->ME_order;
+    int k;
+#ifdef MLSA_SSE2
+    __m128d sum = _mm_setzero_pd();
+    double s[2];
+
+    for (k = n - 1; k > 0; k--)
+        sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(h + (2 * k)),
+                                         _mm_loadu_pd(x + (2 * k))));
+    sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(h),
+                                     _mm_set_pd(xnoise, xpulse)));
+    _mm_storeu_pd(s, sum);
+#else
+    double s[2] = { 0.0, 0.0 };
+
+    for (k = n - 1; k > 0; k--)
+    {
+        s[0] += h[2 * k] * x[2 * k];
+        s[1] += h[(2 * k) + 1] * x[(2 * k) + 1];
+    }
+    s[0] += h[0] * xpulse;
+    s[1] += h[1] * xnoise;
+#endif
+
+    vs->me_pos = (vs->me_pos > 0) ? vs->me_pos - 1 : n - 1;
+    x = vs->me_hist + (2 * vs->me_pos);
+    x[0] = x[2 * n] = xpulse;
+    x[1] = x[(2 * n) + 1] = xnoise;
+
+    return s[0] + s[1];         /* excitation is pulse plus noise */
+}
+
+static void me_frame_noise(VocoderSetup *vs)
+{
+    /* Each sample of a mixed excitation frame takes one noise value */
+    int i;
+
+    for (i = 0; i < vs->fprd; i++)
+        vs->me_noise[i] = plus_or_minus_one(vs);
+}
+
 static void vocoder(double p, double *mc,
                     const float *str,
                     int m, cst_cg_db *cg_db, VocoderSetup *vs, cst_wave *wav,
                     long *pos)
 {
     double inc, x, e1, e2;
-    int i, j, k;
-    double xpulse, xnoise;
-    double fxpulse, fxnoise;
+    int i, j, k, s;
+    double xpulse = 0.0, xnoise = 0.0;
     float gain = 1.0;
 
     if (cg_db->gain != 0.0)
         gain = cg_db->gain;
 
     if (str != NULL)            /* MIXED-EXCITATION */
-    {
-        /* Copy in str's and build hpulse and hnoise for this frame */
-        for (i = 0; i < vs->ME_order; i++)
-        {
-            vs->hpulse[i] = vs->hnoise[i] = 0.0;
-            for (j = 0; j < vs->ME_num; j++)
-            {
-                vs->hpulse[i] += str[j] * vs->h[j][i];
-                vs->hnoise[i] += (1 - str[j]) * vs->h[j][i];
-            }
-        }
-    }
+        me_frame_taps(vs, str);
 
     if (p != 0.0)
         p = vs->rate / p;       /* f0 -> pitch */
@@ -317,19 +419,22 @@ static void vocoder(double p, double *mc,
         vs->p1 = 0.0;
     }
 
-    for (j = vs->fprd, i = (vs->iprd + 1) / 2; j--;)
+    if (str != NULL)
+        me_frame_noise(vs);
+
+    for (j = vs->fprd, s = 0, i = (vs->iprd + 1) / 2; j--; s++)
     {
         if (vs->p1 == 0.0)
         {
-            if (vs->gauss)
-                x = (double) nrandom(vs);
-            else
-                x = plus_or_minus_one();
             if (str != NULL)    /* MIXED EXCITATION */
             {
-                xnoise = x;
+                xnoise = vs->me_noise[s];
                 xpulse = 0.0;
             }
+            else if (vs->gauss)
+                x = (double) nrandom(vs);
+            else
+                x = plus_or_minus_one(vs);
         }
         else
         {
@@ -344,30 +449,14 @@ static void vocoder(double p, double *mc,
             if (str != NULL)    /* MIXED EXCITATION */
             {
                 xpulse = x;
-                xnoise = plus_or_minus_one();
+                xnoise = vs->me_noise[s];
             }
         }
 
         /* MIXED EXCITATION */
         /* The real work -- apply shaping filters to pulse and noise */
         if (str != NULL)
-        {
-            fxpulse = fxnoise = 0.0;
-            for (k = vs->ME_order - 1; k > 0; k--)
-            {
-                fxpulse += vs->hpulse[k] * vs->xpulsesig[k];
-                fxnoise += vs->hnoise[k] * vs->xnoisesig[k];
-
-                vs->xpulsesig[k] = vs->xpulsesig[k - 1];
-                vs->xnoisesig[k] = vs->xnoisesig[k - 1];
-            }
-            fxpulse += vs->hpulse[0] * xpulse;
-            fxnoise += vs->hnoise[0] * xnoise;
-            vs->xpulsesig[0] = xpulse;
-            vs->xnoisesig[0] = xnoise;
-
-            x = fxpulse + fxnoise;      /* excitation is pulse plus noise */
-        }
+            x = me_filter(vs, xpulse, xnoise);
 
         if (cg_db->sample_rate == 8000)
             /* 8KHz voices are too quiet: this is probably not general */
@@ -473,10 +562,9 @@ static void free_vocoder(VocoderSetup *vs)
     vs->cep = NULL;
     vs->ir = NULL;
 
-    cst_free(vs->hpulse);
-    cst_free(vs->hnoise);
-    cst_free(vs->xpulsesig);
-    cst_free(vs->xnoisesig);
+    cst_free(vs->me_taps);
+    cst_free(vs->me_hist);
+    cst_free(vs->me_noise);
 
 
     return;
@@ -76,6 +76,7 @@ typedef struct _VocoderSetup {
 
     int sw;
     double r1, r2, s;
+    unsigned long noise_next;   /* for the +1/-1 noise */
 
     /* for postfiltering */
     double *mc;
@@ -90,11 +91,10 @@ typedef struct _VocoderSetup {
     /* for MIXED EXCITATION */
     int ME_order;
     int ME_num;
-    double *hpulse;
-    double *hnoise;
-
-    double *xpulsesig;
-    double *xnoisesig;
+    double *me_taps;            /* this frame's pulse and noise taps */
+    double *me_hist;            /* pulse and noise histories */
+    int me_pos;
+    double *me_noise;           /* this frame's noise */
 
     const double *const *h;
 
@@ -106,6 +106,9 @@ static void vocoder(double p, double *mc,
                     const float *str,
                     int m, cst_cg_db *cg_db,
                     VocoderSetup *vs, cst_wave *wav, long *pos);
+static void me_frame_taps(VocoderSetup *vs, const float *str);
+static double me_filter(VocoderSetup *vs, double xpulse, double xnoise);
+static void me_frame_noise(VocoderSetup *vs);
 static double nrandom(VocoderSetup *vs);
 static double rnd(unsigned long *next);
 static unsigned long srnd(unsigned long seed);
@@ -53,6 +53,150 @@
 #define BELL_PORDER 5
 
 #define RANDMAX 32767
+
+// The recursion through mlsadf2()'s history terms runs the BELL_PORDER
+// Pade stages side by side, stage i in d2[k+i].  Each stage only depends
+// on itself, so they go in SIMD lanes where the cpu has them, with the
+// same operations in the same order as mlsadf2_stages_ref() so the
+// output is the same to the bit.  k steps from start to end through d2
+// and j through c, the new j is returned.  ptcache gathers the sums.
+typedef int (*mlsadf2_stages_fn)(double *d2, int start, int end,
+                                 const double a, const double *c, int j,
+                                 double *ptcache);
+
+static int mlsadf2_stages_ref(double *d2, int start, int end,
+                              const double a, const double *c, int j,
+                              double *ptcache)
+{
+   int k;
+
+   for (k=start; k<=end; k+=BELL_PORDER,j++) {
+      d2[k]   += a*(d2[k+BELL_PORDER]  -d2[k-BELL_PORDER]);
+      d2[k+1] += a*(d2[k+BELL_PORDER+1]-d2[k-BELL_PORDER+1]);
+      d2[k+2] += a*(d2[k+BELL_PORDER+2]-d2[k-BELL_PORDER+2]);
+      d2[k+3] += a*(d2[k+BELL_PORDER+3]-d2[k-BELL_PORDER+3]);
+      d2[k+4] += a*(d2[k+BELL_PORDER+4]-d2[k-BELL_PORDER+4]);
+      ptcache[0] += d2[k] * c[j];
+      ptcache[1] += d2[k+1]*c[j];
+      ptcache[2] += d2[k+2]*c[j];
+      ptcache[3] += d2[k+3]*c[j];
+      ptcache[4] += d2[k+4]*c[j];
+   }
+
+   return j;
+}
+
+#if defined(__SSE2__)
+// Tested from here on rather than __SSE2__, which <immintrin.h> below
+// can leave defined when it wasn't
+#define MLSA_SSE2
+#include <emmintrin.h>
+
+// Stages 0-1 and 2-3 in pairs, the last on its own.  The terms just
+// updated are carried in registers rather than read back from d2.
+static int mlsadf2_stages_sse2(double *d2, int start, int end,
+                               const double a, const double *c, int j,
+                               double *ptcache)
+{
+   const __m128d va = _mm_set1_pd(a);
+   __m128d p01, p23, q01, q23, cj;
+   double p4, q4;
+   int k;
+
+   if (start > end)
+      return j;
+   p01 = _mm_loadu_pd(ptcache);
+   p23 = _mm_loadu_pd(ptcache+2);
+   p4 = ptcache[4];
+   q01 = _mm_loadu_pd(&d2[start-BELL_PORDER]);
+   q23 = _mm_loadu_pd(&d2[start-BELL_PORDER+2]);
+   q4 = d2[start-BELL_PORDER+4];
+   for (k=start; k<=end; k+=BELL_PORDER,j++) {
+      cj = _mm_set1_pd(c[j]);
+      q01 = _mm_add_pd(_mm_loadu_pd(&d2[k]),
+                       _mm_mul_pd(va, _mm_sub_pd(_mm_loadu_pd(&d2[k+BELL_PORDER]), q01)));
+      q23 = _mm_add_pd(_mm_loadu_pd(&d2[k+2]),
+                       _mm_mul_pd(va, _mm_sub_pd(_mm_loadu_pd(&d2[k+BELL_PORDER+2]), q23)));
+      q4 = d2[k+4] + a*(d2[k+BELL_PORDER+4]-q4);
+      _mm_storeu_pd(&d2[k], q01);
+      _mm_storeu_pd(&d2[k+2], q23);
+      d2[k+4] = q4;
+      p01 = _mm_add_pd(p01, _mm_mul_pd(q01, cj));
+      p23 = _mm_add_pd(p23, _mm_mul_pd(q23, cj));
+      p4 += q4*c[j];
+   }
+   _mm_storeu_pd(ptcache, p01);
+   _mm_storeu_pd(ptcache+2, p23);
+   ptcache[4] = p4;
+
+   return j;
+}
+#endif // MLSA_SSE2
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MLSA_AVX_DISPATCH
+#include <immintrin.h>
+
+// Stages 0-3 together, chosen at run time on cpus with AVX
+__attribute__((target("avx")))
+static int mlsadf2_stages_avx(double *d2, int start, int end,
+                              const double a, const double *c, int j,
+                              double *ptcache)
+{
+   const __m256d va = _mm256_set1_pd(a);
+   __m256d p03, q03;
+   double p4, q4;
+   int k;
+
+   if (start > end)
+      return j;
+   p03 = _mm256_loadu_pd(ptcache);
+   p4 = ptcache[4];
+   q03 = _mm256_loadu_pd(&d2[start-BELL_PORDER]);
+   q4 = d2[start-BELL_PORDER+4];
+   for (k=start; k<=end; k+=BELL_PORDER,j++) {
+      q03 = _mm256_add_pd(_mm256_loadu_pd(&d2[k]),
+                          _mm256_mul_pd(va, _mm256_sub_pd(_mm256_loadu_pd(&d2[k+BELL_PORDER]), q03)));
+      q4 = d2[k+4] + a*(d2[k+BELL_PORDER+4]-q4);
+      _mm256_storeu_pd(&d2[k], q03);
+      d2[k+4] = q4;
+      p03 = _mm256_add_pd(p03, _mm256_mul_pd(q03, _mm256_set1_pd(c[j])));
+      p4 += q4*c[j];
+   }
+   _mm256_storeu_pd(ptcache, p03);
+   ptcache[4] = p4;
+
+   return j;
+}
+#endif // MLSA_AVX_DISPATCH
+
+#ifdef MLSA_AVX_DISPATCH
+// Asking the cpu is too slow for every sample, so it's done once at load
+// time, before any thread can be synthesizing.
+static mlsadf2_stages_fn mlsadf2_stages_chosen = mlsadf2_stages_ref;
+
+__attribute__((constructor)) static void mlsadf2_stages_init(void)
+{
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx"))
+      mlsadf2_stages_chosen = mlsadf2_stages_avx;
+#ifdef MLSA_SSE2
+   else
+      mlsadf2_stages_chosen = mlsadf2_stages_sse2;
+#endif
+}
+#endif // MLSA_AVX_DISPATCH
+
+static mlsadf2_stages_fn mlsadf2_stages_select(void)
+{
+#ifdef MLSA_AVX_DISPATCH
+   return mlsadf2_stages_chosen;
+#endif
+#ifdef MLSA_SSE2
+   return mlsadf2_stages_sse2;
+#endif
+   return mlsadf2_stages_ref;
+}
 static double mlsadf1(double x, const double *c, const double a,
                        double *d1, const double *ppade)
 {
@@ -95,6 +239,7 @@ static double mlsadf2(double x, const double *c, const int m, const double a,
    const double aa = 1 - a*a;
    double ptcache[BELL_PORDER]; // temp holding pt[] values to reduce recursiveness
    const int d2offset = *pd2offset;
+   const mlsadf2_stages_fn stages = mlsadf2_stages_select();
    int j,k;
 // default values for start and end of loops through history terms
 // set end of first loop
@@ -131,18 +276,7 @@ static double mlsadf2(double x, const double *c, const int m, const double a,
    d2[secelement+4] = aa*pt[4] + a*d2[secelement+4];
 
 // First part of loop through wrap around buffer
-   for (k=d2offset+2*BELL_PORDER; k<=offsetend1; k+=BELL_PORDER,j++) {
-      d2[k]   += a*(d2[k+BELL_PORDER]  -d2[k-BELL_PORDER]);
-      d2[k+1] += a*(d2[k+BELL_PORDER+1]-d2[k-BELL_PORDER+1]);
-      d2[k+2] += a*(d2[k+BELL_PORDER+2]-d2[k-BELL_PORDER+2]);
-      d2[k+3] += a*(d2[k+BELL_PORDER+3]-d2[k-BELL_PORDER+3]);
-      d2[k+4] += a*(d2[k+BELL_PORDER+4]-d2[k-BELL_PORDER+4]);
-      ptcache[0] += d2[k] * c[j];
-      ptcache[1] += d2[k+1]*c[j];
-      ptcache[2] += d2[k+2]*c[j];
-      ptcache[3] += d2[k+3]*c[j];
-      ptcache[4] += d2[k+4]*c[j];
-   }
+   j = stages(d2, d2offset+2*BELL_PORDER, offsetend1, a, c, j, ptcache);
 
 // Update 'ghost' edge element of stencil d2[0]
    d2[0] = d2[BELL_PORDER*(m+2)];
@@ -152,18 +286,7 @@ static double mlsadf2(double x, const double *c, const int m, const double a,
    d2[4] = d2[BELL_PORDER*(m+2)+4];
 
 // Second part of loop through wrap around buffer
-   for (k=offsetstart2; k<=offsetend2; k+=BELL_PORDER,j++) {
-      d2[k]   += a*(d2[k+BELL_PORDER]  -d2[k-BELL_PORDER]);
-      d2[k+1] += a*(d2[k+BELL_PORDER+1]-d2[k-BELL_PORDER+1]);
-      d2[k+2] += a*(d2[k+BELL_PORDER+2]-d2[k-BELL_PORDER+2]);
-      d2[k+3] += a*(d2[k+BELL_PORDER+3]-d2[k-BELL_PORDER+3]);
-      d2[k+4] += a*(d2[k+BELL_PORDER+4]-d2[k-BELL_PORDER+4]);
-      ptcache[0] += d2[k] * c[j];
-      ptcache[1] += d2[k+1]*c[j];
-      ptcache[2] += d2[k+2]*c[j];
-      ptcache[3] += d2[k+3]*c[j];
-      ptcache[4] += d2[k+4]*c[j];
-   }
+   j = stages(d2, offsetstart2, offsetend2, a, c, j, ptcache);
 
 // Copy element which is not shuffled in usual implement. of this function
    d2[d2offset]   = d2[secelement];
@@ -47,6 +47,8 @@
 #include "cst_synth.h"
 #include "cst_utt_utils.h"
 #include <math.h>
+#include <limits.h>
+#include <stddef.h>
 #include "cst_file.h"
 #include "cst_val.h"
 #include "cst_string.h"
@@ -80,221 +82,469 @@ void delete_flitehtsengine(Flite_HTS_Engine * f)
 #else /* HAVE_HTSENGINE */
 
 
-#define MAXBUFLEN 1024
-
 CST_VAL_REGISTER_TYPE(flitehtsengine, Flite_HTS_Engine);
 
-/* create_label: create label per phoneme */
-static void create_label(cst_item *item, char *label)
+/* The context of a segment for the HTS models: the fields of its full */
+/* context label, filled in by one pass over the utterance.  Integers  */
+/* are HTS_LABEL_XX where the label has "xx".  The label string itself */
+/* is only made by the HTS engine, if anything asks for it.            */
+#define HTS_LABEL_XX INT_MIN
+
+typedef struct hts_label_struct {
+    const char *p1, *p2, *p3, *p4, *p5;
+    int p6, p7;
+    const char *a1, *a2;
+    int a3;
+    int b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11, b12, b13, b14, b15;
+    const char *b16;
+    const char *c1, *c2;
+    int c3;
+    const char *d1;
+    int d2;
+    const char *e1;
+    int e2, e3, e4, e5, e6, e7, e8;
+    const char *f1;
+    int f2;
+    int g1, g2;
+    int h1, h2, h3, h4;
+    const char *h5;
+    int i1, i2;
+    int j1, j2, j3;
+} hts_label;
+
+/* The fields in label order, with the text before each of them */
+static const struct hts_label_field_struct {
+    const char *delimiter;
+    size_t offset;
+    int is_int;
+} hts_label_fields[] = {
+    {"", offsetof(hts_label, p1), 0},
+    {"^", offsetof(hts_label, p2), 0},
+    {"-", offsetof(hts_label, p3), 0},
+    {"+", offsetof(hts_label, p4), 0},
+    {"=", offsetof(hts_label, p5), 0},
+    {"@", offsetof(hts_label, p6), 1},
+    {"_", offsetof(hts_label, p7), 1},
+    {"/A:", offsetof(hts_label, a1), 0},
+    {"_", offsetof(hts_label, a2), 0},
+    {"_", offsetof(hts_label, a3), 1},
+    {"/B:", offsetof(hts_label, b1), 1},
+    {"-", offsetof(hts_label, b2), 1},
+    {"-", offsetof(hts_label, b3), 1},
+    {"@", offsetof(hts_label, b4), 1},
+    {"-", offsetof(hts_label, b5), 1},
+    {"&", offsetof(hts_label, b6), 1},
+    {"-", offsetof(hts_label, b7), 1},
+    {"#", offsetof(hts_label, b8), 1},
+    {"-", offsetof(hts_label, b9), 1},
+    {"$", offsetof(hts_label, b10), 1},
+    {"-", offsetof(hts_label, b11), 1},
+    {"!", offsetof(hts_label, b12), 1},
+    {"-", offsetof(hts_label, b13), 1},
+    {";", offsetof(hts_label, b14), 1},
+    {"-", offsetof(hts_label, b15), 1},
+    {"|", offsetof(hts_label, b16), 0},
+    {"/C:", offsetof(hts_label, c1), 0},
+    {"+", offsetof(hts_label, c2), 0},
+    {"+", offsetof(hts_label, c3), 1},
+    {"/D:", offsetof(hts_label, d1), 0},
+    {"_", offsetof(hts_label, d2), 1},
+    {"/E:", offsetof(hts_label, e1), 0},
+    {"+", offsetof(hts_label, e2), 1},
+    {"@", offsetof(hts_label, e3), 1},
+    {"+", offsetof(hts_label, e4), 1},
+    {"&", offsetof(hts_label, e5), 1},
+    {"+", offsetof(hts_label, e6), 1},
+    {"#", offsetof(hts_label, e7), 1},
+    {"+", offsetof(hts_label, e8), 1},
+    {"/F:", offsetof(hts_label, f1), 0},
+    {"_", offsetof(hts_label, f2), 1},
+    {"/G:", offsetof(hts_label, g1), 1},
+    {"_", offsetof(hts_label, g2), 1},
+    {"/H:", offsetof(hts_label, h1), 1},
+    {"=", offsetof(hts_label, h2), 1},
+    {"^", offsetof(hts_label, h3), 1},
+    {"=", offsetof(hts_label, h4), 1},
+    {"|", offsetof(hts_label, h5), 0},
+    {"/I:", offsetof(hts_label, i1), 1},
+    {"=", offsetof(hts_label, i2), 1},
+    {"/J:", offsetof(hts_label, j1), 1},
+    {"+", offsetof(hts_label, j2), 1},
+    {"-", offsetof(hts_label, j3), 1}
+};
+
+#define HTS_LABEL_NUM_FIELDS \
+    (sizeof(hts_label_fields) / sizeof(hts_label_fields[0]))
+#define HTS_LABEL_INT_LEN 12    /* enough for any int */
+
+/* Features of a syllable, word or phrase, worked out once and used for */
+/* each segment that needs them.  The last few of each are kept, which  */
+/* covers the previous, current and next ones as the segments go by.   */
+#define HTS_CONTEXT_CACHE 4
+
+typedef struct hts_syl_struct {
+    const cst_item *item;
+    const char *stress, *accented, *vowel;
+    int stress_n, accented_n, numphones, pos_in_word;
+    int syl_in, syl_out, ssyl_in, ssyl_out, asyl_in, asyl_out;
+    int p_stress, n_stress, p_accent, n_accent, sub_phrases;
+} hts_syl;
+
+typedef struct hts_word_struct {
+    const cst_item *item;
+    const char *gpos;
+    int numsyls, pos_in_phrase, content_in, content_out;
+    int p_content, n_content;
+} hts_word;
+
+typedef struct hts_phrase_struct {
+    const cst_item *item;
+    const char *endtone;
+    int num_syls, num_words, total_syls, total_words, total_phrases;
+} hts_phrase;
+
+typedef struct hts_context_struct {
+    hts_syl syl[HTS_CONTEXT_CACHE];
+    hts_word word[HTS_CONTEXT_CACHE];
+    hts_phrase phrase[HTS_CONTEXT_CACHE];
+    int next_syl, next_word, next_phrase;
+} hts_context;
+
+/* What the features are where the path to the item finds nothing */
+static const hts_syl hts_no_syl = {
+    NULL, "0", "0", "0", 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+static const hts_word hts_no_word = { NULL, "0", 0, 0, 0, 0, 0, 0 };
+static const hts_phrase hts_no_phrase = { NULL, "0", 0, 0, 0, 0, 0 };
+
+static const hts_syl *hts_syl_info(hts_context *c, const cst_item *s)
 {
-    const char *p1 = ffeature_string(item, "p.p.name");
-    const char *p2 = ffeature_string(item, "p.name");
-    const char *p3 = ffeature_string(item, "name");
-    const char *p4 = ffeature_string(item, "n.name");
-    const char *p5 = ffeature_string(item, "n.n.name");
+    hts_syl *r;
+    int i;
+
+    if (s == NULL)
+        return &hts_no_syl;
+    for (i = 0; i < HTS_CONTEXT_CACHE; i++)
+        if (c->syl[i].item == s)
+            return &c->syl[i];
+    r = &c->syl[c->next_syl];
+    c->next_syl = (c->next_syl + 1) % HTS_CONTEXT_CACHE;
+
+    r->item = s;
+    r->stress = ffeature_string(s, "stress");
+    r->stress_n = ffeature_int(s, "stress");
+    r->accented = ffeature_string(s, "accented");
+    r->accented_n = ffeature_int(s, "accented");
+    r->vowel = ffeature_string(s, "syl_vowel");
+    r->numphones = ffeature_int(s, "syl_numphones");
+    r->pos_in_word = ffeature_int(s, "pos_in_word");
+    r->syl_in = ffeature_int(s, "syl_in");
+    r->syl_out = ffeature_int(s, "syl_out");
+    r->ssyl_in = ffeature_int(s, "ssyl_in");
+    r->ssyl_out = ffeature_int(s, "ssyl_out");
+    r->asyl_in = ffeature_int(s, "asyl_in");
+    r->asyl_out = ffeature_int(s, "asyl_out");
+    r->p_stress = ffeature_int(s, "lisp_distance_to_p_stress");
+    r->n_stress = ffeature_int(s, "lisp_distance_to_n_stress");
+    r->p_accent = ffeature_int(s, "lisp_distance_to_p_accent");
+    r->n_accent = ffeature_int(s, "lisp_distance_to_n_accent");
+    r->sub_phrases = ffeature_int(s, "sub_phrases");
+
+    return r;
+}
 
-    if (strcmp(p3, "pau") == 0)
+static const hts_word *hts_word_info(hts_context *c, const cst_item *w)
+{
+    hts_word *r;
+    int i;
+
+    if (w == NULL)
+        return &hts_no_word;
+    for (i = 0; i < HTS_CONTEXT_CACHE; i++)
+        if (c->word[i].item == w)
+            return &c->word[i];
+    r = &c->word[c->next_word];
+    c->next_word = (c->next_word + 1) % HTS_CONTEXT_CACHE;
+
+    r->item = w;
+    r->gpos = ffeature_string(w, "gpos");
+    r->numsyls = ffeature_int(w, "word_numsyls");
+    r->pos_in_phrase = ffeature_int(w, "pos_in_phrase");
+    r->content_in = ffeature_int(w, "content_words_in");
+    r->content_out = ffeature_int(w, "content_words_out");
+    r->p_content = ffeature_int(w, "lisp_distance_to_p_content");
+    r->n_content = ffeature_int(w, "lisp_distance_to_n_content");
+
+    return r;
+}
+
+static const hts_phrase *hts_phrase_info(hts_context *c, const cst_item *p)
+{
+    hts_phrase *r;
+    int i;
+
+    if (p == NULL)
+        return &hts_no_phrase;
+    for (i = 0; i < HTS_CONTEXT_CACHE; i++)
+        if (c->phrase[i].item == p)
+            return &c->phrase[i];
+    r = &c->phrase[c->next_phrase];
+    c->next_phrase = (c->next_phrase + 1) % HTS_CONTEXT_CACHE;
+
+    r->item = p;
+    r->endtone =
+        ffeature_string(p, "daughtern.R:SylStructure.daughtern.endtone");
+    r->num_syls = ffeature_int(p, "lisp_num_syls_in_phrase");
+    r->num_words = ffeature_int(p, "lisp_num_words_in_phrase");
+    r->total_syls = ffeature_int(p, "lisp_total_syls");
+    r->total_words = ffeature_int(p, "lisp_total_words");
+    r->total_phrases = ffeature_int(p, "lisp_total_phrases");
+
+    return r;
+}
+
+/* The syllable, word and phrase of segment s, as the label's feature */
+/* paths R:SylStructure.parent.R:Syllable, R:SylStructure.parent.parent */
+/* .R:Word and R:SylStructure.parent.parent.R:Phrase.parent find them   */
+static void hts_seg_context(const cst_item *s, const cst_item **syl,
+                            const cst_item **word, const cst_item **phrase)
+{
+    const cst_item *ss = item_as(s, "SylStructure");
+    const cst_item *ws;
+
+    ss = ss ? item_parent(ss) : NULL;
+    ws = ss ? item_parent(ss) : NULL;
+    *syl = item_as(ss, "Syllable");
+    *word = item_as(ws, "Word");
+    *phrase = item_as(ws, "Phrase");
+    *phrase = *phrase ? item_parent(*phrase) : NULL;
+}
+
+/* Features that the label gives through val_string_n(), as it caps them */
+static int hts_n(int n)
+{
+    return val_int(val_string_n(n));
+}
+
+static int hts_n_xx(int n)
+{
+    return n == 0 ? HTS_LABEL_XX : hts_n(n);
+}
+
+static const char *hts_name_xx(const cst_item *s)
+{
+    const char *name = s ? ffeature_string(s, "name") : "0";
+
+    return cst_streq(name, "0") ? "xx" : name;
+}
+
+/* Fill in l for segment item */
+static void hts_label_set(hts_context *c, const cst_item *item, hts_label *l)
+{
+    const cst_item *syl, *word, *phrase;
+    const hts_syl *sp, *sn;
+    const hts_word *wp, *wn;
+    const hts_phrase *pp, *pn;
+    const cst_item *p = item_prev(item);
+    const cst_item *n = item_next(item);
+
+    l->p1 = hts_name_xx(p ? item_prev(p) : NULL);
+    l->p2 = hts_name_xx(p);
+    l->p3 = ffeature_string(item, "name");
+    l->p4 = hts_name_xx(n);
+    l->p5 = hts_name_xx(n ? item_next(n) : NULL);
+
+    if (cst_streq(l->p3, "pau"))
     {
-        /* for pause */
-        int a3 =
-            ffeature_int(item,
-                         "p.R:SylStructure.parent.R:Syllable.syl_numphones");
-        int c3 =
-            ffeature_int(item,
-                         "n.R:SylStructure.parent.R:Syllable.syl_numphones");
-        int d2 =
-            ffeature_int(item,
-                         "p.R:SylStructure.parent.parent.R:Word.word_numsyls");
-        int f2 =
-            ffeature_int(item,
-                         "n.R:SylStructure.parent.parent.R:Word.word_numsyls");
-        int g1 =
-            ffeature_int(item,
-                         "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_syls_in_phrase");
-        int g2 =
-            ffeature_int(item,
-                         "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_words_in_phrase");
-        int i1 =
-            ffeature_int(item,
-                         "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_syls_in_phrase");
-        int i2 =
-            ffeature_int(item,
-                         "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_words_in_phrase");
-        int j1, j2, j3;
-        if (item_next(item) != NULL)
-        {
-            j1 = ffeature_int(item,
-                              "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_syls");
-            j2 = ffeature_int(item,
-                              "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_words");
-            j3 = ffeature_int(item,
-                              "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_phrases");
-        }
-        else
-        {
-            j1 = ffeature_int(item,
-                              "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_syls");
-            j2 = ffeature_int(item,
-                              "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_words");
-            j3 = ffeature_int(item,
-                              "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_phrases");
-        }
-        sprintf(label, "%s^%s-%s+%s=%s@xx_xx/A:%s_%s_%s/B:xx-xx-xx@xx-xx&xx-xx#xx-xx$xx-xx!xx-xx;xx-xx|xx/C:%s+%s+%s/D:%s_%s/E:xx+xx@xx+xx&xx+xx#xx+xx/F:%s_%s/G:%s_%s/H:xx=xx^xx=xx|xx/I:%s=%s/J:%d+%d-%d",    /* */
-                strcmp(p1, "0") == 0 ? "xx" : p1,       /* p1 */
-                strcmp(p2, "0") == 0 ? "xx" : p2,       /* p2 */
-                p3,             /* p3 */
-                strcmp(p4, "0") == 0 ? "xx" : p4,       /* p4 */
-                strcmp(p5, "0") == 0 ? "xx" : p5,       /* p5 */
-                a3 == 0 ? "xx" : ffeature_string(item, "p.R:SylStructure.parent.R:Syllable.stress"),    /* a1 */
-                a3 == 0 ? "xx" : ffeature_string(item, "p.R:SylStructure.parent.R:Syllable.accented"),  /* a2 */
-                a3 == 0 ? "xx" : val_string(val_string_n(a3)),  /* a3 */
-                c3 == 0 ? "xx" : ffeature_string(item, "n.R:SylStructure.parent.R:Syllable.stress"),    /* c1 */
-                c3 == 0 ? "xx" : ffeature_string(item, "n.R:SylStructure.parent.R:Syllable.accented"),  /* c2 */
-                c3 == 0 ? "xx" : val_string(val_string_n(c3)),  /* c3 */
-                d2 == 0 ? "xx" : ffeature_string(item, "p.R:SylStructure.parent.parent.R:Word.gpos"),   /* d1 */
-                d2 == 0 ? "xx" : val_string(val_string_n(d2)),  /* d2 */
-                f2 == 0 ? "xx" : ffeature_string(item, "n.R:SylStructure.parent.parent.R:Word.gpos"),   /* f1 */
-                f2 == 0 ? "xx" : val_string(val_string_n(f2)),  /* f2 */
-                g1 == 0 ? "xx" : val_string(val_string_n(g1)),  /* g1 */
-                g2 == 0 ? "xx" : val_string(val_string_n(g2)),  /* g2 */
-                i1 == 0 ? "xx" : val_string(val_string_n(i1)),  /* i1 */
-                i2 == 0 ? "xx" : val_string(val_string_n(i2)),  /* i2 */
-                j1,             /* j1 */
-                j2,             /* j2 */
-                j3);            /* j3 */
+        /* for pause, the context is the syllables either side */
+        const hts_phrase *pj;
+
+        hts_seg_context(p, &syl, &word, &phrase);
+        sp = hts_syl_info(c, syl);
+        wp = hts_word_info(c, word);
+        pp = hts_phrase_info(c, phrase);
+        hts_seg_context(n, &syl, &word, &phrase);
+        sn = hts_syl_info(c, syl);
+        wn = hts_word_info(c, word);
+        pn = hts_phrase_info(c, phrase);
+        pj = n ? pn : pp;
+
+        l->p6 = l->p7 = HTS_LABEL_XX;
+        l->a1 = sp->numphones == 0 ? "xx" : sp->stress;
+        l->a2 = sp->numphones == 0 ? "xx" : sp->accented;
+        l->a3 = hts_n_xx(sp->numphones);
+        l->b1 = l->b2 = l->b3 = l->b4 = l->b5 = l->b6 = l->b7 = l->b8 =
+            l->b9 = l->b10 = l->b11 = l->b12 = l->b13 = l->b14 = l->b15 =
+            HTS_LABEL_XX;
+        l->b16 = "xx";
+        l->c1 = sn->numphones == 0 ? "xx" : sn->stress;
+        l->c2 = sn->numphones == 0 ? "xx" : sn->accented;
+        l->c3 = hts_n_xx(sn->numphones);
+        l->d1 = wp->numsyls == 0 ? "xx" : wp->gpos;
+        l->d2 = hts_n_xx(wp->numsyls);
+        l->e1 = "xx";
+        l->e2 = l->e3 = l->e4 = l->e5 = l->e6 = l->e7 = l->e8 =
+            HTS_LABEL_XX;
+        l->f1 = wn->numsyls == 0 ? "xx" : wn->gpos;
+        l->f2 = hts_n_xx(wn->numsyls);
+        l->g1 = hts_n_xx(pp->num_syls);
+        l->g2 = hts_n_xx(pp->num_words);
+        l->h1 = l->h2 = l->h3 = l->h4 = HTS_LABEL_XX;
+        l->h5 = "xx";
+        l->i1 = hts_n_xx(pn->num_syls);
+        l->i2 = hts_n_xx(pn->num_words);
+        l->j1 = pj->total_syls;
+        l->j2 = pj->total_words;
+        l->j3 = pj->total_phrases;
     }
     else
     {
-        /* for no pause */
-        int p6 = ffeature_int(item, "R:SylStructure.pos_in_syl") + 1;
-        int a3 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.p.syl_numphones");
-        int b3 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.syl_numphones");
-        int b4 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.pos_in_word") + 1;
-        int b12 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.lisp_distance_to_p_stress");
-        int b13 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.lisp_distance_to_n_stress");
-        int b14 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.lisp_distance_to_p_accent");
-        int b15 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.lisp_distance_to_n_accent");
-        int c3 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.n.syl_numphones");
-        int d2 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Word.p.word_numsyls");
-        int e2 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Word.word_numsyls");
-        int e3 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Word.pos_in_phrase")
-            + 1;
-        int e7 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Word.lisp_distance_to_p_content");
-        int e8 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Word.lisp_distance_to_n_content");
-        int f2 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Word.n.word_numsyls");
-        int g1 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Phrase.parent.p.lisp_num_syls_in_phrase");
-        int g2 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Phrase.parent.p.lisp_num_words_in_phrase");
-        int h2 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_words_in_phrase");
-        int h3 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.R:Syllable.sub_phrases") + 1;
-        const char *h5 =
-            ffeature_string(item,
-                            "R:SylStructure.parent.parent.R:Phrase.parent.daughtern.R:SylStructure.daughtern.endtone");
-        int i1 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Phrase.parent.n.lisp_num_syls_in_phrase");
-        int i2 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Phrase.parent.n.lisp_num_words_in_phrase");
-        int j1 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_syls");
-        int j2 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_words");
-        int j3 =
-            ffeature_int(item,
-                         "R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_phrases");
-        sprintf(label, "%s^%s-%s+%s=%s@%d_%d/A:%s_%s_%s/B:%d-%d-%d@%d-%d&%d-%d#%d-%d$%d-%d!%s-%s;%s-%s|%s/C:%s+%s+%s/D:%s_%s/E:%s+%d@%d+%d&%d+%d#%s+%s/F:%s_%s/G:%s_%s/H:%d=%d^%d=%d|%s/I:%s=%s/J:%d+%d-%d",    /* */
-                strcmp(p1, "0") == 0 ? "xx" : p1,       /* p1 */
-                strcmp(p2, "0") == 0 ? "xx" : p2,       /* p2 */
-                p3,             /* p3 */
-                strcmp(p4, "0") == 0 ? "xx" : p4,       /* p4 */
-                strcmp(p5, "0") == 0 ? "xx" : p5,       /* p5 */
-                p6,             /* p6 */
-                b3 - p6 + 1,    /* p7 */
-                a3 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.R:Syllable.p.stress"),    /* a1 */
-                a3 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.R:Syllable.p.accented"),  /* a2 */
-                a3 == 0 ? "xx" : val_string(val_string_n(a3)),  /* a3 */
-                ffeature_int(item, "R:SylStructure.parent.R:Syllable.stress"),  /* b1 */
-                ffeature_int(item, "R:SylStructure.parent.R:Syllable.accented"),        /* b2 */
-                b3,             /* b3 */
-                b4,             /* b4 */
-                e2 - b4 + 1,    /* b5 */
-                ffeature_int(item, "R:SylStructure.parent.R:Syllable.syl_in") + 1,      /* b6 */
-                ffeature_int(item, "R:SylStructure.parent.R:Syllable.syl_out") + 1,     /* b7 */
-                ffeature_int(item, "R:SylStructure.parent.R:Syllable.ssyl_in"), /* b8 */
-                ffeature_int(item, "R:SylStructure.parent.R:Syllable.ssyl_out"),        /* b9 */
-                ffeature_int(item, "R:SylStructure.parent.R:Syllable.asyl_in"), /* b10 */
-                ffeature_int(item, "R:SylStructure.parent.R:Syllable.asyl_out"),        /* b11 */
-                b12 == 0 ? "xx" : val_string(val_string_n(b12)),        /* b12 */
-                b13 == 0 ? "xx" : val_string(val_string_n(b13)),        /* b13 */
-                b14 == 0 ? "xx" : val_string(val_string_n(b14)),        /* b14 */
-                b15 == 0 ? "xx" : val_string(val_string_n(b15)),        /* b15 */
-                ffeature_string(item, "R:SylStructure.parent.R:Syllable.syl_vowel"),    /* b16 */
-                c3 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.R:Syllable.n.stress"),    /* c1 */
-                c3 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.R:Syllable.n.accented"),  /* c2 */
-                c3 == 0 ? "xx" : val_string(val_string_n(c3)),  /* c3 */
-                d2 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.parent.R:Word.p.gpos"),   /* d1 */
-                d2 == 0 ? "xx" : val_string(val_string_n(d2)),  /* d2 */
-                ffeature_string(item, "R:SylStructure.parent.parent.R:Word.gpos"),      /* e1 */
-                e2,             /* e2 */
-                e3,             /* e3 */
-                h2 - e3 + 1,    /* e4 */
-                ffeature_int(item, "R:SylStructure.parent.parent.R:Word.content_words_in"),     /* e5 */
-                ffeature_int(item, "R:SylStructure.parent.parent.R:Word.content_words_out"),    /* e6 */
-                e7 == 0 ? "xx" : val_string(val_string_n(e7)),  /* e7 */
-                e8 == 0 ? "xx" : val_string(val_string_n(e8)),  /* e8 */
-                f2 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.parent.R:Word.n.gpos"),   /* f1 */
-                f2 == 0 ? "xx" : val_string(val_string_n(f2)),  /* f2 */
-                g1 == 0 ? "xx" : val_string(val_string_n(g1)),  /* g1 */
-                g2 == 0 ? "xx" : val_string(val_string_n(g2)),  /* g2 */
-                ffeature_int(item, "R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_syls_in_phrase"),     /* h1 */
-                h2,             /* h2 */
-                h3,             /* h3 */
-                j3 - h3 + 1,    /* h4 */
-                strcmp(h5, "0") == 0 ? "NONE" : h5,     /* h5 */
-                i1 == 0 ? "xx" : val_string(val_string_n(i1)),  /* i1 */
-                i2 == 0 ? "xx" : val_string(val_string_n(i2)),  /* i2 */
-                j1,             /* j1 */
-                j2,             /* j2 */
-                j3);            /* j3 */
+        const hts_syl *s;
+        const hts_word *w;
+        const hts_phrase *ph;
+        const cst_item *ss = item_as(item, "SylStructure");
+
+        hts_seg_context(item, &syl, &word, &phrase);
+        s = hts_syl_info(c, syl);
+        sp = hts_syl_info(c, item_prev(syl));
+        sn = hts_syl_info(c, item_next(syl));
+        w = hts_word_info(c, word);
+        wp = hts_word_info(c, item_prev(word));
+        wn = hts_word_info(c, item_next(word));
+        ph = hts_phrase_info(c, phrase);
+        pp = hts_phrase_info(c, item_prev(phrase));
+        pn = hts_phrase_info(c, item_next(phrase));
+
+        l->p6 = (ss ? ffeature_int(ss, "pos_in_syl") : 0) + 1;
+        l->p7 = s->numphones - l->p6 + 1;
+        l->a1 = sp->numphones == 0 ? "xx" : sp->stress;
+        l->a2 = sp->numphones == 0 ? "xx" : sp->accented;
+        l->a3 = hts_n_xx(sp->numphones);
+        l->b1 = s->stress_n;
+        l->b2 = s->accented_n;
+        l->b3 = s->numphones;
+        l->b4 = s->pos_in_word + 1;
+        l->b5 = w->numsyls - l->b4 + 1;
+        l->b6 = s->syl_in + 1;
+        l->b7 = s->syl_out + 1;
+        l->b8 = s->ssyl_in;
+        l->b9 = s->ssyl_out;
+        l->b10 = s->asyl_in;
+        l->b11 = s->asyl_out;
+        l->b12 = hts_n_xx(s->p_stress);
+        l->b13 = hts_n_xx(s->n_stress);
+        l->b14 = hts_n_xx(s->p_accent);
+        l->b15 = hts_n_xx(s->n_accent);
+        l->b16 = s->vowel;
+        l->c1 = sn->numphones == 0 ? "xx" : sn->stress;
+        l->c2 = sn->numphones == 0 ? "xx" : sn->accented;
+        l->c3 = hts_n_xx(sn->numphones);
+        l->d1 = wp->numsyls == 0 ? "xx" : wp->gpos;
+        l->d2 = hts_n_xx(wp->numsyls);
+        l->e1 = w->gpos;
+        l->e2 = w->numsyls;
+        l->e3 = w->pos_in_phrase + 1;
+        l->e4 = ph->num_words - l->e3 + 1;
+        l->e5 = w->content_in;
+        l->e6 = w->content_out;
+        l->e7 = hts_n_xx(w->p_content);
+        l->e8 = hts_n_xx(w->n_content);
+        l->f1 = wn->numsyls == 0 ? "xx" : wn->gpos;
+        l->f2 = hts_n_xx(wn->numsyls);
+        l->g1 = hts_n_xx(pp->num_syls);
+        l->g2 = hts_n_xx(pp->num_words);
+        l->h1 = ph->num_syls;
+        l->h2 = ph->num_words;
+        l->h3 = s->sub_phrases + 1;
+        l->h4 = ph->total_phrases - l->h3 + 1;
+        l->h5 = cst_streq(ph->endtone, "0") ? "NONE" : ph->endtone;
+        l->i1 = hts_n_xx(pn->num_syls);
+        l->i2 = hts_n_xx(pn->num_words);
+        l->j1 = ph->total_syls;
+        l->j2 = ph->total_words;
+        l->j3 = ph->total_phrases;
+    }
+}
+
+/* Writes the decimal digits of n into buff */
+static char *hts_int_string(int n, char *buff)
+{
+    char digits[HTS_LABEL_INT_LEN];
+    unsigned int u = (n < 0) ? -(unsigned int) n : (unsigned int) n;
+    int i = 0, j = 0;
+
+    if (n == HTS_LABEL_XX)
+        return strcpy(buff, "xx");
+    do
+    {
+        digits[i++] = '0' + (u % 10);
+        u /= 10;
+    } while (u > 0);
+    if (n < 0)
+        buff[j++] = '-';
+    while (i > 0)
+        buff[j++] = digits[--i];
+    buff[j] = '\0';
+
+    return buff;
+}
+
+/* Labels for the utterance's segments as HTS_LABEL_NUM_FIELDS values */
+/* each, in one block with the text of the integer fields after them  */
+static const char **hts_labels(cst_utterance *utt, size_t *label_size)
+{
+    const char **fields;
+    hts_context *c;
+    hts_label l;
+    cst_item *s;
+    char *buff;
+    size_t i, j;
+
+    *label_size = 0;
+    for (s = relation_head(utt_relation(utt, "Segment")); s; s = item_next(s))
+        (*label_size)++;
+    if (*label_size == 0)
+        return NULL;
+
+    fields = (const char **) cst_alloc(char,
+                                       *label_size * HTS_LABEL_NUM_FIELDS *
+                                       (sizeof(char *) + HTS_LABEL_INT_LEN));
+    buff = (char *) (fields + *label_size * HTS_LABEL_NUM_FIELDS);
+    c = cst_alloc(hts_context, 1);
+    for (i = 0, s = relation_head(utt_relation(utt, "Segment")); s;
+         s = item_next(s), i++)
+    {
+        hts_label_set(c, s, &l);
+        for (j = 0; j < HTS_LABEL_NUM_FIELDS; j++)
+        {
+            const char *field = (const char *) &l + hts_label_fields[j].offset;
+
+            if (hts_label_fields[j].is_int)
+            {
+                fields[i * HTS_LABEL_NUM_FIELDS + j] =
+                    hts_int_string(*(const int *) field, buff);
+                buff += HTS_LABEL_INT_LEN;
+            }
+            else
+                fields[i * HTS_LABEL_NUM_FIELDS + j] =
+                    *(const char *const *) field;
+        }
     }
+    cst_free(c);
+
+    return fields;
+}
+
+/* Hand the label format to the engine, for hts_labels() */
+static void hts_set_label_format(Flite_HTS_Engine * f)
+{
+    const char *delimiters[HTS_LABEL_NUM_FIELDS + 1];
+    size_t i;
+
+    for (i = 0; i < HTS_LABEL_NUM_FIELDS; i++)
+        delimiters[i] = hts_label_fields[i].delimiter;
+    delimiters[HTS_LABEL_NUM_FIELDS] = "";
+    HTS_Engine_set_label_format(&f->engine, delimiters, HTS_LABEL_NUM_FIELDS);
 }
 
 /* Flite_HTS_Engine_initialize: initialize system */
@@ -302,17 +552,54 @@ void Flite_HTS_Engine_initialize(Flite_HTS_Engine * f)
 {
     HTS_Engine_initialize(&f->engine);
     f->is_engine_loaded = 0;
+    f->map = NULL;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_init(&f->lock, NULL);
+#endif
 }
 
-/* Flite_HTS_Engine_load: load HTS voice */
+/* Flite_HTS_Engine_load: load HTS voice, mapping the file if possible */
+/* so its pdfs are used in place and shared by every process using it */
 HTS_Boolean Flite_HTS_Engine_load(Flite_HTS_Engine * f, const char *fn)
 {
-    HTS_Boolean result;
-    char *voices = cst_strdup(fn);
-    result = HTS_Engine_load(&f->engine, &voices, 1);
-    free(voices);
+    HTS_Boolean result = FALSE;
+    char *voices;
+#if (MMAP_TYPE != MMAP_TYPE_NONE)
+    cst_file fh;
+    const void *data;
+    size_t size = 0;
+#endif
+
+    Flite_HTS_Engine_clear(f);
+#if (MMAP_TYPE != MMAP_TYPE_NONE)
+    if ((fh = cst_fopen(fn, CST_OPEN_READ | CST_OPEN_BINARY)) != NULL)
+    {
+        size = (size_t) cst_filesize(fh);
+        cst_fclose(fh);
+    }
+    if (size > 0 && (f->map = cst_mmap_file(fn)) != NULL)
+    {
+        data = f->map->mem;
+        result =
+            HTS_Engine_load_from_mapped_data(&f->engine, &data, &size, 1);
+        if (result != TRUE)
+        {
+            cst_munmap_file(f->map);
+            f->map = NULL;
+        }
+    }
+#endif
+    if (result != TRUE)
+    {
+        voices = cst_strdup(fn);
+        result = HTS_Engine_load(&f->engine, &voices, 1);
+        cst_free(voices);
+    }
     if (result == TRUE)
+    {
+        hts_set_label_format(f);
         f->is_engine_loaded = 1;
+    }
     return result;
 }
 
@@ -392,129 +679,251 @@ size_t Flite_HTS_Engine_get_sampling_frequency(Flite_HTS_Engine * f)
 void Flite_HTS_Engine_clear(Flite_HTS_Engine * f)
 {
     HTS_Engine_clear(&f->engine);
+    if (f->map)
+        cst_munmap_file(f->map);
+    f->map = NULL;
     f->is_engine_loaded = 0;
 }
 
-/* Flite_HTS_Engine_copy_wave: Copy generated wave to a int16_t* array */
-static int16_t *Flite_HTS_Engine_copy_wave(Flite_HTS_Engine * f)
+/* Where the engine's samples go as hts_synth() makes them */
+#define HTS_STREAM_BUFF_SIZE 1024       /* samples per callback */
+
+typedef struct hts_stream_struct {
+    cst_wave *w;
+    cst_audio_streaming_info *asi;
+    int stream_mark;
+    int rc;
+} hts_stream;
+
+static HTS_Boolean hts_stream_samples(const short *samples,
+                                      size_t num_samples, HTS_Boolean last,
+                                      void *user_data)
 {
-    double x;
-    int16_t xs;
-    size_t i;
-    int16_t *rawwave =
-        cst_alloc(int16_t, HTS_Engine_get_nsamples(&f->engine));
-    if (rawwave == NULL)
-        return NULL;
-    for (i = 0; i < HTS_Engine_get_nsamples(&f->engine); ++i)
+    hts_stream *hs = (hts_stream *) user_data;
+    cst_audio_streaming_info *asi = hs->asi;
+
+    if (asi && asi->sink)
     {
-        x = HTS_Engine_get_generated_speech(&f->engine, i);
-        if (x > 32767.0)
-            xs = 32767;
-        else if (x < -32768.0)
-            xs = -32768;
-        else
-            xs = (int16_t) x;
-        rawwave[i] = xs;
+        /* straight to the sink, the utterance gets an empty wave */
+        audio_stream_stats_chunk(asi);
+        hs->rc = audio_sink_write(asi->sink, samples, num_samples, last);
     }
-    return rawwave;
+    else
+    {
+        memmove(hs->w->samples + hs->w->num_samples, samples,
+                num_samples * sizeof(short));
+        hs->w->num_samples += num_samples;
+        if (asi && (last ||
+                    (hs->w->num_samples - hs->stream_mark >
+                     asi->min_buffsize)))
+        {
+            audio_stream_stats_chunk(asi);
+            hs->rc = (*asi->asc) (hs->w, hs->stream_mark,
+                                  hs->w->num_samples - hs->stream_mark,
+                                  last, asi);
+            hs->stream_mark = hs->w->num_samples;
+        }
+    }
+
+    return (hs->rc == CST_AUDIO_STREAM_CONT) ? TRUE : FALSE;
 }
 
-cst_wave *wave_from_hts_engine(Flite_HTS_Engine * f)
+/* The number of samples the engine's state sequence will make */
+static size_t hts_total_samples(HTS_Engine * engine)
 {
-    int16_t *rawwave = Flite_HTS_Engine_copy_wave(f);
-    if (rawwave == NULL)
-        return NULL;
-    cst_wave *w = new_wave();
-    if (w == NULL)
-        return NULL;
-    w->samples = rawwave;
-    w->type = cst_strdup("riff");
-    w->sample_rate = HTS_Engine_get_sampling_frequency(&f->engine);
-    w->num_samples = HTS_Engine_get_nsamples(&f->engine);
-    w->num_channels = 1;
-    return w;
+    size_t i, frames = 0;
+
+    for (i = 0; i < HTS_Engine_get_total_state(engine); i++)
+        frames += HTS_Engine_get_state_duration(engine, i);
+
+    return frames * HTS_Engine_get_fperiod(engine);
 }
 
-cst_utterance *hts_synth(cst_utterance *utt)
+static void hts_lock(Flite_HTS_Engine * f)
 {
-    Flite_HTS_Engine *flite_hts;
-    size_t label_size = 0, i;
-    cst_wave *w;
-    cst_item *s = NULL;
-    char **label_data = NULL;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&f->lock);
+#endif
+}
+
+static void hts_unlock(Flite_HTS_Engine * f)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&f->lock);
+#endif
+}
 
+/* Set up engine to synthesize utt with the voice's models, loading */
+/* them the first time.  Only this is done under the lock, engine is */
+/* the caller's own and is cleared with HTS_Engine_clear().          */
+static HTS_Boolean hts_engine(cst_utterance *utt, HTS_Engine * engine)
+{
+    Flite_HTS_Engine *flite_hts;
+    HTS_Boolean result;
 
     flite_hts = val_flitehtsengine(utt_feat_val(utt, "flite_hts"));
+    HTS_Engine_initialize(engine);
 
+    hts_lock(flite_hts);
     if (!Flite_HTS_Engine_is_loaded(flite_hts))
     {
         const char *fn_voice =
             get_param_string(utt->features, "htsvoice_file", NULL);
-        if (Flite_HTS_Engine_load(flite_hts, fn_voice) != TRUE)
+        if (fn_voice == NULL
+            || Flite_HTS_Engine_load(flite_hts, fn_voice) != TRUE)
         {
             fprintf(stderr,
                     "flite_hts_engine: HTS voice cannot be loaded.\n");
             Flite_HTS_Engine_clear(flite_hts);
-            return NULL;
+            hts_unlock(flite_hts);
+            return FALSE;
         }
     }
+    result = HTS_Engine_share_model(engine, &flite_hts->engine);
+    hts_unlock(flite_hts);
 
-    for (s = relation_head(utt_relation(utt, "Segment")); s; s = item_next(s))
-        label_size++;
+    return result;
+}
+
+cst_utterance *hts_synth(cst_utterance *utt)
+{
+    HTS_Engine engine;
+    size_t label_size = 0;
+    cst_wave *w;
+    const char **label_data = NULL;
+    const cst_val *streaming_info_val;
+    cst_audio_streaming_info *asi = NULL;
+    hts_stream hs;
 
+    streaming_info_val = get_param_val(utt->features, "streaming_info", NULL);
+    if (streaming_info_val)
+    {
+        asi = val_audio_streaming_info(streaming_info_val);
+        asi->utt = utt;
+    }
+
+    if (hts_engine(utt, &engine) != TRUE)
+    {
+        HTS_Engine_clear(&engine);
+        return NULL;
+    }
+
+    label_data = hts_labels(utt, &label_size);
     if (label_size == 0)
     {
+        HTS_Engine_clear(&engine);
         w = new_wave();
         utt_set_wave(utt, w);
         return utt;
     }
 
-    label_data = (char **) cst_alloc(char *, label_size);
-    for (i = 0, s = relation_head(utt_relation(utt, "Segment")); s;
-         s = item_next(s), i++)
-    {
-        label_data[i] = (char *) cst_alloc(char, MAXBUFLEN);
-        create_label(s, label_data[i]);
-    }
-
     /* Set options from features */
 
 
     float postfiltering_coefficient = get_param_float(utt->features, "postfiltering_coefficient", 0.0); /* [0.0 - 1.0] */
-    Flite_HTS_Engine_set_beta(flite_hts, postfiltering_coefficient);
+    HTS_Engine_set_beta(&engine, postfiltering_coefficient);
 
 
     float dur_stretch =
         get_param_float(utt->features, "duration_stretch", 1.0);
-    Flite_HTS_Engine_set_speed(flite_hts, 1.0 / dur_stretch);
+    HTS_Engine_set_speed(&engine, 1.0 / dur_stretch);
 
     float add_half_tone =
         get_param_float(utt->features, "add_half_tone", 0.0);
-    Flite_HTS_Engine_add_half_tone(flite_hts, add_half_tone);
+    HTS_Engine_add_half_tone(&engine, add_half_tone);
 
     float vu_threshold = get_param_float(utt->features, "vu_threshold", 0.5);   /* [0.0 - 1.0 ] */
-    Flite_HTS_Engine_set_msd_threshold(flite_hts, 1, vu_threshold);
+    HTS_Engine_set_msd_threshold(&engine, 1, vu_threshold);
 
     float gv_weight_spectrum = get_param_float(utt->features, "gv_weight_spectrum", 1.0);       /* [ 0.0 --  ] */
-    Flite_HTS_Engine_set_gv_weight(flite_hts, 0, gv_weight_spectrum);
+    HTS_Engine_set_gv_weight(&engine, 0, gv_weight_spectrum);
 
     float gv_weight_lf0 = get_param_float(utt->features, "gv_weight_lf0", 1.0); /* [ 0.0--    ] */
-    Flite_HTS_Engine_set_gv_weight(flite_hts, 1, gv_weight_lf0);
+    HTS_Engine_set_gv_weight(&engine, 1, gv_weight_lf0);
 
     float volume_db = get_param_float(utt->features, "volume_db", 0.0); /* negative means lower, positive means higher */
-    Flite_HTS_Engine_set_volume(flite_hts, volume_db);
-
-    /* speech synthesis part */
-    HTS_Engine_synthesize_from_strings(&flite_hts->engine, label_data,
-                                       label_size);
+    HTS_Engine_set_volume(&engine, volume_db);
+
+    /* speech synthesis part: the samples are passed on as each frame */
+    /* is vocoded, rather than kept as doubles for the whole utterance */
+    hs.asi = asi;
+    hs.stream_mark = 0;
+    hs.rc = CST_AUDIO_STREAM_CONT;
+    hs.w = w = new_wave();
+    w->sample_rate = HTS_Engine_get_sampling_frequency(&engine);
+    if (asi && asi->sink)
+        asi->sink->sample_rate = w->sample_rate;
+    if (HTS_Engine_generate_state_sequence_from_fields(&engine, label_data,
+                                                       label_size) == TRUE
+        && HTS_Engine_generate_parameter_sequence(&engine) == TRUE)
+    {
+        if (!(asi && asi->sink))
+        {
+            cst_wave_resize(w, hts_total_samples(&engine), 1);
+            w->num_samples = 0;
+        }
+        HTS_Engine_generate_sample_sequence_with_callback(&engine,
+                                                          HTS_STREAM_BUFF_SIZE,
+                                                          hts_stream_samples,
+                                                          &hs);
+    }
+    HTS_Engine_refresh(&engine);
+    HTS_Engine_clear(&engine);
 
-    w = wave_from_hts_engine(flite_hts);
+    if (hs.rc == CST_AUDIO_STREAM_STOP)
+    {
+        /* Synthesis was interrupted */
+        utt_set_feat_int(utt, "Interrupted", 1);
+        w->num_samples = 0;
+    }
     utt_set_wave(utt, w);
-    HTS_Engine_refresh(&flite_hts->engine);
 
-    for (i = 0; i < label_size; i++)
-        free(label_data[i]);
-    free(label_data);
+    cst_free(label_data);
+    return utt;
+}
+
+cst_utterance *hts_durations(cst_utterance *utt)
+{
+    /* Segment ends from the HMM state durations, the first step of */
+    /* hts_synth(), with no parameter or sample generation          */
+    HTS_Engine engine;
+    size_t label_size = 0, nstate, fperiod, fs, frames, i, j;
+    const char **label_data;
+    cst_item *s;
+
+    label_data = hts_labels(utt, &label_size);
+    if (label_size == 0)
+        return utt;
+
+    if (hts_engine(utt, &engine) != TRUE)
+    {
+        HTS_Engine_clear(&engine);
+        cst_free(label_data);
+        return NULL;
+    }
+    HTS_Engine_set_speed(&engine,
+                         1.0 / get_param_float(utt->features,
+                                               "duration_stretch", 1.0));
+    if (HTS_Engine_generate_state_sequence_from_fields(&engine, label_data,
+                                                       label_size) == TRUE)
+    {
+        nstate = HTS_Engine_get_nstate(&engine);
+        fperiod = HTS_Engine_get_fperiod(&engine);
+        fs = HTS_Engine_get_sampling_frequency(&engine);
+        frames = 0;
+        for (i = 0, s = relation_head(utt_relation(utt, "Segment"));
+             s && i < label_size; s = item_next(s), i++)
+        {
+            for (j = 0; j < nstate; j++)
+                frames += HTS_Engine_get_state_duration(&engine,
+                                                        (i * nstate) + j);
+            item_set_float(s, "end", (float) (frames * fperiod) / fs);
+        }
+    }
+    HTS_Engine_refresh(&engine);
+    HTS_Engine_clear(&engine);
+
+    cst_free(label_data);
     return utt;
 }
 
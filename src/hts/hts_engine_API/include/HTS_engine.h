@@ -102,6 +102,8 @@ typedef struct _HTS_Window {
 /* HTS_Pattern: list of patterns in a question and a tree. */
 typedef struct _HTS_Pattern {
    char *string;                /* pattern string */
+   HTS_Boolean compiled;        /* matched through the model's field table */
+   HTS_Boolean format_compiled; /* matched through the model's format table */
    struct _HTS_Pattern *next;   /* pointer to the next pattern */
 } HTS_Pattern;
 
@@ -109,9 +111,38 @@ typedef struct _HTS_Pattern {
 typedef struct _HTS_Question {
    char *string;                /* name of this question */
    HTS_Pattern *head;           /* pointer to the head of pattern list */
+   size_t index;                /* bit for this question in the match set */
+   HTS_Boolean compiled;        /* all of its patterns are compiled */
+   HTS_Boolean format_compiled; /* all of its patterns are compiled to the label format */
    struct _HTS_Question *next;  /* pointer to the next question */
 } HTS_Question;
 
+/* HTS_FieldTest: a question pattern compiled to a test on one field of */
+/* the label, a maximal run of letters and digits, with the delimiters  */
+/* either side of it and any literal text before and after those       */
+typedef struct _HTS_FieldTest {
+   char left;                   /* delimiter before the field, '\0' at the start */
+   char right;                  /* delimiter after the field, '\0' at the end */
+   char *value;                 /* the field */
+   size_t value_length;
+   char *before;                /* text before left, '?' matches any */
+   char *after;                 /* text after right, '?' matches any */
+   HTS_Boolean anchored_start;  /* before must start the label */
+   HTS_Boolean anchored_end;    /* after must end the label */
+   size_t question;             /* index of the question it answers */
+   struct _HTS_FieldTest *next; /* next in the same hash bucket */
+} HTS_FieldTest;
+
+/* HTS_FormatTest: a question pattern compiled against the label format, */
+/* the values it needs in some of the fields of a structured label       */
+typedef struct _HTS_FormatTest {
+   size_t num_fields;           /* # of fields tested */
+   size_t *field;               /* index of each field, field[0] is hashed */
+   char **value;                /* value of each field, '?' matches any but in value[0] */
+   size_t question;             /* index of the question it answers */
+   struct _HTS_FormatTest *next;        /* next in the same hash bucket */
+} HTS_FormatTest;
+
 /* HTS_Node: list of tree nodes in a tree. */
 typedef struct _HTS_Node {
    int index;                   /* index of this node */
@@ -137,11 +168,29 @@ typedef struct _HTS_Model {
    HTS_Boolean is_msd;          /* flag for MSD */
    size_t ntree;                /* # of trees */
    size_t *npdf;                /* # of PDFs at each tree */
-   float ***pdf;                /* PDFs */
+   void ***pdf;                 /* PDFs, float vectors, unaligned if mapped */
+   HTS_Boolean pdf_mapped;      /* PDFs point into a mapped voice file */
    HTS_Tree *tree;              /* pointer to the list of trees */
    HTS_Question *question;      /* pointer to the list of questions */
+   size_t num_questions;        /* # of questions */
+   HTS_FieldTest **field_test;  /* compiled patterns hashed on their field */
+   size_t field_test_size;      /* # of hash buckets, a power of two */
+   HTS_FormatTest **format_test;        /* patterns compiled to the label format, hashed on a field */
+   size_t format_test_size;     /* # of hash buckets, a power of two */
+   HTS_FormatTest *format_wild; /* format tests with no exact field to hash */
+   char *match_label;           /* label the match set is for */
+   char *match_fields;          /* or fields of the structured label it is for */
+   size_t match_fields_size;
+   unsigned char *match_set;    /* bit per question, for match_label */
 } HTS_Model;
 
+/* HTS_LabelFormat: fixed text around the fields of structured labels, */
+/* delimiter[i] comes before field i and delimiter[num_fields] ends it */
+typedef struct _HTS_LabelFormat {
+   size_t num_fields;           /* # of fields */
+   char **delimiter;            /* num_fields + 1 delimiters */
+} HTS_LabelFormat;
+
 /* HTS_ModelSet: set of duration models, HMMs and GV models. */
 typedef struct _HTS_ModelSet {
    char *hts_voice_version;     /* version of HTS voice format */
@@ -154,19 +203,28 @@ typedef struct _HTS_ModelSet {
    char *fullcontext_format;    /* fullcontext label format */
    char *fullcontext_version;   /* version of fullcontext label */
    HTS_Question *gv_off_context;        /* GV switch */
+   HTS_LabelFormat label_format;        /* format of structured labels */
+   HTS_FormatTest *gv_off_format;       /* GV switch compiled to label_format */
    char **option;               /* options for each stream */
    HTS_Model *duration;         /* duration PDFs and trees */
    HTS_Window *window;          /* window coefficients for delta */
    HTS_Model **stream;          /* parameter PDFs and trees */
    HTS_Model **gv;              /* GV PDFs and trees */
+   HTS_Boolean is_shared;       /* models belong to another model set */
 } HTS_ModelSet;
 
 /* label ----------------------------------------------------------- */
 
 /* HTS_LabelString: individual label string with time information */
+/* Structured labels hold their fields, name is only made from them */
+/* when something asks for it                                        */
 typedef struct _HTS_LabelString {
    struct _HTS_LabelString *next;       /* pointer to next label string */
    char *name;                  /* label string */
+   char **field;                /* fields of a structured label, or NULL */
+   size_t fields_size;          /* size of the block holding the values */
+   HTS_Boolean regular;         /* every value is a nonempty run of letters and digits */
+   const HTS_LabelFormat *format;       /* format of the fields */
    double start;                /* start frame specified in the given label */
    double end;                  /* end frame specified in the given label */
 } HTS_LabelString;
@@ -211,9 +269,10 @@ typedef struct _HTS_SStreamSet {
 typedef struct _HTS_SMatrices {
    double **mean;               /* mean vector sequence */
    double **ivar;               /* inverse diag variance sequence */
-   double *g;                   /* vector used in the forward substitution */
-   double **wuw;                /* W' U^-1 W  */
-   double *wum;                 /* W' U^-1 mu */
+   double **g;                  /* vectors used in the forward substitution */
+   double **wuw;                /* W' U^-1 W, all coefficients side by side */
+   double **ldl;                /* its L D L' factorization */
+   double **wum;                /* W' U^-1 mu */
 } HTS_SMatrices;
 
 /* HTS_PStream: individual PDF stream. */
@@ -301,6 +360,9 @@ typedef struct _HTS_Engine {
    HTS_GStreamSet gss;          /* set of generated parameter streams */
 } HTS_Engine;
 
+/* HTS_SampleCallback: receives synthesized samples as they are made, returns FALSE to stop */
+typedef HTS_Boolean(*HTS_SampleCallback) (const short *samples, size_t num_samples, HTS_Boolean last, void *user_data);
+
 /* engine method --------------------------------------------------- */
 
 /* HTS_Engine_initialize: initialize engine */
@@ -309,6 +371,15 @@ void HTS_Engine_initialize(HTS_Engine * engine);
 /* HTS_Engine_load: load HTS voices */
 HTS_Boolean HTS_Engine_load(HTS_Engine * engine, char **voices, size_t num_voices);
 
+/* HTS_Engine_load_from_mapped_data: load HTS voices from memory, e.g. mapped */
+/* files.  The PDFs are used in place, so the data must outlive the engine.  */
+HTS_Boolean HTS_Engine_load_from_mapped_data(HTS_Engine * engine, const void **data, const size_t * size, size_t num_voices);
+
+/* HTS_Engine_share_model: use the voices loaded by source, starting from its */
+/* conditions.  Engines sharing a source synthesize independently and can    */
+/* run at the same time, so long as source isn't used or changed meanwhile.  */
+HTS_Boolean HTS_Engine_share_model(HTS_Engine * engine, HTS_Engine * source);
+
 /* HTS_Engine_set_sampling_frequency: set sampling fraquency */
 void HTS_Engine_set_sampling_frequency(HTS_Engine * engine, size_t i);
 
@@ -435,18 +506,30 @@ HTS_Boolean HTS_Engine_synthesize_from_fn(HTS_Engine * engine, const char *fn);
 /* HTS_Engine_synthesize_from_strings: synthesize speech from string list */
 HTS_Boolean HTS_Engine_synthesize_from_strings(HTS_Engine * engine, char **lines, size_t num_lines);
 
+/* HTS_Engine_set_label_format: set the text around the fields of structured labels */
+void HTS_Engine_set_label_format(HTS_Engine * engine, const char *const *delimiters, size_t num_fields);
+
+/* HTS_Engine_synthesize_from_fields: synthesize speech from structured labels, num_fields values each */
+HTS_Boolean HTS_Engine_synthesize_from_fields(HTS_Engine * engine, const char *const *fields, size_t num_labels);
+
 /* HTS_Engine_generate_state_sequence_from_fn: generate state sequence from file name (1st synthesis step) */
 HTS_Boolean HTS_Engine_generate_state_sequence_from_fn(HTS_Engine * engine, const char *fn);
 
 /* HTS_Engine_generate_state_sequence_from_strings: generate state sequence from string list (1st synthesis step) */
 HTS_Boolean HTS_Engine_generate_state_sequence_from_strings(HTS_Engine * engine, char **lines, size_t num_lines);
 
+/* HTS_Engine_generate_state_sequence_from_fields: generate state sequence from structured labels (1st synthesis step) */
+HTS_Boolean HTS_Engine_generate_state_sequence_from_fields(HTS_Engine * engine, const char *const *fields, size_t num_labels);
+
 /* HTS_Engine_generate_parameter_sequence: generate parameter sequence (2nd synthesis step) */
 HTS_Boolean HTS_Engine_generate_parameter_sequence(HTS_Engine * engine);
 
 /* HTS_Engine_generate_sample_sequence: generate sample sequence (3rd synthesis step) */
 HTS_Boolean HTS_Engine_generate_sample_sequence(HTS_Engine * engine);
 
+/* HTS_Engine_generate_sample_sequence_with_callback: generate sample sequence (3rd synthesis step) in blocks of up to buff_size samples passed to callback, keeping neither the parameters nor the speech */
+HTS_Boolean HTS_Engine_generate_sample_sequence_with_callback(HTS_Engine * engine, size_t buff_size, HTS_SampleCallback callback, void *user_data);
+
 /* HTS_Engine_save_information: save trace information */
 void HTS_Engine_save_information(HTS_Engine * engine, FILE * fp);
 
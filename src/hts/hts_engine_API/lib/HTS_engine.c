@@ -106,23 +106,16 @@ void HTS_Engine_initialize(HTS_Engine * engine)
    HTS_GStreamSet_initialize(&engine->gss);
 }
 
-/* HTS_Engine_load: load HTS voices */
-HTS_Boolean HTS_Engine_load(HTS_Engine * engine, char **voices, size_t num_voices)
+/* HTS_Engine_set_default_condition: set the conditions the loaded voices ask for */
+static void HTS_Engine_set_default_condition(HTS_Engine * engine)
 {
    size_t i, j;
-   size_t nstream;
+   size_t nstream, num_voices;
    double average_weight;
    const char *option, *find;
 
-   /* reset engine */
-   HTS_Engine_clear(engine);
-
-   /* load voices */
-   if (HTS_ModelSet_load(&engine->ms, voices, num_voices) != TRUE) {
-      HTS_Engine_clear(engine);
-      return FALSE;
-   }
    nstream = HTS_ModelSet_get_nstream(&engine->ms);
+   num_voices = HTS_ModelSet_get_nvoices(&engine->ms);
    average_weight = 1.0 / num_voices;
 
    /* global */
@@ -163,6 +156,75 @@ HTS_Boolean HTS_Engine_load(HTS_Engine * engine, char **voices, size_t num_voice
       for (j = 0; j < nstream; j++)
          engine->condition.gv_iw[i][j] = average_weight;
    }
+}
+
+/* HTS_Engine_load: load HTS voices */
+HTS_Boolean HTS_Engine_load(HTS_Engine * engine, char **voices, size_t num_voices)
+{
+   /* reset engine */
+   HTS_Engine_clear(engine);
+
+   /* load voices */
+   if (HTS_ModelSet_load(&engine->ms, voices, num_voices) != TRUE) {
+      HTS_Engine_clear(engine);
+      return FALSE;
+   }
+   HTS_Engine_set_default_condition(engine);
+
+   return TRUE;
+}
+
+/* HTS_Engine_load_from_mapped_data: load HTS voices from memory, e.g. mapped files */
+HTS_Boolean HTS_Engine_load_from_mapped_data(HTS_Engine * engine, const void **data, const size_t * size, size_t num_voices)
+{
+   /* reset engine */
+   HTS_Engine_clear(engine);
+
+   /* load voices */
+   if (HTS_ModelSet_load_from_mapped_data(&engine->ms, data, size, num_voices) != TRUE) {
+      HTS_Engine_clear(engine);
+      return FALSE;
+   }
+   HTS_Engine_set_default_condition(engine);
+
+   return TRUE;
+}
+
+/* HTS_Engine_share_model: use the voices loaded by source, starting from its conditions */
+HTS_Boolean HTS_Engine_share_model(HTS_Engine * engine, HTS_Engine * source)
+{
+   size_t i;
+   size_t nstream, num_voices;
+   HTS_Condition *from = &source->condition;
+
+   /* reset engine */
+   HTS_Engine_clear(engine);
+
+   if (from->msd_threshold == NULL)
+      return FALSE;
+   HTS_ModelSet_share(&engine->ms, &source->ms);
+   nstream = HTS_ModelSet_get_nstream(&engine->ms);
+   num_voices = HTS_ModelSet_get_nvoices(&engine->ms);
+
+   /* copy conditions, with weights of its own */
+   engine->condition = *from;
+   engine->condition.stop = FALSE;
+   engine->condition.msd_threshold = (double *) HTS_calloc(nstream, sizeof(double));
+   memcpy(engine->condition.msd_threshold, from->msd_threshold, nstream * sizeof(double));
+   engine->condition.gv_weight = (double *) HTS_calloc(nstream, sizeof(double));
+   memcpy(engine->condition.gv_weight, from->gv_weight, nstream * sizeof(double));
+   engine->condition.duration_iw = (double *) HTS_calloc(num_voices, sizeof(double));
+   memcpy(engine->condition.duration_iw, from->duration_iw, num_voices * sizeof(double));
+   engine->condition.parameter_iw = (double **) HTS_calloc(num_voices, sizeof(double *));
+   engine->condition.gv_iw = (double **) HTS_calloc(num_voices, sizeof(double *));
+   for (i = 0; i < num_voices; i++) {
+      engine->condition.parameter_iw[i] = (double *) HTS_calloc(nstream, sizeof(double));
+      memcpy(engine->condition.parameter_iw[i], from->parameter_iw[i], nstream * sizeof(double));
+      engine->condition.gv_iw[i] = (double *) HTS_calloc(nstream, sizeof(double));
+      memcpy(engine->condition.gv_iw[i], from->gv_iw[i], nstream * sizeof(double));
+   }
+   if (engine->condition.audio_buff_size > 0)
+      HTS_Audio_set_parameter(&engine->audio, engine->condition.sampling_frequency, engine->condition.audio_buff_size);
 
    return TRUE;
 }
@@ -476,6 +538,18 @@ HTS_Boolean HTS_Engine_generate_state_sequence_from_strings(HTS_Engine * engine,
    return HTS_Engine_generate_state_sequence(engine);
 }
 
+/* HTS_Engine_generate_state_sequence_from_fields: generate state sequence from structured labels (1st synthesis step) */
+HTS_Boolean HTS_Engine_generate_state_sequence_from_fields(HTS_Engine * engine, const char *const *fields, size_t num_labels)
+{
+   HTS_Engine_refresh(engine);
+   if (engine->ms.label_format.delimiter == NULL) {
+      HTS_error(1, "HTS_Engine_generate_state_sequence_from_fields: label format is not set.\n");
+      return FALSE;
+   }
+   HTS_Label_load_from_fields(&engine->label, &engine->ms.label_format, fields, num_labels);
+   return HTS_Engine_generate_state_sequence(engine);
+}
+
 /* HTS_Engine_generate_parameter_sequence: generate parameter sequence (2nd synthesis step) */
 HTS_Boolean HTS_Engine_generate_parameter_sequence(HTS_Engine * engine)
 {
@@ -488,6 +562,12 @@ HTS_Boolean HTS_Engine_generate_sample_sequence(HTS_Engine * engine)
    return HTS_GStreamSet_create(&engine->gss, &engine->pss, engine->condition.stage, engine->condition.use_log_gain, engine->condition.sampling_frequency, engine->condition.fperiod, engine->condition.alpha, engine->condition.beta, &engine->condition.stop, engine->condition.volume, engine->condition.audio_buff_size > 0 ? &engine->audio : NULL);
 }
 
+/* HTS_Engine_generate_sample_sequence_with_callback: generate sample sequence (3rd synthesis step) passing it to callback */
+HTS_Boolean HTS_Engine_generate_sample_sequence_with_callback(HTS_Engine * engine, size_t buff_size, HTS_SampleCallback callback, void *user_data)
+{
+   return HTS_GStreamSet_create_with_callback(&engine->gss, &engine->pss, engine->condition.stage, engine->condition.use_log_gain, engine->condition.sampling_frequency, engine->condition.fperiod, engine->condition.alpha, engine->condition.beta, &engine->condition.stop, engine->condition.volume, buff_size, callback, user_data);
+}
+
 /* HTS_Engine_synthesize: synthesize speech */
 static HTS_Boolean HTS_Engine_synthesize(HTS_Engine * engine)
 {
@@ -522,6 +602,24 @@ HTS_Boolean HTS_Engine_synthesize_from_strings(HTS_Engine * engine, char **lines
    return HTS_Engine_synthesize(engine);
 }
 
+/* HTS_Engine_set_label_format: set the text around the fields of structured labels */
+void HTS_Engine_set_label_format(HTS_Engine * engine, const char *const *delimiters, size_t num_fields)
+{
+   HTS_ModelSet_set_label_format(&engine->ms, delimiters, num_fields);
+}
+
+/* HTS_Engine_synthesize_from_fields: synthesize speech from structured labels */
+HTS_Boolean HTS_Engine_synthesize_from_fields(HTS_Engine * engine, const char *const *fields, size_t num_labels)
+{
+   HTS_Engine_refresh(engine);
+   if (engine->ms.label_format.delimiter == NULL) {
+      HTS_error(1, "HTS_Engine_synthesize_from_fields: label format is not set.\n");
+      return FALSE;
+   }
+   HTS_Label_load_from_fields(&engine->label, &engine->ms.label_format, fields, num_labels);
+   return HTS_Engine_synthesize(engine);
+}
+
 /* HTS_Engine_save_information: save trace information */
 void HTS_Engine_save_information(HTS_Engine * engine, FILE * fp)
 {
@@ -617,7 +715,7 @@ void HTS_Engine_save_information(HTS_Engine * engine, FILE * fp)
       fprintf(fp, "  Duration\n");
       for (j = 0; j < HTS_ModelSet_get_nvoices(ms); j++) {
          fprintf(fp, "    Interpolation[%2lu]\n", (unsigned long) j);
-         HTS_ModelSet_get_duration_index(ms, j, HTS_Label_get_string(label, i), &k, &l);
+         HTS_ModelSet_get_duration_index(ms, j, HTS_Label_get_label_string(label, i), &k, &l);
          fprintf(fp, "      Tree index                       -> %8lu\n", (unsigned long) k);
          fprintf(fp, "      PDF index                        -> %8lu\n", (unsigned long) l);
       }
@@ -634,7 +732,7 @@ void HTS_Engine_save_information(HTS_Engine * engine, FILE * fp)
             }
             for (l = 0; l < HTS_ModelSet_get_nvoices(ms); l++) {
                fprintf(fp, "      Interpolation[%2lu]\n", (unsigned long) l);
-               HTS_ModelSet_get_parameter_index(ms, l, k, j + 2, HTS_Label_get_string(label, i), &m, &n);
+               HTS_ModelSet_get_parameter_index(ms, l, k, j + 2, HTS_Label_get_label_string(label, i), &m, &n);
                fprintf(fp, "        Tree index                     -> %8lu\n", (unsigned long) m);
                fprintf(fp, "        PDF index                      -> %8lu\n", (unsigned long) n);
             }
@@ -68,6 +68,27 @@ void HTS_GStreamSet_initialize(HTS_GStreamSet * gss)
    gss->gspeech = NULL;
 }
 
+/* HTS_GStreamSet_check: check that the parameter streams can be vocoded */
+static HTS_Boolean HTS_GStreamSet_check(HTS_PStreamSet * pss, const char *caller)
+{
+   size_t nstream = HTS_PStreamSet_get_nstream(pss);
+
+   if (nstream != 2 && nstream != 3) {
+      HTS_error(1, "%s: The number of streams should be 2 or 3.\n", caller);
+      return FALSE;
+   }
+   if (HTS_PStreamSet_get_vector_length(pss, 1) != 1) {
+      HTS_error(1, "%s: The size of lf0 static vector should be 1.\n", caller);
+      return FALSE;
+   }
+   if (nstream >= 3 && HTS_PStreamSet_get_vector_length(pss, 2) % 2 == 0) {
+      HTS_error(1, "%s: The number of low-pass filter coefficient should be odd numbers.", caller);
+      return FALSE;
+   }
+
+   return TRUE;
+}
+
 /* HTS_GStreamSet_create: generate speech */
 HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, size_t stage, HTS_Boolean use_log_gain, size_t sampling_rate, size_t fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, HTS_Audio * audio)
 {
@@ -83,6 +104,9 @@ HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, si
       return FALSE;
    }
 
+   if (HTS_GStreamSet_check(pss, "HTS_GStreamSet_create") != TRUE)
+      return FALSE;
+
    /* initialize */
    gss->nstream = HTS_PStreamSet_get_nstream(pss);
    gss->total_frame = HTS_PStreamSet_get_total_frame(pss);
@@ -114,23 +138,6 @@ HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, si
       }
    }
 
-   /* check */
-   if (gss->nstream != 2 && gss->nstream != 3) {
-      HTS_error(1, "HTS_GStreamSet_create: The number of streams should be 2 or 3.\n");
-      HTS_GStreamSet_clear(gss);
-      return FALSE;
-   }
-   if (HTS_PStreamSet_get_vector_length(pss, 1) != 1) {
-      HTS_error(1, "HTS_GStreamSet_create: The size of lf0 static vector should be 1.\n");
-      HTS_GStreamSet_clear(gss);
-      return FALSE;
-   }
-   if (gss->nstream >= 3 && gss->gstream[2].vector_length % 2 == 0) {
-      HTS_error(1, "HTS_GStreamSet_create: The number of low-pass filter coefficient should be odd numbers.");
-      HTS_GStreamSet_clear(gss);
-      return FALSE;
-   }
-
    /* synthesize speech waveform */
    HTS_Vocoder_initialize(&v, gss->gstream[0].vector_length - 1, stage, use_log_gain, sampling_rate, fperiod);
    if (gss->nstream >= 3)
@@ -148,6 +155,84 @@ HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, si
    return TRUE;
 }
 
+/* HTS_GStreamSet_create_with_callback: generate speech frame by frame, passing it to callback */
+HTS_Boolean HTS_GStreamSet_create_with_callback(HTS_GStreamSet * gss, HTS_PStreamSet * pss, size_t stage, HTS_Boolean use_log_gain, size_t sampling_rate, size_t fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, size_t buff_size, HTS_SampleCallback callback, void *user_data)
+{
+   size_t i, j, k;
+   size_t *msd_frame;
+   double **par;
+   double *speech;
+   double *src;
+   short *buff;
+   size_t nbuff = 0;
+   HTS_Vocoder v;
+   size_t nlpf = 0;
+   HTS_Boolean go = TRUE;
+
+   /* check */
+   if (gss->gstream || gss->gspeech) {
+      HTS_error(1, "HTS_GStreamSet_create_with_callback: HTS_GStreamSet is not initialized.\n");
+      return FALSE;
+   }
+   if (HTS_GStreamSet_check(pss, "HTS_GStreamSet_create_with_callback") != TRUE)
+      return FALSE;
+
+   /* initialize: only the current frame is kept, the parameters are read from the parameter streams as they are needed */
+   gss->nstream = HTS_PStreamSet_get_nstream(pss);
+   gss->total_frame = HTS_PStreamSet_get_total_frame(pss);
+   gss->total_nsample = fperiod * gss->total_frame;
+   if (buff_size < fperiod)
+      buff_size = fperiod;
+   par = (double **) HTS_calloc(gss->nstream, sizeof(double *));
+   for (i = 0; i < gss->nstream; i++)
+      par[i] = (double *) HTS_calloc(HTS_PStreamSet_get_vector_length(pss, i), sizeof(double));
+   msd_frame = (size_t *) HTS_calloc(gss->nstream, sizeof(size_t));
+   speech = (double *) HTS_calloc(fperiod, sizeof(double));
+   buff = (short *) HTS_calloc(buff_size, sizeof(short));
+
+   /* synthesize speech waveform */
+   HTS_Vocoder_initialize(&v, HTS_PStreamSet_get_vector_length(pss, 0) - 1, stage, use_log_gain, sampling_rate, fperiod);
+   if (gss->nstream >= 3)
+      nlpf = HTS_PStreamSet_get_vector_length(pss, 2);
+   for (i = 0; i < gss->total_frame && (*stop) == FALSE && go == TRUE; i++) {
+      for (j = 0; j < gss->nstream; j++) {
+         if (HTS_PStreamSet_is_msd(pss, j) && HTS_PStreamSet_get_msd_flag(pss, j, i) != TRUE) {
+            for (k = 0; k < HTS_PStreamSet_get_vector_length(pss, j); k++)
+               par[j][k] = HTS_NODATA;
+         } else {
+            src = HTS_PStreamSet_get_parameter_vector(pss, j, HTS_PStreamSet_is_msd(pss, j) ? msd_frame[j]++ : i);
+            for (k = 0; k < HTS_PStreamSet_get_vector_length(pss, j); k++)
+               par[j][k] = src[k];
+         }
+      }
+      HTS_Vocoder_synthesize(&v, HTS_PStreamSet_get_vector_length(pss, 0) - 1, par[1][0], par[0], nlpf, gss->nstream >= 3 ? par[2] : NULL, alpha, beta, volume, speech, NULL);
+      if (nbuff + fperiod > buff_size) {
+         go = callback(buff, nbuff, FALSE, user_data);
+         nbuff = 0;
+      }
+      for (j = 0; j < fperiod; j++) {
+         if (speech[j] > 32767.0)
+            buff[nbuff++] = 32767;
+         else if (speech[j] < -32768.0)
+            buff[nbuff++] = -32768;
+         else
+            buff[nbuff++] = (short) speech[j];
+      }
+   }
+   if (go == TRUE)
+      callback(buff, nbuff, TRUE, user_data);
+   HTS_Vocoder_clear(&v);
+
+   for (i = 0; i < gss->nstream; i++)
+      HTS_free(par[i]);
+   HTS_free(par);
+   HTS_free(msd_frame);
+   HTS_free(speech);
+   HTS_free(buff);
+
+   return TRUE;
+}
+
 /* HTS_GStreamSet_get_total_nsamples: get total number of sample */
 size_t HTS_GStreamSet_get_total_nsamples(HTS_GStreamSet * gss)
 {
@@ -163,18 +248,24 @@ size_t HTS_GStreamSet_get_total_frame(HTS_GStreamSet * gss)
 /* HTS_GStreamSet_get_vector_length: get features length */
 size_t HTS_GStreamSet_get_vector_length(HTS_GStreamSet * gss, size_t stream_index)
 {
+   if (gss->gstream == NULL)
+      return 0;
    return gss->gstream[stream_index].vector_length;
 }
 
 /* HTS_GStreamSet_get_speech: get synthesized speech parameter */
 double HTS_GStreamSet_get_speech(HTS_GStreamSet * gss, size_t sample_index)
 {
+   if (gss->gspeech == NULL)
+      return 0.0;
    return gss->gspeech[sample_index];
 }
 
 /* HTS_GStreamSet_get_parameter: get generated parameter */
 double HTS_GStreamSet_get_parameter(HTS_GStreamSet * gss, size_t stream_index, size_t frame_index, size_t vector_index)
 {
+   if (gss->gstream == NULL)
+      return 0.0;
    return gss->gstream[stream_index].par[frame_index][vector_index];
 }
 
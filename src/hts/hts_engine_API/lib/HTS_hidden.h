@@ -92,6 +92,9 @@ HTS_File *HTS_fopen_from_fp(HTS_File * fp, size_t size);
 /* HTS_fopen_from_data: wrapper for fopen */
 HTS_File *HTS_fopen_from_data(void *data, size_t size);
 
+/* HTS_fopen_from_mapped_data: wrapper for fopen, reading data in place */
+HTS_File *HTS_fopen_from_mapped_data(const void *data, size_t size);
+
 /* HTS_fclose: wrapper for fclose */
 void HTS_fclose(HTS_File * fp);
 
@@ -113,6 +116,12 @@ size_t HTS_fread_big_endian(void *buf, size_t size, size_t n, HTS_File * fp);
 /* HTS_fread_little_endian: fread with byteswap */
 size_t HTS_fread_little_endian(void *buf, size_t size, size_t n, HTS_File * fp);
 
+/* HTS_fmappable: whether little endian data in fp can be used in place */
+HTS_Boolean HTS_fmappable(HTS_File * fp);
+
+/* HTS_fmap_little_endian: locate data in a mapped file instead of reading it */
+const void *HTS_fmap_little_endian(size_t size, size_t n, HTS_File * fp);
+
 /* HTS_fwrite_little_endian: fwrite with byteswap */
 size_t HTS_fwrite_little_endian(const void *buf, size_t size, size_t n, FILE * fp);
 
@@ -137,6 +146,9 @@ void *HTS_calloc(const size_t num, const size_t size);
 /* HTS_strdup: wrapper for strdup */
 char *HTS_strdup(const char *string);
 
+/* HTS_is_field_char: letters, digits and non-ASCII bytes make up label fields */
+HTS_Boolean HTS_is_field_char(char c);
+
 /* HTS_calloc_matrix: allocate double matrix */
 double **HTS_alloc_matrix(size_t x, size_t y);
 
@@ -174,6 +186,12 @@ void HTS_ModelSet_initialize(HTS_ModelSet * ms);
 /* HTS_ModelSet_load: load HTS voices */
 HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voices);
 
+/* HTS_ModelSet_load_from_mapped_data: load HTS voices in memory, using their PDFs in place */
+HTS_Boolean HTS_ModelSet_load_from_mapped_data(HTS_ModelSet * ms, const void **data, const size_t * size, size_t num_voices);
+
+/* HTS_ModelSet_share: use the models of another model set, with caches of its own */
+void HTS_ModelSet_share(HTS_ModelSet * ms, HTS_ModelSet * source);
+
 /* HTS_ModelSet_get_sampling_frequency: get sampling frequency of HTS voices */
 size_t HTS_ModelSet_get_sampling_frequency(HTS_ModelSet * ms);
 
@@ -184,7 +202,10 @@ size_t HTS_ModelSet_get_fperiod(HTS_ModelSet * ms);
 const char *HTS_ModelSet_get_option(HTS_ModelSet * ms, size_t stream_index);
 
 /* HTS_ModelSet_get_gv_flag: get GV flag */
-HTS_Boolean HTS_ModelSet_get_gv_flag(HTS_ModelSet * ms, const char *string);
+HTS_Boolean HTS_ModelSet_get_gv_flag(HTS_ModelSet * ms, HTS_LabelString * label);
+
+/* HTS_ModelSet_set_label_format: set the text around the fields of structured labels */
+void HTS_ModelSet_set_label_format(HTS_ModelSet * ms, const char *const *delimiters, size_t num_fields);
 
 /* HTS_ModelSet_get_nstate: get number of state */
 size_t HTS_ModelSet_get_nstate(HTS_ModelSet * ms);
@@ -226,21 +247,21 @@ size_t HTS_ModelSet_get_window_max_width(HTS_ModelSet * ms, size_t stream_index)
 HTS_Boolean HTS_ModelSet_use_gv(HTS_ModelSet * ms, size_t stream_index);
 
 /* HTS_ModelSet_get_duration_index: get index of duration tree and PDF */
-void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, size_t voice_index, const char *string, size_t * tree_index, size_t * pdf_index);
+void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, size_t voice_index, HTS_LabelString * label, size_t * tree_index, size_t * pdf_index);
 
 /* HTS_ModelSet_get_duration: get duration using interpolation weight */
-void HTS_ModelSet_get_duration(HTS_ModelSet * ms, const char *string, const double *iw, double *mean, double *vari);
+void HTS_ModelSet_get_duration(HTS_ModelSet * ms, HTS_LabelString * label, const double *iw, double *mean, double *vari);
 
 /* HTS_ModelSet_get_parameter_index: get index of parameter tree and PDF */
-void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, size_t state_index, const char *string, size_t * tree_index, size_t * pdf_index);
+void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, size_t state_index, HTS_LabelString * label, size_t * tree_index, size_t * pdf_index);
 
 /* HTS_ModelSet_get_parameter: get parameter using interpolation weight */
-void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t state_index, const char *string, const double *const *iw, double *mean, double *vari, double *msd);
+void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t state_index, HTS_LabelString * label, const double *const *iw, double *mean, double *vari, double *msd);
 
-void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, const char *string, size_t * tree_index, size_t * pdf_index);
+void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, HTS_LabelString * label, size_t * tree_index, size_t * pdf_index);
 
 /* HTS_ModelSet_get_gv: get GV using interpolation weight */
-void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, const char *string, const double *const *iw, double *mean, double *vari);
+void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, HTS_LabelString * label, const double *const *iw, double *mean, double *vari);
 
 /* HTS_ModelSet_clear: free model set */
 void HTS_ModelSet_clear(HTS_ModelSet * ms);
@@ -256,12 +277,21 @@ void HTS_Label_load_from_fn(HTS_Label * label, size_t sampling_rate, size_t fper
 /* HTS_Label_load_from_strings: load label list from string list */
 void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t fperiod, char **lines, size_t num_lines);
 
+/* HTS_Label_load_from_fields: load structured labels, format->num_fields values each */
+void HTS_Label_load_from_fields(HTS_Label * label, const HTS_LabelFormat * format, const char *const *fields, size_t num_labels);
+
+/* HTS_LabelString_get_name: get label string, made from the fields of a structured label */
+const char *HTS_LabelString_get_name(HTS_LabelString * lstring);
+
 /* HTS_Label_get_size: get number of label string */
 size_t HTS_Label_get_size(HTS_Label * label);
 
 /* HTS_Label_get_string: get label string */
 const char *HTS_Label_get_string(HTS_Label * label, size_t index);
 
+/* HTS_Label_get_label_string: get individual label string */
+HTS_LabelString *HTS_Label_get_label_string(HTS_Label * label, size_t index);
+
 /* HTS_Label_get_start_frame: get start frame */
 double HTS_Label_get_start_frame(HTS_Label * label, size_t index);
 
@@ -399,6 +429,9 @@ void HTS_GStreamSet_initialize(HTS_GStreamSet * gss);
 /* HTS_GStreamSet_create: generate speech */
 HTS_Boolean HTS_GStreamSet_create(HTS_GStreamSet * gss, HTS_PStreamSet * pss, size_t stage, HTS_Boolean use_log_gain, size_t sampling_rate, size_t fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, HTS_Audio * audio);
 
+/* HTS_GStreamSet_create_with_callback: generate speech frame by frame, passing it to callback */
+HTS_Boolean HTS_GStreamSet_create_with_callback(HTS_GStreamSet * gss, HTS_PStreamSet * pss, size_t stage, HTS_Boolean use_log_gain, size_t sampling_rate, size_t fperiod, double alpha, double beta, HTS_Boolean * stop, double volume, size_t buff_size, HTS_SampleCallback callback, void *user_data);
+
 /* HTS_GStreamSet_get_total_nsamples: get total number of sample */
 size_t HTS_GStreamSet_get_total_nsamples(HTS_GStreamSet * gss);
 
@@ -495,6 +528,7 @@ typedef struct _HTS_Vocoder {
    double *gc2gc_buff;          /* used in gc2gc */
    size_t gc2gc_size;           /* buffer size for gc2gc */
    int d2offset;
+   double *frame_buff;          /* excitation of the current frame */
 } HTS_Vocoder;
 
 /* HTS_Vocoder_initialize: initialize vocoder */
@@ -57,6 +57,7 @@ HTS_LABEL_C_START;
 
 #include <stdlib.h>             /* for atof() */
 #include <ctype.h>              /* for isgraph(),isdigit() */
+#include <string.h>             /* for strlen(),memcpy() */
 
 /* hts_engine libraries */
 #include "HTS_hidden.h"
@@ -200,6 +201,80 @@ void HTS_Label_load_from_strings(HTS_Label * label, size_t sampling_rate, size_t
    HTS_Label_check_time(label);
 }
 
+/* HTS_Label_load_from_fields: load structured labels, format->num_fields values each */
+void HTS_Label_load_from_fields(HTS_Label * label, const HTS_LabelFormat * format, const char *const *fields, size_t num_labels)
+{
+   HTS_LabelString *lstring = NULL;
+   const char *const *values;
+   char *buff;
+   size_t i, j, k, size;
+
+   if (label->head || label->size != 0) {
+      HTS_error(1, "HTS_Label_load_from_fields: label list is not initialized.\n");
+      return;
+   }
+   for (i = 0; i < num_labels; i++) {
+      label->size++;
+
+      if (lstring) {
+         lstring->next = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         lstring = lstring->next;
+      } else {                  /* first time */
+         lstring = (HTS_LabelString *) HTS_calloc(1, sizeof(HTS_LabelString));
+         label->head = lstring;
+      }
+      /* the values go in one block after the field pointers */
+      values = fields + i * format->num_fields;
+      for (j = 0, size = 0; j < format->num_fields; j++)
+         size += strlen(values[j]) + 1;
+      lstring->field = (char **) HTS_calloc(1, format->num_fields * sizeof(char *) + size);
+      lstring->fields_size = size;
+      lstring->regular = TRUE;
+      buff = (char *) (lstring->field + format->num_fields);
+      for (j = 0; j < format->num_fields; j++) {
+         lstring->field[j] = buff;
+         for (k = 0; values[j][k] != '\0'; k++)
+            if (!HTS_is_field_char(values[j][k]))
+               lstring->regular = FALSE;
+         if (k == 0)
+            lstring->regular = FALSE;
+         memcpy(buff, values[j], k + 1);
+         buff += k + 1;
+      }
+      lstring->format = format;
+      lstring->name = NULL;
+      lstring->start = -1.0;
+      lstring->end = -1.0;
+      lstring->next = NULL;
+   }
+   HTS_Label_check_time(label);
+}
+
+/* HTS_LabelString_get_name: get label string, made from the fields of a structured label */
+const char *HTS_LabelString_get_name(HTS_LabelString * lstring)
+{
+   const HTS_LabelFormat *format = lstring->format;
+   size_t i, size;
+   char *buff;
+
+   if (lstring->name != NULL || lstring->field == NULL)
+      return lstring->name;
+
+   size = lstring->fields_size + strlen(format->delimiter[format->num_fields]);
+   for (i = 0; i < format->num_fields; i++)
+      size += strlen(format->delimiter[i]);
+   lstring->name = buff = (char *) HTS_calloc(size, sizeof(char));
+   for (i = 0; i < format->num_fields; i++) {
+      strcpy(buff, format->delimiter[i]);
+      buff += strlen(buff);
+      strcpy(buff, lstring->field[i]);
+      buff += strlen(buff);
+   }
+   strcpy(buff, format->delimiter[format->num_fields]);
+
+   return lstring->name;
+}
+
 /* HTS_Label_get_size: get number of label string */
 size_t HTS_Label_get_size(HTS_Label * label)
 {
@@ -216,7 +291,18 @@ const char *HTS_Label_get_string(HTS_Label * label, size_t index)
       lstring = lstring->next;
    if (!lstring)
       return NULL;
-   return lstring->name;
+   return HTS_LabelString_get_name(lstring);
+}
+
+/* HTS_Label_get_label_string: get individual label string */
+HTS_LabelString *HTS_Label_get_label_string(HTS_Label * label, size_t index)
+{
+   size_t i;
+   HTS_LabelString *lstring = label->head;
+
+   for (i = 0; i < index && lstring; i++)
+      lstring = lstring->next;
+   return lstring;
 }
 
 /* HTS_Label_get_start_frame: get start frame */
@@ -252,7 +338,10 @@ void HTS_Label_clear(HTS_Label * label)
 
    for (lstring = label->head; lstring; lstring = next_lstring) {
       next_lstring = lstring->next;
-      HTS_free(lstring->name);
+      if (lstring->name != NULL)
+         HTS_free(lstring->name);
+      if (lstring->field != NULL)
+         HTS_free(lstring->field);
       HTS_free(lstring);
    }
    HTS_Label_initialize(label);
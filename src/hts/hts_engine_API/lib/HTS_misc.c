@@ -58,6 +58,7 @@ HTS_MISC_C_START;
 #include <stdlib.h>             /* for exit(),calloc(),free() */
 #include <stdarg.h>             /* for va_list */
 #include <string.h>             /* for strcpy(),strlen() */
+#include <ctype.h>              /* for isalnum() */
 
 /* hts_engine libraries */
 #include "HTS_hidden.h"
@@ -73,6 +74,7 @@ typedef struct _HTS_Data {
    unsigned char *data;
    size_t size;
    size_t index;
+   HTS_Boolean mapped;          /* data belongs to the caller, e.g. a mapped file */
 } HTS_Data;
 
 /* HTS_fopen_from_fn: wrapper for fopen */
@@ -104,6 +106,7 @@ HTS_File *HTS_fopen_from_fp(HTS_File * fp, size_t size)
       d->data = (unsigned char *) HTS_calloc(size, sizeof(unsigned char));
       d->size = size;
       d->index = 0;
+      d->mapped = FALSE;
       if (fread(d->data, sizeof(unsigned char), size, (FILE *) fp->pointer) != size) {
          free(d->data);
          free(d);
@@ -120,10 +123,16 @@ HTS_File *HTS_fopen_from_fp(HTS_File * fp, size_t size)
       if (tmp1->index + size > tmp1->size)
          return NULL;
       tmp2 = (HTS_Data *) HTS_calloc(1, sizeof(HTS_Data));
-      tmp2->data = (unsigned char *) HTS_calloc(size, sizeof(unsigned char));
       tmp2->size = size;
       tmp2->index = 0;
-      memcpy(tmp2->data, &tmp1->data[tmp1->index], size);
+      tmp2->mapped = tmp1->mapped;
+      if (tmp1->mapped) {
+         /* a view on the same mapping, nothing to copy */
+         tmp2->data = &tmp1->data[tmp1->index];
+      } else {
+         tmp2->data = (unsigned char *) HTS_calloc(size, sizeof(unsigned char));
+         memcpy(tmp2->data, &tmp1->data[tmp1->index], size);
+      }
       tmp1->index += size;
       f = (HTS_File *) HTS_calloc(1, sizeof(HTS_File));
       f->type = HTS_DATA;
@@ -148,6 +157,7 @@ HTS_File *HTS_fopen_from_data(void *data, size_t size)
    d->data = (unsigned char *) HTS_calloc(size, sizeof(unsigned char));
    d->size = size;
    d->index = 0;
+   d->mapped = FALSE;
 
    memcpy(d->data, data, size);
 
@@ -158,6 +168,28 @@ HTS_File *HTS_fopen_from_data(void *data, size_t size)
    return f;
 }
 
+/* HTS_fopen_from_mapped_data: wrapper for fopen, reading data in place */
+HTS_File *HTS_fopen_from_mapped_data(const void *data, size_t size)
+{
+   HTS_Data *d;
+   HTS_File *f;
+
+   if (data == NULL || size == 0)
+      return NULL;
+
+   d = (HTS_Data *) HTS_calloc(1, sizeof(HTS_Data));
+   d->data = (unsigned char *) data;
+   d->size = size;
+   d->index = 0;
+   d->mapped = TRUE;
+
+   f = (HTS_File *) HTS_calloc(1, sizeof(HTS_File));
+   f->type = HTS_DATA;
+   f->pointer = (void *) d;
+
+   return f;
+}
+
 /* HTS_fclose: wrapper for fclose */
 void HTS_fclose(HTS_File * fp)
 {
@@ -171,7 +203,7 @@ void HTS_fclose(HTS_File * fp)
    } else if (fp->type == HTS_DATA) {
       if (fp->pointer != NULL) {
          HTS_Data *d = (HTS_Data *) fp->pointer;
-         if (d->data != NULL)
+         if (d->data != NULL && !d->mapped)
             HTS_free(d->data);
          HTS_free(d);
       }
@@ -329,6 +361,36 @@ size_t HTS_fread_little_endian(void *buf, size_t size, size_t n, HTS_File * fp)
    return block;
 }
 
+/* HTS_fmappable: whether little endian data in fp can be used in place */
+HTS_Boolean HTS_fmappable(HTS_File * fp)
+{
+#ifdef WORDS_BIGENDIAN
+   return FALSE;
+#else
+   if (fp == NULL || fp->type != HTS_DATA)
+      return FALSE;
+   return ((HTS_Data *) fp->pointer)->mapped;
+#endif                          /* WORDS_BIGENDIAN */
+}
+
+/* HTS_fmap_little_endian: as HTS_fread_little_endian(), but returns where */
+/* the data lies in a mappable file instead of copying it, NULL at the end */
+/* of the file.  The result needn't be aligned for the type.               */
+const void *HTS_fmap_little_endian(size_t size, size_t n, HTS_File * fp)
+{
+   HTS_Data *d;
+   const void *p;
+
+   if (HTS_fmappable(fp) != TRUE || size == 0 || n == 0)
+      return NULL;
+   d = (HTS_Data *) fp->pointer;
+   if (d->index + size * n > d->size)
+      return NULL;
+   p = &d->data[d->index];
+   d->index += size * n;
+   return p;
+}
+
 /* HTS_fwrite_little_endian: fwrite with byteswap */
 size_t HTS_fwrite_little_endian(const void *buf, size_t size, size_t n, FILE * fp)
 {
@@ -561,6 +623,12 @@ char *HTS_strdup(const char *string)
 #endif                          /* FESTIVAL */
 }
 
+/* HTS_is_field_char: letters, digits and non-ASCII bytes make up label fields */
+HTS_Boolean HTS_is_field_char(char c)
+{
+   return (isalnum((unsigned char) c) || (unsigned char) c >= 0x80) ? TRUE : FALSE;
+}
+
 /* HTS_alloc_matrix: allocate double matrix */
 double **HTS_alloc_matrix(size_t x, size_t y)
 {
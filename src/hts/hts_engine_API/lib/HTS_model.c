@@ -110,7 +110,10 @@ static HTS_Boolean HTS_pattern_match(const char *string, const char *pattern)
          max++;
       }
    }
-   if (nstar == 2 && nquestion == 0 && pattern[0] == '*' && pattern[i - 1] == '*') {
+   if (nstar == pattern_length) {
+      /* only stars, e.g. the "{*}" of trees for all contexts */
+      return TRUE;
+   } else if (nstar == 2 && nquestion == 0 && pattern[0] == '*' && pattern[i - 1] == '*') {
       /* only string matching is required */
       buff_length = i - 2;
       for (i = 0, j = 1; i < buff_length; i++, j++)
@@ -170,6 +173,9 @@ static void HTS_Question_initialize(HTS_Question * question)
 {
    question->string = NULL;
    question->head = NULL;
+   question->index = 0;
+   question->compiled = FALSE;
+   question->format_compiled = FALSE;
    question->next = NULL;
 }
 
@@ -258,6 +264,314 @@ static HTS_Question *HTS_Question_find(HTS_Question * question, const char *stri
    return NULL;
 }
 
+/* HTS_field_hash: hash a field with the delimiters either side of it */
+static size_t HTS_field_hash(char left, const char *value, size_t length, char right)
+{
+   size_t i, h = 2166136261u;
+
+   h = (h ^ (unsigned char) left) * 16777619u;
+   for (i = 0; i < length; i++)
+      h = (h ^ (unsigned char) value[i]) * 16777619u;
+   h = (h ^ (unsigned char) right) * 16777619u;
+
+   return h;
+}
+
+/* HTS_wild_equal: compare text with literal, where '?' matches any character */
+static HTS_Boolean HTS_wild_equal(const char *text, const char *literal, size_t length)
+{
+   size_t i;
+
+   for (i = 0; i < length; i++)
+      if (literal[i] != '?' && literal[i] != text[i])
+         return FALSE;
+
+   return TRUE;
+}
+
+/* HTS_strndup: copy the first length characters of string */
+static char *HTS_strndup(const char *string, size_t length)
+{
+   char *buff = (char *) HTS_calloc(length + 1, sizeof(char));
+
+   memcpy(buff, string, length);
+   buff[length] = '\0';
+
+   return buff;
+}
+
+/* HTS_FieldTest_create: compile pattern to a test on one field of the label */
+/* Fields are maximal runs of HTS_is_field_char(), so a pattern that has a   */
+/* run bounded by literal delimiters (or by an unstarred end) matches where  */
+/* the label has that very field between those delimiters, with the rest of */
+/* the pattern around it.  Returns NULL for patterns that can't be compiled. */
+static HTS_FieldTest *HTS_FieldTest_create(const char *pattern, size_t question)
+{
+   HTS_FieldTest *test;
+   HTS_Boolean lead = FALSE, trail = FALSE;
+   size_t length = strlen(pattern);
+   size_t s, e;
+
+   if (length > 0 && pattern[0] == '*') {
+      lead = TRUE;
+      pattern++;
+      length--;
+   }
+   if (length > 0 && pattern[length - 1] == '*') {
+      trail = TRUE;
+      length--;
+   }
+   if (length == 0 || memchr(pattern, '*', length) != NULL)
+      return NULL;
+
+   for (s = 0; s < length; s = e) {
+      if (!HTS_is_field_char(pattern[s])) {
+         e = s + 1;
+         continue;
+      }
+      for (e = s; e < length && HTS_is_field_char(pattern[e]); e++);
+      /* the run must be a whole field, '?' or '*' next to it may be more of it */
+      if ((s == 0) ? lead : (pattern[s - 1] == '?'))
+         continue;
+      if ((e == length) ? trail : (pattern[e] == '?'))
+         continue;
+
+      test = (HTS_FieldTest *) HTS_calloc(1, sizeof(HTS_FieldTest));
+      test->left = (s > 0) ? pattern[s - 1] : '\0';
+      test->right = (e < length) ? pattern[e] : '\0';
+      test->value = HTS_strndup(pattern + s, e - s);
+      test->value_length = e - s;
+      test->before = HTS_strndup(pattern, (s > 0) ? s - 1 : 0);
+      test->after = HTS_strndup(pattern + e + 1, (e < length) ? length - e - 1 : 0);
+      test->anchored_start = (!lead && s > 0) ? TRUE : FALSE;
+      test->anchored_end = (!trail && e < length) ? TRUE : FALSE;
+      test->question = question;
+      test->next = NULL;
+      return test;
+   }
+
+   return NULL;
+}
+
+/* HTS_FieldTest_clear: free field test */
+static void HTS_FieldTest_clear(HTS_FieldTest * test)
+{
+   HTS_free(test->value);
+   HTS_free(test->before);
+   HTS_free(test->after);
+}
+
+/* HTS_format_hash: hash a value of field index */
+static size_t HTS_format_hash(size_t index, const char *value, size_t length)
+{
+   size_t i, h = 2166136261u;
+
+   h = (h ^ index) * 16777619u;
+   for (i = 0; i < length; i++)
+      h = (h ^ (unsigned char) value[i]) * 16777619u;
+
+   return h;
+}
+
+/* HTS_FormatTest_clear: free format test */
+static void HTS_FormatTest_clear(HTS_FormatTest * test)
+{
+   size_t i;
+
+   for (i = 0; i < test->num_fields; i++)
+      HTS_free(test->value[i]);
+   if (test->value != NULL)
+      HTS_free(test->value);
+   if (test->field != NULL)
+      HTS_free(test->field);
+}
+
+/* HTS_FormatTest_free_list: free a list of format tests */
+static void HTS_FormatTest_free_list(HTS_FormatTest * test)
+{
+   HTS_FormatTest *next_test;
+
+   for (; test; test = next_test) {
+      next_test = test->next;
+      HTS_FormatTest_clear(test);
+      HTS_free(test);
+   }
+}
+
+/* HTS_FormatTest_check: check fields from index first on of a structured label */
+static HTS_Boolean HTS_FormatTest_check(HTS_FormatTest * test, HTS_LabelString * label, size_t first)
+{
+   size_t i, length;
+
+   for (i = first; i < test->num_fields; i++) {
+      length = strlen(test->value[i]);
+      if (strlen(label->field[test->field[i]]) != length || !HTS_wild_equal(label->field[test->field[i]], test->value[i], length))
+         return FALSE;
+   }
+
+   return TRUE;
+}
+
+/* HTS_FormatAlign: state of HTS_FormatTest_align() */
+typedef struct _HTS_FormatAlign {
+   const HTS_LabelFormat *format;
+   const char *literal;         /* pattern without its leading and trailing '*' */
+   size_t length;
+   HTS_Boolean trail;           /* pattern ends with '*' */
+   size_t question;
+   size_t num_fields;           /* fields fixed so far */
+   size_t *field;
+   size_t *start;               /* where their values are in literal */
+   size_t *value_length;
+   HTS_FormatTest *tests;       /* alignments found */
+} HTS_FormatAlign;
+
+/* HTS_FormatAlign_add: add the fields fixed so far as a test */
+static void HTS_FormatAlign_add(HTS_FormatAlign * align)
+{
+   HTS_FormatTest *test = (HTS_FormatTest *) HTS_calloc(1, sizeof(HTS_FormatTest));
+   size_t i, n, first = 0;
+
+   /* the hashed field must have an exact value */
+   for (i = 0; i < align->num_fields; i++)
+      if (memchr(align->literal + align->start[i], '?', align->value_length[i]) == NULL) {
+         first = i;
+         break;
+      }
+   test->num_fields = align->num_fields;
+   if (test->num_fields > 0) {
+      test->field = (size_t *) HTS_calloc(test->num_fields, sizeof(size_t));
+      test->value = (char **) HTS_calloc(test->num_fields, sizeof(char *));
+   }
+   for (i = 0; i < test->num_fields; i++) {
+      n = (i == 0) ? first : ((i <= first) ? i - 1 : i);
+      test->field[i] = align->field[n];
+      test->value[i] = HTS_strndup(align->literal + align->start[n], align->value_length[n]);
+   }
+   test->question = align->question;
+   test->next = align->tests;
+   align->tests = test;
+}
+
+/* HTS_FormatTest_align: find where the rest of the literal from j can lie */
+/* in the format, from offset k of delimiter i on, for labels whose values */
+/* are nonempty runs of HTS_is_field_char().  Returns FALSE if one of the  */
+/* places needs a field to only start or end with something.               */
+static HTS_Boolean HTS_FormatTest_align(HTS_FormatAlign * align, size_t j, size_t i, size_t k)
+{
+   const char *delimiter = align->format->delimiter[i];
+   const char *literal = align->literal;
+   size_t m, r;
+
+   for (; delimiter[k] != '\0' && j < align->length; j++, k++)
+      if (literal[j] != '?' && literal[j] != delimiter[k])
+         return TRUE;
+   if (j == align->length) {
+      if (align->trail || (delimiter[k] == '\0' && i == align->format->num_fields))
+         HTS_FormatAlign_add(align);
+      return TRUE;
+   }
+   if (i == align->format->num_fields)
+      return TRUE;
+
+   /* the value of field i */
+   for (r = 0; j + r < align->length && (literal[j + r] == '?' || HTS_is_field_char(literal[j + r])); r++);
+   for (m = 1; m <= r; m++) {
+      if (j + m == align->length && align->trail)
+         return FALSE;
+      align->field[align->num_fields] = i;
+      align->start[align->num_fields] = j;
+      align->value_length[align->num_fields] = m;
+      align->num_fields++;
+      if (j + m == align->length) {
+         if (i + 1 == align->format->num_fields && align->format->delimiter[i + 1][0] == '\0')
+            HTS_FormatAlign_add(align);
+      } else if (!HTS_FormatTest_align(align, j + m, i + 1, 0)) {
+         align->num_fields--;
+         return FALSE;
+      }
+      align->num_fields--;
+   }
+
+   return TRUE;
+}
+
+/* HTS_FormatTest_create: compile pattern to tests on the fields of structured */
+/* labels, one for each place it can match.  Returns FALSE if it can't be.     */
+static HTS_Boolean HTS_FormatTest_create(const char *pattern, const HTS_LabelFormat * format, size_t question, HTS_FormatTest ** tests)
+{
+   HTS_FormatAlign align;
+   HTS_Boolean lead = FALSE, result = TRUE;
+   size_t length = strlen(pattern);
+   size_t i, k;
+
+   align.trail = FALSE;
+   if (length > 0 && pattern[0] == '*') {
+      lead = TRUE;
+      pattern++;
+      length--;
+   }
+   if (length > 0 && pattern[length - 1] == '*') {
+      align.trail = TRUE;
+      length--;
+   }
+   if (memchr(pattern, '*', length) != NULL)
+      return FALSE;
+   /* after a '*', the literal could start inside a value */
+   if (lead && length > 0 && (pattern[0] == '?' || HTS_is_field_char(pattern[0])))
+      return FALSE;
+
+   align.format = format;
+   align.literal = pattern;
+   align.length = length;
+   align.question = question;
+   align.num_fields = 0;
+   align.field = (size_t *) HTS_calloc(length + 1, sizeof(size_t));
+   align.start = (size_t *) HTS_calloc(length + 1, sizeof(size_t));
+   align.value_length = (size_t *) HTS_calloc(length + 1, sizeof(size_t));
+   align.tests = NULL;
+
+   if (length == 0) {
+      if (lead || align.trail)
+         HTS_FormatAlign_add(&align);
+   } else if (!lead) {
+      result = HTS_FormatTest_align(&align, 0, 0, 0);
+   } else {
+      for (i = 0; i <= format->num_fields && result; i++)
+         for (k = 0; format->delimiter[i][k] != '\0' && result; k++)
+            result = HTS_FormatTest_align(&align, 0, i, k);
+   }
+
+   HTS_free(align.field);
+   HTS_free(align.start);
+   HTS_free(align.value_length);
+   if (!result) {
+      HTS_FormatTest_free_list(align.tests);
+      return FALSE;
+   }
+   while (align.tests != NULL) {
+      HTS_FormatTest *test = align.tests;
+      align.tests = test->next;
+      test->next = *tests;
+      *tests = test;
+   }
+
+   return TRUE;
+}
+
+/* HTS_Question_compile_format: compile the patterns of question to format tests */
+static void HTS_Question_compile_format(HTS_Question * question, const HTS_LabelFormat * format, HTS_FormatTest ** tests)
+{
+   HTS_Pattern *pattern;
+
+   question->format_compiled = TRUE;
+   for (pattern = question->head; pattern; pattern = pattern->next) {
+      pattern->format_compiled = HTS_FormatTest_create(pattern->string, format, question->index, tests);
+      if (!pattern->format_compiled)
+         question->format_compiled = FALSE;
+   }
+}
+
 /* HTS_Node_initialzie: initialize node */
 static void HTS_Node_initialize(HTS_Node * node)
 {
@@ -430,15 +744,25 @@ static HTS_Boolean HTS_Tree_load(HTS_Tree * tree, HTS_File * fp, HTS_Question *
    return TRUE;
 }
 
-/* HTS_Node_search: tree search */
-static size_t HTS_Tree_search_node(HTS_Tree * tree, const char *string)
+/* HTS_Node_search: tree search, with the model's match set for label */
+/* format says whether that set came from the fields of the label      */
+static size_t HTS_Tree_search_node(HTS_Tree * tree, HTS_Model * model, HTS_LabelString * label, HTS_Boolean format)
 {
    HTS_Node *node = tree->root;
+   HTS_Question *question;
+   HTS_Pattern *pattern;
+   HTS_Boolean match;
 
    while (node != NULL) {
       if (node->quest == NULL)
          return node->pdf;
-      if (HTS_Question_match(node->quest, string)) {
+      question = node->quest;
+      match = (model->match_set[question->index / 8] >> (question->index % 8)) & 1;
+      if (!match && !(format ? question->format_compiled : question->compiled))
+         for (pattern = question->head; pattern && !match; pattern = pattern->next)
+            if (!(format ? pattern->format_compiled : pattern->compiled))
+               match = HTS_pattern_match(HTS_LabelString_get_name(label), pattern->string);
+      if (match) {
          if (node->yes->pdf > 0)
             return node->yes->pdf;
          node = node->yes;
@@ -554,8 +878,38 @@ static void HTS_Model_initialize(HTS_Model * model)
    model->ntree = 0;
    model->npdf = NULL;
    model->pdf = NULL;
+   model->pdf_mapped = FALSE;
    model->tree = NULL;
    model->question = NULL;
+   model->num_questions = 0;
+   model->field_test = NULL;
+   model->field_test_size = 0;
+   model->format_test = NULL;
+   model->format_test_size = 0;
+   model->format_wild = NULL;
+   model->match_label = NULL;
+   model->match_fields = NULL;
+   model->match_fields_size = 0;
+   model->match_set = NULL;
+}
+
+/* HTS_Model_clear_format: free the tests compiled to a label format */
+static void HTS_Model_clear_format(HTS_Model * model)
+{
+   size_t i;
+
+   for (i = 0; i < model->format_test_size; i++)
+      HTS_FormatTest_free_list(model->format_test[i]);
+   if (model->format_test)
+      HTS_free(model->format_test);
+   HTS_FormatTest_free_list(model->format_wild);
+   if (model->match_fields)
+      HTS_free(model->match_fields);
+   model->format_test = NULL;
+   model->format_test_size = 0;
+   model->format_wild = NULL;
+   model->match_fields = NULL;
+   model->match_fields_size = 0;
 }
 
 /* HTS_Model_clear: free pdfs and trees */
@@ -564,7 +918,22 @@ static void HTS_Model_clear(HTS_Model * model)
    size_t i, j;
    HTS_Question *question, *next_question;
    HTS_Tree *tree, *next_tree;
+   HTS_FieldTest *test, *next_test;
 
+   for (i = 0; i < model->field_test_size; i++) {
+      for (test = model->field_test[i]; test; test = next_test) {
+         next_test = test->next;
+         HTS_FieldTest_clear(test);
+         HTS_free(test);
+      }
+   }
+   if (model->field_test)
+      HTS_free(model->field_test);
+   HTS_Model_clear_format(model);
+   if (model->match_label)
+      HTS_free(model->match_label);
+   if (model->match_set)
+      HTS_free(model->match_set);
    for (question = model->question; question; question = next_question) {
       next_question = question->next;
       HTS_Question_clear(question);
@@ -577,9 +946,9 @@ static void HTS_Model_clear(HTS_Model * model)
    }
    if (model->pdf) {
       for (i = 2; i <= model->ntree + 1; i++) {
-         for (j = 1; j <= model->npdf[i]; j++) {
-            HTS_free(model->pdf[i][j]);
-         }
+         if (!model->pdf_mapped)
+            for (j = 1; j <= model->npdf[i]; j++)
+               HTS_free(model->pdf[i][j]);
          model->pdf[i]++;
          HTS_free(model->pdf[i]);
       }
@@ -593,6 +962,191 @@ static void HTS_Model_clear(HTS_Model * model)
    HTS_Model_initialize(model);
 }
 
+/* HTS_Model_share: use the pdfs, trees and tests of source, with match caches of its own */
+static void HTS_Model_share(HTS_Model * model, HTS_Model * source)
+{
+   *model = *source;
+   model->match_label = NULL;
+   model->match_fields = NULL;
+   model->match_fields_size = 0;
+   if (source->match_set != NULL)
+      model->match_set = (unsigned char *) HTS_calloc((model->num_questions + 7) / 8, sizeof(unsigned char));
+}
+
+/* HTS_Model_clear_shared: free the match caches of a shared model */
+static void HTS_Model_clear_shared(HTS_Model * model)
+{
+   if (model->match_label)
+      HTS_free(model->match_label);
+   if (model->match_fields)
+      HTS_free(model->match_fields);
+   if (model->match_set)
+      HTS_free(model->match_set);
+   HTS_Model_initialize(model);
+}
+
+/* HTS_Model_compile_questions: compile question patterns into field tests */
+static void HTS_Model_compile_questions(HTS_Model * model)
+{
+   HTS_Question *question;
+   HTS_Pattern *pattern;
+   HTS_FieldTest *test, *next_test, *tests = NULL;
+   size_t i, n = 0;
+
+   if (model->num_questions == 0)
+      return;
+   for (question = model->question; question; question = question->next) {
+      question->compiled = TRUE;
+      for (pattern = question->head; pattern; pattern = pattern->next) {
+         if ((test = HTS_FieldTest_create(pattern->string, question->index)) == NULL) {
+            question->compiled = FALSE;
+            continue;
+         }
+         pattern->compiled = TRUE;
+         test->next = tests;
+         tests = test;
+         n++;
+      }
+   }
+
+   for (model->field_test_size = 1; model->field_test_size < 2 * n; model->field_test_size *= 2);
+   model->field_test = (HTS_FieldTest **) HTS_calloc(model->field_test_size, sizeof(HTS_FieldTest *));
+   for (test = tests; test; test = next_test) {
+      next_test = test->next;
+      i = HTS_field_hash(test->left, test->value, test->value_length, test->right) & (model->field_test_size - 1);
+      test->next = model->field_test[i];
+      model->field_test[i] = test;
+   }
+   model->match_set = (unsigned char *) HTS_calloc((model->num_questions + 7) / 8, sizeof(unsigned char));
+}
+
+/* HTS_Model_match_label: find the compiled questions string answers yes to */
+/* Each field of the label is looked up once, so every question for this  */
+/* label is then a bit test.  The set is kept while the label stays the    */
+/* same, models are only used by one engine, and one thread, at a time.   */
+static void HTS_Model_match_label(HTS_Model * model, const char *string)
+{
+   HTS_FieldTest *test;
+   size_t length, s, e, nb, na;
+   char left, right;
+
+   if (model->match_set == NULL)
+      return;
+   if (model->match_label != NULL && strcmp(model->match_label, string) == 0)
+      return;
+   if (model->match_label != NULL)
+      HTS_free(model->match_label);
+   if (model->match_fields != NULL) {
+      HTS_free(model->match_fields);
+      model->match_fields = NULL;
+   }
+   model->match_label = HTS_strdup(string);
+   memset(model->match_set, 0, (model->num_questions + 7) / 8);
+
+   length = strlen(string);
+   for (s = 0; s < length; s = e) {
+      if (!HTS_is_field_char(string[s])) {
+         e = s + 1;
+         continue;
+      }
+      for (e = s; e < length && HTS_is_field_char(string[e]); e++);
+      left = (s > 0) ? string[s - 1] : '\0';
+      right = string[e];
+      test = model->field_test[HTS_field_hash(left, string + s, e - s, right) & (model->field_test_size - 1)];
+      for (; test; test = test->next) {
+         if (test->left != left || test->right != right || test->value_length != e - s || memcmp(test->value, string + s, e - s) != 0)
+            continue;
+         if (left != '\0') {
+            nb = strlen(test->before);
+            if (nb + 1 > s || !HTS_wild_equal(string + s - 1 - nb, test->before, nb))
+               continue;
+            if (test->anchored_start && s - 1 - nb != 0)
+               continue;
+         }
+         if (right != '\0') {
+            na = strlen(test->after);
+            if (e + 1 + na > length || !HTS_wild_equal(string + e + 1, test->after, na))
+               continue;
+            if (test->anchored_end && e + 1 + na != length)
+               continue;
+         }
+         model->match_set[test->question / 8] |= 1 << (test->question % 8);
+      }
+   }
+}
+
+/* HTS_Model_compile_format: compile question patterns to tests on the fields of structured labels */
+static void HTS_Model_compile_format(HTS_Model * model, const HTS_LabelFormat * format)
+{
+   HTS_Question *question;
+   HTS_FormatTest *test, *next_test, *tests = NULL;
+   size_t i, n = 0;
+
+   HTS_Model_clear_format(model);
+   if (model->num_questions == 0)
+      return;
+   for (question = model->question; question; question = question->next)
+      HTS_Question_compile_format(question, format, &tests);
+   for (test = tests; test; test = test->next)
+      n++;
+
+   for (model->format_test_size = 1; model->format_test_size < 2 * n; model->format_test_size *= 2);
+   model->format_test = (HTS_FormatTest **) HTS_calloc(model->format_test_size, sizeof(HTS_FormatTest *));
+   for (test = tests; test; test = next_test) {
+      next_test = test->next;
+      if (test->num_fields == 0 || strchr(test->value[0], '?') != NULL) {
+         test->next = model->format_wild;
+         model->format_wild = test;
+      } else {
+         i = HTS_format_hash(test->field[0], test->value[0], strlen(test->value[0])) & (model->format_test_size - 1);
+         test->next = model->format_test[i];
+         model->format_test[i] = test;
+      }
+   }
+}
+
+/* HTS_Model_match_fields: find the questions a structured label answers yes to */
+/* As HTS_Model_match_label(), but each field is looked up as it is            */
+static void HTS_Model_match_fields(HTS_Model * model, HTS_LabelString * label)
+{
+   HTS_FormatTest *test;
+   size_t i, length;
+
+   if (model->match_set == NULL)
+      return;
+   if (model->match_fields != NULL && model->match_fields_size == label->fields_size && memcmp(model->match_fields, label->field[0], label->fields_size) == 0)
+      return;
+   if (model->match_label != NULL) {
+      HTS_free(model->match_label);
+      model->match_label = NULL;
+   }
+   if (model->match_fields != NULL)
+      HTS_free(model->match_fields);
+   model->match_fields = (char *) HTS_calloc(label->fields_size, sizeof(char));
+   memcpy(model->match_fields, label->field[0], label->fields_size);
+   model->match_fields_size = label->fields_size;
+   memset(model->match_set, 0, (model->num_questions + 7) / 8);
+
+   for (i = 0; i < label->format->num_fields; i++) {
+      length = strlen(label->field[i]);
+      test = model->format_test[HTS_format_hash(i, label->field[i], length) & (model->format_test_size - 1)];
+      for (; test; test = test->next)
+         if (test->field[0] == i && strcmp(test->value[0], label->field[i]) == 0 && HTS_FormatTest_check(test, label, 1))
+            model->match_set[test->question / 8] |= 1 << (test->question % 8);
+   }
+   for (test = model->format_wild; test; test = test->next)
+      if (HTS_FormatTest_check(test, label, 0))
+         model->match_set[test->question / 8] |= 1 << (test->question % 8);
+}
+
+/* HTS_label_match: match pattern against label, only making the label string if needed */
+static HTS_Boolean HTS_label_match(HTS_LabelString * label, const char *pattern)
+{
+   if (pattern[0] != '\0' && pattern[strspn(pattern, "*")] == '\0')
+      return TRUE;
+   return HTS_pattern_match(HTS_LabelString_get_name(label), pattern);
+}
+
 /* HTS_Model_load_tree: load trees */
 static HTS_Boolean HTS_Model_load_tree(HTS_Model * model, HTS_File * fp)
 {
@@ -631,6 +1185,7 @@ static HTS_Boolean HTS_Model_load_tree(HTS_Model * model, HTS_File * fp)
          else
             model->question = question;
          question->next = NULL;
+         question->index = model->num_questions++;
          last_question = question;
       }
       /* parse trees */
@@ -658,6 +1213,8 @@ static HTS_Boolean HTS_Model_load_tree(HTS_Model * model, HTS_File * fp)
    if (model->tree == NULL)
       model->ntree = 1;
 
+   HTS_Model_compile_questions(model);
+
    return TRUE;
 }
 
@@ -702,20 +1259,28 @@ static HTS_Boolean HTS_Model_load_pdf(HTS_Model * model, HTS_File * fp, size_t v
       HTS_Model_initialize(model);
       return FALSE;
    }
-   model->pdf = (float ***) HTS_calloc(model->ntree, sizeof(float **));
+   model->pdf = (void ***) HTS_calloc(model->ntree, sizeof(void **));
    model->pdf -= 2;
    /* read means and variances */
    if (is_msd)                  /* for MSD */
       len = model->vector_length * model->num_windows * 2 + 1;
    else
       len = model->vector_length * model->num_windows * 2;
+   /* use the vectors where they lie if the voice file is mapped */
+   model->pdf_mapped = HTS_fmappable(fp);
    for (j = 2; j <= model->ntree + 1; j++) {
-      model->pdf[j] = (float **) HTS_calloc(model->npdf[j], sizeof(float *));
+      model->pdf[j] = (void **) HTS_calloc(model->npdf[j], sizeof(void *));
       model->pdf[j]--;
       for (k = 1; k <= model->npdf[j]; k++) {
-         model->pdf[j][k] = (float *) HTS_calloc(len, sizeof(float));
-         if (HTS_fread_little_endian(model->pdf[j][k], sizeof(float), len, fp) != len)
-            result = FALSE;
+         if (model->pdf_mapped) {
+            model->pdf[j][k] = (void *) HTS_fmap_little_endian(sizeof(float), len, fp);
+            if (model->pdf[j][k] == NULL)
+               result = FALSE;
+         } else {
+            model->pdf[j][k] = HTS_calloc(len, sizeof(float));
+            if (HTS_fread_little_endian(model->pdf[j][k], sizeof(float), len, fp) != len)
+               result = FALSE;
+         }
       }
    }
    if (result == FALSE) {
@@ -752,11 +1317,11 @@ static HTS_Boolean HTS_Model_load(HTS_Model * model, HTS_File * pdf, HTS_File *
 
 
 /* HTS_Model_get_index: get index of tree and PDF */
-static void HTS_Model_get_index(HTS_Model * model, size_t state_index, const char *string, size_t * tree_index, size_t * pdf_index)
+static void HTS_Model_get_index(HTS_Model * model, size_t state_index, HTS_LabelString * label, size_t * tree_index, size_t * pdf_index)
 {
    HTS_Tree *tree;
    HTS_Pattern *pattern;
-   HTS_Boolean find;
+   HTS_Boolean find, format;
 
    (*tree_index) = 2;
    (*pdf_index) = 1;
@@ -771,7 +1336,7 @@ static void HTS_Model_get_index(HTS_Model * model, size_t state_index, const cha
          if (!pattern)
             find = TRUE;
          for (; pattern; pattern = pattern->next)
-            if (HTS_pattern_match(string, pattern->string)) {
+            if (HTS_label_match(label, pattern->string)) {
                find = TRUE;
                break;
             }
@@ -781,10 +1346,15 @@ static void HTS_Model_get_index(HTS_Model * model, size_t state_index, const cha
       (*tree_index)++;
    }
 
+   format = (label->field != NULL && label->regular && model->format_test != NULL) ? TRUE : FALSE;
+   if (format)
+      HTS_Model_match_fields(model, label);
+   else if (model->match_set != NULL)
+      HTS_Model_match_label(model, HTS_LabelString_get_name(label));
    if (tree != NULL) {
-      (*pdf_index) = HTS_Tree_search_node(tree, string);
+      (*pdf_index) = HTS_Tree_search_node(tree, model, label, format);
    } else {
-      (*pdf_index) = HTS_Tree_search_node(model->tree, string);
+      (*pdf_index) = HTS_Tree_search_node(model->tree, model, label, format);
    }
 }
 
@@ -801,12 +1371,78 @@ void HTS_ModelSet_initialize(HTS_ModelSet * ms)
    ms->fullcontext_format = NULL;
    ms->fullcontext_version = NULL;
    ms->gv_off_context = NULL;
+   ms->label_format.num_fields = 0;
+   ms->label_format.delimiter = NULL;
+   ms->gv_off_format = NULL;
    ms->option = NULL;
 
    ms->duration = NULL;
    ms->window = NULL;
    ms->stream = NULL;
    ms->gv = NULL;
+   ms->is_shared = FALSE;
+}
+
+/* HTS_ModelSet_clear_shared: free what a shared model set doesn't borrow */
+static void HTS_ModelSet_clear_shared(HTS_ModelSet * ms)
+{
+   size_t i, j;
+
+   if (ms->duration != NULL) {
+      for (i = 0; i < ms->num_voices; i++)
+         HTS_Model_clear_shared(&ms->duration[i]);
+      HTS_free(ms->duration);
+   }
+   if (ms->stream != NULL) {
+      for (i = 0; i < ms->num_voices; i++) {
+         for (j = 0; j < ms->num_streams; j++)
+            HTS_Model_clear_shared(&ms->stream[i][j]);
+         HTS_free(ms->stream[i]);
+      }
+      HTS_free(ms->stream);
+   }
+   if (ms->gv != NULL) {
+      for (i = 0; i < ms->num_voices; i++) {
+         for (j = 0; j < ms->num_streams; j++)
+            HTS_Model_clear_shared(&ms->gv[i][j]);
+         HTS_free(ms->gv[i]);
+      }
+      HTS_free(ms->gv);
+   }
+   HTS_ModelSet_initialize(ms);
+}
+
+/* HTS_ModelSet_share: use the models of source, which must not change and must */
+/* outlive ms.  The caches used while searching the trees are ms's own, so ms    */
+/* and other model sets sharing source can be used at the same time.            */
+void HTS_ModelSet_share(HTS_ModelSet * ms, HTS_ModelSet * source)
+{
+   size_t i, j;
+
+   HTS_ModelSet_clear(ms);
+   *ms = *source;
+   ms->is_shared = TRUE;
+   if (source->duration != NULL) {
+      ms->duration = (HTS_Model *) HTS_calloc(ms->num_voices, sizeof(HTS_Model));
+      for (i = 0; i < ms->num_voices; i++)
+         HTS_Model_share(&ms->duration[i], &source->duration[i]);
+   }
+   if (source->stream != NULL) {
+      ms->stream = (HTS_Model **) HTS_calloc(ms->num_voices, sizeof(HTS_Model *));
+      for (i = 0; i < ms->num_voices; i++) {
+         ms->stream[i] = (HTS_Model *) HTS_calloc(ms->num_streams, sizeof(HTS_Model));
+         for (j = 0; j < ms->num_streams; j++)
+            HTS_Model_share(&ms->stream[i][j], &source->stream[i][j]);
+      }
+   }
+   if (source->gv != NULL) {
+      ms->gv = (HTS_Model **) HTS_calloc(ms->num_voices, sizeof(HTS_Model *));
+      for (i = 0; i < ms->num_voices; i++) {
+         ms->gv[i] = (HTS_Model *) HTS_calloc(ms->num_streams, sizeof(HTS_Model));
+         for (j = 0; j < ms->num_streams; j++)
+            HTS_Model_share(&ms->gv[i][j], &source->gv[i][j]);
+      }
+   }
 }
 
 /* HTS_ModelSet_clear: free model set */
@@ -814,6 +1450,11 @@ void HTS_ModelSet_clear(HTS_ModelSet * ms)
 {
    size_t i, j;
 
+   if (ms->is_shared) {
+      HTS_ModelSet_clear_shared(ms);
+      return;
+   }
+
    if (ms->hts_voice_version != NULL)
       free(ms->hts_voice_version);
    if (ms->stream_type != NULL)
@@ -826,6 +1467,12 @@ void HTS_ModelSet_clear(HTS_ModelSet * ms)
       HTS_Question_clear(ms->gv_off_context);
       free(ms->gv_off_context);
    }
+   HTS_FormatTest_free_list(ms->gv_off_format);
+   if (ms->label_format.delimiter != NULL) {
+      for (i = 0; i <= ms->label_format.num_fields; i++)
+         HTS_free(ms->label_format.delimiter[i]);
+      HTS_free(ms->label_format.delimiter);
+   }
    if (ms->option != NULL) {
       for (i = 0; i < ms->num_streams; i++)
          if (ms->option[i] != NULL)
@@ -889,8 +1536,8 @@ static HTS_Boolean HTS_strequal(const char *s1, const char *s2)
       return strcmp(s1, s2) == 0 ? TRUE : FALSE;
 }
 
-/* HTS_ModelSet_load: load model set */
-HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voices)
+/* HTS_ModelSet_load_voices: load model set from voice files, or from voice data used in place */
+static HTS_Boolean HTS_ModelSet_load_voices(HTS_ModelSet * ms, char **voices, const void **data, const size_t * size, size_t num_voices)
 {
    size_t i, j, k, s, e;
    HTS_Boolean error = FALSE;
@@ -942,14 +1589,17 @@ HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voice
 
    HTS_ModelSet_clear(ms);
 
-   if (ms == NULL || voices == NULL || num_voices < 1)
+   if (ms == NULL || (voices == NULL && data == NULL) || num_voices < 1)
       return FALSE;
 
    ms->num_voices = num_voices;
 
    for (i = 0; i < num_voices && error == FALSE; i++) {
       /* open file */
-      fp = HTS_fopen_from_fn(voices[i], "rb");
+      if (data != NULL)
+         fp = HTS_fopen_from_mapped_data(data[i], size[i]);
+      else
+         fp = HTS_fopen_from_fn(voices[i], "rb");
       if (fp == NULL) {
          error = TRUE;
          break;
@@ -1496,6 +2146,21 @@ HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voice
    return !error;
 }
 
+/* HTS_ModelSet_load: load model set */
+HTS_Boolean HTS_ModelSet_load(HTS_ModelSet * ms, char **voices, size_t num_voices)
+{
+   return HTS_ModelSet_load_voices(ms, voices, NULL, NULL, num_voices);
+}
+
+/* HTS_ModelSet_load_from_mapped_data: load model set from voices in memory, */
+/* the PDFs are used in place so the data must outlive the model set         */
+HTS_Boolean HTS_ModelSet_load_from_mapped_data(HTS_ModelSet * ms, const void **data, const size_t * size, size_t num_voices)
+{
+   if (data == NULL || size == NULL)
+      return FALSE;
+   return HTS_ModelSet_load_voices(ms, NULL, data, size, num_voices);
+}
+
 /* HTS_ModelSet_get_sampling_frequency: get sampling frequency of HTS voices */
 size_t HTS_ModelSet_get_sampling_frequency(HTS_ModelSet * ms)
 {
@@ -1515,16 +2180,59 @@ const char *HTS_ModelSet_get_option(HTS_ModelSet * ms, size_t stream_index)
 }
 
 /* HTS_ModelSet_get_gv_flag: get GV flag */
-HTS_Boolean HTS_ModelSet_get_gv_flag(HTS_ModelSet * ms, const char *string)
+HTS_Boolean HTS_ModelSet_get_gv_flag(HTS_ModelSet * ms, HTS_LabelString * label)
 {
+   HTS_FormatTest *test;
+
    if (ms->gv_off_context == NULL)
       return TRUE;
-   else if (HTS_Question_match(ms->gv_off_context, string) == TRUE)
+   if (label->field != NULL && label->regular && ms->gv_off_context->format_compiled) {
+      for (test = ms->gv_off_format; test; test = test->next)
+         if (HTS_FormatTest_check(test, label, 0))
+            return FALSE;
+      return TRUE;
+   }
+   if (HTS_Question_match(ms->gv_off_context, HTS_LabelString_get_name(label)) == TRUE)
       return FALSE;
    else
       return TRUE;
 }
 
+/* HTS_ModelSet_set_label_format: set the text around the fields of structured labels */
+void HTS_ModelSet_set_label_format(HTS_ModelSet * ms, const char *const *delimiters, size_t num_fields)
+{
+   size_t i, j;
+
+   /* the format belongs to the model set that is shared */
+   if (ms->is_shared)
+      return;
+
+   HTS_FormatTest_free_list(ms->gv_off_format);
+   ms->gv_off_format = NULL;
+   if (ms->label_format.delimiter != NULL) {
+      for (i = 0; i <= ms->label_format.num_fields; i++)
+         HTS_free(ms->label_format.delimiter[i]);
+      HTS_free(ms->label_format.delimiter);
+   }
+   ms->label_format.num_fields = num_fields;
+   ms->label_format.delimiter = (char **) HTS_calloc(num_fields + 1, sizeof(char *));
+   for (i = 0; i <= num_fields; i++)
+      ms->label_format.delimiter[i] = HTS_strdup(delimiters[i]);
+
+   if (ms->gv_off_context != NULL)
+      HTS_Question_compile_format(ms->gv_off_context, &ms->label_format, &ms->gv_off_format);
+   for (i = 0; i < ms->num_voices; i++) {
+      if (ms->duration != NULL)
+         HTS_Model_compile_format(&ms->duration[i], &ms->label_format);
+      for (j = 0; j < ms->num_streams; j++) {
+         if (ms->stream != NULL)
+            HTS_Model_compile_format(&ms->stream[i][j], &ms->label_format);
+         if (ms->gv != NULL)
+            HTS_Model_compile_format(&ms->gv[i][j], &ms->label_format);
+      }
+   }
+}
+
 /* HTS_ModelSet_get_nstate: get number of state */
 size_t HTS_ModelSet_get_nstate(HTS_ModelSet * ms)
 {
@@ -1606,30 +2314,41 @@ HTS_Boolean HTS_ModelSet_use_gv(HTS_ModelSet * ms, size_t stream_index)
       return FALSE;
 }
 
+/* HTS_pdf_value: i-th float of a pdf vector, which may be unaligned */
+static double HTS_pdf_value(const void *pdf, size_t i)
+{
+   float f;
+
+   memcpy(&f, (const unsigned char *) pdf + i * sizeof(float), sizeof(float));
+   return (double) f;
+}
+
 /* HTS_Model_add_parameter: get parameter using interpolation weight */
-static void HTS_Model_add_parameter(HTS_Model * model, size_t state_index, const char *string, double *mean, double *vari, double *msd, double weight)
+static void HTS_Model_add_parameter(HTS_Model * model, size_t state_index, HTS_LabelString * label, double *mean, double *vari, double *msd, double weight)
 {
    size_t i;
    size_t tree_index, pdf_index;
    size_t len = model->vector_length * model->num_windows;
+   const void *pdf;
 
-   HTS_Model_get_index(model, state_index, string, &tree_index, &pdf_index);
+   HTS_Model_get_index(model, state_index, label, &tree_index, &pdf_index);
+   pdf = model->pdf[tree_index][pdf_index];
    for (i = 0; i < len; i++) {
-      mean[i] += weight * model->pdf[tree_index][pdf_index][i];
-      vari[i] += weight * model->pdf[tree_index][pdf_index][i + len];
+      mean[i] += weight * HTS_pdf_value(pdf, i);
+      vari[i] += weight * HTS_pdf_value(pdf, i + len);
    }
    if (msd != NULL && model->is_msd == TRUE)
-      *msd += weight * model->pdf[tree_index][pdf_index][len + len];
+      *msd += weight * HTS_pdf_value(pdf, len + len);
 }
 
 /* HTS_ModelSet_get_duration_index: get duration PDF & tree index */
-void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, size_t voice_index, const char *string, size_t * tree_index, size_t * pdf_index)
+void HTS_ModelSet_get_duration_index(HTS_ModelSet * ms, size_t voice_index, HTS_LabelString * label, size_t * tree_index, size_t * pdf_index)
 {
-   HTS_Model_get_index(&ms->duration[voice_index], 2, string, tree_index, pdf_index);
+   HTS_Model_get_index(&ms->duration[voice_index], 2, label, tree_index, pdf_index);
 }
 
 /* HTS_ModelSet_get_duration: get duration using interpolation weight */
-void HTS_ModelSet_get_duration(HTS_ModelSet * ms, const char *string, const double *iw, double *mean, double *vari)
+void HTS_ModelSet_get_duration(HTS_ModelSet * ms, HTS_LabelString * label, const double *iw, double *mean, double *vari)
 {
    size_t i;
    size_t len = ms->num_states;
@@ -1640,17 +2359,17 @@ void HTS_ModelSet_get_duration(HTS_ModelSet * ms, const char *string, const doub
    }
    for (i = 0; i < ms->num_voices; i++)
       if (iw[i] != 0.0)
-         HTS_Model_add_parameter(&ms->duration[i], 2, string, mean, vari, NULL, iw[i]);
+         HTS_Model_add_parameter(&ms->duration[i], 2, label, mean, vari, NULL, iw[i]);
 }
 
 /* HTS_ModelSet_get_parameter_index: get paramter PDF & tree index */
-void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, size_t state_index, const char *string, size_t * tree_index, size_t * pdf_index)
+void HTS_ModelSet_get_parameter_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, size_t state_index, HTS_LabelString * label, size_t * tree_index, size_t * pdf_index)
 {
-   HTS_Model_get_index(&ms->stream[voice_index][stream_index], state_index, string, tree_index, pdf_index);
+   HTS_Model_get_index(&ms->stream[voice_index][stream_index], state_index, label, tree_index, pdf_index);
 }
 
 /* HTS_ModelSet_get_parameter: get parameter using interpolation weight */
-void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t state_index, const char *string, const double *const *iw, double *mean, double *vari, double *msd)
+void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t state_index, HTS_LabelString * label, const double *const *iw, double *mean, double *vari, double *msd)
 {
    size_t i;
    size_t len = ms->stream[0][stream_index].vector_length * ms->stream[0][stream_index].num_windows;
@@ -1664,17 +2383,17 @@ void HTS_ModelSet_get_parameter(HTS_ModelSet * ms, size_t stream_index, size_t s
 
    for (i = 0; i < ms->num_voices; i++)
       if (iw[i][stream_index] != 0.0)
-         HTS_Model_add_parameter(&ms->stream[i][stream_index], state_index, string, mean, vari, msd, iw[i][stream_index]);
+         HTS_Model_add_parameter(&ms->stream[i][stream_index], state_index, label, mean, vari, msd, iw[i][stream_index]);
 }
 
 /* HTS_ModelSet_get_gv_index: get gv PDF & tree index */
-void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, const char *string, size_t * tree_index, size_t * pdf_index)
+void HTS_ModelSet_get_gv_index(HTS_ModelSet * ms, size_t voice_index, size_t stream_index, HTS_LabelString * label, size_t * tree_index, size_t * pdf_index)
 {
-   HTS_Model_get_index(&ms->gv[voice_index][stream_index], 2, string, tree_index, pdf_index);
+   HTS_Model_get_index(&ms->gv[voice_index][stream_index], 2, label, tree_index, pdf_index);
 }
 
 /* HTS_ModelSet_get_gv: get GV using interpolation weight */
-void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, const char *string, const double *const *iw, double *mean, double *vari)
+void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, HTS_LabelString * label, const double *const *iw, double *mean, double *vari)
 {
    size_t i;
    size_t len = ms->stream[0][stream_index].vector_length;
@@ -1685,7 +2404,7 @@ void HTS_ModelSet_get_gv(HTS_ModelSet * ms, size_t stream_index, const char *str
    }
    for (i = 0; i < ms->num_voices; i++)
       if (iw[i][stream_index] != 0.0)
-         HTS_Model_add_parameter(&ms->gv[i][stream_index], 2, string, mean, vari, NULL, iw[i][stream_index]);
+         HTS_Model_add_parameter(&ms->gv[i][stream_index], 2, label, mean, vari, NULL, iw[i][stream_index]);
 }
 
 HTS_MODEL_C_END;
@@ -56,6 +56,7 @@
 HTS_PSTREAM_C_START;
 
 #include <math.h>               /* for sqrt() */
+#include <string.h>             /* for memcpy() */
 
 /* hts_engine libraries */
 #include "HTS_hidden.h"
@@ -75,46 +76,79 @@ static double HTS_finv(const double x)
    return (1.0 / x);
 }
 
+/* All coefficients of a stream are solved together: the matrices hold */
+/* coefficient m of row t at [t][m], with band i of W'U^{-1}W at        */
+/* [t][i * vector_length + m], so the inner loops run over contiguous    */
+/* coefficients and vectorize.  Each coefficient still sees the same     */
+/* operations in the same order as when they were solved one by one.    */
+
 /* HTS_PStream_calc_wuw_and_wum: calcurate W'U^{-1}W and W'U^{-1}M */
-static void HTS_PStream_calc_wuw_and_wum(HTS_PStream * pst, size_t m)
+static void HTS_PStream_calc_wuw_and_wum(HTS_PStream * pst)
 {
-   size_t t, i, j;
+   const size_t vl = pst->vector_length;
+   size_t t, i, j, m;
    int shift;
-   double wu;
+   double cw, cj, wu;
+   double *wum, *wuw;
+   const double *ivar, *mean;
 
    for (t = 0; t < pst->length; t++) {
       /* initialize */
-      pst->sm.wum[t] = 0.0;
-      for (i = 0; i < pst->width; i++)
-         pst->sm.wuw[t][i] = 0.0;
+      wum = pst->sm.wum[t];
+      wuw = pst->sm.wuw[t];
+      for (m = 0; m < vl; m++)
+         wum[m] = 0.0;
+      for (i = 0; i < pst->width * vl; i++)
+         wuw[i] = 0.0;
 
       /* calc WUW & WUM */
       for (i = 0; i < pst->win_size; i++)
          for (shift = pst->win_l_width[i]; shift <= pst->win_r_width[i]; shift++)
             if (((int) t + shift >= 0) && ((int) t + shift < pst->length) && (pst->win_coefficient[i][-shift] != 0.0)) {
-               wu = pst->win_coefficient[i][-shift] * pst->sm.ivar[t + shift][i * pst->vector_length + m];
-               pst->sm.wum[t] += wu * pst->sm.mean[t + shift][i * pst->vector_length + m];
+               cw = pst->win_coefficient[i][-shift];
+               ivar = &pst->sm.ivar[t + shift][i * vl];
+               mean = &pst->sm.mean[t + shift][i * vl];
+               for (m = 0; m < vl; m++) {
+                  wu = cw * ivar[m];
+                  wum[m] += wu * mean[m];
+               }
                for (j = 0; (j < pst->width) && (t + j < pst->length); j++)
-                  if (((int) j <= pst->win_r_width[i] + shift) && (pst->win_coefficient[i][j - shift] != 0.0))
-                     pst->sm.wuw[t][j] += wu * pst->win_coefficient[i][j - shift];
+                  if (((int) j <= pst->win_r_width[i] + shift) && (pst->win_coefficient[i][j - shift] != 0.0)) {
+                     cj = pst->win_coefficient[i][j - shift];
+                     for (m = 0; m < vl; m++) {
+                        wu = cw * ivar[m];
+                        wuw[j * vl + m] += wu * cj;
+                     }
+                  }
             }
    }
 }
 
-
 /* HTS_PStream_ldl_factorization: Factorize W'*U^{-1}*W to L*D*L' (L: lower triangular, D: diagonal) */
 static void HTS_PStream_ldl_factorization(HTS_PStream * pst)
 {
-   size_t t, i, j;
+   const size_t vl = pst->vector_length;
+   size_t t, i, j, m;
+   double *l, *p;
 
    for (t = 0; t < pst->length; t++) {
-      for (i = 1; (i < pst->width) && (t >= i); i++)
-         pst->sm.wuw[t][0] -= pst->sm.wuw[t - i][i] * pst->sm.wuw[t - i][i] * pst->sm.wuw[t - i][0];
+      l = pst->sm.ldl[t];
+      memcpy(l, pst->sm.wuw[t], pst->width * vl * sizeof(double));
+
+      for (i = 1; (i < pst->width) && (t >= i); i++) {
+         p = pst->sm.ldl[t - i];
+         for (m = 0; m < vl; m++)
+            l[m] -= p[i * vl + m] * p[i * vl + m] * p[m];
+      }
 
       for (i = 1; i < pst->width; i++) {
-         for (j = 1; (i + j < pst->width) && (t >= j); j++)
-            pst->sm.wuw[t][i] -= pst->sm.wuw[t - j][j] * pst->sm.wuw[t - j][i + j] * pst->sm.wuw[t - j][0];
-         pst->sm.wuw[t][i] /= pst->sm.wuw[t][0];
+         for (j = 1; (i + j < pst->width) && (t >= j); j++) {
+            p = pst->sm.ldl[t - j];
+            for (m = 0; m < vl; m++)
+               l[i * vl + m] -= p[j * vl + m] * p[(i + j) * vl + m] * p[m];
+         }
+         for (m = 0; m < vl; m++)
+            l[i * vl + m] /= l[m];
       }
    }
 }
@@ -122,145 +156,189 @@ static void HTS_PStream_ldl_factorization(HTS_PStream * pst)
 /* HTS_PStream_forward_substitution: forward subtitution for mlpg */
 static void HTS_PStream_forward_substitution(HTS_PStream * pst)
 {
-   size_t t, i;
+   const size_t vl = pst->vector_length;
+   size_t t, i, m;
+   double *g;
+   const double *p;
 
    for (t = 0; t < pst->length; t++) {
-      pst->sm.g[t] = pst->sm.wum[t];
-      for (i = 1; (i < pst->width) && (t >= i); i++)
-         pst->sm.g[t] -= pst->sm.wuw[t - i][i] * pst->sm.g[t - i];
+      g = pst->sm.g[t];
+      for (m = 0; m < vl; m++)
+         g[m] = pst->sm.wum[t][m];
+      for (i = 1; (i < pst->width) && (t >= i); i++) {
+         p = &pst->sm.ldl[t - i][i * vl];
+         for (m = 0; m < vl; m++)
+            g[m] -= p[m] * pst->sm.g[t - i][m];
+      }
    }
 }
 
 /* HTS_PStream_backward_substitution: backward subtitution for mlpg */
-static void HTS_PStream_backward_substitution(HTS_PStream * pst, size_t m)
+static void HTS_PStream_backward_substitution(HTS_PStream * pst)
 {
-   size_t rev, t, i;
+   const size_t vl = pst->vector_length;
+   size_t rev, t, i, m;
+   double *par;
+   const double *l;
 
    for (rev = 0; rev < pst->length; rev++) {
       t = pst->length - 1 - rev;
-      pst->par[t][m] = pst->sm.g[t] / pst->sm.wuw[t][0];
+      par = pst->par[t];
+      l = pst->sm.ldl[t];
+      for (m = 0; m < vl; m++)
+         par[m] = pst->sm.g[t][m] / l[m];
       for (i = 1; (i < pst->width) && (t + i < pst->length); i++)
-         pst->par[t][m] -= pst->sm.wuw[t][i] * pst->par[t + i][m];
+         for (m = 0; m < vl; m++)
+            par[m] -= l[i * vl + m] * pst->par[t + i][m];
    }
 }
 
 /* HTS_PStream_calc_gv: subfunction for mlpg using GV */
-static void HTS_PStream_calc_gv(HTS_PStream * pst, size_t m, double *mean, double *vari)
+static void HTS_PStream_calc_gv(HTS_PStream * pst, double *mean, double *vari)
 {
-   size_t t;
+   const size_t vl = pst->vector_length;
+   size_t t, m;
 
-   *mean = 0.0;
+   for (m = 0; m < vl; m++)
+      mean[m] = 0.0;
    for (t = 0; t < pst->length; t++)
       if (pst->gv_switch[t])
-         *mean += pst->par[t][m];
-   *mean /= pst->gv_length;
-   *vari = 0.0;
+         for (m = 0; m < vl; m++)
+            mean[m] += pst->par[t][m];
+   for (m = 0; m < vl; m++) {
+      mean[m] /= pst->gv_length;
+      vari[m] = 0.0;
+   }
    for (t = 0; t < pst->length; t++)
       if (pst->gv_switch[t])
-         *vari += (pst->par[t][m] - *mean) * (pst->par[t][m] - *mean);
-   *vari /= pst->gv_length;
+         for (m = 0; m < vl; m++)
+            vari[m] += (pst->par[t][m] - mean[m]) * (pst->par[t][m] - mean[m]);
+   for (m = 0; m < vl; m++)
+      vari[m] /= pst->gv_length;
 }
 
 /* HTS_PStream_conv_gv: subfunction for mlpg using GV */
-static void HTS_PStream_conv_gv(HTS_PStream * pst, size_t m)
+static void HTS_PStream_conv_gv(HTS_PStream * pst, double *mean, double *vari, double *ratio)
 {
-   size_t t;
-   double ratio;
-   double mean;
-   double vari;
+   const size_t vl = pst->vector_length;
+   size_t t, m;
 
-   HTS_PStream_calc_gv(pst, m, &mean, &vari);
-   ratio = sqrt(pst->gv_mean[m] / vari);
+   HTS_PStream_calc_gv(pst, mean, vari);
+   for (m = 0; m < vl; m++)
+      ratio[m] = sqrt(pst->gv_mean[m] / vari[m]);
    for (t = 0; t < pst->length; t++)
       if (pst->gv_switch[t])
-         pst->par[t][m] = ratio * (pst->par[t][m] - mean) + mean;
+         for (m = 0; m < vl; m++)
+            pst->par[t][m] = ratio[m] * (pst->par[t][m] - mean[m]) + mean[m];
 }
 
-/* HTS_PStream_calc_derivative: subfunction for mlpg using GV */
-static double HTS_PStream_calc_derivative(HTS_PStream * pst, size_t m)
+/* HTS_PStream_calc_derivative: subfunction for mlpg using GV, the objective of each coefficient goes in obj */
+static void HTS_PStream_calc_derivative(HTS_PStream * pst, double *obj, double *mean, double *vari, double *dv)
 {
-   size_t t, i;
-   double mean;
-   double vari;
-   double dv;
+   const size_t vl = pst->vector_length;
+   size_t t, i, m;
    double h;
    double gvobj;
-   double hmmobj;
+   double *g;
+   const double *p;
    double w = 1.0 / (pst->win_size * pst->length);
 
-   HTS_PStream_calc_gv(pst, m, &mean, &vari);
-   gvobj = -0.5 * W2 * vari * pst->gv_vari[m] * (vari - 2.0 * pst->gv_mean[m]);
-   dv = -2.0 * pst->gv_vari[m] * (vari - pst->gv_mean[m]) / pst->length;
+   HTS_PStream_calc_gv(pst, mean, vari);
+   for (m = 0; m < vl; m++) {
+      obj[m] = 0.0;             /* hmmobj */
+      dv[m] = -2.0 * pst->gv_vari[m] * (vari[m] - pst->gv_mean[m]) / pst->length;
+   }
 
    for (t = 0; t < pst->length; t++) {
-      pst->sm.g[t] = pst->sm.wuw[t][0] * pst->par[t][m];
+      g = pst->sm.g[t];
+      for (m = 0; m < vl; m++)
+         g[m] = pst->sm.wuw[t][m] * pst->par[t][m];
       for (i = 1; i < pst->width; i++) {
-         if (t + i < pst->length)
-            pst->sm.g[t] += pst->sm.wuw[t][i] * pst->par[t + i][m];
-         if (t + 1 > i)
-            pst->sm.g[t] += pst->sm.wuw[t - i][i] * pst->par[t - i][m];
+         if (t + i < pst->length) {
+            p = &pst->sm.wuw[t][i * vl];
+            for (m = 0; m < vl; m++)
+               g[m] += p[m] * pst->par[t + i][m];
+         }
+         if (t + 1 > i) {
+            p = &pst->sm.wuw[t - i][i * vl];
+            for (m = 0; m < vl; m++)
+               g[m] += p[m] * pst->par[t - i][m];
+         }
       }
    }
 
-   for (t = 0, hmmobj = 0.0; t < pst->length; t++) {
-      hmmobj += W1 * w * pst->par[t][m] * (pst->sm.wum[t] - 0.5 * pst->sm.g[t]);
-      h = -W1 * w * pst->sm.wuw[t][1 - 1] - W2 * 2.0 / (pst->length * pst->length) * ((pst->length - 1) * pst->gv_vari[m] * (vari - pst->gv_mean[m]) + 2.0 * pst->gv_vari[m] * (pst->par[t][m] - mean) * (pst->par[t][m] - mean));
-      if (pst->gv_switch[t])
-         pst->sm.g[t] = 1.0 / h * (W1 * w * (-pst->sm.g[t] + pst->sm.wum[t]) + W2 * dv * (pst->par[t][m] - mean));
-      else
-         pst->sm.g[t] = 1.0 / h * (W1 * w * (-pst->sm.g[t] + pst->sm.wum[t]));
+   for (t = 0; t < pst->length; t++) {
+      g = pst->sm.g[t];
+      for (m = 0; m < vl; m++) {
+         obj[m] += W1 * w * pst->par[t][m] * (pst->sm.wum[t][m] - 0.5 * g[m]);
+         h = -W1 * w * pst->sm.wuw[t][m] - W2 * 2.0 / (pst->length * pst->length) * ((pst->length - 1) * pst->gv_vari[m] * (vari[m] - pst->gv_mean[m]) + 2.0 * pst->gv_vari[m] * (pst->par[t][m] - mean[m]) * (pst->par[t][m] - mean[m]));
+         if (pst->gv_switch[t])
+            g[m] = 1.0 / h * (W1 * w * (-g[m] + pst->sm.wum[t][m]) + W2 * dv[m] * (pst->par[t][m] - mean[m]));
+         else
+            g[m] = 1.0 / h * (W1 * w * (-g[m] + pst->sm.wum[t][m]));
+      }
    }
 
-   return (-(hmmobj + gvobj));
+   for (m = 0; m < vl; m++) {
+      gvobj = -0.5 * W2 * vari[m] * pst->gv_vari[m] * (vari[m] - 2.0 * pst->gv_mean[m]);
+      obj[m] = -(obj[m] + gvobj);
+   }
 }
 
 /* HTS_PStream_gv_parmgen: function for mlpg using GV */
-static void HTS_PStream_gv_parmgen(HTS_PStream * pst, size_t m)
+static void HTS_PStream_gv_parmgen(HTS_PStream * pst)
 {
-   size_t t, i;
-   double step = STEPINIT;
-   double prev = 0.0;
-   double obj;
+   const size_t vl = pst->vector_length;
+   size_t t, i, m;
+   double *step, *prev, *obj, *mean, *vari, *dv;
 
    if (pst->gv_length == 0)
       return;
 
-   HTS_PStream_conv_gv(pst, m);
-   if (GV_MAX_ITERATION > 0) {
-      HTS_PStream_calc_wuw_and_wum(pst, m);
-      for (i = 1; i <= GV_MAX_ITERATION; i++) {
-         obj = HTS_PStream_calc_derivative(pst, m);
+   step = (double *) HTS_calloc(6 * vl, sizeof(double));
+   prev = step + vl;
+   obj = prev + vl;
+   mean = obj + vl;
+   vari = mean + vl;
+   dv = vari + vl;
+
+   HTS_PStream_conv_gv(pst, mean, vari, dv);
+   for (m = 0; m < vl; m++)
+      step[m] = STEPINIT;
+   /* sm.wuw is still W'U^{-1}W, only sm.ldl was factorized */
+   for (i = 1; i <= GV_MAX_ITERATION; i++) {
+      HTS_PStream_calc_derivative(pst, obj, mean, vari, dv);
+      for (m = 0; m < vl; m++) {
          if (i > 1) {
-            if (obj > prev)
-               step *= STEPDEC;
-            if (obj < prev)
-               step *= STEPINC;
+            if (obj[m] > prev[m])
+               step[m] *= STEPDEC;
+            if (obj[m] < prev[m])
+               step[m] *= STEPINC;
          }
-         for (t = 0; t < pst->length; t++) {
-            if (pst->gv_switch[t])
-               pst->par[t][m] += step * pst->sm.g[t];
-         }
-         prev = obj;
+         prev[m] = obj[m];
+      }
+      for (t = 0; t < pst->length; t++) {
+         if (pst->gv_switch[t])
+            for (m = 0; m < vl; m++)
+               pst->par[t][m] += step[m] * pst->sm.g[t][m];
       }
    }
+
+   HTS_free(step);
 }
 
 /* HTS_PStream_mlpg: generate sequence of speech parameter vector maximizing its output probability for given pdf sequence */
 static void HTS_PStream_mlpg(HTS_PStream * pst)
 {
-   size_t m;
-
    if (pst->length == 0)
       return;
 
-   for (m = 0; m < pst->vector_length; m++) {
-      HTS_PStream_calc_wuw_and_wum(pst, m);
-      HTS_PStream_ldl_factorization(pst);       /* LDL factorization */
-      HTS_PStream_forward_substitution(pst);    /* forward substitution   */
-      HTS_PStream_backward_substitution(pst, m);        /* backward substitution  */
-      if (pst->gv_length > 0)
-         HTS_PStream_gv_parmgen(pst, m);
-   }
+   HTS_PStream_calc_wuw_and_wum(pst);
+   HTS_PStream_ldl_factorization(pst);  /* LDL factorization */
+   HTS_PStream_forward_substitution(pst);       /* forward substitution   */
+   HTS_PStream_backward_substitution(pst);      /* backward substitution  */
+   if (pst->gv_length > 0)
+      HTS_PStream_gv_parmgen(pst);
 }
 
 /* HTS_PStreamSet_initialize: initialize parameter stream set */
@@ -323,9 +401,10 @@ HTS_Boolean HTS_PStreamSet_create(HTS_PStreamSet * pss, HTS_SStreamSet * sss, do
       if (pst->length > 0) {
          pst->sm.mean = HTS_alloc_matrix(pst->length, pst->vector_length * pst->win_size);
          pst->sm.ivar = HTS_alloc_matrix(pst->length, pst->vector_length * pst->win_size);
-         pst->sm.wum = (double *) HTS_calloc(pst->length, sizeof(double));
-         pst->sm.wuw = HTS_alloc_matrix(pst->length, pst->width);
-         pst->sm.g = (double *) HTS_calloc(pst->length, sizeof(double));
+         pst->sm.wum = HTS_alloc_matrix(pst->length, pst->vector_length);
+         pst->sm.wuw = HTS_alloc_matrix(pst->length, pst->width * pst->vector_length);
+         pst->sm.ldl = HTS_alloc_matrix(pst->length, pst->width * pst->vector_length);
+         pst->sm.g = HTS_alloc_matrix(pst->length, pst->vector_length);
          pst->par = HTS_alloc_matrix(pst->length, pst->vector_length);
       }
       /* copy dynamic window */
@@ -482,11 +561,13 @@ void HTS_PStreamSet_clear(HTS_PStreamSet * pss)
       for (i = 0; i < pss->nstream; i++) {
          pstream = &pss->pstream[i];
          if (pstream->sm.wum)
-            HTS_free(pstream->sm.wum);
+            HTS_free_matrix(pstream->sm.wum, pstream->length);
          if (pstream->sm.g)
-            HTS_free(pstream->sm.g);
+            HTS_free_matrix(pstream->sm.g, pstream->length);
          if (pstream->sm.wuw)
             HTS_free_matrix(pstream->sm.wuw, pstream->length);
+         if (pstream->sm.ldl)
+            HTS_free_matrix(pstream->sm.ldl, pstream->length);
          if (pstream->sm.ivar)
             HTS_free_matrix(pstream->sm.ivar, pstream->length);
          if (pstream->sm.mean)
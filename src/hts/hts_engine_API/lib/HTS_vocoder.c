@@ -599,6 +599,26 @@ static double HTS_Vocoder_get_excitation(HTS_Vocoder * v, const double *lpf)
    return x;
 }
 
+/* HTS_Vocoder_get_frame_excitation: get excitation of a whole frame at once */
+static void HTS_Vocoder_get_frame_excitation(HTS_Vocoder * v, const double *lpf, double *x, size_t n)
+{
+   size_t j;
+
+   if (v->excite_buff_size == 0 && v->pitch_of_curr_point == 0.0) {
+      /* unvoiced, noise throughout */
+      if (v->gauss) {
+         for (j = 0; j < n; j++)
+            x[j] = HTS_nrandom(v);
+      } else {
+         for (j = 0; j < n; j++)
+            x[j] = (double) HTS_mseq(v);
+      }
+   } else {
+      for (j = 0; j < n; j++)
+         x[j] = HTS_Vocoder_get_excitation(v, lpf);
+   }
+}
+
 /* HTS_Vocoder_end_excitation: end excitation of each frame */
 static void HTS_Vocoder_end_excitation(HTS_Vocoder * v, double pitch)
 {
@@ -718,6 +738,7 @@ void HTS_Vocoder_initialize(HTS_Vocoder * v, size_t m, size_t stage, HTS_Boolean
       v->d1 = v->cinc + m + 1;
    }
    v->d2offset = 1;
+   v->frame_buff = (double *) HTS_calloc(fperiod, sizeof(double));
 }
 
 /* HTS_Vocoder_synthesize: pulse/noise excitation and MLSA/MGLSA filster based waveform synthesis */
@@ -773,8 +794,10 @@ void HTS_Vocoder_synthesize(HTS_Vocoder * v, size_t m, double lf0, double *spect
          v->cinc[i] = (v->cc[i] - v->c[i]) / v->fprd;
    }
 
+   /* the excitation of the whole frame, then the filter sample by sample */
+   HTS_Vocoder_get_frame_excitation(v, lpf, v->frame_buff, v->fprd);
    for (j = 0; j < v->fprd; j++) {
-      x = HTS_Vocoder_get_excitation(v, lpf);
+      x = v->frame_buff[j];
       if (v->stage == 0) {      /* for MCP */
          if (x != 0.0)
             x *= exp(v->c[0]);
@@ -843,6 +866,10 @@ void HTS_Vocoder_clear(HTS_Vocoder * v)
          HTS_free(v->c);
          v->c = NULL;
       }
+      if (v->frame_buff != NULL) {
+         HTS_free(v->frame_buff);
+         v->frame_buff = NULL;
+      }
       v->excite_buff_size = 0;
       v->excite_buff_index = 0;
       if (v->excite_ring_buff != NULL) {
@@ -59,18 +59,13 @@ void cst_regex_init()
 
 int cst_regex_match(const cst_regex *r, const char *str)
 {
-    cst_regstate *s;
+    cst_regstate s;
 
     if (r == NULL)
         return 0;
-    s = hs_regexec(r, str);
-    if (s)
-    {
-        cst_free(s);
-        return 1;
-    }
-    else
-        return 0;
+    if (r->dfa && str)
+        return cst_regex_dfa_match(r->dfa, str, FALSE) != 0;
+    return hs_regexec_state(r, str, &s);
 }
 
 cst_regstate *cst_regex_match_return(const cst_regex *r, const char *str)
@@ -88,6 +83,8 @@ cst_regex *new_cst_regex(const char *str)
 
     r = hs_regcomp(reg_str);
     cst_free(reg_str);
+    if (r)
+        r->dfa = new_cst_regex_dfa((const cst_regex *const *) &r, 1);
 
     return r;
 }
@@ -95,7 +92,10 @@ cst_regex *new_cst_regex(const char *str)
 void delete_cst_regex(cst_regex *r)
 {
     if (r)
+    {
+        delete_cst_regex_dfa((cst_regex_dfa *) r->dfa);
         hs_regdelete(r);
+    }
 
     return;
 }
@@ -4,9 +4,53 @@ static const unsigned char cst_rx_white_rxprog[] = {
     114, 0, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_white_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_white_rxtrans[] = {
+    -1, 1, -1, 1,
+};
+
+static const unsigned int cst_rx_white_rxaccept[] = {
+    0, 0,
+};
+
+static const unsigned int cst_rx_white_rxaccept_end[] = {
+    0, 1,
+};
+
+static const cst_regex_dfa cst_rx_white_rxdfa = {
+    2, 2,
+    cst_rx_white_rxclassmap, cst_rx_white_rxtrans, cst_rx_white_rxaccept,
+    cst_rx_white_rxaccept_end
+};
+
 static const cst_regex cst_rx_white_rx = {
     0, 1, NULL, 0, 24,
-    (char *) cst_rx_white_rxprog
+    (char *) cst_rx_white_rxprog,
+    &cst_rx_white_rxdfa
 };
 
 const cst_regex *const cst_rx_white = &cst_rx_white_rx;
@@ -20,9 +64,53 @@ static const unsigned char cst_rx_alpha_rxprog[] = {
     122, 0, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_alpha_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_alpha_rxtrans[] = {
+    -1, 1, -1, 1,
+};
+
+static const unsigned int cst_rx_alpha_rxaccept[] = {
+    0, 0,
+};
+
+static const unsigned int cst_rx_alpha_rxaccept_end[] = {
+    0, 1,
+};
+
+static const cst_regex_dfa cst_rx_alpha_rxdfa = {
+    2, 2,
+    cst_rx_alpha_rxclassmap, cst_rx_alpha_rxtrans, cst_rx_alpha_rxaccept,
+    cst_rx_alpha_rxaccept_end
+};
+
 static const cst_regex cst_rx_alpha_rx = {
     0, 1, NULL, 0, 72,
-    (char *) cst_rx_alpha_rxprog
+    (char *) cst_rx_alpha_rxprog,
+    &cst_rx_alpha_rxdfa
 };
 
 const cst_regex *const cst_rx_alpha = &cst_rx_alpha_rx;
@@ -33,9 +121,53 @@ static const unsigned char cst_rx_uppercase_rxprog[] = {
     84, 85, 86, 87, 88, 89, 90, 0, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_uppercase_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_uppercase_rxtrans[] = {
+    -1, 1, -1, 1,
+};
+
+static const unsigned int cst_rx_uppercase_rxaccept[] = {
+    0, 0,
+};
+
+static const unsigned int cst_rx_uppercase_rxaccept_end[] = {
+    0, 1,
+};
+
+static const cst_regex_dfa cst_rx_uppercase_rxdfa = {
+    2, 2,
+    cst_rx_uppercase_rxclassmap, cst_rx_uppercase_rxtrans, cst_rx_uppercase_rxaccept,
+    cst_rx_uppercase_rxaccept_end
+};
+
 static const cst_regex cst_rx_uppercase_rx = {
     0, 1, NULL, 0, 46,
-    (char *) cst_rx_uppercase_rxprog
+    (char *) cst_rx_uppercase_rxprog,
+    &cst_rx_uppercase_rxdfa
 };
 
 const cst_regex *const cst_rx_uppercase = &cst_rx_uppercase_rx;
@@ -47,9 +179,53 @@ static const unsigned char cst_rx_lowercase_rxprog[] = {
     116, 117, 118, 119, 120, 121, 122, 0, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_lowercase_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_lowercase_rxtrans[] = {
+    -1, 1, -1, 1,
+};
+
+static const unsigned int cst_rx_lowercase_rxaccept[] = {
+    0, 0,
+};
+
+static const unsigned int cst_rx_lowercase_rxaccept_end[] = {
+    0, 1,
+};
+
+static const cst_regex_dfa cst_rx_lowercase_rxdfa = {
+    2, 2,
+    cst_rx_lowercase_rxclassmap, cst_rx_lowercase_rxtrans, cst_rx_lowercase_rxaccept,
+    cst_rx_lowercase_rxaccept_end
+};
+
 static const cst_regex cst_rx_lowercase_rx = {
     0, 1, NULL, 0, 46,
-    (char *) cst_rx_lowercase_rxprog
+    (char *) cst_rx_lowercase_rxprog,
+    &cst_rx_lowercase_rxdfa
 };
 
 const cst_regex *const cst_rx_lowercase = &cst_rx_lowercase_rx;
@@ -64,9 +240,53 @@ static const unsigned char cst_rx_alphanum_rxprog[] = {
     0, 0,
 };
 
+static const unsigned char cst_rx_alphanum_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_alphanum_rxtrans[] = {
+    -1, 1, -1, 1,
+};
+
+static const unsigned int cst_rx_alphanum_rxaccept[] = {
+    0, 0,
+};
+
+static const unsigned int cst_rx_alphanum_rxaccept_end[] = {
+    0, 1,
+};
+
+static const cst_regex_dfa cst_rx_alphanum_rxdfa = {
+    2, 2,
+    cst_rx_alphanum_rxclassmap, cst_rx_alphanum_rxtrans, cst_rx_alphanum_rxaccept,
+    cst_rx_alphanum_rxaccept_end
+};
+
 static const cst_regex cst_rx_alphanum_rx = {
     0, 1, NULL, 0, 82,
-    (char *) cst_rx_alphanum_rxprog
+    (char *) cst_rx_alphanum_rxprog,
+    &cst_rx_alphanum_rxdfa
 };
 
 const cst_regex *const cst_rx_alphanum = &cst_rx_alphanum_rx;
@@ -85,9 +305,53 @@ static const unsigned char cst_rx_identifier_rxprog[] = {
     119, 120, 121, 122, 95, 0, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_identifier_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 2,
+    0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_identifier_rxtrans[] = {
+    -1, -1, 1, -1, 2, 2, -1, 2, 2,
+};
+
+static const unsigned int cst_rx_identifier_rxaccept[] = {
+    0, 0, 0,
+};
+
+static const unsigned int cst_rx_identifier_rxaccept_end[] = {
+    0, 0, 1,
+};
+
+static const cst_regex_dfa cst_rx_identifier_rxdfa = {
+    3, 3,
+    cst_rx_identifier_rxclassmap, cst_rx_identifier_rxtrans, cst_rx_identifier_rxaccept,
+    cst_rx_identifier_rxaccept_end
+};
+
 static const cst_regex cst_rx_identifier_rx = {
     0, 1, NULL, 0, 140,
-    (char *) cst_rx_identifier_rxprog
+    (char *) cst_rx_identifier_rxprog,
+    &cst_rx_identifier_rxdfa
 };
 
 const cst_regex *const cst_rx_identifier = &cst_rx_identifier_rx;
@@ -98,9 +362,53 @@ static const unsigned char cst_rx_int_rxprog[] = {
     53, 54, 55, 56, 57, 0, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_int_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_int_rxtrans[] = {
+    -1, 1, 2, -1, -1, 2, -1, -1, 2,
+};
+
+static const unsigned int cst_rx_int_rxaccept[] = {
+    0, 0, 0,
+};
+
+static const unsigned int cst_rx_int_rxaccept_end[] = {
+    0, 0, 1,
+};
+
+static const cst_regex_dfa cst_rx_int_rxdfa = {
+    3, 3,
+    cst_rx_int_rxclassmap, cst_rx_int_rxtrans, cst_rx_int_rxaccept,
+    cst_rx_int_rxaccept_end
+};
+
 static const cst_regex cst_rx_int_rx = {
     0, 1, NULL, 0, 44,
-    (char *) cst_rx_int_rxprog
+    (char *) cst_rx_int_rxprog,
+    &cst_rx_int_rxdfa
 };
 
 const cst_regex *const cst_rx_int = &cst_rx_int_rx;
@@ -121,9 +429,57 @@ static const unsigned char cst_rx_double_rxprog[] = {
     0, 3, 9, 0, 3, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_double_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 1, 0, 2, 3, 0,
+    4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_double_rxtrans[] = {
+    -1, -1, 1, 2, 3, -1, -1, -1, -1, 2, 3, -1,
+    -1, -1, -1, -1, 4, -1, -1, -1, -1, 5, 3, 6,
+    -1, -1, -1, -1, 4, 6, -1, -1, -1, -1, 5, 6,
+    -1, 7, 7, -1, 8, -1, -1, -1, -1, -1, 8, -1,
+    -1, -1, -1, -1, 8, -1,
+};
+
+static const unsigned int cst_rx_double_rxaccept[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const unsigned int cst_rx_double_rxaccept_end[] = {
+    0, 0, 0, 1, 1, 1, 0, 0, 1,
+};
+
+static const cst_regex_dfa cst_rx_double_rxdfa = {
+    9, 6,
+    cst_rx_double_rxclassmap, cst_rx_double_rxtrans, cst_rx_double_rxaccept,
+    cst_rx_double_rxaccept_end
+};
+
 static const cst_regex cst_rx_double_rx = {
     0, 1, NULL, 0, 203,
-    (char *) cst_rx_double_rxprog
+    (char *) cst_rx_double_rxprog,
+    &cst_rx_double_rxdfa
 };
 
 const cst_regex *const cst_rx_double = &cst_rx_double_rx;
@@ -146,9 +502,56 @@ static const unsigned char cst_rx_commaint_rxprog[] = {
     3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_commaint_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 2, 0,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_commaint_rxtrans[] = {
+    -1, -1, -1, 1, -1, 2, -1, 3, -1, -1, -1, 4,
+    -1, 2, -1, 5, -1, -1, -1, 6, -1, 2, -1, -1,
+    -1, -1, -1, 7, -1, 2, 8, -1, -1, -1, -1, 9,
+    -1, -1, -1, 9,
+};
+
+static const unsigned int cst_rx_commaint_rxaccept[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const unsigned int cst_rx_commaint_rxaccept_end[] = {
+    0, 0, 0, 0, 0, 0, 0, 1, 0, 1,
+};
+
+static const cst_regex_dfa cst_rx_commaint_rxdfa = {
+    10, 4,
+    cst_rx_commaint_rxclassmap, cst_rx_commaint_rxtrans, cst_rx_commaint_rxaccept,
+    cst_rx_commaint_rxaccept_end
+};
+
 static const cst_regex cst_rx_commaint_rx = {
     0, 1, NULL, 0, 228,
-    (char *) cst_rx_commaint_rxprog
+    (char *) cst_rx_commaint_rxprog,
+    &cst_rx_commaint_rxdfa
 };
 
 const cst_regex *const cst_rx_commaint = &cst_rx_commaint_rx;
@@ -159,9 +562,53 @@ static const unsigned char cst_rx_digits_rxprog[] = {
     53, 54, 55, 56, 57, 0, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_digits_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_digits_rxtrans[] = {
+    -1, 1, -1, 1,
+};
+
+static const unsigned int cst_rx_digits_rxaccept[] = {
+    0, 0,
+};
+
+static const unsigned int cst_rx_digits_rxaccept_end[] = {
+    0, 1,
+};
+
+static const cst_regex_dfa cst_rx_digits_rxdfa = {
+    2, 2,
+    cst_rx_digits_rxclassmap, cst_rx_digits_rxtrans, cst_rx_digits_rxaccept,
+    cst_rx_digits_rxaccept_end
+};
+
 static const cst_regex cst_rx_digits_rx = {
     0, 1, NULL, 0, 44,
-    (char *) cst_rx_digits_rxprog
+    (char *) cst_rx_digits_rxprog,
+    &cst_rx_digits_rxdfa
 };
 
 const cst_regex *const cst_rx_digits = &cst_rx_digits_rx;
@@ -181,9 +628,53 @@ static const unsigned char cst_rx_dotted_abbrev_rxprog[] = {
     0, 2, 0, 3, 0, 0, 0,
 };
 
+static const unsigned char cst_rx_dotted_abbrev_rxclassmap[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0,
+    0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,
+};
+
+static const short cst_rx_dotted_abbrev_rxtrans[] = {
+    -1, -1, 1, -1, 0, -1,
+};
+
+static const unsigned int cst_rx_dotted_abbrev_rxaccept[] = {
+    0, 0,
+};
+
+static const unsigned int cst_rx_dotted_abbrev_rxaccept_end[] = {
+    0, 1,
+};
+
+static const cst_regex_dfa cst_rx_dotted_abbrev_rxdfa = {
+    2, 3,
+    cst_rx_dotted_abbrev_rxclassmap, cst_rx_dotted_abbrev_rxtrans, cst_rx_dotted_abbrev_rxaccept,
+    cst_rx_dotted_abbrev_rxaccept_end
+};
+
 static const cst_regex cst_rx_dotted_abbrev_rx = {
     0, 1, NULL, 0, 151,
-    (char *) cst_rx_dotted_abbrev_rxprog
+    (char *) cst_rx_dotted_abbrev_rxprog,
+    &cst_rx_dotted_abbrev_rxdfa
 };
 
 const cst_regex *const cst_rx_dotted_abbrev = &cst_rx_dotted_abbrev_rx;
@@ -0,0 +1,579 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*    Compiles regexes into DFAs for allocation free linear time matching*/
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  The Spencer matcher backtracks, and the text normalization code      */
+/*  calls it many times per token.  Matching only needs a yes or no, so  */
+/*  the compiled programs are turned into an NFA and then, by the subset */
+/*  construction, into a DFA over classes of bytes that behave the same. */
+/*  Regexes that start anywhere get the NFA's start states added after   */
+/*  every character, so one pass finds a match at any position.  Word    */
+/*  boundaries (\< \>) depend on the previous character and aren't done  */
+/*  here, those regexes keep using the backtracking matcher.             */
+/*                                                                       */
+/*************************************************************************/
+
+#include "cst_alloc.h"
+#include "cst_string.h"
+#include "cst_error.h"
+#include "cst_regex.h"
+#include "regprog.h"
+
+#define DFA_MAX_STATES 4096
+#define DFA_MAX_NFA_NODES 16384
+
+#define NFA_CHAR 0
+#define NFA_SPLIT 1
+#define NFA_BOL 2
+#define NFA_EOL 3
+#define NFA_MATCH 4
+
+typedef unsigned int nfa_charset[8];     /* 256 bits */
+
+typedef struct nfa_node_struct {
+    int type;
+    int out1, out2;             /* -1 if unused */
+    int arg;                    /* charset for CHAR, regex for MATCH */
+} nfa_node;
+
+typedef struct nfa_struct {
+    nfa_node *nodes;
+    int num_nodes, max_nodes;
+    nfa_charset *sets;          /* one per CHAR node */
+    int num_sets;
+    int *memo;                  /* program offset to node */
+    int failed;
+} nfa;
+
+static int nfa_add(nfa *n, int type, int arg)
+{
+    nfa_node *nodes;
+    nfa_charset *sets;
+
+    if (n->num_nodes == n->max_nodes)
+    {
+        if (n->max_nodes >= DFA_MAX_NFA_NODES)
+        {
+            n->failed = 1;
+            return -1;
+        }
+        nodes = cst_alloc(nfa_node, n->max_nodes * 2);
+        memmove(nodes, n->nodes, n->num_nodes * sizeof(nfa_node));
+        cst_free(n->nodes);
+        n->nodes = nodes;
+        sets = cst_alloc(nfa_charset, n->max_nodes * 2);
+        memmove(sets, n->sets, n->num_sets * sizeof(nfa_charset));
+        cst_free(n->sets);
+        n->sets = sets;
+        n->max_nodes *= 2;
+    }
+    n->nodes[n->num_nodes].type = type;
+    n->nodes[n->num_nodes].out1 = -1;
+    n->nodes[n->num_nodes].out2 = -1;
+    n->nodes[n->num_nodes].arg = arg;
+    if (type == NFA_CHAR)
+    {
+        memset(n->sets[n->num_sets], 0, sizeof(nfa_charset));
+        n->nodes[n->num_nodes].arg = n->num_sets++;
+    }
+    return n->num_nodes++;
+}
+
+#define SET_HAS(s, c) ((s)[(c) >> 5] & (1u << ((c) & 31)))
+#define SET_ADD(s, c) ((s)[(c) >> 5] |= (1u << ((c) & 31)))
+
+static void node_charset(const char *p, unsigned int *set)
+{
+    /* The characters a single character node accepts, never '\0' as */
+    /* the matcher always stops at the end of the string             */
+    const unsigned char *o = (const unsigned char *) OPERAND(p);
+    int c;
+
+    switch (OP(p))
+    {
+    case ANY:
+        for (c = 1; c < 256; c++)
+            SET_ADD(set, c);
+        break;
+    case ANYOF:
+        for (; *o; o++)
+            SET_ADD(set, *o);
+        break;
+    case ANYBUT:
+        for (c = 1; c < 256; c++)
+            if (strchr((const char *) o, c) == NULL)
+                SET_ADD(set, c);
+        break;
+    case EXACTLY:
+        SET_ADD(set, *o);
+        break;
+    }
+}
+
+static const char *prog_next(const char *p)
+{
+    int offset = NEXT(p);
+
+    if (offset == 0)
+        return NULL;
+    return (OP(p) == BACK) ? p - offset : p + offset;
+}
+
+static int nfa_build(nfa *n, const char *prog, const char *p, int rx);
+
+static int nfa_build_next(nfa *n, const char *prog, const char *p, int rx)
+{
+    const char *next = prog_next(p);
+
+    if (next == NULL)
+    {
+        /* Only END may end a chain, the matcher would fail here */
+        n->failed = 1;
+        return -1;
+    }
+    return nfa_build(n, prog, next, rx);
+}
+
+static int nfa_build(nfa *n, const char *prog, const char *p, int rx)
+{
+    /* Returns the node that matches the program from p on, the nodes */
+    /* are memoized by offset so the loops made with BACK close up    */
+    int node, c, loop, t, i, len;
+    const char *next;
+
+    if (n->failed)
+        return -1;
+    if (n->memo[p - prog] >= 0)
+        return n->memo[p - prog];
+
+    switch (OP(p))
+    {
+    case END:
+        node = nfa_add(n, NFA_MATCH, rx);
+        n->memo[p - prog] = node;
+        return node;
+    case BOL:
+    case EOL:
+        node = nfa_add(n, (OP(p) == BOL) ? NFA_BOL : NFA_EOL, 0);
+        if (node < 0)
+            return -1;
+        n->memo[p - prog] = node;
+        t = nfa_build_next(n, prog, p, rx);
+        n->nodes[node].out1 = t;
+        return node;
+    case ANY:
+    case ANYOF:
+    case ANYBUT:
+        node = nfa_add(n, NFA_CHAR, 0);
+        if (node < 0)
+            return -1;
+        node_charset(p, n->sets[n->nodes[node].arg]);
+        n->memo[p - prog] = node;
+        t = nfa_build_next(n, prog, p, rx);
+        n->nodes[node].out1 = t;
+        return node;
+    case EXACTLY:
+        len = cst_strlen(OPERAND(p));
+        node = c = -1;
+        for (i = 0; i < len; i++)
+        {
+            t = nfa_add(n, NFA_CHAR, 0);
+            if (t < 0)
+                return -1;
+            SET_ADD(n->sets[n->nodes[t].arg],
+                    ((const unsigned char *) OPERAND(p))[i]);
+            if (c >= 0)
+                n->nodes[c].out1 = t;
+            else
+                node = t;
+            c = t;
+        }
+        n->memo[p - prog] = node;
+        t = nfa_build_next(n, prog, p, rx);
+        n->nodes[c].out1 = t;
+        return node;
+    case BRANCH:
+        node = nfa_add(n, NFA_SPLIT, 0);
+        if (node < 0)
+            return -1;
+        n->memo[p - prog] = node;
+        t = nfa_build(n, prog, OPERAND(p), rx);
+        n->nodes[node].out1 = t;
+        /* Consecutive BRANCHes are the alternatives of one choice */
+        next = prog_next(p);
+        if (next && OP(next) == BRANCH)
+        {
+            t = nfa_build(n, prog, next, rx);
+            n->nodes[node].out2 = t;
+        }
+        return node;
+    case STAR:
+    case PLUS:
+        loop = nfa_add(n, NFA_SPLIT, 0);
+        c = nfa_add(n, NFA_CHAR, 0);
+        if (c < 0)
+            return -1;
+        node_charset(OPERAND(p), n->sets[n->nodes[c].arg]);
+        n->nodes[c].out1 = loop;
+        n->nodes[loop].out1 = c;
+        node = (OP(p) == STAR) ? loop : c;
+        n->memo[p - prog] = node;
+        t = nfa_build_next(n, prog, p, rx);
+        n->nodes[loop].out2 = t;
+        return node;
+    case NOTHING:
+    case BACK:
+        break;
+    default:
+        if (OP(p) < OPEN || OP(p) >= CLOSE + 10)
+        {
+            /* WORDA, WORDZ */
+            n->failed = 1;
+            return -1;
+        }
+        break;
+    }
+
+    /* Matches the empty string */
+    node = nfa_add(n, NFA_SPLIT, 0);
+    if (node < 0)
+        return -1;
+    n->memo[p - prog] = node;
+    t = nfa_build_next(n, prog, p, rx);
+    n->nodes[node].out1 = t;
+    return node;
+}
+
+typedef struct dfa_build_struct {
+    nfa *n;
+    int words;                  /* per NFA node set */
+    int *entries;
+    int num_entries;
+    /* closure work space */
+    int *stack;
+    int *seen;
+    int generation;
+    /* the states found so far */
+    unsigned int *keys;
+    unsigned int *acc, *acc_end;
+    int num_states;
+    int *hash;
+    int hash_size;
+} dfa_build;
+
+static void closure_push(dfa_build *b, int *sp, int node, int eol)
+{
+    int k = node * 2 + eol;
+
+    if (node < 0 || b->seen[k] == b->generation)
+        return;
+    b->seen[k] = b->generation;
+    b->stack[(*sp)++] = k;
+}
+
+static void closure(dfa_build *b, const int *seeds, int num_seeds,
+                    int at_start, unsigned int *key,
+                    unsigned int *acc, unsigned int *acc_end)
+{
+    /* Follows the empty moves from seeds, setting the CHAR nodes    */
+    /* reached in key.  Anything reached past a $ can only match at  */
+    /* the end of the string.                                        */
+    nfa_node *nd;
+    int sp = 0, k, i, node, eol;
+
+    b->generation++;
+    for (i = 0; i < num_seeds; i++)
+        closure_push(b, &sp, seeds[i], 0);
+    for (i = 0; i < b->num_entries; i++)
+        closure_push(b, &sp, b->entries[i], 0);
+
+    while (sp > 0)
+    {
+        k = b->stack[--sp];
+        node = k / 2;
+        eol = k % 2;
+        nd = &b->n->nodes[node];
+        switch (nd->type)
+        {
+        case NFA_CHAR:
+            if (!eol)
+                key[node >> 5] |= 1u << (node & 31);
+            break;
+        case NFA_MATCH:
+            if (eol)
+                *acc_end |= 1u << nd->arg;
+            else
+                *acc |= 1u << nd->arg;
+            break;
+        case NFA_SPLIT:
+            closure_push(b, &sp, nd->out1, eol);
+            closure_push(b, &sp, nd->out2, eol);
+            break;
+        case NFA_BOL:
+            if (at_start)
+                closure_push(b, &sp, nd->out1, eol);
+            break;
+        case NFA_EOL:
+            closure_push(b, &sp, nd->out1, 1);
+            break;
+        }
+    }
+}
+
+static unsigned int key_hash(const unsigned int *key, int words,
+                             unsigned int acc, unsigned int acc_end)
+{
+    unsigned int h = acc * 31 + acc_end;
+    int i;
+
+    for (i = 0; i < words; i++)
+        h = h * 2654435761u + key[i];
+    return h;
+}
+
+static int find_state(dfa_build *b, const unsigned int *key,
+                      unsigned int acc, unsigned int acc_end)
+{
+    /* Returns the state for key, adding it if it's new, -1 if there */
+    /* are too many                                                  */
+    unsigned int h;
+    int s;
+
+    h = key_hash(key, b->words, acc, acc_end) & (b->hash_size - 1);
+    while ((s = b->hash[h]) >= 0)
+    {
+        if (b->acc[s] == acc && b->acc_end[s] == acc_end &&
+            memcmp(&b->keys[s * b->words], key,
+                   b->words * sizeof(unsigned int)) == 0)
+            return s;
+        h = (h + 1) & (b->hash_size - 1);
+    }
+    if (b->num_states == DFA_MAX_STATES)
+        return -1;
+    s = b->num_states++;
+    memmove(&b->keys[s * b->words], key, b->words * sizeof(unsigned int));
+    b->acc[s] = acc;
+    b->acc_end[s] = acc_end;
+    b->hash[h] = s;
+    return s;
+}
+
+static int byte_classes(const nfa *n, unsigned char *classmap)
+{
+    /* Splits the bytes into classes that every charset treats alike */
+    int map[512];
+    int num_classes = 1, i, c, k, nc;
+
+    memset(classmap, 0, 256);
+    for (i = 0; i < n->num_sets; i++)
+    {
+        for (k = 0; k < 2 * num_classes; k++)
+            map[k] = -1;
+        nc = 0;
+        for (c = 0; c < 256; c++)
+        {
+            k = classmap[c] * 2 + (SET_HAS(n->sets[i], c) ? 1 : 0);
+            if (map[k] < 0)
+                map[k] = nc++;
+            classmap[c] = map[k];
+        }
+        num_classes = nc;
+        if (num_classes == 256)
+            break;
+    }
+    return num_classes;
+}
+
+cst_regex_dfa *new_cst_regex_dfa(const cst_regex *const *rxs, int num)
+{
+    nfa n;
+    dfa_build b;
+    cst_regex_dfa *d = NULL;
+    unsigned char *classmap;
+    unsigned char rep[256];
+    short *trans = NULL;
+    unsigned int *key, *acc, *acc_end;
+    unsigned int a, ae;
+    int *seeds;
+    int i, j, s, c, num_classes, node, num_seeds;
+
+    if (num < 1 || num > CST_REGEX_DFA_MAX_REGEXES)
+        return NULL;
+
+    memset(&n, 0, sizeof(n));
+    n.max_nodes = 64;
+    n.nodes = cst_alloc(nfa_node, n.max_nodes);
+    n.sets = cst_alloc(nfa_charset, n.max_nodes);
+    memset(&b, 0, sizeof(b));
+    b.entries = cst_alloc(int, num);
+    for (i = 0; i < num && !n.failed; i++)
+    {
+        if (rxs[i] == NULL || rxs[i]->regsize < 1 ||
+            (unsigned char) rxs[i]->program[0] != CST_REGMAGIC)
+        {
+            n.failed = 1;
+            break;
+        }
+        n.memo = cst_alloc(int, rxs[i]->regsize);
+        for (j = 0; j < rxs[i]->regsize; j++)
+            n.memo[j] = -1;
+        b.entries[i] = nfa_build(&n, rxs[i]->program,
+                                 rxs[i]->program + 1, i);
+        cst_free(n.memo);
+    }
+    if (n.failed)
+        goto done;
+
+    classmap = cst_alloc(unsigned char, 256);
+    num_classes = byte_classes(&n, classmap);
+    for (c = 255; c > 0; c--)
+        rep[classmap[c]] = c;   /* so '\0' is never a representative */
+
+    b.n = &n;
+    b.num_entries = 0;          /* the start has them, see below */
+    b.words = (n.num_nodes + 31) / 32;
+    b.stack = cst_alloc(int, 2 * n.num_nodes);
+    b.seen = cst_alloc(int, 2 * n.num_nodes);
+    b.keys = cst_alloc(unsigned int, DFA_MAX_STATES * b.words);
+    b.acc = cst_alloc(unsigned int, DFA_MAX_STATES);
+    b.acc_end = cst_alloc(unsigned int, DFA_MAX_STATES);
+    b.hash_size = 2 * DFA_MAX_STATES;
+    b.hash = cst_alloc(int, b.hash_size);
+    for (i = 0; i < b.hash_size; i++)
+        b.hash[i] = -1;
+    key = cst_alloc(unsigned int, b.words);
+    seeds = cst_alloc(int, n.num_nodes);
+    trans = cst_alloc(short, DFA_MAX_STATES * num_classes);
+
+    /* The start state: everything reachable at the beginning of the */
+    /* string.  After that the entries are added to every state for  */
+    /* the regexes that can start anywhere, ^ stops the others.      */
+    a = ae = 0;
+    closure(&b, b.entries, num, 1, key, &a, &ae);
+    find_state(&b, key, a, ae);
+    b.num_entries = num;
+
+    for (s = 0; s < b.num_states; s++)
+    {
+        for (c = 0; c < num_classes; c++)
+        {
+            num_seeds = 0;
+            for (node = 0; node < n.num_nodes; node++)
+                if ((b.keys[s * b.words + (node >> 5)] & (1u << (node & 31)))
+                    && SET_HAS(n.sets[n.nodes[node].arg], rep[c]))
+                    seeds[num_seeds++] = n.nodes[node].out1;
+            memset(key, 0, b.words * sizeof(unsigned int));
+            a = ae = 0;
+            closure(&b, seeds, num_seeds, 0, key, &a, &ae);
+            for (i = 0; i < b.words && key[i] == 0; i++);
+            if (i == b.words && a == 0 && ae == 0)
+                trans[s * num_classes + c] = -1;
+            else if ((trans[s * num_classes + c] =
+                      find_state(&b, key, a, ae)) < 0)
+                break;
+        }
+        if (c < num_classes)
+            break;
+    }
+
+    if (s == b.num_states)
+    {
+        d = cst_alloc(cst_regex_dfa, 1);
+        d->num_states = b.num_states;
+        d->num_classes = num_classes;
+        d->classmap = classmap;
+        d->trans = cst_alloc(short, b.num_states * num_classes);
+        memmove((short *) d->trans, trans,
+                b.num_states * num_classes * sizeof(short));
+        acc = cst_alloc(unsigned int, b.num_states);
+        acc_end = cst_alloc(unsigned int, b.num_states);
+        memmove(acc, b.acc, b.num_states * sizeof(unsigned int));
+        memmove(acc_end, b.acc_end, b.num_states * sizeof(unsigned int));
+        d->accept = acc;
+        d->accept_end = acc_end;
+    }
+    else
+        cst_free(classmap);
+
+    cst_free(trans);
+    cst_free(seeds);
+    cst_free(key);
+    cst_free(b.hash);
+    cst_free(b.acc_end);
+    cst_free(b.acc);
+    cst_free(b.keys);
+    cst_free(b.seen);
+    cst_free(b.stack);
+  done:
+    cst_free(b.entries);
+    cst_free(n.sets);
+    cst_free(n.nodes);
+
+    return d;
+}
+
+void delete_cst_regex_dfa(cst_regex_dfa *d)
+{
+    if (d == NULL)
+        return;
+    cst_free((unsigned char *) d->classmap);
+    cst_free((short *) d->trans);
+    cst_free((unsigned int *) d->accept);
+    cst_free((unsigned int *) d->accept_end);
+    cst_free(d);
+}
+
+unsigned int cst_regex_dfa_match(const cst_regex_dfa *d, const char *str,
+                                 int all)
+{
+    const unsigned char *s = (const unsigned char *) str;
+    unsigned int m;
+    int state = 0;
+
+    m = d->accept[0];
+    for (; *s && (all || m == 0); s++)
+    {
+        state = d->trans[state * d->num_classes + d->classmap[*s]];
+        if (state < 0)
+            return m;
+        m |= d->accept[state];
+    }
+    if (*s == '\0')
+        m |= d->accept_end[state];
+
+    return m;
+}
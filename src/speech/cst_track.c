@@ -37,6 +37,7 @@
 /*  Tracks (cepstrum, ffts, F0 etc)                                      */
 /*                                                                       */
 /*************************************************************************/
+#include <stdint.h>
 #include "cst_string.h"
 #include "cst_val.h"
 #include "cst_track.h"
@@ -50,13 +51,13 @@ cst_track *new_track()
 
 void delete_track(cst_track *w)
 {
-    int i;
-
     if (w)
     {
-        cst_free(w->times);
-        for (i = 0; i < w->num_frames; i++)
-            cst_free(w->frames[i]);
+        if (w->block)
+        {
+            cst_free(w->times);
+            cst_free(w->block);
+        }
         cst_free(w->frames);
         cst_free(w);
     }
@@ -71,56 +72,135 @@ float track_frame_shift(cst_track *t, int frame)
         return t->times[frame] - t->times[frame - 1];
 }
 
-void cst_track_resize(cst_track *t, int num_frames, int num_channels)
+static int track_step(int n)
 {
-    float *n_times;
-    float **n_frames;
-    int i;
+    /* Rows or channels are padded so each one starts aligned */
+    int a = CST_TRACK_ALIGN / sizeof(float);
 
-    n_times = cst_alloc(float, num_frames);
-    memmove(n_times, t->times,
-            (sizeof(float) * ((num_frames < t->num_frames) ?
-                              num_frames : t->num_frames)));
-    n_frames = cst_alloc(float *, num_frames);
-    for (i = 0; i < num_frames; i++)
+    return ((n + a - 1) / a) * a;
+}
+
+static void track_alloc(cst_track *t, int num_frames, int num_channels,
+                        int layout)
+{
+    /* Zeroed storage for num_frames by num_channels, doesn't free */
+    /* what was there                                               */
+    int i, size;
+
+    if (layout == CST_TRACK_CHANNEL_MAJOR)
     {
-        n_frames[i] = cst_alloc(float, num_channels);
-        if (i < t->num_frames)
-        {
-            memmove(n_frames[i],
-                    t->frames[i],
-                    sizeof(float) * ((num_channels < t->num_channels) ?
-                                     num_channels : t->num_channels));
-            cst_free(t->frames[i]);
-        }
+        t->frame_step = 1;
+        t->channel_step = track_step(num_frames);
+        size = num_channels * t->channel_step;
     }
-    for (; i < t->num_frames; i++)
-        cst_free(t->frames[i]);
-    cst_free(t->frames);
-    t->frames = n_frames;
-    cst_free(t->times);
-    t->times = n_times;
+    else
+    {
+        t->frame_step = track_step(num_channels);
+        t->channel_step = 1;
+        size = num_frames * t->frame_step;
+    }
+    t->block = cst_safe_alloc((sizeof(float) * size) + CST_TRACK_ALIGN);
+    t->data = (float *) (((uintptr_t) t->block + CST_TRACK_ALIGN - 1) &
+                         ~((uintptr_t) CST_TRACK_ALIGN - 1));
+    t->frames = NULL;
+    if (layout == CST_TRACK_ROW_MAJOR)
+    {
+        t->frames = cst_alloc(float *, num_frames);
+        for (i = 0; i < num_frames; i++)
+            t->frames[i] = t->data + (i * t->frame_step);
+    }
+    t->times = cst_alloc(float, num_frames);
     t->num_frames = num_frames;
     t->num_channels = num_channels;
+    t->layout = layout;
+}
+
+static void track_copy_vals(cst_track *t, const cst_track *from)
+{
+    /* Copies the frames and channels t and from have in common */
+    int i, j, num_frames, num_channels;
+
+    num_frames = (t->num_frames < from->num_frames) ?
+        t->num_frames : from->num_frames;
+    num_channels = (t->num_channels < from->num_channels) ?
+        t->num_channels : from->num_channels;
+    memmove(t->times, from->times, sizeof(float) * num_frames);
+    if ((t->layout == CST_TRACK_ROW_MAJOR) &&
+        (from->layout == CST_TRACK_ROW_MAJOR))
+        for (i = 0; i < num_frames; i++)
+            memmove(t->frames[i], from->frames[i],
+                    sizeof(float) * num_channels);
+    else
+        for (j = 0; j < num_channels; j++)
+            for (i = 0; i < num_frames; i++)
+                cst_track_val(t, i, j) = cst_track_val(from, i, j);
+}
+
+static void track_move(cst_track *t, const cst_track *old)
+{
+    /* t has new storage, old is what it had */
+    track_copy_vals(t, old);
+    if (old->block)
+    {
+        cst_free(old->times);
+        cst_free(old->block);
+    }
+    cst_free(old->frames);
+}
+
+void cst_track_resize(cst_track *t, int num_frames, int num_channels)
+{
+    cst_track old;
+
+    old = *t;
+    track_alloc(t, num_frames, num_channels, old.layout);
+    track_move(t, &old);
+}
+
+void cst_track_set_layout(cst_track *t, int layout)
+{
+    cst_track old;
+
+    if (t->layout == layout)
+        return;
+    old = *t;
+    track_alloc(t, old.num_frames, old.num_channels, layout);
+    track_move(t, &old);
 }
 
 cst_track *cst_track_copy(const cst_track *t)
 {
     cst_track *t2;
-    int i;
 
     t2 = new_track();
-    t2->times = cst_alloc(float, t->num_frames);
-    memmove(t2->times, t->times, (sizeof(float) * t->num_frames));
-    t2->num_frames = t->num_frames;
-    t2->num_channels = t->num_channels;
-    t2->frames = cst_alloc(float *, t->num_frames);
-    for (i = 0; i < t2->num_frames; i++)
+    track_alloc(t2, t->num_frames, t->num_channels, t->layout);
+    track_copy_vals(t2, t);
+
+    return t2;
+}
+
+cst_track *cst_track_view(const cst_track *t, int first_frame,
+                          int num_frames, int first_channel,
+                          int num_channels)
+{
+    cst_track *v;
+    int i;
+
+    v = new_track();
+    v->type = t->type;
+    v->num_frames = num_frames;
+    v->num_channels = num_channels;
+    v->times = t->times + first_frame;
+    v->data = &cst_track_val(t, first_frame, first_channel);
+    v->frame_step = t->frame_step;
+    v->channel_step = t->channel_step;
+    v->layout = t->layout;
+    if (t->layout == CST_TRACK_ROW_MAJOR)
     {
-        t2->frames[i] = cst_alloc(float, t2->num_channels);
-        memmove(t2->frames[i], t->frames[i],
-                sizeof(float) * t2->num_channels);
+        v->frames = cst_alloc(float *, num_frames);
+        for (i = 0; i < num_frames; i++)
+            v->frames[i] = v->data + (i * v->frame_step);
     }
 
-    return t2;
+    return v;
 }
@@ -64,7 +64,7 @@ int cst_track_save_est(cst_track *t, const char *filename)
     {
         cst_fprintf(fd, "%f\t1 \t", t->times[i]);
         for (j = 0; j < t->num_channels; j++)
-            cst_fprintf(fd, "%f ", t->frames[i][j]);
+            cst_fprintf(fd, "%f ", cst_track_val(t, i, j));
         cst_fprintf(fd, "\n");
     }
 
@@ -101,7 +101,7 @@ int cst_track_save_est_binary(cst_track *t, const char *filename)
         cst_fwrite(fd, t->times + i, sizeof(float), 1);
         cst_fwrite(fd, &foo, sizeof(float), 1);
         for (j = 0; j < t->num_channels; j++)
-            cst_fwrite(fd, &(t->frames[i][j]), sizeof(float), 1);
+            cst_fwrite(fd, &cst_track_val(t, i, j), sizeof(float), 1);
     }
 
     cst_fclose(fd);
@@ -116,7 +116,7 @@ static int load_frame_ascii(cst_track *t, int i, cst_tokenstream *ts)
     t->times[i] = cst_atof(ts_get(ts));
     ts_get(ts);                 /* the can be only 1 */
     for (j = 0; j < t->num_channels; j++)
-        t->frames[i][j] = cst_atof(ts_get(ts));
+        cst_track_val(t, i, j) = cst_atof(ts_get(ts));
     if ((i + 1 < t->num_frames) && (ts_eof(ts)))
     {
         return -1;
@@ -130,23 +130,23 @@ static int load_frame_binary(cst_track *t, int i, cst_tokenstream *ts,
     float val;
     int j;
 
-    if (cst_fread(ts->fd, &val, sizeof(float), 1) != 1)
+    if (ts_read(&val, sizeof(float), 1, ts) != 1)
         return -1;
     if (swap)
         swapfloat(&val);
     t->times[i] = val;
 
     /* Ignore the 'breaks' field */
-    if (cst_fread(ts->fd, &val, sizeof(float), 1) != 1)
+    if (ts_read(&val, sizeof(float), 1, ts) != 1)
         return -1;
 
     for (j = 0; j < t->num_channels; j++)
     {
-        if (cst_fread(ts->fd, &val, sizeof(float), 1) != 1)
+        if (ts_read(&val, sizeof(float), 1, ts) != 1)
             return -1;
         if (swap)
             swapfloat(&val);
-        t->frames[i][j] = val;
+        cst_track_val(t, i, j) = val;
     }
 
     return 0;
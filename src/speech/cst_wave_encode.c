@@ -0,0 +1,325 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*    Output encoders for telephony: rate conversion fused with          */
+/*    table driven mu-law and A-law, and G.721 ADPCM                     */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Gateways want 8kHz mu-law, A-law or G.721 rather than 16 bit wave    */
+/*  files at the voice's rate.  Samples are pushed through the           */
+/*  resampler a block at a time and coded straight out of its output     */
+/*  buffer, so there is no intermediate wave at either rate.  The         */
+/*  G.711 codes come from tables built once: mu-law is indexed by the    */
+/*  whole 16 bit sample, A-law only looks at the top 13 bits.            */
+/*                                                                       */
+/*************************************************************************/
+
+#include "cst_alloc.h"
+#include "cst_error.h"
+#include "cst_string.h"
+#include "cst_file.h"
+#include "cst_wave.h"
+#include "g72x.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#define ENC_BLOCK 1024          /* input samples per resampler run */
+
+static unsigned char ulaw_table[65536];
+static unsigned char alaw_table[8192];
+
+static void build_tables(void)
+{
+    int i;
+
+    for (i = 0; i < 65536; i++)
+        ulaw_table[i] = cst_short_to_ulaw((short) (i - 32768));
+    for (i = 0; i < 8192; i++)
+        alaw_table[i] = cst_short_to_alaw((short) ((i - 4096) << 3));
+}
+
+#ifdef HAVE_PTHREAD_H
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+#else
+static int tables_built = 0;
+#endif
+
+static void init_tables(void)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_once(&tables_once, build_tables);
+#else
+    if (!tables_built)
+    {
+        build_tables();
+        tables_built = 1;
+    }
+#endif
+}
+
+int cst_wave_encoding_id(const char *name)
+{
+    if (name == NULL)
+        return -1;
+    if (cst_streq(name, "ulaw") || cst_streq(name, "mulaw"))
+        return CST_WAVE_ENC_ULAW;
+    if (cst_streq(name, "alaw"))
+        return CST_WAVE_ENC_ALAW;
+    if (cst_streq(name, "g721"))
+        return CST_WAVE_ENC_G721;
+    if (cst_streq(name, "linear16") || cst_streq(name, "short"))
+        return CST_WAVE_ENC_LINEAR16;
+    return -1;
+}
+
+cst_wave_encoder *new_wave_encoder(int encoding, int out_rate,
+                                   int (*write) (cst_wave_encoder *enc,
+                                                 const unsigned char *bytes,
+                                                 int num_bytes),
+                                   void *userdata)
+{
+    cst_wave_encoder *enc;
+
+    if (encoding < CST_WAVE_ENC_LINEAR16 || encoding > CST_WAVE_ENC_G721)
+    {
+        cst_errmsg("new_wave_encoder: unknown encoding %d\n", encoding);
+        return NULL;
+    }
+    init_tables();
+
+    enc = cst_alloc(cst_wave_encoder, 1);
+    enc->encoding = encoding;
+    enc->out_rate = out_rate;
+    enc->write = write;
+    enc->userdata = userdata;
+    enc->nibble = -1;
+    if (encoding == CST_WAVE_ENC_G721)
+    {
+        enc->g72x = cst_alloc(struct g72x_state, 1);
+        g72x_init_state((struct g72x_state *) enc->g72x);
+    }
+    enc->obuf_size = 2 * ENC_BLOCK;
+    enc->obuf = cst_alloc(unsigned char, enc->obuf_size);
+
+    return enc;
+}
+
+void delete_wave_encoder(cst_wave_encoder *enc)
+{
+    if (enc == NULL)
+        return;
+    if (enc->rateconv)
+        delete_rateconv(enc->rateconv);
+    cst_free(enc->g72x);
+    cst_free(enc->sbuf);
+    cst_free(enc->obuf);
+    cst_free(enc);
+}
+
+static int encoder_set_rate(cst_wave_encoder *enc, int sample_rate)
+{
+    int size;
+
+    if (enc->rateconv)
+        delete_rateconv(enc->rateconv);
+    enc->rateconv = NULL;
+    enc->in_rate = sample_rate;
+
+    if (enc->out_rate <= 0 || enc->out_rate == sample_rate)
+        return 0;
+
+    enc->rateconv = new_rateconv_rates(sample_rate, enc->out_rate, 1);
+    if (enc->rateconv == NULL)
+    {
+        cst_errmsg("cst_wave_encoder: can't convert %d Hz to %d Hz\n",
+                   sample_rate, enc->out_rate);
+        enc->in_rate = 0;
+        return -1;
+    }
+
+    size = cst_rateconv_max_out(enc->rateconv, ENC_BLOCK);
+    if (size > enc->sbuf_size)
+    {
+        cst_free(enc->sbuf);
+        enc->sbuf = cst_alloc(short, size);
+        enc->sbuf_size = size;
+    }
+    if (2 * size > enc->obuf_size)
+    {
+        cst_free(enc->obuf);
+        enc->obuf = cst_alloc(unsigned char, 2 * size);
+        enc->obuf_size = 2 * size;
+    }
+    return 0;
+}
+
+static int encode_block(cst_wave_encoder *enc, const short *s, int n)
+{
+    unsigned char *o = enc->obuf;
+    int i, code, nb = 0;
+
+    switch (enc->encoding)
+    {
+    case CST_WAVE_ENC_ULAW:
+        for (i = 0; i < n; i++)
+            o[i] = ulaw_table[(unsigned short) (s[i] + 32768)];
+        nb = n;
+        break;
+    case CST_WAVE_ENC_ALAW:
+        for (i = 0; i < n; i++)
+            o[i] = alaw_table[(s[i] >> 3) + 4096];
+        nb = n;
+        break;
+    case CST_WAVE_ENC_G721:
+        for (i = 0; i < n; i++)
+        {
+            code = g721_encoder(s[i], AUDIO_ENCODING_LINEAR,
+                                (struct g72x_state *) enc->g72x);
+            if (enc->nibble < 0)
+                enc->nibble = code;
+            else
+            {
+                o[nb++] = (unsigned char) ((enc->nibble << 4) | code);
+                enc->nibble = -1;
+            }
+        }
+        break;
+    default:
+        /* Little endian, as in a riff file, whatever the host */
+        for (i = 0; i < n; i++)
+        {
+            o[nb++] = (unsigned char) (s[i] & 0xff);
+            o[nb++] = (unsigned char) ((s[i] >> 8) & 0xff);
+        }
+        break;
+    }
+
+    if (nb == 0)
+        return 0;
+    enc->bytes_out += nb;
+    return (*enc->write) (enc, o, nb);
+}
+
+int cst_wave_encoder_write(cst_wave_encoder *enc, const short *samples,
+                           int num_samples, int sample_rate, int last)
+{
+    int n, done = 0, rv = 0;
+
+    if (enc->in_rate != sample_rate &&
+        encoder_set_rate(enc, sample_rate) != 0)
+        return -1;
+
+    /* Runs at least once so last gets the resampler's tail out */
+    do
+    {
+        n = num_samples - done;
+        if (n > ENC_BLOCK)
+            n = ENC_BLOCK;
+        if (enc->rateconv)
+            rv = encode_block(enc, enc->sbuf,
+                              cst_rateconv_run(enc->rateconv, samples + done,
+                                               n, enc->sbuf, enc->sbuf_size,
+                                               last &&
+                                               (done + n == num_samples)));
+        else
+            rv = encode_block(enc, samples + done, n);
+        done += n;
+    } while (rv >= 0 && done < num_samples);
+
+    if (last && rv >= 0)
+    {
+        if (enc->nibble >= 0)
+        {
+            enc->obuf[0] = (unsigned char) (enc->nibble << 4);
+            enc->bytes_out++;
+            rv = (*enc->write) (enc, enc->obuf, 1);
+        }
+        enc->nibble = -1;
+        if (enc->g72x)
+            g72x_init_state((struct g72x_state *) enc->g72x);
+        /* So the next write starts the resampler from silence */
+        enc->in_rate = 0;
+    }
+
+    return rv < 0 ? -1 : 0;
+}
+
+static int encoder_file_write(cst_wave_encoder *enc,
+                              const unsigned char *bytes, int num_bytes)
+{
+    cst_file fd = (cst_file) enc->userdata;
+
+    if (cst_fwrite(fd, bytes, 1, num_bytes) != num_bytes)
+        return -1;
+    return 0;
+}
+
+int cst_wave_save_encoded(const cst_wave *w, const char *filename,
+                          int encoding, int out_rate, int append)
+{
+    cst_wave_encoder *enc;
+    cst_file fd;
+    int rv;
+
+    if (w->num_channels != 1)
+    {
+        cst_errmsg("cst_wave_save_encoded: only mono waves can be encoded\n");
+        return -1;
+    }
+
+    if ((fd = cst_fopen(filename,
+                        (append ? CST_OPEN_APPEND : CST_OPEN_WRITE) |
+                        CST_OPEN_BINARY)) == NULL)
+    {
+        cst_errmsg("cst_wave_save_encoded: can't open file \"%s\"\n",
+                   filename);
+        return -1;
+    }
+
+    enc = new_wave_encoder(encoding, out_rate, encoder_file_write, fd);
+    if (enc == NULL)
+    {
+        cst_fclose(fd);
+        return -1;
+    }
+    rv = cst_wave_encoder_write(enc, w->samples, w->num_samples,
+                                w->sample_rate, 1);
+    delete_wave_encoder(enc);
+    cst_fclose(fd);
+
+    return rv;
+}
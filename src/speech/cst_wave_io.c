@@ -47,55 +47,26 @@ void cst_wave_resample(cst_wave *w, int sample_rate)
     /* platforms like PalmOS                                              */
 
     cst_rateconv *filt;
-    int up, down;
     short *in;
-    const short *inptr;
-    short *outptr;
-    int n, insize, outsize;
+    int outsize;
 
-    /* Sure, we could take the GCD.  In practice, though, this
-       gives us what we want and makes things go faster. */
-    down = w->sample_rate / 1000;
-    up = sample_rate / 1000;
-
-    if (up < 1 || down < 1)
+    filt = new_rateconv_rates(w->sample_rate, sample_rate, w->num_channels);
+    if (filt == NULL)
     {
         cst_errmsg
             ("cst_wave_resample: invalid input/output sample rates (%d, %d)\n",
-             up * 1000, down * 1000);
+             w->sample_rate, sample_rate);
         cst_error();
     }
 
-    filt = new_rateconv(up, down, w->num_channels);
-
-    inptr = in = w->samples;
-    insize = w->num_samples;
-
-    w->num_samples = w->num_samples * up / down + 2048;
-    w->samples = cst_alloc(short, w->num_samples * w->num_channels);
+    in = w->samples;
+    outsize = cst_rateconv_max_out(filt, w->num_samples * w->num_channels);
+    w->samples = cst_alloc(short, outsize);
+    w->num_samples =
+        cst_rateconv_run(filt, in, w->num_samples * w->num_channels,
+                         w->samples, outsize, 1) / w->num_channels;
     w->sample_rate = sample_rate;
 
-    outptr = w->samples;
-    outsize = w->num_samples;
-
-    while ((n = cst_rateconv_in(filt, inptr, insize)) > 0)
-    {
-        inptr += n;
-        insize -= n;
-
-        while ((n = cst_rateconv_out(filt, outptr, outsize)) > 0)
-        {
-            outptr += n;
-            outsize -= n;
-        }
-    }
-    cst_rateconv_leadout(filt);
-    while ((n = cst_rateconv_out(filt, outptr, outsize)) > 0)
-    {
-        outptr += n;
-        outsize -= n;
-    }
-
     cst_free(in);
     delete_rateconv(filt);
 
@@ -89,20 +89,22 @@ unsigned char cst_short_to_ulaw(short sample)
         7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
         7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7
     };
-    int sign, exponent, mantissa;
+    int sign, exponent, mantissa, mag;
     unsigned char ulawbyte;
 
-    /* Get the sample into sign-magnitude. */
-    sign = (sample >> 8) & 0x80;        /* set aside the sign */
+    /* Get the sample into sign-magnitude, in an int as -32768 has */
+    /* no short magnitude                                          */
+    mag = sample;
+    sign = (mag >> 8) & 0x80;   /* set aside the sign */
     if (sign != 0)
-        sample = -sample;       /* get magnitude */
-    if (sample > CLIP)
-        sample = CLIP;          /* clip the magnitude */
+        mag = -mag;             /* get magnitude */
+    if (mag > CLIP)
+        mag = CLIP;             /* clip the magnitude */
 
     /* Convert from 16 bit linear to ulaw. */
-    sample = sample + BIAS;
-    exponent = exp_lut[(sample >> 7) & 0xFF];
-    mantissa = (sample >> (exponent + 3)) & 0x0F;
+    mag = mag + BIAS;
+    exponent = exp_lut[(mag >> 7) & 0xFF];
+    mantissa = (mag >> (exponent + 3)) & 0x0F;
     ulawbyte = ~(sign | (exponent << 4) | mantissa);
 #ifdef ZEROTRAP
     if (ulawbyte == 0)
@@ -146,6 +148,58 @@ short cst_ulaw_to_short(unsigned char ulawbyte)
     return sample;
 }
 
+/*
+** A-law as in ITU-T G.711, after the Sun Microsystems g711.c.  The
+** even bits are inverted on the wire, hence the 0x55 masks.
+*/
+unsigned char cst_short_to_alaw(short sample)
+{
+    static const int seg_end[8] =
+        { 0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF };
+    int pcm, mask, seg;
+    unsigned char aval;
+
+    pcm = sample >> 3;
+    if (pcm >= 0)
+        mask = 0xD5;
+    else
+    {
+        mask = 0x55;
+        pcm = -pcm - 1;
+    }
+
+    for (seg = 0; seg < 8; seg++)
+        if (pcm <= seg_end[seg])
+            break;
+    if (seg >= 8)
+        return 0x7F ^ mask;
+
+    aval = seg << 4;
+    if (seg < 2)
+        aval |= (pcm >> 1) & 0x0F;
+    else
+        aval |= (pcm >> seg) & 0x0F;
+
+    return aval ^ mask;
+}
+
+short cst_alaw_to_short(unsigned char alawbyte)
+{
+    int t, seg;
+
+    alawbyte ^= 0x55;
+    t = (alawbyte & 0x0F) << 4;
+    seg = (alawbyte & 0x70) >> 4;
+    if (seg == 0)
+        t += 8;
+    else if (seg == 1)
+        t += 0x108;
+    else
+        t = (t + 0x108) << (seg - 1);
+
+    return (alawbyte & 0x80) ? t : -t;
+}
+
 
 unsigned char *cst_g721_decode(int *actual_size, int size,
                                const unsigned char *packed_residual)
@@ -0,0 +1,242 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*    Incremental wave file writer: keeps the file open across           */
+/*    utterances and patches the riff header once at close               */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  cst_wave_append_riff() reopens the file, reads the header, seeks     */
+/*  and rewrites the sizes for every utterance, which adds up over a     */
+/*  book.  The writer writes a header once with zero sizes, buffers the  */
+/*  samples in large blocks and fixes the header when it is closed.      */
+/*  Samples go through a cst_wave_encoder so the file can be converted   */
+/*  to a fixed rate and to mu-law or A-law on the way out.               */
+/*                                                                       */
+/*************************************************************************/
+
+#include "cst_alloc.h"
+#include "cst_error.h"
+#include "cst_string.h"
+#include "cst_file.h"
+#include "cst_wave.h"
+
+#define RIFF_HEADER_SIZE 44
+
+static void put_le16(unsigned char *p, int v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+}
+
+static void put_le32(unsigned char *p, long v)
+{
+    p[0] = v & 0xff;
+    p[1] = (v >> 8) & 0xff;
+    p[2] = (v >> 16) & 0xff;
+    p[3] = (v >> 24) & 0xff;
+}
+
+static int write_riff_header(cst_wave_writer *ww)
+{
+    unsigned char h[RIFF_HEADER_SIZE];
+    int format, bps;
+    long data_bytes;
+
+    switch (ww->enc->encoding)
+    {
+    case CST_WAVE_ENC_ULAW:
+        format = RIFF_FORMAT_MULAW;
+        bps = 1;
+        break;
+    case CST_WAVE_ENC_ALAW:
+        format = RIFF_FORMAT_ALAW;
+        bps = 1;
+        break;
+    default:
+        format = RIFF_FORMAT_PCM;
+        bps = 2;
+        break;
+    }
+    /* The size fields are 32 bit, past that the file is still playable */
+    data_bytes = ww->data_bytes;
+    if (data_bytes > 0x7fffffffL - RIFF_HEADER_SIZE)
+        data_bytes = 0x7fffffffL - RIFF_HEADER_SIZE;
+
+    memmove(h, "RIFF", 4);
+    put_le32(h + 4, data_bytes + RIFF_HEADER_SIZE - 8);
+    memmove(h + 8, "WAVEfmt ", 8);
+    put_le32(h + 16, 16);
+    put_le16(h + 20, format);
+    put_le16(h + 22, 1);        /* channels */
+    put_le32(h + 24, ww->sample_rate);
+    put_le32(h + 28, (long) ww->sample_rate * bps);
+    put_le16(h + 32, bps);      /* block align */
+    put_le16(h + 34, bps * 8);
+    memmove(h + 36, "data", 4);
+    put_le32(h + 40, data_bytes);
+
+    if (cst_fwrite(ww->fd, h, 1, RIFF_HEADER_SIZE) != RIFF_HEADER_SIZE)
+        return -1;
+    return 0;
+}
+
+static int writer_flush(cst_wave_writer *ww)
+{
+    if (ww->fill > 0 && cst_fwrite(ww->fd, ww->buff, 1, ww->fill) != ww->fill)
+    {
+        ww->fill = 0;
+        return -1;
+    }
+    ww->fill = 0;
+    return 0;
+}
+
+static int writer_put(cst_wave_encoder *enc, const unsigned char *bytes,
+                      int num_bytes)
+{
+    cst_wave_writer *ww = (cst_wave_writer *) enc->userdata;
+
+    ww->data_bytes += num_bytes;
+    if (ww->fill + num_bytes > ww->buff_size)
+    {
+        if (writer_flush(ww) != 0)
+            return -1;
+        /* Big enough to not be worth copying */
+        if (num_bytes >= ww->buff_size)
+            return cst_fwrite(ww->fd, bytes, 1, num_bytes) == num_bytes ?
+                0 : -1;
+    }
+    memmove(ww->buff + ww->fill, bytes, num_bytes);
+    ww->fill += num_bytes;
+    return 0;
+}
+
+cst_wave_writer *cst_wave_writer_open(const char *filename, int encoding,
+                                      int sample_rate, int riff)
+{
+    cst_wave_writer *ww;
+
+    if (riff && encoding == CST_WAVE_ENC_G721)
+    {
+        cst_errmsg("cst_wave_writer_open: no riff format for g721\n");
+        return NULL;
+    }
+
+    ww = cst_alloc(cst_wave_writer, 1);
+    ww->enc = new_wave_encoder(encoding, sample_rate, writer_put, ww);
+    if (ww->enc == NULL)
+    {
+        cst_free(ww);
+        return NULL;
+    }
+    if ((ww->fd = cst_fopen(filename, CST_OPEN_WRITE | CST_OPEN_BINARY))
+        == NULL)
+    {
+        cst_errmsg("cst_wave_writer_open: can't open file \"%s\"\n",
+                   filename);
+        delete_wave_encoder(ww->enc);
+        cst_free(ww);
+        return NULL;
+    }
+    ww->riff = riff;
+    ww->sample_rate = sample_rate;
+    ww->buff_size = CST_WAVE_WRITER_BUFFSIZE;
+    ww->buff = cst_alloc(unsigned char, ww->buff_size);
+
+    /* Placeholder, the sizes (and maybe the rate) are filled in at close */
+    if (riff && write_riff_header(ww) != 0)
+    {
+        cst_wave_writer_close(ww);
+        return NULL;
+    }
+
+    return ww;
+}
+
+int cst_wave_writer_write(cst_wave_writer *ww, const short *samples,
+                          int num_samples, int sample_rate)
+{
+    if (ww->sample_rate == 0)
+    {
+        /* The first write fixes the file's rate, anything after that */
+        /* at another rate is converted to it                         */
+        ww->sample_rate = sample_rate;
+        ww->enc->out_rate = sample_rate;
+    }
+    return cst_wave_encoder_write(ww->enc, samples, num_samples,
+                                  sample_rate, 0);
+}
+
+int cst_wave_writer_write_wave(cst_wave_writer *ww, const cst_wave *w)
+{
+    if (w->num_channels != 1)
+    {
+        cst_errmsg("cst_wave_writer_write_wave: only mono waves\n");
+        return -1;
+    }
+    return cst_wave_writer_write(ww, w->samples, w->num_samples,
+                                 w->sample_rate);
+}
+
+int cst_wave_writer_close(cst_wave_writer *ww)
+{
+    short none = 0;
+    int rv = 0;
+
+    if (ww == NULL)
+        return 0;
+
+    /* Resampler tail and any odd G.721 code */
+    if (ww->enc->in_rate > 0)
+        rv = cst_wave_encoder_write(ww->enc, &none, 0, ww->enc->in_rate, 1);
+    if (writer_flush(ww) != 0)
+        rv = -1;
+    if (ww->riff)
+    {
+        if (ww->sample_rate == 0)
+            ww->sample_rate = 16000;    /* nothing written, as before */
+        cst_fseek(ww->fd, 0, CST_SEEK_ABSOLUTE);
+        if (write_riff_header(ww) != 0)
+            rv = -1;
+    }
+    if (cst_fclose(ww->fd) != 0)
+        rv = -1;
+
+    delete_wave_encoder(ww->enc);
+    cst_free(ww->buff);
+    cst_free(ww);
+
+    return rv;
+}
@@ -2,6 +2,11 @@
    Huggins-Daines <dhd@cepstral.com> in December 2001 for use in the
    Mimic speech synthesis systems. */
 
+/* Modified again by the mimic developers (2026): 16 bit filter banks
+   shared between converters of the same ratio, exact rational ratios
+   from the sample rates, SSE2 inner products, larger blocks and a
+   proper flush of the final partial block. */
+
 /*
  *
  *	RATECONV.C
@@ -155,15 +160,30 @@
 #include "cst_error.h"
 #include "cst_wave.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
 /*
  *	adaptable defines and globals
  */
 
 #define DPRINTF(l, x)
 
-#define FIXSHIFT 16
+/* Coefficients are 16 bit so the FIR sums fit pairwise multiply-adds */
+#define FIXSHIFT 15
 #define FIXMUL (1<<FIXSHIFT)
 
+/* Input samples (per channel) filtered per block */
+#define RATECONV_BLOCK 1024
+
+/* Beyond this many phases the filter bank gets too big, so odd ratios */
+/* are approximated in kHz like we used to                             */
+#define RATECONV_MAX_UP 1024
+
 #ifndef M_PI
 #define M_PI 3.1415926535
 #endif
@@ -174,64 +194,38 @@
  *	FIR-routines, mono and stereo
  *	this is where we need all the MIPS
  */
-static void fir_mono(int *inp, int *coep, int firlen, int *outp)
+static int fir_mono(const short *inp, const short *coep, int firlen)
 {
-    register int akku = 0, *endp;
-    int n1 = (firlen / 8) * 8, n0 = firlen % 8;
-
-    endp = coep + n1;
-    while (coep != endp)
-    {
-        akku += *inp++ * *coep++;
-        akku += *inp++ * *coep++;
-        akku += *inp++ * *coep++;
-        akku += *inp++ * *coep++;
-        akku += *inp++ * *coep++;
-        akku += *inp++ * *coep++;
-        akku += *inp++ * *coep++;
-        akku += *inp++ * *coep++;
-    }
+    int akku = 0, i = 0;
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+
+    for (; i + 8 <= firlen; i += 8)
+        acc = _mm_add_epi32(acc,
+                            _mm_madd_epi16(_mm_loadu_si128((const __m128i *)
+                                                           (inp + i)),
+                                           _mm_loadu_si128((const __m128i *)
+                                                           (coep + i))));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    akku = _mm_cvtsi128_si32(acc);
+#endif
+    for (; i < firlen; i++)
+        akku += inp[i] * coep[i];
 
-    endp = coep + n0;
-    while (coep != endp)
-    {
-        akku += *inp++ * *coep++;
-    }
-    *outp = akku;
+    return akku;
 }
 
 static void
-fir_stereo(int *inp, int *coep, int firlen, int *out1p, int *out2p)
+fir_stereo(const short *inp, const short *coep, int firlen,
+           int *out1p, int *out2p)
 {
-    register int akku1 = 0, akku2 = 0, *endp;
-    int n1 = (firlen / 8) * 8, n0 = firlen % 8;
+    int akku1 = 0, akku2 = 0, i;
 
-    endp = coep + n1;
-    while (coep != endp)
+    for (i = 0; i < firlen; i++)
     {
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
-    }
-
-    endp = coep + n0;
-    while (coep != endp)
-    {
-        akku1 += *inp++ * *coep;
-        akku2 += *inp++ * *coep++;
+        akku1 += inp[2 * i] * coep[i];
+        akku2 += inp[2 * i + 1] * coep[i];
     }
     *out1p = akku1;
     *out2p = akku2;
@@ -240,135 +234,72 @@ fir_stereo(int *inp, int *coep, int firlen, int *out1p, int *out2p)
 /*
  * 	filtering from input buffer to output buffer;
  *	returns number of processed samples in output buffer:
- *	if it is not equal to output buffer size,
- *	the input buffer is expected to be refilled upon entry, so that
- *	the last firlen numbers of the old input buffer are
- *	the first firlen numbers of the new input buffer;
+ *	if it is not equal to output buffer size, the input buffer is
+ *	exhausted and expected to be refilled upon entry, so that
+ *	the last lag numbers of the old input buffer are
+ *	the first lag numbers of the new input buffer;
  *	if it is equal to output buffer size, the output buffer
  *	is full and is expected to be stowed away;
  *
  */
 static int filtering_on_buffers(cst_rateconv *filt)
 {
-    int insize;
+    int insize, n, o1, o2;
+    int channels = filt->channels;
 
     DPRINTF(0, ("filtering_on_buffers(%d)\n", filt->incount));
     insize = filt->incount + filt->lag;
-    if (filt->channels == 1)
+    while (1)
     {
-        while (1)
+        /* firlen, up, down and cycctr relate to samples in general,  */
+        /* whether mono or stereo; inbaseidx, inoffset and outidx as  */
+        /* well as insize and outsize account for interleaved samples */
+        filt->inoffset = channels * ((filt->cycctr * filt->down) / filt->up);
+        if ((filt->inbaseidx + filt->inoffset + channels * filt->len) >
+            insize)
         {
-            filt->inoffset = (filt->cycctr * filt->down) / filt->up;
-            if ((filt->inbaseidx + filt->inoffset + filt->len) > insize)
-            {
-                filt->inbaseidx -= insize - filt->len + 1;
-                memcpy(filt->sin, filt->sin + insize - filt->lag,
-                       filt->lag * sizeof(int));
-                /* Prevent people from re-filtering the same stuff. */
-                filt->incount = 0;
-                return 0;
-            }
-            fir_mono(filt->sin + filt->inoffset + filt->inbaseidx,
-                     filt->coep + filt->cycctr * filt->len,
-                     filt->len, filt->sout + filt->outidx);
-            DPRINTF(1, ("in(%d + %d) = %d cycctr %d out(%d) = %d\n",
-                        filt->inoffset, filt->inbaseidx,
-                        filt->sin[filt->inoffset + filt->inbaseidx],
-                        filt->cycctr, filt->outidx,
-                        filt->sout[filt->outidx] >> FIXSHIFT));
-            ++filt->outidx;
-            ++filt->cycctr;
-            if (!(filt->cycctr %= filt->up))
-                filt->inbaseidx += filt->down;
-            if (!(filt->outidx %= filt->outsize))
-                return filt->outsize;
+            filt->inbaseidx -= insize - filt->lag;
+            memmove(filt->sin, filt->sin + insize - filt->lag,
+                    filt->lag * sizeof(short));
+            /* Prevent people from re-filtering the same stuff. */
+            filt->incount = 0;
+            /* hand back what we have so far */
+            n = filt->outidx;
+            filt->outidx = 0;
+            return n;
         }
-    }
-    else if (filt->channels == 2)
-    {
-        /*
-         * rule how to convert mono routine to stereo routine:
-         * firlen, up, down and cycctr relate to samples in general,
-         * wether mono or stereo; inbaseidx, inoffset and outidx as
-         * well as insize and outsize still account for mono samples.
-         */
-        while (1)
+        if (channels == 1)
+            filt->sout[filt->outidx] =
+                fir_mono(filt->sin + filt->inoffset + filt->inbaseidx,
+                         filt->coep + filt->cycctr * filt->len,
+                         filt->len) >> FIXSHIFT;
+        else
         {
-            filt->inoffset = 2 * ((filt->cycctr * filt->down) / filt->up);
-            if ((filt->inbaseidx + filt->inoffset + 2 * filt->len) > insize)
-            {
-                filt->inbaseidx -= insize - 2 * filt->len + 2;
-                return filt->outidx;
-            }
             fir_stereo(filt->sin + filt->inoffset + filt->inbaseidx,
                        filt->coep + filt->cycctr * filt->len,
-                       filt->len,
-                       filt->sout + filt->outidx,
-                       filt->sout + filt->outidx + 1);
-            filt->outidx += 2;
-            ++filt->cycctr;
-            if (!(filt->cycctr %= filt->up))
-                filt->inbaseidx += 2 * filt->down;
-            if (!(filt->outidx %= filt->outsize))
-                return filt->outsize;
+                       filt->len, &o1, &o2);
+            filt->sout[filt->outidx] = o1 >> FIXSHIFT;
+            filt->sout[filt->outidx + 1] = o2 >> FIXSHIFT;
         }
-    }
-    else
-    {
-        cst_errmsg("filtering_on_buffers: only 1 or 2 channels supported!\n");
-        cst_error();
+        filt->outidx += channels;
+        ++filt->cycctr;
+        if (!(filt->cycctr %= filt->up))
+            filt->inbaseidx += channels * filt->down;
+        if (!(filt->outidx %= filt->outsize))
+            return filt->outsize;
     }
     return 0;
 }
 
 /*
- *	convert buffer of n samples to ints
- */
-static void sample_to_int(short *buff, int n)
-{
-    short *s, *e;
-    int *d;
-
-    if (n < 1)
-        return;
-    s = buff + n;
-    d = (int *) buff + n;
-    e = buff;
-    while (s != e)
-    {
-        *--d = (int) (*--s);
-    }
-}
-
-/*
- *	convert buffer of n ints to samples
- */
-static void int_to_sample(short *buff, int n)
-{
-    int *s;
-    short *e, *d;
-
-    if (n < 1)
-        return;
-    s = (int *) buff;
-    d = buff;
-    e = buff + n;
-    while (d != e)
-        *d++ = (*s++ >> FIXSHIFT);
-}
-
-/*
- *	read and convert input sample format to integer
+ *	read input samples
  */
 int cst_rateconv_in(cst_rateconv *filt, const short *inptr, int max)
 {
     if (max > filt->insize - filt->lag)
         max = filt->insize - filt->lag;
     if (max > 0)
-    {
-        memcpy(filt->sin + filt->lag, inptr, max * sizeof(short));
-        sample_to_int((short *) (filt->sin + filt->lag), max);
-    }
+        memmove(filt->sin + filt->lag, inptr, max * sizeof(short));
     filt->incount = max;
     return max;
 }
@@ -384,18 +315,50 @@ int cst_rateconv_out(cst_rateconv *filt, short *outptr, int max)
         return 0;
     if (max > outsize)
         max = outsize;
-    int_to_sample((short *) filt->sout, max);
-    memcpy(outptr, filt->sout, max * sizeof(short));
+    memmove(outptr, filt->sout, max * sizeof(short));
     return max;
 }
 
 int cst_rateconv_leadout(cst_rateconv *filt)
 {
-    memset(filt->sin + filt->lag, 0, filt->lag * sizeof(int));
+    memset(filt->sin + filt->lag, 0, filt->lag * sizeof(short));
     filt->incount = filt->lag;
     return filt->lag;
 }
 
+int cst_rateconv_max_out(const cst_rateconv *filt, int insize)
+{
+    /* An upper bound on what cst_rateconv_run() can write for insize */
+    /* input samples, including the lead out                           */
+    return (int) (((long long) insize + filt->lag) * filt->up / filt->down)
+        + 2 * filt->outsize + filt->channels;
+}
+
+int cst_rateconv_run(cst_rateconv *filt, const short *in, int insize,
+                     short *out, int outsize, int last)
+{
+    /* Streams all of in through the converter, writes at most outsize */
+    /* samples into out and returns the number written.  last adds the */
+    /* lead out so the tail of the signal comes through                */
+    int n, total = 0;
+
+    while ((n = cst_rateconv_in(filt, in, insize)) > 0)
+    {
+        in += n;
+        insize -= n;
+        while ((n = cst_rateconv_out(filt, out + total, outsize - total)) > 0)
+            total += n;
+    }
+    if (last)
+    {
+        cst_rateconv_leadout(filt);
+        while ((n = cst_rateconv_out(filt, out + total, outsize - total)) > 0)
+            total += n;
+    }
+
+    return total;
+}
+
 /*
  *	evaluate sinc(x) = sin(x)/x safely
  */
@@ -418,34 +381,93 @@ static double interpol_func(double t, double fgk, double fgg)
  *	evaluate coefficient from i, q=n%u by sampling interpolation function 
  *	and scale it for integer multiplication used by FIR-filtering
  */
-static int coefficient(int i, int q, cst_rateconv *filt)
+static short coefficient(int i, int q, cst_rateconv *filt)
 {
-    return (int) (FIXMUL * filt->gain *
-                  interpol_func((fmod(q * filt->down / (double) filt->up, 1.0)
-                                 + (filt->len - 1) / 2.0 - i) / filt->fsin,
-                                filt->fgk, filt->fgg) / filt->fsin);
+    return (short) (FIXMUL * filt->gain *
+                    interpol_func((fmod(q * filt->down / (double) filt->up,
+                                        1.0)
+                                   + (filt->len - 1) / 2.0 - i) / filt->fsin,
+                                  filt->fgk, filt->fgg) / filt->fsin);
 }
 
+/*
+ *	filter banks only depend on the ratio so they are built once
+ *	and shared by all converters with the same up/down
+ */
+typedef struct rateconv_bank_struct {
+    int up, down, len;
+    short *coep;
+    struct rateconv_bank_struct *next;
+} rateconv_bank;
+
+static rateconv_bank *rateconv_banks = NULL;
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t rateconv_banks_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 /*
  *	set up coefficient array
  */
 static void make_coe(cst_rateconv *filt)
 {
+    rateconv_bank *b;
+    short *coep;
     int i, q;
 
-    filt->coep = cst_alloc(int, filt->len * filt->up);
-    for (i = 0; i < filt->len; i++)
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&rateconv_banks_lock);
+#endif
+    for (b = rateconv_banks; b; b = b->next)
+        if ((b->up == filt->up) && (b->down == filt->down) &&
+            (b->len == filt->len))
+            break;
+    if (b == NULL)
     {
-        for (q = 0; q < filt->up; q++)
+        coep = cst_alloc(short, filt->len * filt->up);
+        for (i = 0; i < filt->len; i++)
         {
-            filt->coep[q * filt->len + i] = coefficient(i, q, filt);
+            for (q = 0; q < filt->up; q++)
+            {
+                coep[q * filt->len + i] = coefficient(i, q, filt);
+            }
         }
+        b = cst_alloc(rateconv_bank, 1);
+        b->up = filt->up;
+        b->down = filt->down;
+        b->len = filt->len;
+        b->coep = coep;
+        b->next = rateconv_banks;
+        rateconv_banks = b;
+    }
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&rateconv_banks_lock);
+#endif
+    filt->coep = b->coep;
+}
+
+void cst_rateconv_free_banks(void)
+{
+    rateconv_bank *b, *nb;
+
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&rateconv_banks_lock);
+#endif
+    for (b = rateconv_banks; b; b = nb)
+    {
+        nb = b->next;
+        cst_free(b->coep);
+        cst_free(b);
     }
+    rateconv_banks = NULL;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&rateconv_banks_lock);
+#endif
 }
 
 cst_rateconv *new_rateconv(int up, int down, int channels)
 {
     cst_rateconv *filt;
+    int block;
 
     if (!(channels == 1 || channels == 2))
     {
@@ -471,18 +493,64 @@ cst_rateconv *new_rateconv(int up, int down, int channels)
     }
 
     make_coe(filt);
+    block = (filt->len > RATECONV_BLOCK) ? filt->len : RATECONV_BLOCK;
     filt->lag = (filt->len - 1) * channels;
-    filt->insize = channels * filt->len + filt->lag;
-    filt->outsize = channels * filt->len;
-    filt->sin = cst_alloc(int, filt->insize);
-    filt->sout = cst_alloc(int, filt->outsize);
+    filt->insize = channels * block + filt->lag;
+    filt->outsize = channels * block;
+    filt->sin = cst_alloc(short, filt->insize);
+    filt->sout = cst_alloc(short, filt->outsize);
 
     return filt;
 }
 
+static int rateconv_gcd(int a, int b)
+{
+    int t;
+
+    while (b)
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+cst_rateconv *new_rateconv_rates(int in_rate, int out_rate, int channels)
+{
+    int g, up, down;
+
+    if ((in_rate < 1) || (out_rate < 1))
+    {
+        cst_errmsg("new_rateconv_rates: invalid sample rates (%d, %d)\n",
+                   in_rate, out_rate);
+        return NULL;
+    }
+
+    g = rateconv_gcd(in_rate, out_rate);
+    up = out_rate / g;
+    down = in_rate / g;
+    if (up > RATECONV_MAX_UP)
+    {
+        up = (out_rate + 500) / 1000;
+        down = (in_rate + 500) / 1000;
+        if (up < 1 || down < 1)
+        {
+            cst_errmsg("new_rateconv_rates: can't convert %d to %d\n",
+                       in_rate, out_rate);
+            return NULL;
+        }
+        g = rateconv_gcd(up, down);
+        up /= g;
+        down /= g;
+    }
+
+    return new_rateconv(up, down, channels);
+}
+
 void delete_rateconv(cst_rateconv *filt)
 {
-    cst_free(filt->coep);
+    /* the filter bank is shared and stays cached */
     cst_free(filt->sin);
     cst_free(filt->sout);
     cst_free(filt);
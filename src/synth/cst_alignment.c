@@ -0,0 +1,299 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*  Phone timing without audio, one record per input line                */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  For lip sync and the like only the phones and their times are       */
+/*  wanted.  mimic_text_to_alignment() runs the front end and the       */
+/*  voice's duration model (its alignment_func for clustergen and HTS   */
+/*  voices) and never predicts parameters or makes audio.               */
+/*                                                                       */
+/*  Each non empty line of an input file is one utterance.  Records     */
+/*  are JSON, one object per line:                                       */
+/*                                                                       */
+/*     {"line":3,"phones":[["pau",0.000,0.150],["hh",0.150,0.212],...]}  */
+/*                                                                       */
+/*  or binary, after a "MALN" and version (1) header, all little endian: */
+/*                                                                       */
+/*     uint32 line, uint32 num_phones,                                   */
+/*     num_phones * (uint8 name length, name, uint32 end in us)          */
+/*                                                                       */
+/*  Phones start where the one before ends.  Batches of files are split  */
+/*  over threads, one file at a time each.                               */
+/*                                                                       */
+/*************************************************************************/
+
+#include <string.h>
+#include "mimic.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+int mimic_alignment_format(const char *name)
+{
+    if (cst_streq(name, "json"))
+        return MIMIC_ALIGN_JSON;
+    else if (cst_streq(name, "bin") || cst_streq(name, "binary"))
+        return MIMIC_ALIGN_BINARY;
+    return -1;
+}
+
+static int align_write_u32(cst_file fd, unsigned int v)
+{
+    unsigned char b[4];
+
+    b[0] = v & 0xff;
+    b[1] = (v >> 8) & 0xff;
+    b[2] = (v >> 16) & 0xff;
+    b[3] = (v >> 24) & 0xff;
+    return (cst_fwrite(fd, b, 1, 4) == 4) ? 0 : -1;
+}
+
+int mimic_alignment_write_header(cst_file fd, int format)
+{
+    if (format != MIMIC_ALIGN_BINARY)
+        return 0;
+    if (cst_fwrite(fd, "MALN", 1, 4) != 4)
+        return -1;
+    return align_write_u32(fd, 1);
+}
+
+static int align_write_json(cst_file fd, const cst_utterance *u, int line)
+{
+    const cst_item *s;
+    const char *name, *p;
+    float start = 0.0, end;
+
+    cst_fprintf(fd, "{\"line\":%d,\"phones\":[", line);
+    for (s = relation_head(utt_relation(u, "Segment")); s; s = item_next(s))
+    {
+        name = item_feat_string(s, "name");
+        end = ffeature_float(s, "end");
+        cst_fprintf(fd, "%s[\"", item_prev(s) ? "," : "");
+        for (p = name; *p; p++)
+            cst_fprintf(fd, (*p == '"' || *p == '\\') ? "\\%c" : "%c", *p);
+        cst_fprintf(fd, "\",%.3f,%.3f]", start, end);
+        start = end;
+    }
+    return (cst_fprintf(fd, "]}\n") < 0) ? -1 : 0;
+}
+
+static int align_write_binary(cst_file fd, const cst_utterance *u, int line)
+{
+    const cst_item *s;
+    const char *name;
+    unsigned char len;
+    float end;
+    int n;
+
+    for (n = 0, s = relation_head(utt_relation(u, "Segment")); s;
+         s = item_next(s))
+        n++;
+    if (align_write_u32(fd, line) < 0 || align_write_u32(fd, n) < 0)
+        return -1;
+    for (s = relation_head(utt_relation(u, "Segment")); s; s = item_next(s))
+    {
+        name = item_feat_string(s, "name");
+        len = (cst_strlen(name) > 255) ? 255 : cst_strlen(name);
+        end = ffeature_float(s, "end");
+        if (cst_fwrite(fd, &len, 1, 1) != 1 ||
+            cst_fwrite(fd, name, 1, len) != len ||
+            align_write_u32(fd, (end > 0.0) ? (unsigned int)
+                            ((end * 1000000.0) + 0.5) : 0) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+int mimic_alignment_write(cst_file fd, const cst_utterance *u, int format,
+                          int line)
+{
+    if (format == MIMIC_ALIGN_BINARY)
+        return align_write_binary(fd, u, line);
+    return align_write_json(fd, u, line);
+}
+
+cst_utterance *mimic_text_to_alignment(const char *text, cst_voice *voice)
+{
+    cst_utterance *u;
+
+    u = new_utterance();
+    utt_set_input_text(u, text);
+    return mimic_do_synth(u, voice, utt_synth_alignment);
+}
+
+int mimic_file_to_alignments(const char *filename, cst_voice *voice,
+                             const char *outfile, int format)
+{
+    cst_filemap *fmap;
+    cst_file fd;
+    cst_utterance *u;
+    char *text, *line, *eol;
+    int n, err = 0;
+
+    if ((fmap = cst_read_whole_file(filename)) == NULL)
+    {
+        cst_errmsg("failed to open file \"%s\" for reading\n", filename);
+        return -1;
+    }
+    if ((fd = cst_fopen(outfile, CST_OPEN_WRITE | CST_OPEN_BINARY)) == NULL)
+    {
+        cst_errmsg("failed to open file \"%s\" for writing\n", outfile);
+        cst_free_whole_file(fmap);
+        return -1;
+    }
+    err = mimic_alignment_write_header(fd, format);
+
+    /* A copy so lines can be terminated in place */
+    text = cst_alloc(char, fmap->mapsize + 1);
+    memmove(text, fmap->mem, fmap->mapsize);
+    cst_free_whole_file(fmap);
+
+    for (n = 1, line = text; err == 0 && *line; n++, line = eol)
+    {
+        for (eol = line; *eol && *eol != '\n'; eol++);
+        if (*eol)
+            *eol++ = '\0';
+        if (line[strspn(line, " \t\r")] == '\0')
+            continue;
+        if ((u = mimic_text_to_alignment(line, voice)) == NULL)
+        {
+            cst_errmsg("%s:%d: alignment failed\n", filename, n);
+            err = -1;
+            break;
+        }
+        err = mimic_alignment_write(fd, u, format, n);
+        delete_utterance(u);
+    }
+
+    cst_free(text);
+    if (cst_fclose(fd) != 0)
+        err = -1;
+    return err;
+}
+
+/* Files are handed out one at a time to whichever thread is free */
+typedef struct align_batch_struct {
+    const char *const *filenames;
+    int num_files;
+    int next;
+    cst_voice *voice;
+    int format;
+    int errors;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_t lock;
+#endif
+} align_batch;
+
+static void *align_worker(void *arg)
+{
+    align_batch *b = (align_batch *) arg;
+    const char *filename;
+    char *outfile;
+    int i, err;
+
+    while (1)
+    {
+#ifdef HAVE_PTHREAD_H
+        pthread_mutex_lock(&b->lock);
+#endif
+        i = b->next++;
+#ifdef HAVE_PTHREAD_H
+        pthread_mutex_unlock(&b->lock);
+#endif
+        if (i >= b->num_files)
+            break;
+
+        filename = b->filenames[i];
+        outfile = cst_alloc(char, cst_strlen(filename) + 16);
+        cst_sprintf(outfile, "%s%s", filename,
+                    (b->format == MIMIC_ALIGN_BINARY) ? ".align" :
+                    ".align.json");
+        err = mimic_file_to_alignments(filename, b->voice, outfile,
+                                       b->format);
+        cst_free(outfile);
+
+        if (err != 0)
+        {
+#ifdef HAVE_PTHREAD_H
+            pthread_mutex_lock(&b->lock);
+#endif
+            b->errors++;
+#ifdef HAVE_PTHREAD_H
+            pthread_mutex_unlock(&b->lock);
+#endif
+        }
+    }
+
+    return NULL;
+}
+
+int mimic_files_to_alignments(const char *const *filenames, int num_files,
+                              cst_voice *voice, int format, int num_threads)
+{
+    align_batch b;
+#ifdef HAVE_PTHREAD_H
+    pthread_t *threads;
+    int i, started;
+#endif
+
+    memset(&b, 0, sizeof(b));
+    b.filenames = filenames;
+    b.num_files = num_files;
+    b.voice = voice;
+    b.format = format;
+
+    if (num_threads > num_files)
+        num_threads = num_files;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_init(&b.lock, NULL);
+    threads = cst_alloc(pthread_t, (num_threads > 1) ? num_threads : 1);
+    for (started = 0; started < num_threads - 1; started++)
+        if (pthread_create(&threads[started], NULL, align_worker, &b) != 0)
+            break;
+    align_worker(&b);           /* this thread works too */
+    for (i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+    cst_free(threads);
+    pthread_mutex_destroy(&b.lock);
+#else
+    (void) num_threads;
+    align_worker(&b);
+#endif
+
+    return b.errors;
+}
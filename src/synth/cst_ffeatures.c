@@ -147,14 +147,42 @@ const cst_val *ph_cvox(const cst_item *p)
     return phone_feature(item_phoneset(p), item_name(p), "cvox");
 }
 
+#define CG_FRAME_SHIFT 0.005
+
+/* With the phrase cache, states and segments end on whole frames and */
+/* carry end_frame.  Times are then worked out from frame differences */
+/* so a phrase gets the same values wherever it is in the utterance,  */
+/* rather than whatever float rounding gives at that time             */
+static int cg_whole_frames(const cst_item *p)
+{
+    return p && item_feat_present(p, "end_frame");
+}
+
+/* The frame a state's phrase starts at, 0 outside phrases */
+static int cg_phrase_start_frame(const cst_item *p)
+{
+    return ffeature_int(p,
+                        "R:segstate.parent.R:SylStructure.parent.parent.R:Phrase.parent.daughter1.R:SylStructure.daughter1.daughter1.R:Segment.p.end_frame");
+}
+
 const cst_val *cg_duration(const cst_item *p)
 {
     /* Note this constructs float vals, these will be freed when the */
     /* cart cache is freed, so this should only be used in carts     */
     if (!p)
         return float_val(0.0);
+    else if (!item_prev(p) && cg_whole_frames(p))
+        /* Without a previous state this is the time since the start, */
+        /* which for the phrase cache has to be the phrase's start    */
+        return float_val(CG_FRAME_SHIFT *
+                         (item_feat_int(p, "end_frame") -
+                          cg_phrase_start_frame(p)));
     else if (!item_prev(p))
         return item_feat(p, "end");
+    else if (cg_whole_frames(p))
+        return float_val(CG_FRAME_SHIFT *
+                         (item_feat_int(p, "end_frame") -
+                          item_feat_int(item_prev(p), "end_frame")));
     else
         return float_val(item_feat_float(p, "end")
                          - item_feat_float(item_prev(p), "end"));
@@ -164,13 +192,35 @@ DEF_STATIC_CONST_VAL_STRING(val_string_pos_b, "b");
 DEF_STATIC_CONST_VAL_STRING(val_string_pos_m, "m");
 DEF_STATIC_CONST_VAL_STRING(val_string_pos_e, "e");
 
+/* Name of the frame before (dir < 0) or after frame p.  Frames are */
+/* not always items of their own, so this goes by the first_frame   */
+/* and last_frame of the states in mcep_link.                        */
+static const char *cg_frame_name(const cst_item *p, int dir)
+{
+    const cst_item *state;
+    int this;
+
+    state = item_parent(item_as(p, "mcep_link"));
+    if (state == NULL)
+        return ffeature_string(p, (dir < 0) ? "p.name" : "n.name");
+    this = item_feat_int(p, "frame_number");
+    if ((dir < 0) ? (this > item_feat_int(state, "first_frame")) :
+        (this < item_feat_int(state, "last_frame")))
+        return item_feat_string(state, "name");
+    do
+        state = (dir < 0) ? item_prev(state) : item_next(state);
+    while (state && !item_feat_present(state, "first_frame"));
+
+    return state ? item_feat_string(state, "name") : "0";
+}
+
 const cst_val *cg_state_pos(const cst_item *p)
 {
     const char *name;
     name = item_feat_string(p, "name");
-    if (!cst_streq(name, ffeature_string(p, "p.name")))
+    if (!cst_streq(name, cg_frame_name(p, -1)))
         return (cst_val *) &val_string_pos_b;
-    if (cst_streq(name, ffeature_string(p, "n.name")))
+    if (cst_streq(name, cg_frame_name(p, 1)))
         return (cst_val *) &val_string_pos_m;
     else
         return (cst_val *) &val_string_pos_e;
@@ -181,9 +231,9 @@ const cst_val *cg_state_place(const cst_item *p)
     float start, end;
     int this;
     start =
-        (float) ffeature_int(p, "R:mcep_link.parent.daughter1.frame_number");
+        (float) ffeature_int(p, "R:mcep_link.parent.first_frame");
     end =
-        (float) ffeature_int(p, "R:mcep_link.parent.daughtern.frame_number");
+        (float) ffeature_int(p, "R:mcep_link.parent.last_frame");
     this = item_feat_int(p, "frame_number");
     if ((end - start) == 0.0)
         return float_val(0.0);
@@ -196,7 +246,7 @@ const cst_val *cg_state_index(const cst_item *p)
     float start;
     int this;
     start =
-        (float) ffeature_int(p, "R:mcep_link.parent.daughter1.frame_number");
+        (float) ffeature_int(p, "R:mcep_link.parent.first_frame");
     this = item_feat_int(p, "frame_number");
     return float_val(this - start);
 }
@@ -206,7 +256,7 @@ const cst_val *cg_state_rindex(const cst_item *p)
     float end;
     int this;
     end =
-        (float) ffeature_int(p, "R:mcep_link.parent.daughtern.frame_number");
+        (float) ffeature_int(p, "R:mcep_link.parent.last_frame");
     this = item_feat_int(p, "frame_number");
     return float_val(end - this);
 }
@@ -217,10 +267,10 @@ const cst_val *cg_phone_place(const cst_item *p)
     int this;
     start =
         (float) ffeature_int(p,
-                             "R:mcep_link.parent.R:segstate.parent.daughter1.R:mcep_link.daughter1.frame_number");
+                             "R:mcep_link.parent.R:segstate.parent.first_frame");
     end =
         (float) ffeature_int(p,
-                             "R:mcep_link.parent.R:segstate.parent.daughtern.R:mcep_link.daughtern.frame_number");
+                             "R:mcep_link.parent.R:segstate.parent.last_frame");
     this = item_feat_int(p, "frame_number");
     if ((end - start) == 0.0)
         return float_val(0.0);
@@ -234,7 +284,7 @@ const cst_val *cg_phone_index(const cst_item *p)
     int this;
     start =
         (float) ffeature_int(p,
-                             "R:mcep_link.parent.R:segstate.parent.daughter1.R:mcep_link.daughter1.frame_number");
+                             "R:mcep_link.parent.R:segstate.parent.first_frame");
     this = item_feat_int(p, "frame_number");
     return float_val(this - start);
 }
@@ -245,7 +295,7 @@ const cst_val *cg_phone_rindex(const cst_item *p)
     int this;
     end =
         (float) ffeature_int(p,
-                             "R:mcep_link.parent.R:segstate.parent.daughtern.R:mcep_link.daughtern.frame_number");
+                             "R:mcep_link.parent.R:segstate.parent.last_frame");
     this = item_feat_int(p, "frame_number");
     return float_val(end - this);
 }
@@ -273,7 +323,24 @@ const cst_val *cg_position_in_phrasep(const cst_item *p)
 {
     float pstart, pend, phrasenumber;
     float x;
-#define CG_FRAME_SHIFT 0.005
+
+    if (cg_whole_frames(path_to_item(p, "R:mcep_link.parent")))
+    {
+        pstart =
+            ffeature_int(p,
+                         "R:mcep_link.parent.R:segstate.parent.R:SylStructure.parent.parent.R:Phrase.parent.daughter1.R:SylStructure.daughter1.daughter1.R:Segment.p.end_frame");
+        pend =
+            ffeature_int(p,
+                         "R:mcep_link.parent.R:segstate.parent.R:SylStructure.parent.parent.R:Phrase.parent.daughtern.R:SylStructure.daughtern.daughtern.R:Segment.end_frame");
+        phrasenumber =
+            ffeature_float(p,
+                           "R:mcep_link.parent.R:segstate.parent.R:SylStructure.parent.parent.R:Phrase.parent.lisp_cg_find_phrase_number");
+        if (pend == pstart)
+            return float_val(-1.0);
+        return float_val(phrasenumber +
+                         (item_feat_int(p, "frame_number") - pstart) /
+                         (pend - pstart));
+    }
 
     pstart =
         ffeature_float(p,
@@ -57,32 +57,104 @@
 /*  Voice call backs (e.g. -pw and -ps) are not transfered when new      */
 /*  voices are selected                                                  */
 /*                                                                       */
+/*                                                                       */
+/*  The parser is event driven: tokens and tags are handed to the        */
+/*  handler as they are read.  Tokens go into the same synthesis         */
+/*  pipeline as plain text (so utterances are synthesized in parallel    */
+/*  with "synth_threads" set), tags change the word features, voice or   */
+/*  utterance breaks, and audio is queued in order with the speech.      */
+/*                                                                       */
 /*************************************************************************/
 
 #include "mimic.h"
 #include "cst_tokenstream.h"
 #include "errno.h"
+#include <string.h>
 
 static const char *const ssml_singlecharsymbols_general = "<>&/\";";
 static const char *const ssml_singlecharsymbols_inattr = "=>;/\"";
 
 #define SSML_DEBUG 0
 
-static const char *ts_get_quoted_remainder(cst_tokenstream *ts)
+/* A tag as the parser hands it over.  The strings live in buf, which */
+/* is kept from tag to tag, so reading a tag doesn't allocate.        */
+#define SSML_TAG_START 0
+#define SSML_TAG_END 1
+#define SSML_TAG_EMPTY 2        /* <tag ... /> */
+#define SSML_MAX_ATTRS 8
+
+typedef struct ssml_tag_struct {
+    const char *name;           /* upper case */
+    int type;
+    int num_attrs;
+    const char *attr[SSML_MAX_ATTRS];
+    const char *val[SSML_MAX_ATTRS];
+    char *buf;
+    int buf_size;
+    int fill;
+} ssml_tag;
+
+typedef struct ssml_handler_struct {
+    /* Return non-zero to stop parsing */
+    int (*token) (struct ssml_handler_struct *h, cst_tokenstream *ts,
+                  const char *token);
+    int (*tag) (struct ssml_handler_struct *h, const ssml_tag *tag);
+    void *userdata;
+} ssml_handler;
+
+static int ssml_tag_save(ssml_tag *tag, const char *s, int upcase)
 {
-    const char *q;
+    /* Copies s into buf, returns its offset as buf may move */
+    int len = cst_strlen(s) + 1;
+    int i, o;
+    char *nbuf;
+
+    if (tag->fill + len > tag->buf_size)
+    {
+        tag->buf_size = 2 * (tag->fill + len);
+        nbuf = cst_alloc(char, tag->buf_size);
+        memmove(nbuf, tag->buf, tag->fill);
+        cst_free(tag->buf);
+        tag->buf = nbuf;
+    }
+    o = tag->fill;
+    for (i = 0; i < len; i++)
+        tag->buf[o + i] = (upcase && s[i] >= 'a' && s[i] <= 'z') ?
+            s[i] - ('a' - 'A') : s[i];
+    tag->fill += len;
+
+    return o;
+}
 
-    q = ts_get_quoted_token(ts, '"', '\\');
+static const char *ssml_tag_attr(const ssml_tag *tag, const char *name,
+                                 const char *def)
+{
+    int i;
 
-    return q;
+    for (i = 0; i < tag->num_attrs; i++)
+        if (cst_streq(name, tag->attr[i]))
+            return tag->val[i];
+    return def;
 }
 
-static cst_features *ssml_get_attributes(cst_tokenstream *ts)
+static int ssml_read_tag(cst_tokenstream *ts, ssml_tag *tag)
 {
-    cst_features *a = new_features();
-    const char *name, *val;
-    const char *fnn, *vnn;
-    int i = 0;
+    /* Reads the rest of a tag after its "<", -1 at EOF */
+    int name_o, attr_o[SSML_MAX_ATTRS], val_o[SSML_MAX_ATTRS];
+    const char *token;
+    int i, a, v;
+
+    tag->type = SSML_TAG_START;
+    tag->num_attrs = 0;
+    tag->fill = 0;
+
+    token = ts_get(ts);
+    if (cst_streq("/", token))
+    {
+        tag->type = SSML_TAG_END;
+        token = ts_get(ts);
+    }
+    name_o = ssml_tag_save(tag, token, TRUE);
 
     set_charclasses(ts,
                     ts->p_whitespacesymbols,
@@ -90,49 +162,35 @@ static cst_features *ssml_get_attributes(cst_tokenstream *ts)
                     ts->p_prepunctuationsymbols,
                     ts->p_postpunctuationsymbols);
 
-    name = ts_get(ts);
-    while (!cst_streq(">", name))
+    for (token = ts_get(ts); !cst_streq(">", token);)
     {
-        /* I want names and values to be const */
-        fnn = "_name0";
-        vnn = "_val0";
-        // Tags with more than one attribute need to have additional
-        // attributes defined here.
-        if (cst_streq("volume", name))
-        {
-            fnn = "_name1";
-            vnn = "_val1";
-        }
-        else if (cst_streq("pitch", name))
+        if (ts_eof(ts))
         {
-            fnn = "_name2";
-            vnn = "_val2";
+            fprintf(stderr, "ssml: unexpected EOF\n");
+            return -1;
         }
-        else if (cst_streq("range", name))
+        if (cst_streq("/", token))
         {
-            fnn = "_name3";
-            vnn = "_val3";
+            tag->type = SSML_TAG_EMPTY;
+            token = ts_get(ts);
+            continue;
         }
-        if (cst_streq(name, "/"))
-            feat_set_string(a, "_type", "startend");
-        else
+        a = ssml_tag_save(tag, token, FALSE);
+        token = ts_get(ts);
+        if (cst_streq("=", token))
         {
-            feat_set_string(a, "_type", "start");
-            feat_set_string(a, fnn, name);
-            if (cst_streq("=", ts_get(ts)))
-            {
-                val = ts_get_quoted_remainder(ts);
-                feat_set_string(a, vnn, val);
-            }
+            v = ssml_tag_save(tag, ts_get_quoted_token(ts, '"', '\\'),
+                              FALSE);
+            token = ts_get(ts);
         }
-        if (ts_eof(ts))
+        else                    /* no value, token is whatever follows */
+            v = ssml_tag_save(tag, "", FALSE);
+        if (tag->num_attrs < SSML_MAX_ATTRS)
         {
-            fprintf(stderr, "ssml: unexpected EOF\n");
-            delete_features(a);
-            return 0;
+            attr_o[tag->num_attrs] = a;
+            val_o[tag->num_attrs] = v;
+            tag->num_attrs++;
         }
-        name = ts_get(ts);
-        i++;
     }
 
     set_charclasses(ts,
@@ -141,218 +199,200 @@ static cst_features *ssml_get_attributes(cst_tokenstream *ts)
                     ts->p_prepunctuationsymbols,
                     ts->p_postpunctuationsymbols);
 
-    return a;
+    tag->name = tag->buf + name_o;
+    for (i = 0; i < tag->num_attrs; i++)
+    {
+        tag->attr[i] = tag->buf + attr_o[i];
+        tag->val[i] = tag->buf + val_o[i];
+    }
+    return 0;
 }
 
-static cst_utterance *ssml_apply_tag(const char *tag,
-                                     cst_features *attributes,
-                                     cst_utterance *u,
-                                     cst_features *word_feats,
-                                     cst_features *feats)
+static int ssml_parse(cst_tokenstream *ts, ssml_handler *h)
 {
-    const char *wavefilename;
-    const char *vname;
-    cst_voice *nvoice;
-    cst_wave *wave;
-    cst_item *t;
-    cst_relation *r;
-    float break_size;
+    /* Reads the whole stream, handing tokens and tags to h as it goes */
+    ssml_tag tag;
+    const char *token;
+    int rv = 0;
 
+    memset(&tag, 0, sizeof(tag));
+    tag.buf_size = 256;
+    tag.buf = cst_alloc(char, tag.buf_size);
+
+    while (!ts_eof(ts) && rv == 0)
+    {
+        token = ts_get(ts);
+        if (cst_streq("<", token))
+        {
+            if ((rv = ssml_read_tag(ts, &tag)) < 0)
+                break;
 #if SSML_DEBUG
-    printf("SSML TAG %s\n", tag);
-    cst_feat_print(stdout, attributes);
-    printf("...\n");
+            printf("SSML TAG %s %d %d\n", tag.name, tag.type, tag.num_attrs);
 #endif
+            if (tag.name[0] != '!' && tag.name[0] != '?')    /* comments */
+                rv = h->tag(h, &tag);
+        }
+        else
+            rv = h->token(h, ts, token);
+    }
 
-    if (cst_streq("AUDIO", tag))
+    cst_free(tag.buf);
+    return rv;
+}
+
+/* Synthesis from the parser's events */
+typedef struct ssml_synth_struct {
+    cst_synth_pipeline *p;
+    cst_voice *default_voice;
+    cst_features *word_feats;   /* copied onto each token */
+} ssml_synth;
+
+static int ssml_synth_token(ssml_handler *h, cst_tokenstream *ts,
+                            const char *token)
+{
+    ssml_synth *s = (ssml_synth *) h->userdata;
+    cst_item *t;
+
+    if (cst_strlen(token) == 0)
     {
-        if ((cst_streq("start", feat_string(attributes, "_type"))) ||
-            (cst_streq("startend", feat_string(attributes, "_type"))))
+        /* end of the stream, or an utterance break */
+        if (synth_pipeline_break(s->p) < 0)
+            return -1;
+        if (ts_eof(ts))
+            return 0;
+    }
+    if ((t = synth_pipeline_token(s->p, ts, token)) == NULL)
+        return -1;
+    feat_copy_into(s->word_feats, item_feats(t));
+
+    return 0;
+}
+
+static float ssml_rate(const char *str)
+{
+    /* Note SSML doesn't do stretch it does reciprical of stretch */
+    if (cst_streq(str, "x-slow"))
+        return 0.3;
+    if (cst_streq(str, "slow"))
+        return 0.5;
+    if (cst_streq(str, "medium"))
+        return 1.0;
+    if (cst_streq(str, "fast"))
+        return 1.5;
+    if (cst_streq(str, "x-fast"))
+        return 2.0;
+    return cst_atof(str);
+}
+
+static int ssml_synth_tag(ssml_handler *h, const ssml_tag *tag)
+{
+    ssml_synth *s = (ssml_synth *) h->userdata;
+    cst_features *wf = s->word_feats;
+    const char *v;
+    cst_voice *nvoice;
+    cst_wave *wave;
+    cst_item *t;
+    float rate;
+
+    if (cst_streq("AUDIO", tag->name))
+    {
+        if (tag->type == SSML_TAG_END)
         {
-            wavefilename = feat_string(attributes, "_val0");
-            wave = new_wave();
-            if (cst_wave_load_riff(wave, wavefilename) == CST_OK_FORMAT)
-            {
-                if (cst_streq("start", feat_string(attributes, "_type")))
-                {
-                    feat_set_string(word_feats, "ssml_comment", "1");
-                }
-                feat_set(word_feats, "ssml_play_audio", wave_val(wave));
-            }
-            else
-                delete_wave(wave);
-            return NULL;        /* Cause eou */
+            feat_remove(wf, "ssml_comment");
+            return synth_pipeline_break(s->p);
         }
-        else if (cst_streq("end", feat_string(attributes, "_type")))
+        wave = new_wave();
+        v = ssml_tag_attr(tag, "src", (tag->num_attrs > 0) ?
+                          tag->val[0] : "");
+        if (cst_wave_load_riff(wave, v) != CST_OK_FORMAT)
         {
-            feat_remove(word_feats, "ssml_comment");
-            return NULL;        /* Cause eou */
+            delete_wave(wave);
+            return synth_pipeline_break(s->p);
         }
+        /* The contents are the text alternative for the audio */
+        if (tag->type == SSML_TAG_START)
+            feat_set_string(wf, "ssml_comment", "1");
+        return synth_pipeline_wave(s->p, wave);
     }
-    else if (cst_streq("BREAK", tag))
+    else if (cst_streq("BREAK", tag->name))
     {
-        if (u &&
-            ((r = utt_relation(u, "Token")) != NULL) &&
-            ((t = relation_tail(r)) != NULL))
+        if ((t = synth_pipeline_last_token(s->p)) != NULL)
         {
             item_set_string(t, "break", "1");
-            /* cst_feat_print(stdout,attributes); */
-            if (cst_streq("size", get_param_string(attributes, "_name0", "")))
-            {
-                break_size = feat_float(attributes, "_val0");
-                item_set_float(t, "break_size", break_size);
-            }
+            if ((v = ssml_tag_attr(tag, "size", NULL)) != NULL)
+                item_set_float(t, "break_size", cst_atof(v));
         }
     }
-    else if (cst_streq("PROSODY", tag))
+    else if (cst_streq("PROSODY", tag->name))
     {
-        if (cst_streq("start", feat_string(attributes, "_type")))
+        if (tag->type == SSML_TAG_START)
         {
-            /* Note SSML doesn't do stretch it does reciprical of stretch */
-            if (cst_streq("rate", get_param_string(attributes, "_name0", "")))
-            {
-                float val = feat_float(attributes, "_val0");
-                const char *str = feat_string(attributes, "_val0");
-                if (cst_streq(str, "x-slow"))
-                    val = 0.3;
-                if (cst_streq(str, "slow"))
-                    val = 0.5;
-                if (cst_streq(str, "fast"))
-                    val = 1.5;
-                if (cst_streq(str, "x-fast"))
-                    val = 2.0;
-                if (cst_streq(str, "medium"))
-                    val = 1.0;
-                if (val > 0)
-                    feat_set_float(word_feats, "local_duration_stretch",
-                                   1.0 / val);
-            }
-            // volume is stored in _name1
-            if (cst_streq
-                ("volume", get_param_string(attributes, "_name1", "")))
-                feat_set_float(word_feats, "local_gain",
-                               feat_float(attributes, "_val1") / 100.0);
-            // pitch is stored in _name2
-            if (cst_streq("pitch", get_param_string(attributes, "_name2", "")))
-            {
-                feat_set_float(word_feats, "local_f0_mean", feat_float(attributes, "_val2"));
-            }
-            // range is stored in _name3
-            if (cst_streq("range", get_param_string(attributes, "_name3", "")))
-            {
-                feat_set_float(word_feats, "local_f0_range",
-                               // shift by + 1.0 to allow 0.0 to be passed.
-                               feat_float(attributes, "_val3") + 1.0);
-            }
+            if ((v = ssml_tag_attr(tag, "rate", NULL)) != NULL &&
+                (rate = ssml_rate(v)) > 0)
+                feat_set_float(wf, "local_duration_stretch", 1.0 / rate);
+            if ((v = ssml_tag_attr(tag, "volume", NULL)) != NULL)
+                feat_set_float(wf, "local_gain", cst_atof(v) / 100.0);
+            if ((v = ssml_tag_attr(tag, "pitch", NULL)) != NULL)
+                feat_set_float(wf, "local_f0_mean", cst_atof(v));
+            /* shift by + 1.0 to allow 0.0 to be passed. */
+            if ((v = ssml_tag_attr(tag, "range", NULL)) != NULL)
+                feat_set_float(wf, "local_f0_range", cst_atof(v) + 1.0);
         }
-        else if (cst_streq("end", feat_string(attributes, "_type")))
+        else if (tag->type == SSML_TAG_END)
         {
-            feat_remove(word_feats, "local_duration_stretch");
-            feat_remove(word_feats, "local_gain");
-            feat_remove(word_feats, "local_f0_mean");
-            feat_remove(word_feats, "local_f0_range");
+            feat_remove(wf, "local_duration_stretch");
+            feat_remove(wf, "local_gain");
+            feat_remove(wf, "local_f0_mean");
+            feat_remove(wf, "local_f0_range");
         }
-
     }
-    else if (cst_streq("PHONEME", tag))
+    else if (cst_streq("PHONEME", tag->name))
     {
-        if (cst_streq("start", feat_string(attributes, "_type")))
-        {
-            if (cst_streq("ph", get_param_string(attributes, "_name0", "")))
-            {
-                const char *ph;
-                ph = feat_string(attributes, "_val0");
-                feat_set_string(word_feats, "phones", ph);
-            }
-        }
-        else if (cst_streq("end", feat_string(attributes, "_type")))
-        {
-            feat_remove(word_feats, "phones");
-        }
-
+        if (tag->type == SSML_TAG_START &&
+            (v = ssml_tag_attr(tag, "ph", NULL)) != NULL)
+            feat_set_string(wf, "phones", v);
+        else if (tag->type == SSML_TAG_END)
+            feat_remove(wf, "phones");
     }
-    else if (cst_streq("SUB", tag))
+    else if (cst_streq("SUB", tag->name))
     {
-        if (cst_streq("start", feat_string(attributes, "_type")))
-        {
-            if (cst_streq
-                ("alias", get_param_string(attributes, "_name0", "")))
-            {
-                const char *alias;
-                alias = feat_string(attributes, "_val0");
-                feat_set_string(word_feats, "ssml_alias", alias);
-            }
-        }
-        else if (cst_streq("end", feat_string(attributes, "_type")))
-        {
-            feat_remove(word_feats, "ssml_alias");
-        }
-
+        if (tag->type == SSML_TAG_START &&
+            (v = ssml_tag_attr(tag, "alias", NULL)) != NULL)
+            feat_set_string(wf, "ssml_alias", v);
+        else if (tag->type == SSML_TAG_END)
+            feat_remove(wf, "ssml_alias");
     }
-    else if (cst_streq("VOICE", tag))
+    else if (cst_streq("VOICE", tag->name))
     {
-        if (cst_streq("start", feat_string(attributes, "_type")))
+        /* A voice change is always an utterance break */
+        if (synth_pipeline_break(s->p) < 0)
+            return -1;
+        if (tag->type == SSML_TAG_START)
         {
-            vname = get_param_string(attributes, "_val0", "");
-            nvoice = mimic_voice_select(vname);
-            feat_set(feats, "current_voice", userdata_val(nvoice));
-            return NULL;        /* cause an utterance break */
+            v = ssml_tag_attr(tag, "name", (tag->num_attrs > 0) ?
+                              tag->val[0] : "");
+            if ((nvoice = mimic_voice_select(v)) != NULL)
+                synth_pipeline_set_voice(s->p, nvoice);
         }
-        else if (cst_streq("end", feat_string(attributes, "_type")))
-        {
+        else if (tag->type == SSML_TAG_END)
             /* Hmm we should really have a stack of these */
-            nvoice =
-                (cst_voice *) val_userdata(feat_val(feats, "default_voice"));
-            feat_set(feats, "current_voice", userdata_val(nvoice));
-            return NULL;
-        }
+            synth_pipeline_set_voice(s->p, s->default_voice);
     }
 
-    /* do stuff */
-    /* flag what to do mark or end */
-    /*
-       ph set attributes silence all contained tokens
-       break add to previous token a break marker
-       audio silence all following tokens (utt break)
-       insert waveform 
-
-     */
-
-    return u;
+    return 0;
 }
 
-static float mimic_ssml_to_speech_ts(cst_tokenstream *ts, cst_voice *voice,
-                                     const char *outtype, float *durs)
+static int mimic_ssml_to_speech_ts(cst_tokenstream *ts, cst_voice *voice,
+                                   const char *outtype, float *durs)
 {
-    /* This is a very ugly function, that might be better written with gotos */
-    /* This just doesn't seem to be properly functions -- perhaps a proper */
-    /* consumer/producer threaded model might be better here -- but its */
-    /* not clear.  There is so much have-to-be-done-now vs note-for-later */
-    /* code, that the code is far from clear, and probably not right */
-    cst_features *ssml_feats, *ssml_word_feats;
-    cst_features *attributes;
-    const char *token = "";
-    char *tag = NULL;
-    cst_utterance *utt;
-    cst_relation *tokrel;
-    int num_tokens;
-    cst_breakfunc breakfunc = default_utt_break;
-    cst_uttfunc utt_user_callback = 0;
-    cst_item *t;
-    cst_voice *current_voice;
-    int ssml_eou = 0;
-    const cst_wave *wave;
-    cst_wave *w;
-    int err = 0;
+    ssml_handler h;
+    ssml_synth s;
+    int err;
 
     if ((durs == NULL) || (voice == NULL) || (ts == NULL) || (outtype == NULL))
     {
         return -EINVAL;
     }
-    ssml_feats = new_features();
-    feat_set(ssml_feats, "current_voice", userdata_val(voice));
-    feat_set(ssml_feats, "default_voice", userdata_val(voice));
-    ssml_word_feats = new_features();
     set_charclasses(ts,
                     " \t\n\r",
                     ssml_singlecharsymbols_general,
@@ -361,155 +401,21 @@ static float mimic_ssml_to_speech_ts(cst_tokenstream *ts, cst_voice *voice,
                                                            "text_postpunctuation",
                                                            ""));
 
-    if (feat_present(voice->features, "utt_break"))
-        breakfunc = val_breakfunc(feat_val(voice->features, "utt_break"));
-
-    if (feat_present(voice->features, "utt_user_callback"))
-        utt_user_callback =
-            val_uttfunc(feat_val(voice->features, "utt_user_callback"));
-
-    /* If its a file to write to, create and save an empty wave file */
-    /* as we are going to incrementally append to it                 */
-    if (!cst_streq(outtype, "play") &&
-        !cst_streq(outtype, "none") && !cst_streq(outtype, "stream"))
-    {
-        w = new_wave();
-        if (cst_wave_resize(w, 0, 1) == 0)
-        {
-            cst_wave_set_sample_rate(w, 16000);
-            cst_wave_save_riff(w, outtype); /* an empty wave */
-        }
-        delete_wave(w);
-    }
-
-    num_tokens = 0;
-    utt = new_utterance();
-
-    tokrel = utt_relation_create(utt, "Token");
-    while (!ts_eof(ts) || num_tokens > 0)
-    {
-        current_voice =
-            (cst_voice *) val_userdata(feat_val(ssml_feats, "current_voice"));
-        /* printf("awb_debug prewhile %d %s\n",ssml_eou,token); */
-        if (ssml_eou == 0)
-            token = ts_get(ts);
-        else
-        {
-            if (!cst_streq("<", token))
-                token = ts_get(ts);
-            ssml_eou = 0;
-        }
-        while ((cst_streq("<", token)) && (ssml_eou == 0))
-        {                       /* A tag -- look ahead and process it to find out how to advance */
-            tag = cst_upcase(ts_get(ts));
-            /* printf("awb_debug tag is %s\n",tag); */
-            if (cst_streq("/", tag))    /* an end tag */
-            {
-                cst_free(tag);
-                tag = NULL;
-                tag = cst_upcase(ts_get(ts));
-                attributes = ssml_get_attributes(ts);
-                feat_set_string(attributes, "_type", "end");
-            }
-            else
-                attributes = ssml_get_attributes(ts);
-            token = ts_get(ts); /* skip ">" */
-            if (ssml_apply_tag
-                (tag, attributes, utt, ssml_word_feats, ssml_feats))
-                ssml_eou = 0;
-            else
-                ssml_eou = 1;
-
-            delete_features(attributes);
-            cst_free(tag);
-            tag = NULL;
-        }
-
-        if ((cst_strlen(token) == 0) || (num_tokens > 500) ||   /* need an upper bound */
-            (ssml_eou == 1) ||  /* ssml tag was utterance break */
-            (relation_head(tokrel) && breakfunc(ts, token, tokrel)))
-        {
-            /* An end of utt, so synthesize it */
-            if (utt_user_callback)
-                utt = (utt_user_callback) (utt);
-
-            if (utt)
-            {
-                float new_durs;
-                utt = mimic_do_synth(utt, current_voice, utt_synth_tokens);
-                if (feat_present(utt->features, "Interrupted"))
-                {
-                    delete_utterance(utt);
-                    utt = NULL;
-                    break;
-                }
-                err = mimic_process_output(utt, outtype, TRUE, &new_durs);
-                if (err < 0)
-                    goto cleanup;
-                *durs += new_durs;
-                delete_utterance(utt);
-                utt = NULL;
-            }
-            else
-                break;
-
-            if (ts_eof(ts))
-                break;
-
-            utt = new_utterance();
-            tokrel = utt_relation_create(utt, "Token");
-            num_tokens = 0;
-        }
-
-        if (feat_present(ssml_word_feats, "ssml_play_audio"))
-        {
-            float new_durs;
-            wave = val_wave(feat_val(ssml_word_feats, "ssml_play_audio"));
-            /* Should create an utterances with the waveform in it */
-            /* Have to stream it if there is streaming */
-            if (utt)
-                delete_utterance(utt);
-            utt = utt_synth_wave(copy_wave(wave), current_voice);
-            if (utt == NULL)
-               goto cleanup;
-            if (utt_user_callback)
-                utt = (utt_user_callback) (utt);
-            mimic_process_output(utt, outtype, TRUE, &new_durs);
-            if (err < 0)
-                goto cleanup;
-            *durs += new_durs;
-            delete_utterance(utt);
-            utt = NULL;
-
-            utt = new_utterance();
-            tokrel = utt_relation_create(utt, "Token");
-            num_tokens = 0;
-
-            feat_remove(ssml_word_feats, "ssml_play_audio");
-        }
-        else if (!cst_streq("<", token))
-        {                       /* wasn't an ssml tag */
-            num_tokens++;
-
-            t = relation_append(tokrel, NULL);
-            item_set_string(t, "name", token);
-            item_set_string(t, "whitespace", ts->whitespace);
-            item_set_string(t, "prepunctuation", ts->prepunctuation);
-            item_set_string(t, "punc", ts->postpunctuation);
-            /* Mark it at the beginning of the token */
-            item_set_int(t, "file_pos",
-                         /* as we are already on the next char */
-                         ts->file_pos - (1 + cst_strlen(token) +
-                              cst_strlen(ts->prepunctuation) +
-                              cst_strlen(ts->postpunctuation)));
-            item_set_int(t, "line_number", ts->line_number);
-            feat_copy_into(ssml_word_feats, item_feats(t));
-        }
-    }
-  cleanup:
-    delete_utterance(utt);
-    delete_features(ssml_feats);
-    delete_features(ssml_word_feats);
+    s.p = new_synth_pipeline(voice, outtype,
+                             get_param_int(voice->features, "synth_threads",
+                                           1));
+    if (s.p == NULL)
+        return -EIO;
+    s.default_voice = voice;
+    s.word_feats = new_features();
+    h.token = ssml_synth_token;
+    h.tag = ssml_synth_tag;
+    h.userdata = &s;
+
+    ssml_parse(ts, &h);
+
+    err = synth_pipeline_close(s.p, durs);
+    delete_features(s.word_feats);
     return err;
 }
 
@@ -519,7 +425,6 @@ int mimic_ssml_file_to_speech(const char *filename, cst_voice *voice,
     cst_tokenstream *ts;
     int fp;
     int err;
-    cst_wave *w;
 
     if ((dur == NULL) || (voice == NULL)
             || (filename == NULL) || (outtype == NULL))
@@ -546,20 +451,6 @@ int mimic_ssml_file_to_speech(const char *filename, cst_voice *voice,
     if (fp > 0)
         ts_set_stream_pos(ts, fp);
 
-    /* If its a file to write to, create and save an empty wave file */
-    /* as we are going to incrementally append to it                 */
-    if (!cst_streq(outtype, "play") &&
-        !cst_streq(outtype, "none") && !cst_streq(outtype, "stream"))
-    {
-        w = new_wave();
-        if (cst_wave_resize(w, 0, 1) == 0)
-        {
-            cst_wave_set_sample_rate(w, 16000);
-            cst_wave_save_riff(w, outtype); /* an empty wave */
-        }
-        delete_wave(w);
-    }
-
     err = mimic_ssml_to_speech_ts(ts, voice, outtype, dur);
 
     ts_close(ts);
@@ -574,32 +465,33 @@ int mimic_ssml_text_to_speech(const char *text, cst_voice *voice,
     cst_tokenstream *ts;
     int fp;
     int err;
-    cst_wave *w;
-
-    // Workaround for the case "hello: there" (colon before the last word)
-    // In above case the last word won't be generated.
-    // Below is a workaround adding a silent space at the end of the sentence
-    // TODO fix for real
-    char * new_text = malloc(strlen(text) + 2);
-    sprintf(new_text, "%s ", text);
+    char *new_text;
 
     if ((dur == NULL) || (voice == NULL) || (text == NULL) || (outtype == NULL))
     {
         return -EINVAL;
     }
 
-    if ((ts = ts_open_string(new_text,
-                             get_param_string(voice->features,
-                                              "text_whitespace", NULL),
-                             get_param_string(voice->features,
-                                              "text_singlecharsymbols", NULL),
-                             get_param_string(voice->features,
-                                              "text_prepunctuation", NULL),
-                             get_param_string(voice->features,
-                                              "text_postpunctuation",
-                                              NULL),
-                            get_param_int(voice->features,
-                                       "text_emoji_as_singlecharsymbols", 0))) == NULL)
+    // Workaround for the case "hello: there" (colon before the last word)
+    // In above case the last word won't be generated.
+    // Below is a workaround adding a silent space at the end of the sentence
+    // TODO fix for real
+    new_text = cst_alloc(char, cst_strlen(text) + 2);
+    cst_sprintf(new_text, "%s ", text);
+
+    ts = ts_open_string(new_text,
+                        get_param_string(voice->features,
+                                         "text_whitespace", NULL),
+                        get_param_string(voice->features,
+                                         "text_singlecharsymbols", NULL),
+                        get_param_string(voice->features,
+                                         "text_prepunctuation", NULL),
+                        get_param_string(voice->features,
+                                         "text_postpunctuation", NULL),
+                        get_param_int(voice->features,
+                                      "text_emoji_as_singlecharsymbols", 0));
+    cst_free(new_text);
+    if (ts == NULL)
     {
         return -EINVAL;
     }
@@ -607,20 +499,6 @@ int mimic_ssml_text_to_speech(const char *text, cst_voice *voice,
     if (fp > 0)
         ts_set_stream_pos(ts, fp);
 
-    /* If its a file to write to, create and save an empty wave file */
-    /* as we are going to incrementally append to it                 */
-    if (!cst_streq(outtype, "play") &&
-        !cst_streq(outtype, "none") && !cst_streq(outtype, "stream"))
-    {
-        w = new_wave();
-        if (cst_wave_resize(w, 0, 1) == 0)
-        {
-            cst_wave_set_sample_rate(w, 16000);
-            cst_wave_save_riff(w, outtype); /* an empty wave */
-        }
-        delete_wave(w);
-    }
-
     err = mimic_ssml_to_speech_ts(ts, voice, outtype, dur);
 
     ts_close(ts);
@@ -84,6 +84,22 @@ static const cst_synth_module synth_method_text2segs[] = {
     {NULL, NULL}
 };
 
+/* Timing only: alignment_func is for voices whose durations come from */
+/* the waveform synthesizer, it sets the Segment ends without audio    */
+static const cst_synth_module synth_method_alignment[] = {
+    {"tokenizer_func", default_tokenization},
+    {"textanalysis_func", default_textanalysis},
+    {"pos_tagger_func", default_pos_tagger},
+    {"phrasing_func", default_phrasing},
+    {"lexical_insertion_func", default_lexical_insertion},
+    {"pause_insertion_func", default_pause_insertion},
+    {"intonation_func", cart_intonation},
+    {"postlex_func", NULL},
+    {"duration_model_func", cart_duration},
+    {"alignment_func", NULL},
+    {NULL, NULL}
+};
+
 static const cst_synth_module synth_method_tokens[] = {
     {"textanalysis_func", default_textanalysis},
     {"pos_tagger_func", default_pos_tagger},
@@ -137,6 +153,7 @@ cst_utterance *utt_synth_wave(cst_wave *w, cst_voice *v)
         return u;               /* no stream */
 
     /* Do streaming */
+    audio_stream_stats_chunk(asi);
     (*asi->asc) (w, 0, w->num_samples, 1, asi);
 
     return u;
@@ -158,10 +175,14 @@ cst_utterance *apply_synth_module(cst_utterance *u,
 cst_utterance *apply_synth_method(cst_utterance *u,
                                   const cst_synth_module meth[])
 {
+    double start;
+
     while (meth->hookname)
     {
+        start = cst_stats_start();
         if ((u = apply_synth_module(u, meth)) == NULL)
             return NULL;
+        cst_stats_end(meth->hookname, start);
         ++meth;
     }
 
@@ -197,6 +218,11 @@ cst_utterance *utt_synth_text2segs(cst_utterance *u)
     return apply_synth_method(u, synth_method_text2segs);
 }
 
+cst_utterance *utt_synth_alignment(cst_utterance *u)
+{
+    return apply_synth_method(u, synth_method_alignment);
+}
+
 cst_utterance *utt_synth_phones(cst_utterance *u)
 {
     return apply_synth_method(u, synth_method_phones);
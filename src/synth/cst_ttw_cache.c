@@ -0,0 +1,473 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*      Cache of token to words expansions, keyed on the token and the   */
+/*      context features the expansion depends on                        */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Text normalization expands the same numbers, times, prices and       */
+/*  abbreviations over and over in templated text.  The expansion of a   */
+/*  token is a function of its name and a small, language specific set   */
+/*  of context features, so the cache key is those feature values.       */
+/*  Any token features the expansion function sets (e.g. punc) are       */
+/*  recorded with the words and set again on a hit.                      */
+/*                                                                       */
+/*  Entries hold a flat copy of the words, never cst_vals, so nothing    */
+/*  is shared between threads.  The cache is bounded with LRU eviction,  */
+/*  guarded by a mutex, and entries made with an older version of the    */
+/*  lexicon addenda are dropped when they are next looked at.            */
+/*                                                                       */
+/*************************************************************************/
+
+#include <string.h>
+#include "cst_alloc.h"
+#include "cst_string.h"
+#include "cst_item.h"
+#include "cst_utterance.h"
+#include "cst_lexicon.h"
+#include "cst_synth.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+/* Longer keys aren't worth keeping */
+#define TTW_CACHE_MAX_KEY 512
+
+typedef struct ttw_entry_struct {
+    char *key;
+    int key_len;
+    unsigned int hash;
+    const cst_lexicon *lex;
+    int lex_generation;
+    /* words as name\0 nfeats (fname\0 fval\0)*, nfeats is one byte */
+    char *words;
+    int words_len;
+    char **token_feats;         /* values after the expansion, or NULL */
+    struct ttw_entry_struct *hnext;
+    struct ttw_entry_struct *prev, *next;       /* LRU, head is newest */
+} ttw_entry;
+
+struct cst_ttw_cache_struct {
+    int max_entries;
+    const char *const *context_feats;
+    const char *const *token_feats;
+    int num_token_feats;
+    ttw_entry **buckets;
+    unsigned int num_buckets;   /* a power of 2 */
+    ttw_entry *head, *tail;
+    cst_val *fnames;            /* feature names handed out to words */
+    cst_ttw_cache_stats stats;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_t lock;
+#endif
+};
+
+static void ttw_lock(cst_ttw_cache *c)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&c->lock);
+#endif
+}
+
+static void ttw_unlock(cst_ttw_cache *c)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&c->lock);
+#endif
+}
+
+cst_ttw_cache *new_ttw_cache(int max_entries,
+                             const char *const *context_feats,
+                             const char *const *token_feats)
+{
+    cst_ttw_cache *c = cst_alloc(cst_ttw_cache, 1);
+
+    c->max_entries = max_entries;
+    c->context_feats = context_feats;
+    c->token_feats = token_feats;
+    for (c->num_token_feats = 0; token_feats && token_feats[c->num_token_feats];
+         c->num_token_feats++);
+    for (c->num_buckets = 16; c->num_buckets < (unsigned int) max_entries;
+         c->num_buckets *= 2);
+    c->buckets = cst_alloc(ttw_entry *, c->num_buckets);
+    c->stats.max_entries = max_entries;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_init(&c->lock, NULL);
+#endif
+
+    return c;
+}
+
+static void delete_ttw_entry(const cst_ttw_cache *c, ttw_entry *e)
+{
+    int i;
+
+    for (i = 0; i < c->num_token_feats; i++)
+        cst_free(e->token_feats[i]);
+    cst_free(e->token_feats);
+    cst_free(e->words);
+    cst_free(e->key);
+    cst_free(e);
+}
+
+static void ttw_lru_unlink(cst_ttw_cache *c, ttw_entry *e)
+{
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        c->head = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        c->tail = e->prev;
+}
+
+static void ttw_unlink(cst_ttw_cache *c, ttw_entry *e)
+{
+    ttw_entry **h;
+
+    for (h = &c->buckets[e->hash & (c->num_buckets - 1)]; *h != e;
+         h = &(*h)->hnext);
+    *h = e->hnext;
+    ttw_lru_unlink(c, e);
+    c->stats.entries--;
+}
+
+static ttw_entry *ttw_find(cst_ttw_cache *c, const char *key, int key_len,
+                           unsigned int hash, const cst_lexicon *lex)
+{
+    ttw_entry *e;
+
+    for (e = c->buckets[hash & (c->num_buckets - 1)]; e; e = e->hnext)
+        if (e->hash == hash && e->lex == lex && e->key_len == key_len &&
+            memcmp(e->key, key, key_len) == 0)
+            return e;
+    return NULL;
+}
+
+static void ttw_push_front(cst_ttw_cache *c, ttw_entry *e)
+{
+    e->prev = NULL;
+    e->next = c->head;
+    if (c->head)
+        c->head->prev = e;
+    else
+        c->tail = e;
+    c->head = e;
+}
+
+void ttw_cache_clear(cst_ttw_cache *c)
+{
+    ttw_entry *e, *n;
+
+    ttw_lock(c);
+    for (e = c->head; e; e = n)
+    {
+        n = e->next;
+        delete_ttw_entry(c, e);
+    }
+    memset(c->buckets, 0, c->num_buckets * sizeof(ttw_entry *));
+    c->head = c->tail = NULL;
+    c->stats.entries = 0;
+    ttw_unlock(c);
+}
+
+void delete_ttw_cache(cst_ttw_cache *c)
+{
+    if (c == NULL)
+        return;
+    ttw_cache_clear(c);
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_destroy(&c->lock);
+#endif
+    delete_val(c->fnames);
+    cst_free(c->buckets);
+    cst_free(c);
+}
+
+void ttw_cache_get_stats(cst_ttw_cache *c, cst_ttw_cache_stats *stats)
+{
+    ttw_lock(c);
+    *stats = c->stats;
+    ttw_unlock(c);
+}
+
+static int ttw_append(char *buf, int len, int max, const char *s, int n)
+{
+    if (len < 0 || len + n > max)
+        return -1;
+    memmove(buf + len, s, n);
+    return len + n;
+}
+
+/* Context values joined with \037, with the presence of the neighbours */
+/* first as the expansion may test those directly                       */
+static int ttw_make_key(const cst_ttw_cache *c, cst_item *token, char *key)
+{
+    const char *v;
+    char nb[2];
+    int i, len;
+
+    nb[0] = item_prev(token) ? 'p' : '-';
+    nb[1] = item_next(token) ? 'n' : '-';
+    len = ttw_append(key, 0, TTW_CACHE_MAX_KEY, nb, 2);
+    for (i = 0; c->context_feats[i]; i++)
+    {
+        v = ffeature_string(token, c->context_feats[i]);
+        len = ttw_append(key, len, TTW_CACHE_MAX_KEY, "\037", 1);
+        len = ttw_append(key, len, TTW_CACHE_MAX_KEY, v, cst_strlen(v));
+    }
+
+    return len;
+}
+
+static unsigned int ttw_hash(const char *key, int len, const cst_lexicon *lex)
+{
+    unsigned int h = 2166136261u;
+    int i;
+
+    for (i = 0; i < len; i++)
+        h = (h ^ (unsigned char) key[i]) * 16777619u;
+    return h ^ (unsigned int) (size_t) lex;
+}
+
+/* Flattens the words, returns -1 if they aren't all strings */
+static int ttw_flatten(const cst_val *words, char **flat)
+{
+    const cst_val *w;
+    const cst_featvalpair *fp;
+    const cst_features *f;
+    char *buf;
+    int size, len, n;
+
+    for (size = 0, w = words; w; w = val_cdr(w))
+    {
+        if (cst_val_consp(val_car(w)))
+        {
+            if (!val_stringp(val_car(val_car(w))))
+                return -1;
+            size += cst_strlen(val_string(val_car(val_car(w)))) + 2;
+            f = val_features(val_cdr(val_car(w)));
+            for (n = 0, fp = f->head; fp; fp = fp->next, n++)
+            {
+                if (!val_stringp(fp->val) || n == 255)
+                    return -1;
+                size += cst_strlen(fp->name) + cst_strlen(val_string(fp->val))
+                    + 2;
+            }
+        }
+        else if (val_stringp(val_car(w)))
+            size += cst_strlen(val_string(val_car(w))) + 2;
+        else
+            return -1;
+    }
+
+    buf = cst_alloc(char, size + 1);
+    for (len = 0, w = words; w; w = val_cdr(w))
+    {
+        f = NULL;
+        if (cst_val_consp(val_car(w)))
+        {
+            len = ttw_append(buf, len, size, val_string(val_car(val_car(w))),
+                             cst_strlen(val_string(val_car(val_car(w)))) + 1);
+            f = val_features(val_cdr(val_car(w)));
+        }
+        else
+            len = ttw_append(buf, len, size, val_string(val_car(w)),
+                             cst_strlen(val_string(val_car(w))) + 1);
+        for (n = 0, fp = f ? f->head : NULL; fp; fp = fp->next, n++);
+        buf[len++] = (char) n;
+        for (fp = f ? f->head : NULL; fp; fp = fp->next)
+        {
+            len = ttw_append(buf, len, size, fp->name,
+                             cst_strlen(fp->name) + 1);
+            len = ttw_append(buf, len, size, val_string(fp->val),
+                             cst_strlen(val_string(fp->val)) + 1);
+        }
+    }
+    *flat = buf;
+
+    return len;
+}
+
+/* Word features are copied into items by name without copying the */
+/* name, so names have to live as long as the cache                 */
+static const char *ttw_fname(cst_ttw_cache *c, const char *name)
+{
+    const cst_val *v;
+
+    for (v = c->fnames; v; v = val_cdr(v))
+        if (cst_streq(val_string(val_car(v)), name))
+            return val_string(val_car(v));
+    c->fnames = cons_val(string_val(name), c->fnames);
+
+    return val_string(val_car(c->fnames));
+}
+
+static cst_val *ttw_unflatten(cst_ttw_cache *c, const char *flat,
+                              int flat_len)
+{
+    cst_val *words = NULL;
+    cst_features *f;
+    const char *p, *name, *fname;
+    int n;
+
+    for (p = flat; p < flat + flat_len;)
+    {
+        name = p;
+        p += cst_strlen(p) + 1;
+        n = (unsigned char) *p++;
+        if (n == 0)
+        {
+            words = cons_val(string_val(name), words);
+            continue;
+        }
+        f = new_features();
+        for (; n > 0; n--)
+        {
+            fname = p;
+            p += cst_strlen(p) + 1;
+            feat_set_string(f, ttw_fname(c, fname), p);
+            p += cst_strlen(p) + 1;
+        }
+        words = cons_val(cons_val(string_val(name), features_val(f)), words);
+    }
+
+    return val_reverse(words);
+}
+
+static const cst_lexicon *ttw_lexicon(cst_item *token)
+{
+    const cst_utterance *u = item_utt(token);
+
+    if (u && feat_present(u->features, "lexicon"))
+        return val_lexicon(feat_val(u->features, "lexicon"));
+    return NULL;
+}
+
+cst_val *ttw_cache_tokentowords(cst_ttw_cache *c, cst_item *token,
+                                cst_itemfunc ttw)
+{
+    char key[TTW_CACHE_MAX_KEY];
+    char *flat;
+    const cst_lexicon *lex;
+    ttw_entry *e, *o;
+    cst_val *words;
+    int key_len, flat_len, i;
+    unsigned int hash;
+
+    key_len = ttw_make_key(c, token, key);
+    if (key_len < 0 || c->max_entries <= 0)
+    {
+        ttw_lock(c);
+        c->stats.uncached++;
+        ttw_unlock(c);
+        return (*ttw) (token);
+    }
+    lex = ttw_lexicon(token);
+    hash = ttw_hash(key, key_len, lex);
+
+    ttw_lock(c);
+    e = ttw_find(c, key, key_len, hash, lex);
+    if (e && lex && e->lex_generation != lex->addenda_generation)
+    {
+        ttw_unlink(c, e);
+        delete_ttw_entry(c, e);
+        c->stats.invalidated++;
+        e = NULL;
+    }
+    if (e)
+    {
+        /* Move to the front and rebuild the words while still locked */
+        ttw_lru_unlink(c, e);
+        ttw_push_front(c, e);
+        c->stats.hits++;
+        words = ttw_unflatten(c, e->words, e->words_len);
+        for (i = 0; i < c->num_token_feats; i++)
+            if (e->token_feats[i] &&
+                (!item_feat_present(token, c->token_feats[i]) ||
+                 !cst_streq(e->token_feats[i],
+                            item_feat_string(token, c->token_feats[i]))))
+                item_set_string(token, c->token_feats[i], e->token_feats[i]);
+        ttw_unlock(c);
+        return words;
+    }
+    c->stats.misses++;
+    ttw_unlock(c);
+
+    words = (*ttw) (token);
+
+    flat_len = ttw_flatten(words, &flat);
+    if (flat_len < 0)
+        return words;
+
+    e = cst_alloc(ttw_entry, 1);
+    e->key = cst_alloc(char, key_len);
+    memmove(e->key, key, key_len);
+    e->key_len = key_len;
+    e->hash = hash;
+    e->lex = lex;
+    e->lex_generation = lex ? lex->addenda_generation : 0;
+    e->words = flat;
+    e->words_len = flat_len;
+    e->token_feats = cst_alloc(char *, c->num_token_feats);
+    for (i = 0; i < c->num_token_feats; i++)
+        if (item_feat_present(token, c->token_feats[i]))
+            e->token_feats[i] =
+                cst_strdup(item_feat_string(token, c->token_feats[i]));
+
+    ttw_lock(c);
+    /* Another thread may have added it meanwhile, keep the newest */
+    if ((o = ttw_find(c, key, key_len, hash, lex)) != NULL)
+    {
+        ttw_unlink(c, o);
+        delete_ttw_entry(c, o);
+    }
+    e->hnext = c->buckets[hash & (c->num_buckets - 1)];
+    c->buckets[hash & (c->num_buckets - 1)] = e;
+    ttw_push_front(c, e);
+    c->stats.entries++;
+    while (c->stats.entries > c->max_entries)
+    {
+        o = c->tail;
+        ttw_unlink(c, o);
+        delete_ttw_entry(c, o);
+        c->stats.evictions++;
+    }
+    ttw_unlock(c);
+
+    return words;
+}
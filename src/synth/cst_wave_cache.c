@@ -0,0 +1,687 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*      Content addressed cache of synthesized waveforms, in memory and  */
+/*      in a directory of mmapped files                                  */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Prompts in IVR and notification systems are synthesized over and    */
+/*  over.  The key is the voice name, the voice features that change     */
+/*  the audio and the trimmed text, so anything that would synthesize    */
+/*  the same samples finds them here.                                    */
+/*                                                                       */
+/*  The memory tier holds whole waves with LRU eviction under a byte     */
+/*  limit.  The disk tier, if a directory is given, keeps one file per   */
+/*  key named by its 64 bit hash; the file holds the full key so hash    */
+/*  collisions are just misses.  Files are written to a temporary name   */
+/*  and renamed, read through cst_mmap_file(), and evicted oldest first  */
+/*  under their own byte limit.  Files already in the directory are      */
+/*  picked up at start, oldest modification time first.                 */
+/*                                                                       */
+/*************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "cst_alloc.h"
+#include "cst_string.h"
+#include "cst_file.h"
+#include "cst_lexicon.h"
+#include "cst_synth.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+#ifdef HAVE_DIRENT_H
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+CST_VAL_REGISTER_TYPE_NODEL(wave_cache, cst_wave_cache);
+
+#define WAVE_CACHE_MAGIC "MIMICWC1"
+#define WAVE_CACHE_SUFFIX ".mwc"
+#define WAVE_CACHE_BUCKETS 1024
+
+/* Voice features that change the samples, text_* ones only change */
+/* how the text is read and the text is in the key already.  Voices  */
+/* loaded from files are told apart by where they came from, as the  */
+/* name alone may be the same for two of them.                       */
+static const char *const wave_cache_feats[] = {
+    "htsvoice_file",
+    "pathname",
+    "voxdir",
+    "duration_stretch",
+    "f0_shift",
+    "int_f0_target_mean",
+    "int_f0_target_stddev",
+    "target_f0_mean",
+    "target_f0_stddev",
+    "volume_db",
+    "postfiltering_coefficient",
+    "gv_weight_lf0",
+    "gv_weight_spectrum",
+    "add_half_tone",
+    "vu_threshold",
+    "join_type",
+    "resynth_type",
+    "variant",
+    NULL
+};
+
+typedef struct wave_cache_header_struct {
+    char magic[8];
+    int32_t key_len;
+    int32_t sample_rate;
+    int32_t num_channels;
+    int32_t num_samples;
+} wave_cache_header;
+
+typedef struct wc_entry_struct {
+    char *key;
+    uint64_t hash;
+    cst_wave *wave;
+    long bytes;
+    struct wc_entry_struct *hnext;
+    struct wc_entry_struct *prev, *next;        /* LRU, head is newest */
+} wc_entry;
+
+typedef struct wc_file_struct {
+    uint64_t hash;
+    long bytes;
+    unsigned long tick;         /* last use */
+    struct wc_file_struct *next;
+} wc_file;
+
+struct cst_wave_cache_struct {
+    long max_mem_bytes;
+    wc_entry **buckets;
+    wc_entry *head, *tail;
+
+    char *dir;                  /* NULL for memory only */
+    long max_disk_bytes;
+    wc_file *files;
+    unsigned long tick;
+    unsigned long tmp_serial;   /* for unique temporary file names */
+
+    cst_wave_cache_stats stats;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_t lock;
+#endif
+};
+
+static void wc_lock(cst_wave_cache *wc)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&wc->lock);
+#endif
+}
+
+static void wc_unlock(cst_wave_cache *wc)
+{
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_unlock(&wc->lock);
+#endif
+}
+
+static uint64_t wc_hash(const char *key)
+{
+    uint64_t h = 14695981039346656037ULL;
+
+    for (; *key; key++)
+        h = (h ^ (unsigned char) *key) * 1099511628211ULL;
+    return h;
+}
+
+static char *wc_path(const cst_wave_cache *wc, uint64_t hash,
+                     const char *suffix)
+{
+    char *path = cst_alloc(char, cst_strlen(wc->dir) + 40);
+
+    cst_sprintf(path, "%s/%016llx%s", wc->dir, (unsigned long long) hash,
+                suffix);
+    return path;
+}
+
+static long wc_file_bytes(int key_len, int num_samples)
+{
+    return sizeof(wave_cache_header) + ((key_len + 1) & ~1) +
+        (long) num_samples * sizeof(short);
+}
+
+/* Disk tier index */
+
+static wc_file *wc_find_file(cst_wave_cache *wc, uint64_t hash)
+{
+    wc_file *f;
+
+    for (f = wc->files; f; f = f->next)
+        if (f->hash == hash)
+            return f;
+    return NULL;
+}
+
+static void wc_add_file(cst_wave_cache *wc, uint64_t hash, long bytes,
+                        unsigned long tick)
+{
+    wc_file *f;
+
+    if ((f = wc_find_file(wc, hash)) != NULL)
+        wc->stats.disk_bytes -= f->bytes;
+    else
+    {
+        f = cst_alloc(wc_file, 1);
+        f->hash = hash;
+        f->next = wc->files;
+        wc->files = f;
+        wc->stats.disk_entries++;
+    }
+    f->bytes = bytes;
+    f->tick = tick;
+    wc->stats.disk_bytes += bytes;
+}
+
+static void wc_remove_file(cst_wave_cache *wc, wc_file *f)
+{
+    wc_file **p;
+    char *path;
+
+    for (p = &wc->files; *p != f; p = &(*p)->next);
+    *p = f->next;
+    path = wc_path(wc, f->hash, WAVE_CACHE_SUFFIX);
+    remove(path);
+    cst_free(path);
+    wc->stats.disk_bytes -= f->bytes;
+    wc->stats.disk_entries--;
+    cst_free(f);
+}
+
+static void wc_trim_disk(cst_wave_cache *wc)
+{
+    wc_file *f, *oldest;
+
+    while (wc->files && wc->stats.disk_bytes > wc->max_disk_bytes)
+    {
+        for (oldest = f = wc->files; f; f = f->next)
+            if (f->tick < oldest->tick)
+                oldest = f;
+        wc_remove_file(wc, oldest);
+        wc->stats.disk_evictions++;
+    }
+}
+
+#ifdef HAVE_DIRENT_H
+typedef struct wc_scan_struct {
+    uint64_t hash;
+    time_t mtime;
+    long bytes;
+} wc_scan;
+
+static int wc_scan_cmp(const void *a, const void *b)
+{
+    time_t ta = ((const wc_scan *) a)->mtime;
+    time_t tb = ((const wc_scan *) b)->mtime;
+
+    return (ta > tb) - (ta < tb);
+}
+#endif
+
+static void wc_scan_dir(cst_wave_cache *wc)
+{
+#ifdef HAVE_DIRENT_H
+    /* Index what an earlier run left, oldest first */
+    DIR *d;
+    struct dirent *de;
+    struct stat st;
+    wc_scan *found = NULL;
+    unsigned long long hash;
+    char *path;
+    int n = 0, max = 0, i;
+
+    if ((d = opendir(wc->dir)) == NULL)
+        return;
+    while ((de = readdir(d)) != NULL)
+    {
+        if (cst_strlen(de->d_name) != 16 + cst_strlen(WAVE_CACHE_SUFFIX) ||
+            !cst_streq(de->d_name + 16, WAVE_CACHE_SUFFIX) ||
+            sscanf(de->d_name, "%16llx", &hash) != 1)
+            continue;
+        path = wc_path(wc, hash, WAVE_CACHE_SUFFIX);
+        if (stat(path, &st) == 0 && S_ISREG(st.st_mode))
+        {
+            if (n == max)
+            {
+                max = max ? max * 2 : 64;
+                found = cst_realloc(found, wc_scan, max);
+            }
+            found[n].hash = hash;
+            found[n].mtime = st.st_mtime;
+            found[n].bytes = (long) st.st_size;
+            n++;
+        }
+        cst_free(path);
+    }
+    closedir(d);
+
+    if (n > 0)
+        qsort(found, n, sizeof(wc_scan), wc_scan_cmp);
+    for (i = 0; i < n; i++)
+        wc_add_file(wc, found[i].hash, found[i].bytes, ++wc->tick);
+    cst_free(found);
+    wc_trim_disk(wc);
+#else
+    (void) wc;
+#endif
+}
+
+/* Memory tier */
+
+static void wc_unlink(cst_wave_cache *wc, wc_entry *e)
+{
+    wc_entry **h;
+
+    for (h = &wc->buckets[e->hash % WAVE_CACHE_BUCKETS]; *h != e;
+         h = &(*h)->hnext);
+    *h = e->hnext;
+    if (e->prev)
+        e->prev->next = e->next;
+    else
+        wc->head = e->next;
+    if (e->next)
+        e->next->prev = e->prev;
+    else
+        wc->tail = e->prev;
+    wc->stats.mem_bytes -= e->bytes;
+    wc->stats.mem_entries--;
+}
+
+static void wc_link(cst_wave_cache *wc, wc_entry *e)
+{
+    e->hnext = wc->buckets[e->hash % WAVE_CACHE_BUCKETS];
+    wc->buckets[e->hash % WAVE_CACHE_BUCKETS] = e;
+    e->prev = NULL;
+    e->next = wc->head;
+    if (wc->head)
+        wc->head->prev = e;
+    else
+        wc->tail = e;
+    wc->head = e;
+    wc->stats.mem_bytes += e->bytes;
+    wc->stats.mem_entries++;
+}
+
+static void delete_wc_entry(wc_entry *e)
+{
+    delete_wave(e->wave);
+    cst_free(e->key);
+    cst_free(e);
+}
+
+static wc_entry *wc_find(cst_wave_cache *wc, const char *key, uint64_t hash)
+{
+    wc_entry *e;
+
+    for (e = wc->buckets[hash % WAVE_CACHE_BUCKETS]; e; e = e->hnext)
+        if (e->hash == hash && cst_streq(e->key, key))
+            return e;
+    return NULL;
+}
+
+static void wc_mem_put(cst_wave_cache *wc, const char *key, uint64_t hash,
+                       const cst_wave *w)
+{
+    wc_entry *e;
+    long bytes;
+
+    bytes = (long) w->num_samples * w->num_channels * sizeof(short) +
+        cst_strlen(key);
+    if (bytes > wc->max_mem_bytes)
+        return;
+    if ((e = wc_find(wc, key, hash)) != NULL)
+    {
+        wc_unlink(wc, e);
+        delete_wc_entry(e);
+    }
+    while (wc->tail && wc->stats.mem_bytes + bytes > wc->max_mem_bytes)
+    {
+        e = wc->tail;
+        wc_unlink(wc, e);
+        delete_wc_entry(e);
+        wc->stats.mem_evictions++;
+    }
+    e = cst_alloc(wc_entry, 1);
+    e->key = cst_strdup(key);
+    e->hash = hash;
+    e->wave = copy_wave(w);
+    e->bytes = bytes;
+    wc_link(wc, e);
+}
+
+/* Disk files */
+
+/* These only read wc->dir, so are called without the lock held */
+static cst_wave *wc_disk_get(const cst_wave_cache *wc, const char *key,
+                             uint64_t hash)
+{
+    wave_cache_header h;
+    cst_filemap *fmap;
+    cst_file fd;
+    cst_wave *w = NULL;
+    const char *mem;
+    char *path;
+    int key_len = cst_strlen(key);
+    long size;
+
+    /* The mapping is whole pages, the file may be shorter if it was */
+    /* cut off, and reading past its last page faults                */
+    path = wc_path(wc, hash, WAVE_CACHE_SUFFIX);
+    if (!cst_file_exists(path) ||
+        (fd = cst_fopen(path, CST_OPEN_READ | CST_OPEN_BINARY)) == NULL)
+    {
+        cst_free(path);
+        return NULL;
+    }
+    size = cst_filesize(fd);
+    cst_fclose(fd);
+    if (size < (long) sizeof(h) || (fmap = cst_mmap_file(path)) == NULL)
+    {
+        cst_free(path);
+        return NULL;
+    }
+    cst_free(path);
+
+    mem = (const char *) fmap->mem;
+    memmove(&h, mem, sizeof(h));
+    if (memcmp(h.magic, WAVE_CACHE_MAGIC, sizeof(h.magic)) == 0 &&
+        h.key_len == key_len && h.num_samples >= 0 &&
+        h.num_channels > 0 &&
+        wc_file_bytes(key_len, h.num_samples * h.num_channels)
+        <= size &&
+        memcmp(mem + sizeof(h), key, key_len) == 0)
+    {
+        w = new_wave();
+        cst_wave_resize(w, h.num_samples, h.num_channels);
+        w->sample_rate = h.sample_rate;
+        memmove(w->samples, mem + sizeof(h) + ((key_len + 1) & ~1),
+                (size_t) h.num_samples * h.num_channels * sizeof(short));
+    }
+    cst_munmap_file(fmap);
+
+    return w;
+}
+
+static long wc_disk_put(const cst_wave_cache *wc, const char *key,
+                        uint64_t hash, const cst_wave *w,
+                        unsigned long serial)
+{
+    /* Returns the file's size, or 0 if it wasn't written */
+    wave_cache_header h;
+    cst_file fd;
+    char *tmp, *path, pad = 0, suffix[64];
+    int key_len = cst_strlen(key), n;
+    long bytes;
+
+    n = w->num_samples * w->num_channels;
+    bytes = wc_file_bytes(key_len, n);
+    if (bytes > wc->max_disk_bytes)
+        return 0;
+
+    memset(&h, 0, sizeof(h));
+    memmove(h.magic, WAVE_CACHE_MAGIC, sizeof(h.magic));
+    h.key_len = key_len;
+    h.sample_rate = w->sample_rate;
+    h.num_channels = w->num_channels;
+    h.num_samples = w->num_samples;
+
+    /* Other processes may share the directory, so write then rename, */
+    /* through a name no other writer, here or elsewhere, will use    */
+#ifdef HAVE_UNISTD_H
+    cst_sprintf(suffix, ".%ld.%lu.tmp", (long) getpid(), serial);
+#else
+    cst_sprintf(suffix, ".%lu.tmp", serial);
+#endif
+    tmp = wc_path(wc, hash, suffix);
+    if ((fd = cst_fopen(tmp, CST_OPEN_WRITE | CST_OPEN_BINARY)) == NULL)
+    {
+        cst_free(tmp);
+        return 0;
+    }
+    if (cst_fwrite(fd, &h, sizeof(h), 1) != 1 ||
+        cst_fwrite(fd, key, 1, key_len) != key_len ||
+        ((key_len & 1) && cst_fwrite(fd, &pad, 1, 1) != 1) ||
+        cst_fwrite(fd, w->samples, sizeof(short), n) != n)
+    {
+        cst_fclose(fd);
+        remove(tmp);
+        cst_free(tmp);
+        return 0;
+    }
+    cst_fclose(fd);
+
+    path = wc_path(wc, hash, WAVE_CACHE_SUFFIX);
+    if (rename(tmp, path) != 0)
+    {
+        remove(tmp);
+        bytes = 0;
+    }
+    cst_free(path);
+    cst_free(tmp);
+
+    return bytes;
+}
+
+cst_wave_cache *new_wave_cache(long max_mem_bytes, const char *dir,
+                               long max_disk_bytes)
+{
+    cst_wave_cache *wc = cst_alloc(cst_wave_cache, 1);
+
+    wc->max_mem_bytes = max_mem_bytes;
+    wc->buckets = cst_alloc(wc_entry *, WAVE_CACHE_BUCKETS);
+    wc->max_disk_bytes = max_disk_bytes;
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_init(&wc->lock, NULL);
+#endif
+    if (dir)
+    {
+        wc->dir = cst_strdup(dir);
+        wc_scan_dir(wc);
+    }
+
+    return wc;
+}
+
+void delete_wave_cache(cst_wave_cache *wc)
+{
+    wc_entry *e, *en;
+    wc_file *f, *fn;
+
+    if (wc == NULL)
+        return;
+    for (e = wc->head; e; e = en)
+    {
+        en = e->next;
+        delete_wc_entry(e);
+    }
+    for (f = wc->files; f; f = fn)
+    {
+        fn = f->next;
+        cst_free(f);
+    }
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_destroy(&wc->lock);
+#endif
+    cst_free(wc->buckets);
+    cst_free(wc->dir);
+    cst_free(wc);
+}
+
+char *wave_cache_key(const cst_voice *v, const char *text)
+{
+    cst_val *parts = NULL;
+    const cst_val *fv, *p;
+    const cst_lexicon *lex;
+    char buff[64];
+    char *key, *k;
+    const char *s, *e;
+    int i, len;
+
+    parts = cons_val(string_val(v->name), parts);
+    for (i = 0; wave_cache_feats[i]; i++)
+    {
+        if (!feat_present(v->features, wave_cache_feats[i]))
+            continue;
+        fv = feat_val(v->features, wave_cache_feats[i]);
+        if (CST_VAL_TYPE(fv) == CST_VAL_TYPE_INT)
+            cst_sprintf(buff, "%d", val_int(fv));
+        else if (CST_VAL_TYPE(fv) == CST_VAL_TYPE_FLOAT)
+            cst_sprintf(buff, "%f", val_float(fv));
+        else if (CST_VAL_TYPE(fv) == CST_VAL_TYPE_STRING)
+        {
+            parts = cons_val(string_val(wave_cache_feats[i]), parts);
+            parts = cons_val(string_val(val_string(fv)), parts);
+            continue;
+        }
+        else
+            continue;
+        parts = cons_val(string_val(wave_cache_feats[i]), parts);
+        parts = cons_val(string_val(buff), parts);
+    }
+    /* Addenda loaded at run time change pronunciations */
+    if (feat_present(v->features, "lexicon"))
+    {
+        lex = val_lexicon(feat_val(v->features, "lexicon"));
+        cst_sprintf(buff, "%d", lex->addenda_generation);
+        parts = cons_val(string_val("addenda"), parts);
+        parts = cons_val(string_val(buff), parts);
+    }
+    /* Phrases spliced from the CG parameter cache may differ slightly */
+    if (feat_present(v->features, "cg_param_cache"))
+        parts = cons_val(string_val("cg_param_cache"), parts);
+    parts = val_reverse(parts);
+
+    for (len = cst_strlen(text) + 2, p = parts; p; p = val_cdr(p))
+        len += cst_strlen(val_string(val_car(p))) + 1;
+    key = k = cst_alloc(char, len);
+    for (p = parts; p; p = val_cdr(p))
+    {
+        for (s = val_string(val_car(p)); *s; s++)
+            *k++ = *s;
+        *k++ = '\n';
+    }
+    delete_val(parts);
+
+    /* The text trimmed and with \r\n as \n.  Inner whitespace is kept, */
+    /* text analysis treats a single space differently from others     */
+    for (s = text; *s && strchr(" \t\n\r", *s); s++);
+    for (e = s + cst_strlen(s); e > s && strchr(" \t\n\r", e[-1]); e--);
+    for (; s < e; s++)
+        if (s[0] != '\r' || s[1] != '\n')
+            *k++ = *s;
+    *k = '\0';
+
+    return key;
+}
+
+cst_wave *wave_cache_get(cst_wave_cache *wc, const char *key)
+{
+    uint64_t hash = wc_hash(key);
+    cst_wave *w = NULL;
+    wc_entry *e;
+    wc_file *f;
+
+    wc_lock(wc);
+    if ((e = wc_find(wc, key, hash)) != NULL)
+    {
+        wc_unlink(wc, e);
+        wc_link(wc, e);
+        w = copy_wave(e->wave);
+        wc->stats.mem_hits++;
+        if (wc->dir && (f = wc_find_file(wc, hash)) != NULL)
+            f->tick = ++wc->tick;
+        wc_unlock(wc);
+        return w;
+    }
+    wc_unlock(wc);
+
+    if (wc->dir)
+        w = wc_disk_get(wc, key, hash);
+
+    wc_lock(wc);
+    if (w != NULL)
+    {
+        wc->stats.disk_hits++;
+        wc_add_file(wc, hash,
+                    wc_file_bytes(cst_strlen(key),
+                                  w->num_samples * w->num_channels),
+                    ++wc->tick);
+        wc_mem_put(wc, key, hash, w);
+    }
+    else
+        wc->stats.misses++;
+    wc_unlock(wc);
+
+    return w;
+}
+
+void wave_cache_put(cst_wave_cache *wc, const char *key, const cst_wave *w)
+{
+    uint64_t hash = wc_hash(key);
+    unsigned long serial;
+    long bytes;
+
+    if (w == NULL || w->num_samples <= 0)
+        return;
+    wc_lock(wc);
+    wc_mem_put(wc, key, hash, w);
+    wc->stats.stores++;
+    serial = ++wc->tmp_serial;
+    wc_unlock(wc);
+
+    if (wc->dir && (bytes = wc_disk_put(wc, key, hash, w, serial)) > 0)
+    {
+        wc_lock(wc);
+        wc_add_file(wc, hash, bytes, ++wc->tick);
+        wc_trim_disk(wc);
+        wc_unlock(wc);
+    }
+}
+void wave_cache_get_stats(cst_wave_cache *wc, cst_wave_cache_stats *stats)
+{
+    wc_lock(wc);
+    *stats = wc->stats;
+    wc_unlock(wc);
+}
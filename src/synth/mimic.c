@@ -46,6 +46,10 @@
 #include "cst_cg.h"
 #include "cst_audio.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
 /* This is a global, which isn't ideal, this may change */
 /* It is set when mimic_set_voice_list() is called which happens in */
 /* mimic_main() */
@@ -53,6 +57,15 @@ cst_val *mimic_voice_list = 0;
 cst_lang mimic_lang_list[20];
 int mimic_lang_list_length = 0;
 
+static int output_wave(cst_utterance *u, const char *outtype, int append,
+                       cst_wave_writer *ww, float *dur);
+static int output_encoding(const cst_features *f, int *enc, int *rate);
+static cst_utterance *mimic_do_synth_cached(cst_utterance *u,
+                                            cst_voice *voice,
+                                            cst_uttfunc synth,
+                                            const char *text);
+static char *utt_token_text(cst_utterance *u);
+
 int mimic_init()
 {
     cst_regex_init();
@@ -64,6 +77,7 @@ int mimic_init()
 int mimic_exit()
 {
     mimic_audio_exit();
+    cst_rateconv_free_banks();
     return 0;
 }
 
@@ -185,21 +199,54 @@ int mimic_voice_add_lex_addenda(cst_voice *v, const cst_string *lexfile)
     if (lex->lex_addenda)
         delete_val(lex->lex_addenda);
     lex->lex_addenda = new_addenda;
+    lex->addenda_generation++;
 
     return 0;
 }
 
+static void mimic_do_synth_stats(cst_utterance *u, double start,
+                                 cst_audio_streaming_info *asi)
+{
+    const cst_wave *w;
+
+    cst_stats_add_time("utterance", cst_stats_now() - start);
+    cst_stats_add_count("utterances", 1);
+    if (!feat_present(u->features, "wave"))
+        return;                 /* e.g. alignment only */
+    w = utt_wave(u);
+    if (w->sample_rate > 0)
+        cst_stats_add_count("audio_seconds",
+                            (double) w->num_samples / w->sample_rate);
+    /* Without streaming the first chunk is the whole wave */
+    if (asi == NULL)
+        cst_stats_add_time("first_chunk", cst_stats_now() - start);
+    else if (asi->stats_start > 0.0)
+        audio_stream_stats_chunk(asi);
+}
+
 cst_utterance *mimic_do_synth(cst_utterance *u,
                               cst_voice *voice, cst_uttfunc synth)
 {
+    cst_audio_streaming_info *asi = NULL;
+    double start;
+
+    start = cst_stats_start();
     utt_init(u, voice);
+    if (cst_stats_enabled &&
+        feat_present(u->features, "streaming_info"))
+    {
+        asi = val_audio_streaming_info(feat_val(u->features,
+                                                "streaming_info"));
+        asi->stats_start = start;
+    }
     if ((*synth) (u) == NULL)
     {
         delete_utterance(u);
         return NULL;
     }
-    else
-        return u;
+    if (cst_stats_enabled)
+        mimic_do_synth_stats(u, start, asi);
+    return u;
 }
 
 cst_utterance *mimic_synth_text(const char *text, cst_voice *voice)
@@ -220,12 +267,163 @@ cst_utterance *mimic_synth_phones(const char *text, cst_voice *voice)
     return mimic_do_synth(u, voice, utt_synth_phones);
 }
 
+static cst_wave_cache *voice_wave_cache(const cst_voice *voice)
+{
+    if (feat_present(voice->features, "wave_cache"))
+        return val_wave_cache(feat_val(voice->features, "wave_cache"));
+    return NULL;
+}
+
+static int stream_cached_wave(cst_wave *w, cst_audio_streaming_info *asi)
+{
+    /* Feed a cached wave to the streaming callback as a vocoder would */
+    int start, chunk, rc = CST_AUDIO_STREAM_CONT;
+
+    audio_stream_stats_chunk(asi);
+    if (asi->sink)
+    {
+        asi->sink->sample_rate = w->sample_rate;
+        return audio_sink_write(asi->sink, w->samples, w->num_samples, 1);
+    }
+
+    chunk = (asi->min_buffsize > 0) ? asi->min_buffsize : w->num_samples;
+    for (start = 0; (rc == CST_AUDIO_STREAM_CONT) &&
+         (start + chunk < w->num_samples); start += chunk)
+        rc = (*asi->asc) (w, start, chunk, 0, asi);
+    if (rc == CST_AUDIO_STREAM_CONT)
+        rc = (*asi->asc) (w, start, w->num_samples - start, 1, asi);
+
+    return rc;
+}
+
+static cst_utterance *mimic_do_synth_cached(cst_utterance *u,
+                                            cst_voice *voice,
+                                            cst_uttfunc synth,
+                                            const char *text)
+{
+    /* mimic_do_synth() through the voice's wave cache, a hit only */
+    /* gets the wave, streamed if streaming is on                  */
+    cst_wave_cache *wc = voice_wave_cache(voice);
+    const cst_val *streaming_info_val;
+    cst_audio_streaming_info *asi;
+    cst_wave *w;
+    char *key;
+
+    /* Not when anything wants the relations, a hit doesn't have them */
+    if (wc == NULL || text == NULL ||
+        get_param_val(u->features, "post_synth_hook_func", NULL) ||
+        feat_present(voice->features, "post_synth_hook_func") ||
+        feat_present(voice->features, "utt_user_callback"))
+        return mimic_do_synth(u, voice, synth);
+
+    key = wave_cache_key(voice, text);
+    if ((w = wave_cache_get(wc, key)) != NULL)
+    {
+        cst_free(key);
+        if (cst_stats_enabled)
+            cst_stats_add_count("wave_cache_hits", 1);
+        utt_init(u, voice);
+        utt_set_wave(u, w);
+        streaming_info_val = get_param_val(u->features, "streaming_info",
+                                           NULL);
+        if (streaming_info_val)
+        {
+            asi = val_audio_streaming_info(streaming_info_val);
+            asi->utt = u;
+            if (stream_cached_wave(w, asi) == CST_AUDIO_STREAM_STOP)
+                utt_set_feat_int(u, "Interrupted", 1);
+        }
+        return u;
+    }
+
+    u = mimic_do_synth(u, voice, synth);
+    if (u && !feat_present(u->features, "Interrupted"))
+        wave_cache_put(wc, key, utt_wave(u));
+    cst_free(key);
+
+    return u;
+}
+
+static void token_text_append(char **text, int *len, int *max,
+                              const char *str)
+{
+    int l = cst_strlen(str);
+
+    if (*len + l + 1 > *max)
+    {
+        *max = (*len + l + 1) * 2;
+        *text = cst_realloc(*text, char, *max);
+    }
+    memmove(*text + *len, str, l + 1);
+    *len += l;
+}
+
+static char *utt_token_text(cst_utterance *u)
+{
+    /* The text the tokens were read from, near enough for a key, with */
+    /* any other token features, e.g. SSML prosody and breaks, as they */
+    /* change the wave too.  NULL if one can't go in the key.           */
+    static const char *const parts[] = {
+        "whitespace", "prepunctuation", "name", "punc", NULL
+    };
+    const cst_item *t;
+    const cst_featvalpair *fp;
+    char *text, num[64];
+    int i, len, max;
+
+    max = 64;
+    len = 0;
+    text = cst_alloc(char, max);
+    for (t = relation_head(utt_relation(u, "Token")); t; t = item_next(t))
+    {
+        for (i = 0; parts[i]; i++)
+            token_text_append(&text, &len, &max,
+                              get_param_string(item_feats(t), parts[i], ""));
+        for (fp = item_feats(t)->head; fp; fp = fp->next)
+        {
+            for (i = 0; parts[i] && !cst_streq(parts[i], fp->name); i++);
+            if (parts[i] || cst_streq(fp->name, "file_pos") ||
+                cst_streq(fp->name, "line_number"))
+                continue;
+            token_text_append(&text, &len, &max, "\001");
+            token_text_append(&text, &len, &max, fp->name);
+            token_text_append(&text, &len, &max, "=");
+            if (cst_val_consp(fp->val))
+            {
+                cst_free(text);
+                return NULL;
+            }
+            else if (CST_VAL_TYPE(fp->val) == CST_VAL_TYPE_STRING)
+                token_text_append(&text, &len, &max, val_string(fp->val));
+            else if (CST_VAL_TYPE(fp->val) == CST_VAL_TYPE_INT)
+            {
+                cst_sprintf(num, "%d", val_int(fp->val));
+                token_text_append(&text, &len, &max, num);
+            }
+            else if (CST_VAL_TYPE(fp->val) == CST_VAL_TYPE_FLOAT)
+            {
+                cst_sprintf(num, "%.9g", val_float(fp->val));
+                token_text_append(&text, &len, &max, num);
+            }
+            else
+            {
+                cst_free(text);
+                return NULL;
+            }
+        }
+    }
+
+    return text;
+}
+
 cst_wave *mimic_text_to_wave(const char *text, cst_voice *voice)
 {
     cst_utterance *u;
     cst_wave *w;
 
-    if ((u = mimic_synth_text(text, voice)) == NULL)
+    u = new_utterance();
+    utt_set_input_text(u, text);
+    if ((u = mimic_do_synth_cached(u, voice, utt_synth, text)) == NULL)
         return NULL;
 
     w = copy_wave(utt_wave(u));
@@ -233,6 +431,55 @@ cst_wave *mimic_text_to_wave(const char *text, cst_voice *voice)
     return w;
 }
 
+int mimic_wave_cache_warmup(cst_voice *voice, const char *listfile)
+{
+    /* Synthesize each line of listfile into the voice's wave cache */
+    cst_file fd;
+    cst_wave *w;
+    char *line, *s;
+    int c, len, max, n;
+
+    if (voice_wave_cache(voice) == NULL)
+    {
+        cst_errmsg("mimic_wave_cache_warmup: voice has no wave_cache\n");
+        return -EINVAL;
+    }
+    if ((fd = cst_fopen(listfile, CST_OPEN_READ)) == NULL)
+    {
+        cst_errmsg("mimic_wave_cache_warmup: can't open \"%s\"\n",
+                   listfile);
+        return -EIO;
+    }
+
+    max = 256;
+    line = cst_alloc(char, max);
+    for (n = 0, c = 0; c != EOF; )
+    {
+        for (len = 0; (c = cst_fgetc(fd)) != EOF && c != '\n'; len++)
+        {
+            if (len + 1 >= max)
+            {
+                max *= 2;
+                line = cst_realloc(line, char, max);
+            }
+            line[len] = c;
+        }
+        line[len] = '\0';
+        for (s = line; *s && strchr(" \t\r", *s); s++);
+        if (*s == '\0')
+            continue;
+        if ((w = mimic_text_to_wave(line, voice)) != NULL)
+        {
+            delete_wave(w);
+            n++;
+        }
+    }
+    cst_free(line);
+    cst_fclose(fd);
+
+    return n;
+}
+
 int mimic_file_to_speech(const char *filename, cst_voice *voice,
                          const char *outtype, float *dur)
 {
@@ -257,104 +504,392 @@ int mimic_file_to_speech(const char *filename, cst_voice *voice,
     return mimic_ts_to_speech(ts, voice, outtype, dur);
 }
 
-int mimic_ts_to_speech(cst_tokenstream *ts, cst_voice *voice,
-                       const char *outtype, float *dur)
-{
-    (void) dur;
-    int err = 0;
+/* Synthesis pipeline.  Utterances are cut from the tokens on the       */
+/* calling thread, synthesized by up to num_threads worker threads and   */
+/* output in order, again on the calling thread.  Tokens come from plain */
+/* text (mimic_ts_to_speech()) or from the ssml parser.  With no threads */
+/* (or when streaming, whose callbacks must stay in order) each          */
+/* utterance is synthesized and output as soon as it is cut.             */
+#define SYNTH_JOB_PENDING 0
+#define SYNTH_JOB_RUNNING 1
+#define SYNTH_JOB_DONE 2
+
+typedef struct synth_job_struct {
     cst_utterance *utt;
-    const char *token;
-    cst_item *t;
+    cst_voice *voice;
+    char *text;                 /* wave cache key text, or NULL */
+    int state;
+} synth_job;
+
+struct cst_synth_pipeline_struct {
+    cst_voice *voice;           /* for the utterance being built */
+    cst_breakfunc breakfunc;
+    cst_uttfunc utt_user_callback;
+    const char *outtype;
+    cst_wave_writer *ww;
+    cst_utterance *utt;         /* being built */
     cst_relation *tokrel;
-    float durs = 0;
     int num_tokens;
-    cst_wave *w;
-    cst_breakfunc breakfunc = default_utt_break;
-    cst_uttfunc utt_user_callback = 0;
-    int fp;
+    float durs;
+    int err;
+    int stopped;
+
+    /* Jobs in order, head is the next to output, next the next to */
+    /* synthesize and tail the next free slot (all mod num_jobs)    */
+    int num_threads;
+    synth_job *jobs;
+    int num_jobs;
+    int head, next, tail;
+#ifdef HAVE_PTHREAD_H
+    pthread_t *threads;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;       /* a job to synthesize, or closing */
+    pthread_cond_t done;        /* a job is synthesized */
+    int closing;
+#endif
+};
 
-    fp = get_param_int(voice->features, "file_start_position", 0);
-    if (fp > 0)
-        ts_set_stream_pos(ts, fp);
-    if (feat_present(voice->features, "utt_break"))
-        breakfunc = val_breakfunc(feat_val(voice->features, "utt_break"));
+static void synth_pipeline_output(cst_synth_pipeline *p, cst_utterance *u)
+{
+    float new_durs = 0;
+    int err;
 
-    if (feat_present(voice->features, "utt_user_callback"))
-        utt_user_callback =
-            val_uttfunc(feat_val(voice->features, "utt_user_callback"));
+    if (u == NULL)
+        return;
+    if (!p->stopped)
+    {
+        if (feat_present(u->features, "Interrupted"))
+            p->stopped = TRUE;
+        else if ((err = output_wave(u, p->outtype, TRUE, p->ww,
+                                    &new_durs)) < 0)
+        {
+            p->err = err;
+            p->stopped = TRUE;
+        }
+        else
+            p->durs += new_durs;
+    }
+    delete_utterance(u);
+}
+
+#ifdef HAVE_PTHREAD_H
+static void synth_pipeline_output_head(cst_synth_pipeline *p)
+{
+    /* called locked, waits for the oldest job */
+    synth_job *j = &p->jobs[p->head % p->num_jobs];
+    cst_utterance *u;
+
+    while (j->state != SYNTH_JOB_DONE)
+        pthread_cond_wait(&p->done, &p->lock);
+    u = j->utt;
+    j->utt = NULL;
+    p->head++;
 
-    /* If its a file to write to, create and save an empty wave file */
-    /* as we are going to incrementally append to it                 */
+    pthread_mutex_unlock(&p->lock);
+    synth_pipeline_output(p, u);
+    pthread_mutex_lock(&p->lock);
+}
+
+static void *synth_pipeline_worker(void *arg)
+{
+    cst_synth_pipeline *p = (cst_synth_pipeline *) arg;
+    synth_job *j;
+
+    pthread_mutex_lock(&p->lock);
+    while (1)
+    {
+        while (!p->closing && p->next == p->tail)
+            pthread_cond_wait(&p->ready, &p->lock);
+        if (p->next == p->tail)
+            break;
+        j = &p->jobs[p->next++ % p->num_jobs];
+        if (j->state != SYNTH_JOB_PENDING)
+            continue;
+        j->state = SYNTH_JOB_RUNNING;
+        pthread_mutex_unlock(&p->lock);
+
+        j->utt = mimic_do_synth_cached(j->utt, j->voice, utt_synth_tokens,
+                                       j->text);
+        cst_free(j->text);
+        j->text = NULL;
+
+        pthread_mutex_lock(&p->lock);
+        j->state = SYNTH_JOB_DONE;
+        pthread_cond_broadcast(&p->done);
+    }
+    pthread_mutex_unlock(&p->lock);
+
+    return NULL;
+}
+#endif
+
+static void synth_pipeline_submit(cst_synth_pipeline *p, cst_utterance *u,
+                                  char *text, int synthesized)
+{
+#ifdef HAVE_PTHREAD_H
+    synth_job *j;
+#endif
+
+    if (p->stopped)
+    {
+        delete_utterance(u);
+        cst_free(text);
+        return;
+    }
+    if (p->num_threads == 0)
+    {
+        if (!synthesized)
+            u = mimic_do_synth_cached(u, p->voice, utt_synth_tokens, text);
+        cst_free(text);
+        synth_pipeline_output(p, u);
+        return;
+    }
+
+#ifdef HAVE_PTHREAD_H
+    pthread_mutex_lock(&p->lock);
+    while (p->tail - p->head == p->num_jobs)
+        synth_pipeline_output_head(p);
+    j = &p->jobs[p->tail++ % p->num_jobs];
+    j->utt = u;
+    j->voice = p->voice;
+    j->text = text;
+    j->state = synthesized ? SYNTH_JOB_DONE : SYNTH_JOB_PENDING;
+    pthread_cond_signal(&p->ready);
+    /* and whatever is ready, without waiting */
+    while ((p->head < p->tail) &&
+           (p->jobs[p->head % p->num_jobs].state == SYNTH_JOB_DONE))
+        synth_pipeline_output_head(p);
+    pthread_mutex_unlock(&p->lock);
+#endif
+}
+
+cst_synth_pipeline *new_synth_pipeline(cst_voice *voice,
+                                       const char *outtype, int num_threads)
+{
+    cst_synth_pipeline *p;
+    int enc, rate, rv;
+
+    p = cst_alloc(cst_synth_pipeline, 1);
+    p->outtype = outtype;
+    synth_pipeline_set_voice(p, voice);
+
+    /* If its a file to write to, keep it open for all the utterances */
+    /* and set the header sizes once at the end                       */
     if (!cst_streq(outtype, "play") &&
         !cst_streq(outtype, "none") && !cst_streq(outtype, "stream"))
     {
-        w = new_wave();
-        if (cst_wave_resize(w, 0, 1) == 0)
+        if ((rv = output_encoding(voice->features, &enc, &rate)) < 0)
+        {
+            cst_free(p);
+            return NULL;
+        }
+        if (rv == 0)
+            p->ww = cst_wave_writer_open(outtype, CST_WAVE_ENC_LINEAR16, 0,
+                                         TRUE);
+        else
+            p->ww = cst_wave_writer_open(outtype, enc, rate, FALSE);
+        if (p->ww == NULL)
         {
-            cst_wave_set_sample_rate(w, 16000);
-            cst_wave_save_riff(w, outtype); /* an empty wave */
+            cst_free(p);
+            return NULL;
         }
+    }
+
+#ifdef HAVE_PTHREAD_H
+    if (cst_streq(outtype, "stream") ||
+        feat_present(voice->features, "streaming_info"))
+        num_threads = 0;
+    if (num_threads > 1)
+    {
+        p->num_jobs = 2 * num_threads;
+        p->jobs = cst_alloc(synth_job, p->num_jobs);
+        p->threads = cst_alloc(pthread_t, num_threads);
+        pthread_mutex_init(&p->lock, NULL);
+        pthread_cond_init(&p->ready, NULL);
+        pthread_cond_init(&p->done, NULL);
+        for (p->num_threads = 0; p->num_threads < num_threads;
+             p->num_threads++)
+            if (pthread_create(&p->threads[p->num_threads], NULL,
+                               synth_pipeline_worker, p) != 0)
+                break;
+    }
+#else
+    (void) num_threads;
+#endif
+
+    return p;
+}
+
+void synth_pipeline_set_voice(cst_synth_pipeline *p, cst_voice *voice)
+{
+    /* Takes effect from the next utterance */
+    p->voice = voice;
+    p->breakfunc = default_utt_break;
+    if (feat_present(voice->features, "utt_break"))
+        p->breakfunc = val_breakfunc(feat_val(voice->features, "utt_break"));
+    p->utt_user_callback = NULL;
+    if (feat_present(voice->features, "utt_user_callback"))
+        p->utt_user_callback =
+            val_uttfunc(feat_val(voice->features, "utt_user_callback"));
+}
+
+int synth_pipeline_break(cst_synth_pipeline *p)
+{
+    /* Ends the utterance being built, if there is one, and queues it */
+    cst_utterance *u = p->utt;
+    char *text = NULL;
+
+    if (u == NULL)
+        return p->stopped ? -1 : 0;
+    p->utt = NULL;
+    p->tokrel = NULL;
+    p->num_tokens = 0;
+
+    if (p->utt_user_callback)
+        u = (p->utt_user_callback) (u);
+    if (u == NULL)
+        p->stopped = TRUE;
+    else
+    {
+        /* Drawn here, in order, as workers finish in any order */
+        utt_set_feat_int(u, "noise_seed", rand() & 0x7fffffff);
+        if (voice_wave_cache(p->voice))
+            text = utt_token_text(u);
+        synth_pipeline_submit(p, u, text, FALSE);
+    }
+
+    return p->stopped ? -1 : 0;
+}
+
+cst_item *synth_pipeline_token(cst_synth_pipeline *p, cst_tokenstream *ts,
+                               const char *token)
+{
+    cst_item *t;
+
+    if ((p->num_tokens > 500) ||        /* need an upper bound */
+        (p->tokrel && relation_head(p->tokrel) &&
+         p->breakfunc(ts, token, p->tokrel)))
+        synth_pipeline_break(p);
+    if (p->stopped)
+        return NULL;
+
+    if (p->utt == NULL)
+    {
+        p->utt = new_utterance();
+        p->tokrel = utt_relation_create(p->utt, "Token");
+    }
+    p->num_tokens++;
+
+    t = relation_append(p->tokrel, NULL);
+    item_set_string(t, "name", token);
+    item_set_string(t, "whitespace", ts->whitespace);
+    item_set_string(t, "prepunctuation", ts->prepunctuation);
+    item_set_string(t, "punc", ts->postpunctuation);
+    /* Mark it at the beginning of the token */
+    item_set_int(t, "file_pos",
+                 /* as we are already on the next char */
+                 ts->file_pos - (1 + cst_strlen(token) +
+                                 cst_strlen(ts->prepunctuation) +
+                                 cst_strlen(ts->postpunctuation)));
+    item_set_int(t, "line_number", ts->line_number);
+
+    return t;
+}
+
+cst_item *synth_pipeline_last_token(cst_synth_pipeline *p)
+{
+    return p->tokrel ? relation_tail(p->tokrel) : NULL;
+}
+
+int synth_pipeline_wave(cst_synth_pipeline *p, cst_wave *w)
+{
+    /* Output w as an utterance of its own, after the tokens so far */
+    cst_utterance *u;
+
+    if (synth_pipeline_break(p) < 0)
+    {
         delete_wave(w);
+        return -1;
+    }
+    if ((u = utt_synth_wave(w, p->voice)) != NULL)
+    {
+        if (p->utt_user_callback)
+            u = (p->utt_user_callback) (u);
+        synth_pipeline_submit(p, u, NULL, TRUE);
     }
 
-    num_tokens = 0;
-    utt = new_utterance();
-    tokrel = utt_relation_create(utt, "Token");
-    while (!ts_eof(ts) || num_tokens > 0)
+    return p->stopped ? -1 : 0;
+}
+
+int synth_pipeline_close(cst_synth_pipeline *p, float *dur)
+{
+    /* Synthesizes and outputs what is left, returns 0 or -errno */
+    int err;
+
+    synth_pipeline_break(p);
+#ifdef HAVE_PTHREAD_H
+    if (p->jobs)
     {
-        token = ts_get(ts);
-        if ((cst_strlen(token) == 0) || (num_tokens > 500) ||   /* need an upper bound */
-            (relation_head(tokrel) && breakfunc(ts, token, tokrel)))
-        {
-            /* An end of utt, so synthesize it */
-            if (utt_user_callback)
-                utt = (utt_user_callback) (utt);
+        pthread_mutex_lock(&p->lock);
+        while (p->head < p->tail)
+            synth_pipeline_output_head(p);
+        p->closing = TRUE;
+        pthread_cond_broadcast(&p->ready);
+        pthread_mutex_unlock(&p->lock);
+        while (p->num_threads > 0)
+            pthread_join(p->threads[--p->num_threads], NULL);
+        pthread_cond_destroy(&p->done);
+        pthread_cond_destroy(&p->ready);
+        pthread_mutex_destroy(&p->lock);
+        cst_free(p->threads);
+        cst_free(p->jobs);
+    }
+#endif
 
-            if (utt)
-            {
-                float new_durs = 0;
-                utt = mimic_do_synth(utt, voice, utt_synth_tokens);
-                if (feat_present(utt->features, "Interrupted"))
-                {
-                    delete_utterance(utt);
-                    utt = NULL;
-                    break;
-                }
-                err = mimic_process_output(utt, outtype, TRUE, &new_durs);
-                if (err < 0)
-                    goto cleanup;
-                durs += new_durs;
-                delete_utterance(utt);
-                utt = NULL;
-            }
-            else
-                break;
+    err = p->err;
+    if (cst_wave_writer_close(p->ww) < 0 && err == 0)
+        err = -EIO;
+    if (dur)
+        *dur = p->durs;
+    cst_free(p);
+
+    return err;
+}
 
+int mimic_ts_to_speech(cst_tokenstream *ts, cst_voice *voice,
+                       const char *outtype, float *dur)
+{
+    cst_synth_pipeline *p;
+    const char *token;
+    int fp, err;
+
+    fp = get_param_int(voice->features, "file_start_position", 0);
+    if (fp > 0)
+        ts_set_stream_pos(ts, fp);
+
+    p = new_synth_pipeline(voice, outtype,
+                           get_param_int(voice->features, "synth_threads",
+                                         1));
+    if (p == NULL)
+    {
+        ts_close(ts);
+        return -EIO;
+    }
+
+    while (!ts_eof(ts))
+    {
+        token = ts_get(ts);
+        if (cst_strlen(token) == 0)
+        {
+            synth_pipeline_break(p);
             if (ts_eof(ts))
                 break;
-
-            utt = new_utterance();
-            tokrel = utt_relation_create(utt, "Token");
-            num_tokens = 0;
         }
-        num_tokens++;
-
-        t = relation_append(tokrel, NULL);
-        item_set_string(t, "name", token);
-        item_set_string(t, "whitespace", ts->whitespace);
-        item_set_string(t, "prepunctuation", ts->prepunctuation);
-        item_set_string(t, "punc", ts->postpunctuation);
-        /* Mark it at the beginning of the token */
-        item_set_int(t, "file_pos",
-                     /* as we are already on the next char */
-                     ts->file_pos - (1 + cst_strlen(token) +
-                     cst_strlen(ts->prepunctuation) +
-                     cst_strlen(ts->postpunctuation)));
-        item_set_int(t, "line_number", ts->line_number);
-    }
-  cleanup:
-    if (utt)
-        delete_utterance(utt);
+        if (synth_pipeline_token(p, ts, token) == NULL)
+            break;
+    }
+
+    err = synth_pipeline_close(p, dur);
     ts_close(ts);
     return err;
 }
@@ -371,7 +906,9 @@ int mimic_text_to_speech(const char *text, cst_voice *voice,
     else
     {
         cst_utterance *u;
-        u = mimic_synth_text(text, voice);
+        u = new_utterance();
+        utt_set_input_text(u, text);
+        u = mimic_do_synth_cached(u, voice, utt_synth, text);
         ret = mimic_process_output(u, outtype, FALSE, dur);
         delete_utterance(u);
     }
@@ -397,11 +934,32 @@ int mimic_phones_to_speech(const char *text, cst_voice *voice,
     return ret;
 }
 
-int mimic_process_output(cst_utterance *u, const char *outtype,
-                         int append, float *dur)
+static int output_encoding(const cst_features *f, int *enc, int *rate)
 {
-    /* Play or save (append) output to output file */
+    /* 1 and the encoding if output_encoding is set, 0 if it isn't */
+    const char *encoding;
+
+    encoding = get_param_string(f, "output_encoding", NULL);
+    if (encoding == NULL)
+        return 0;
+    *enc = cst_wave_encoding_id(encoding);
+    if (*enc < 0)
+    {
+        cst_errmsg("mimic: unknown output_encoding \"%s\"\n", encoding);
+        return -EINVAL;
+    }
+    /* Headerless telephony output, 8kHz unless asked otherwise */
+    *rate = get_param_int(f, "output_sample_rate",
+                          CST_WAVE_ENC_TELEPHONY_RATE);
+    return 1;
+}
+
+static int output_wave(cst_utterance *u, const char *outtype, int append,
+                       cst_wave_writer *ww, float *dur)
+{
+    /* Play or save (append) output to output file, or to ww if open */
     cst_wave *w;
+    int enc, rate, rv;
 
     if (!u)
         return 0.0;
@@ -422,7 +980,19 @@ int mimic_process_output(cst_utterance *u, const char *outtype,
     }
     else if (!cst_streq(outtype, "none"))
     {
-        if (append)
+        if (ww)
+        {
+            if (cst_wave_writer_write_wave(ww, w) < 0)
+                return -EIO;
+        }
+        else if ((rv = output_encoding(u->features, &enc, &rate)) != 0)
+        {
+            if (rv < 0)
+                return rv;
+            if (cst_wave_save_encoded(w, outtype, enc, rate, append) < 0)
+                return -EIO;
+        }
+        else if (append)
             cst_wave_append_riff(w, outtype);
         else
             cst_wave_save_riff(w, outtype);
@@ -431,6 +1001,12 @@ int mimic_process_output(cst_utterance *u, const char *outtype,
     return 0;
 }
 
+int mimic_process_output(cst_utterance *u, const char *outtype,
+                         int append, float *dur)
+{
+    return output_wave(u, outtype, append, NULL, dur);
+}
+
 int mimic_get_param_int(const cst_features *f, const char *name, int def)
 {
     return get_param_int(f, name, def);
@@ -0,0 +1,280 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*             Author:  mimic developers                                 */
+/*               Date:  October 2026                                     */
+/*************************************************************************/
+/*                                                                       */
+/*  Timing and counters for the synthesis stages                         */
+/*                                                                       */
+/*  A small fixed table of named timers and counters behind one lock.   */
+/*  Names are looked up by string, there are only a few dozen of them,  */
+/*  and nothing here runs unless stats are enabled.                      */
+/*                                                                       */
+/*************************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include "cst_alloc.h"
+#include "cst_string.h"
+#include "cst_stats.h"
+#include "config.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+#define STATS_LOCK() pthread_mutex_lock(&stats_lock)
+#define STATS_UNLOCK() pthread_mutex_unlock(&stats_lock)
+#else
+#define STATS_LOCK()
+#define STATS_UNLOCK()
+#endif
+
+int cst_stats_enabled = 0;
+
+static cst_stat stats[CST_STATS_MAX];
+static int num_stats = 0;
+
+void cst_stats_enable(int on)
+{
+    cst_stats_enabled = on;
+}
+
+double cst_stats_now(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+#endif
+    {
+        struct timeval tv;
+
+        gettimeofday(&tv, NULL);
+        return (double) tv.tv_sec + ((double) tv.tv_usec / 1000000.0);
+    }
+}
+
+static cst_stat *stat_find(const char *name, int type)
+{
+    /* called locked, adds name if it's new and there's room, a timer */
+    /* and a counter of the same name are kept apart                  */
+    int i;
+
+    for (i = 0; i < num_stats; i++)
+        if ((stats[i].type == type) && cst_streq(name, stats[i].name))
+            return &stats[i];
+    if (num_stats == CST_STATS_MAX)
+        return NULL;
+
+    memset(&stats[num_stats], 0, sizeof(cst_stat));
+    stats[num_stats].name = cst_strdup(name);
+    stats[num_stats].type = type;
+    return &stats[num_stats++];
+}
+
+static int stat_bucket(double seconds)
+{
+    double us = seconds * 1000000.0;
+    int b;
+
+    for (b = 0; (b < CST_STATS_BUCKETS - 1) && (us >= 1.0); b++)
+        us /= 2.0;
+    return b;
+}
+
+void cst_stats_add_time(const char *name, double seconds)
+{
+    cst_stat *s;
+
+    if (seconds < 0.0)
+        seconds = 0.0;
+    STATS_LOCK();
+    if ((s = stat_find(name, CST_STATS_TIMER)) != NULL)
+    {
+        if ((s->count == 0) || (seconds < s->min))
+            s->min = seconds;
+        if ((s->count == 0) || (seconds > s->max))
+            s->max = seconds;
+        s->count++;
+        s->total += seconds;
+        s->hist[stat_bucket(seconds)]++;
+    }
+    STATS_UNLOCK();
+}
+
+void cst_stats_add_count(const char *name, double value)
+{
+    cst_stat *s;
+
+    STATS_LOCK();
+    if ((s = stat_find(name, CST_STATS_COUNTER)) != NULL)
+    {
+        s->count++;
+        s->total += value;
+    }
+    STATS_UNLOCK();
+}
+
+void cst_stats_reset(void)
+{
+    int i;
+
+    STATS_LOCK();
+    for (i = 0; i < num_stats; i++)
+        cst_free((char *) stats[i].name);
+    num_stats = 0;
+    STATS_UNLOCK();
+}
+
+int cst_stats_num(void)
+{
+    int n;
+
+    STATS_LOCK();
+    n = num_stats;
+    STATS_UNLOCK();
+    return n;
+}
+
+int cst_stats_get(int n, cst_stat *st)
+{
+    /* st->name stays valid until cst_stats_reset() */
+    int rv = -1;
+
+    STATS_LOCK();
+    if ((n >= 0) && (n < num_stats))
+    {
+        *st = stats[n];
+        rv = 0;
+    }
+    STATS_UNLOCK();
+    return rv;
+}
+
+int cst_stats_find(const char *name, cst_stat *st)
+{
+    int i, rv = -1;
+
+    STATS_LOCK();
+    for (i = 0; i < num_stats; i++)
+        if (cst_streq(name, stats[i].name))
+        {
+            *st = stats[i];
+            rv = 0;
+            break;
+        }
+    STATS_UNLOCK();
+    return rv;
+}
+
+static double bucket_limit(int b)
+{
+    /* upper bound of bucket b in seconds */
+    return (double) (1UL << b) / 1000000.0;
+}
+
+double cst_stats_quantile(const cst_stat *st, double q)
+{
+    long n, want;
+    int b;
+
+    if (st->count == 0)
+        return 0.0;
+    want = (long) (q * st->count + 0.5);
+    if (want < 1)
+        want = 1;
+    for (n = 0, b = 0; b < CST_STATS_BUCKETS - 1; b++)
+        if ((n += st->hist[b]) >= want)
+            break;
+    /* never past what was actually seen */
+    return (bucket_limit(b) < st->max) ? bucket_limit(b) : st->max;
+}
+
+static void json_name(cst_file fd, const char *sep, const char *name)
+{
+    /* sep then name as a JSON string and its colon */
+    const char *c;
+
+    cst_fprintf(fd, "%s\n\"", sep);
+    for (c = name; *c; c++)
+    {
+        if ((*c == '"') || (*c == '\\'))
+            cst_fprintf(fd, "\\%c", *c);
+        else if ((unsigned char) *c < 0x20)
+            cst_fprintf(fd, "\\u%04x", (unsigned char) *c);
+        else
+            cst_fprintf(fd, "%c", *c);
+    }
+    cst_fprintf(fd, "\":");
+}
+
+int cst_stats_dump_json(cst_file fd)
+{
+    /* {"timers":{"name":{"count":..,"total":..,"p50":..,..,          */
+    /*  "histogram":[[upper_us,count],..]},..},"counters":{"name":..}} */
+    cst_stat s;
+    int i, b, n, first;
+
+    cst_fprintf(fd, "{\"timers\":{");
+    for (first = 1, i = 0; cst_stats_get(i, &s) == 0; i++)
+    {
+        if (s.type != CST_STATS_TIMER)
+            continue;
+        json_name(fd, first ? "" : ",", s.name);
+        cst_fprintf(fd, "{\"count\":%ld,\"total\":%.6f,"
+                    "\"mean\":%.6f,\"min\":%.6f,\"max\":%.6f,"
+                    "\"p50\":%.6f,\"p90\":%.6f,\"p99\":%.6f,"
+                    "\"histogram\":[",
+                    s.count, s.total,
+                    s.count ? s.total / s.count : 0.0, s.min, s.max,
+                    cst_stats_quantile(&s, 0.5),
+                    cst_stats_quantile(&s, 0.9),
+                    cst_stats_quantile(&s, 0.99));
+        for (n = 0, b = 0; b < CST_STATS_BUCKETS; b++)
+            if (s.hist[b])
+                cst_fprintf(fd, "%s[%lu,%ld]", n++ ? "," : "",
+                            1UL << b, s.hist[b]);
+        cst_fprintf(fd, "]}");
+        first = 0;
+    }
+    cst_fprintf(fd, "},\n\"counters\":{");
+    for (first = 1, i = 0; cst_stats_get(i, &s) == 0; i++)
+    {
+        if (s.type != CST_STATS_COUNTER)
+            continue;
+        json_name(fd, first ? "" : ",", s.name);
+        cst_fprintf(fd, "%.6f", s.total);
+        first = 0;
+    }
+    return (cst_fprintf(fd, "}}\n") < 0) ? -1 : 0;
+}
@@ -40,6 +40,7 @@
 #include "cst_tokenstream.h"
 #include "cst_alloc.h"
 #include <stdint.h>
+#include <limits.h>
 
 const cst_string *const cst_ts_default_whitespacesymbols = " \t\n\r";
 const cst_string *const cst_ts_default_singlecharsymbols = "(){}[]";
@@ -48,6 +49,7 @@ const cst_string *const cst_ts_default_postpunctuationsymbols =
     "\"'`.,:;!?(){}[]";
 
 #define TS_BUFFER_SIZE 256
+#define TS_READ_SIZE 65536
 
 static void ts_getc(cst_tokenstream *ts);
 static void internal_ts_getc(cst_tokenstream *ts);
@@ -518,6 +520,7 @@ static cst_tokenstream *new_tokenstream(const cst_string *whitespace,
 
 void delete_tokenstream(cst_tokenstream *ts)
 {
+    cst_free(ts->fd_buffer);
     cst_free(ts->whitespace);
     cst_free(ts->token);
     if (ts->tags)
@@ -639,6 +642,82 @@ void ts_close(cst_tokenstream *ts)
     delete_tokenstream(ts);
 }
 
+static int ts_fill_buffer(cst_tokenstream *ts)
+{
+    int size;
+
+    /* stdin may be interactive, where a full block could be a long wait */
+    size = (ts->fd == stdin) ? 1 : TS_READ_SIZE;
+    if (ts->fd_buffer == NULL)
+        ts->fd_buffer = cst_alloc(unsigned char, TS_READ_SIZE);
+    ts->fd_buffer_len = (int) cst_fread(ts->fd, ts->fd_buffer, 1, size);
+    if (ts->fd_buffer_len < 0)
+        ts->fd_buffer_len = 0;
+    ts->fd_buffer_pos = 0;
+
+    return ts->fd_buffer_len;
+}
+
+static inline int ts_fd_getc(cst_tokenstream *ts)
+{
+    if ((ts->fd_buffer_pos >= ts->fd_buffer_len) && (ts_fill_buffer(ts) == 0))
+        return EOF;
+    return ts->fd_buffer[ts->fd_buffer_pos++];
+}
+
+static int ts_copy_run(cst_tokenstream *ts, int cclass, int in_class,
+                       cst_string **buffer, int *buffer_max, int p)
+{
+    /* Copies the ASCII characters that follow current_char in the    */
+    /* input to buffer at p, while they are (in_class) or aren't in   */
+    /* cclass, and returns how many.  This is what the getc loops in  */
+    /* the callers would do, a block at a time.  The next getc picks  */
+    /* up at the character that ended the run.                        */
+    const unsigned char *s;
+    int avail, n, lines;
+    unsigned char c, cc;
+
+    if (ts->open || ts->utf8_explode_mode)
+        return 0;
+    if (ts->fd)
+    {
+        s = ts->fd_buffer + ts->fd_buffer_pos;
+        avail = ts->fd_buffer_len - ts->fd_buffer_pos;
+    }
+    else if (ts->string_buffer)
+    {
+        s = (const unsigned char *) ts->string_buffer + ts->file_pos;
+        avail = INT_MAX;        /* stops at the '\0' */
+    }
+    else
+        return 0;
+
+    for (n = 0, lines = 0; n < avail; n++)
+    {
+        c = s[n];
+        if ((c == '\0') || (c & 0x80))
+            break;
+        cc = ts->charclass[c];
+        if ((cc & TS_CHARCLASS_SINGLECHAR) ||
+            (((cc & cclass) != 0) != in_class))
+            break;
+        if (c == '\n')
+            lines++;
+    }
+    if (n == 0)
+        return 0;
+
+    while (p + n >= *buffer_max)
+        extend_buffer(buffer, buffer_max);
+    memcpy(&((*buffer)[p]), s, n);
+    if (ts->fd)
+        ts->fd_buffer_pos += n;
+    ts->file_pos += n;
+    ts->line_number += lines;
+
+    return n;
+}
+
 static void get_token_sub_part(cst_tokenstream *ts,
                                int charclass,
                                cst_string **buffer, int *buffer_max)
@@ -656,6 +735,8 @@ static void get_token_sub_part(cst_tokenstream *ts,
         if (p + curr_char_len >= *buffer_max)
             extend_buffer(buffer, buffer_max);
         memcpy(&((*buffer)[p]), ts->current_char, curr_char_len);
+        curr_char_len += ts_copy_run(ts, charclass, TRUE, buffer, buffer_max,
+                                     p + curr_char_len);
         ts_getc(ts);
     }
     (*buffer)[p] = '\0';
@@ -698,6 +779,8 @@ static void get_token_sub_part_2(cst_tokenstream *ts,
             (p == ts_utf8_sequence_length((*buffer)[0])))
             break;
 
+        curr_char_len += ts_copy_run(ts, endclass1, FALSE, buffer, buffer_max,
+                                     p + curr_char_len);
         ts_getc(ts);
     }
     (*buffer)[p] = '\0';
@@ -705,23 +788,22 @@ static void get_token_sub_part_2(cst_tokenstream *ts,
 
 static void get_token_postpunctuation(cst_tokenstream *ts)
 {
+    /* Walks back over the utf8 characters at the end of the token for */
+    /* as long as they are postpunctuation                             */
     int p, t, plast = 0;
-    const cst_string *one_cp;
+    cst_string one_cp[5];
 
     t = cst_strlen(ts->token);
     p = t;
-    cst_val *utf8lets;
-    const cst_val *v;
-    utf8lets = val_reverse(cst_utf8_explode(ts->token));
-    for (v = utf8lets; v; v = val_cdr(v))
+    while (p > 0)
     {
-        one_cp = val_string(val_car(v));
-        plast = cst_strlen(one_cp);
+        for (plast = 1; (plast < 4) && (p - plast > 0) &&
+             ((ts->token[p - plast] & 0xC0) == 0x80); plast++);
         p -= plast;
+        memcpy(one_cp, &ts->token[p], plast);
+        one_cp[plast] = '\0';
         if (ts_charclass(one_cp, TS_CHARCLASS_POSTPUNCT, ts) == 0)
-        {
             break;
-        }
     }
 
     if (t != p)
@@ -729,11 +811,11 @@ static void get_token_postpunctuation(cst_tokenstream *ts)
         if (t - p >= ts->postp_max)
             extend_buffer(&ts->postpunctuation, &ts->postp_max);
         /* Copy postpunctuation from token */
-        memmove(ts->postpunctuation, &ts->token[p + plast], (t - p));
+        memmove(ts->postpunctuation, &ts->token[p + plast], t - p - plast);
+        ts->postpunctuation[t - p - plast] = '\0';
         /* truncate token at postpunctuation */
         ts->token[p + plast] = '\0';
     }
-    delete_val(utf8lets);
 }
 
 int ts_eof(cst_tokenstream *ts)
@@ -744,6 +826,45 @@ int ts_eof(cst_tokenstream *ts)
         return FALSE;
 }
 
+int ts_read(void *buff, int size, int num, cst_tokenstream *ts)
+{
+    /* The block buffer is ahead of the file, so that goes first */
+    unsigned char *b = (unsigned char *) buff;
+    int bytes, n, r;
+
+    bytes = size * num;
+    n = 0;
+    if (ts->fd)
+    {
+        n = ts->fd_buffer_len - ts->fd_buffer_pos;
+        if (n > bytes)
+            n = bytes;
+        if (n > 0)
+        {
+            memmove(b, ts->fd_buffer + ts->fd_buffer_pos, n);
+            ts->fd_buffer_pos += n;
+        }
+        else
+            n = 0;
+        if (n < bytes)
+        {
+            r = (int) cst_fread(ts->fd, b + n, 1, bytes - n);
+            if (r > 0)
+                n += r;
+        }
+    }
+    else if (ts->string_buffer)
+    {
+        for (; n < bytes && ts->string_buffer[ts->file_pos + n]; n++)
+            b[n] = ts->string_buffer[ts->file_pos + n];
+    }
+    ts->file_pos += n;
+    if (n < bytes)
+        ts->eof_flag = TRUE;
+
+    return (size > 0) ? n / size : 0;
+}
+
 int ts_set_stream_pos(cst_tokenstream *ts, int pos)
 {
     /* Note this doesn't preserve line_pos */
@@ -752,6 +873,7 @@ int ts_set_stream_pos(cst_tokenstream *ts, int pos)
     if (ts->fd)
     {
         new_pos = (int) cst_fseek(ts->fd, (long) pos, CST_SEEK_ABSOLUTE);
+        ts->fd_buffer_len = ts->fd_buffer_pos = 0;
         if (new_pos == pos)
             ts->eof_flag = FALSE;
     }
@@ -797,6 +919,7 @@ int ts_get_stream_size(cst_tokenstream *ts)
         current_pos = ts->file_pos;
         end_pos = (int) cst_fseek(ts->fd, (long) 0, CST_SEEK_ENDREL);
         cst_fseek(ts->fd, (long) current_pos, CST_SEEK_ABSOLUTE);
+        ts->fd_buffer_len = ts->fd_buffer_pos = 0;
         return end_pos;
     }
     else if (ts->string_buffer)
@@ -822,7 +945,7 @@ static void internal_ts_getc(cst_tokenstream *ts)
     int cur_char_len, i;
     if (ts->fd)
     {
-        gotchar = cst_fgetc(ts->fd);
+        gotchar = ts_fd_getc(ts);
         if (gotchar == EOF)
         {
             ts->eof_flag = TRUE;
@@ -842,8 +965,8 @@ static void internal_ts_getc(cst_tokenstream *ts)
         }
         for (i = 1; i < cur_char_len; i++)
         {
-            gotchar = cst_fgetc(ts->fd);
-            if (gotchar == -1)
+            gotchar = ts_fd_getc(ts);
+            if (gotchar == EOF)
             {
                 ts->eof_flag = TRUE;
                 cst_errmsg
@@ -936,21 +1059,15 @@ const cst_string *ts_get_quoted_token(cst_tokenstream *ts,
     if (ts->current_char[0] == quote)
     {                           /* go until quote */
         ts_getc(ts);
-        for (p = 0; ((!ts_eof(ts)) && (ts->current_char[0] != quote));)
+        for (p = 0; ((!ts_eof(ts)) && (ts->current_char[0] != quote));
+             ts_getc(ts))
         {
-            if (p >= ts->token_max)
+            /* the character after escape is taken as it is */
+            if (ts->current_char[0] == escape)
+                ts_getc(ts);
+            if (p + 5 >= ts->token_max)
                 extend_buffer(&ts->token, &ts->token_max);
             strcpy(&(ts->token[p]), ts->current_char);
-            ts_getc(ts);
-            if (ts->current_char[0] == escape)
-            {
-                ts_get(ts);
-                if (p >= ts->token_max)
-                    extend_buffer(&ts->token, &ts->token_max);
-                memcpy(&(ts->token[p]), ts->current_char,
-                       strlen(ts->current_char));
-                ts_get(ts);
-            }
             p += strlen(ts->current_char);
         }
         ts->token[p] = '\0';
@@ -43,14 +43,237 @@
 #include "cst_string.h"
 #include "cst_tokenstream.h"
 
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#if !defined(__STDC_NO_ATOMICS__)
+#define CST_VAL_INTERN_ATOMIC
+#include <stdatomic.h>
+#endif
+#endif
+
+/* Cells come from per-thread free lists cut from slabs rather than one */
+/* cst_alloc each.  A list that grows past two batches gives a batch to */
+/* the shared depot, so cells freed on another thread than the one that */
+/* made them (the caller of a synthesis pipeline deletes what workers   */
+/* built) get reused.  Slabs are never given back.  Define              */
+/* CST_NO_VAL_POOL to cst_alloc each cell, for hunting leaks.           */
+#define CST_VAL_POOL_BATCH 256
+#define CST_VAL_POOL_SLAB 1024
+
+/* Short strings are interned: string_val() returns the same immortal  */
+/* val for each, phone names, stress, pos and the like.  The table is  */
+/* bounded, once it's full strings are copied as before.               */
+#define CST_VAL_INTERN_SIZE 4096        /* a power of two */
+#define CST_VAL_INTERN_MAX 3072
+#define CST_VAL_INTERN_MAXLEN 15
+
+#ifndef CST_NO_VAL_POOL
+typedef struct val_pool_struct {
+    cst_val *cells;             /* linked through their cdr */
+    int num_cells;              /* about */
+} val_pool;
+
+/* Batches are linked through the car of their first cell, slabs */
+/* through the car of their first cell, which is never handed out */
+static cst_val *val_depot = NULL;
+static cst_val *val_slabs = NULL;
+
+#ifdef HAVE_PTHREAD_H
+static pthread_mutex_t val_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t val_pool_key;
+static pthread_once_t val_pool_once = PTHREAD_ONCE_INIT;
+#define val_lock() pthread_mutex_lock(&val_mutex)
+#define val_unlock() pthread_mutex_unlock(&val_mutex)
+#else
+static val_pool val_the_pool;
+#define val_lock()
+#define val_unlock()
+#endif
+
+static void val_depot_put(cst_val *batch)
+{
+    val_lock();
+    CST_VAL_CAR(batch) = val_depot;
+    val_depot = batch;
+    val_unlock();
+}
+
+static cst_val *val_depot_get(void)
+{
+    cst_val *batch, *slab;
+    int i;
+
+    val_lock();
+    if (val_depot)
+    {
+        batch = val_depot;
+        val_depot = CST_VAL_CAR(batch);
+    }
+    else
+    {
+        slab = cst_alloc(cst_val, CST_VAL_POOL_SLAB);
+        CST_VAL_CAR(slab) = val_slabs;
+        val_slabs = slab;
+        for (i = 1; i < CST_VAL_POOL_SLAB - 1; i++)
+            CST_VAL_CDR(&slab[i]) = &slab[i + 1];
+        batch = &slab[1];
+    }
+    val_unlock();
+
+    return batch;
+}
+
+#ifdef HAVE_PTHREAD_H
+static void val_pool_thread_exit(void *p)
+{
+    val_pool *pool = (val_pool *) p;
+
+    if (pool->cells)
+        val_depot_put(pool->cells);
+    cst_free(pool);
+}
+
+static void val_pool_init(void)
+{
+    pthread_key_create(&val_pool_key, val_pool_thread_exit);
+}
+
+static val_pool *val_pool_get(void)
+{
+    val_pool *pool;
+
+    pthread_once(&val_pool_once, val_pool_init);
+    if ((pool = pthread_getspecific(val_pool_key)) == NULL)
+    {
+        pool = cst_alloc(val_pool, 1);
+        pthread_setspecific(val_pool_key, pool);
+    }
+    return pool;
+}
+#else
+#define val_pool_get() (&val_the_pool)
+#endif
+
+static cst_val *new_val()
+{
+    val_pool *pool = val_pool_get();
+    cst_val *v;
+
+    if (pool->cells == NULL)
+    {
+        pool->cells = val_depot_get();
+        pool->num_cells = CST_VAL_POOL_BATCH;
+    }
+    v = pool->cells;
+    pool->cells = CST_VAL_CDR(v);
+    if (pool->num_cells > 0)
+        pool->num_cells--;
+    memset(v, 0, sizeof(cst_val));
+
+    return v;
+}
+
+static void free_val(cst_val *v)
+{
+    val_pool *pool = val_pool_get();
+    cst_val *last;
+    int i;
+
+    CST_VAL_CDR(v) = pool->cells;
+    pool->cells = v;
+    if (++pool->num_cells >= 2 * CST_VAL_POOL_BATCH)
+    {
+        for (last = v, i = 1; i < CST_VAL_POOL_BATCH && CST_VAL_CDR(last);
+             i++)
+            last = CST_VAL_CDR(last);
+        pool->cells = CST_VAL_CDR(last);
+        pool->num_cells = pool->cells ? pool->num_cells - i : 0;
+        CST_VAL_CDR(last) = NULL;
+        val_depot_put(v);
+    }
+}
+
+#ifdef CST_VAL_INTERN_ATOMIC
+static _Atomic(cst_val *) val_interned[CST_VAL_INTERN_SIZE];
+#define val_intern_load(n) \
+    atomic_load_explicit(&val_interned[n], memory_order_acquire)
+#define val_intern_store(n, v) \
+    atomic_store_explicit(&val_interned[n], v, memory_order_release)
+#else
+static cst_val *val_interned[CST_VAL_INTERN_SIZE];
+#define val_intern_load(n) (val_interned[n])
+#define val_intern_store(n, v) (val_interned[n] = (v))
+#endif
+static int val_num_interned = 0;
+
+static cst_val *val_intern_find(const char *s, unsigned int h, int add)
+{
+    cst_val *v;
+    int i;
+
+    for (i = 0; i < CST_VAL_INTERN_SIZE; i++)
+    {
+        h &= CST_VAL_INTERN_SIZE - 1;
+        if ((v = val_intern_load(h)) == NULL)
+            break;
+        if (cst_streq(s, CST_VAL_STRING(v)))
+            return v;
+        h++;
+    }
+    if (!add || (val_num_interned >= CST_VAL_INTERN_MAX))
+        return NULL;
+
+    /* Never deleted, as the consts in the text segment */
+    v = cst_alloc(cst_val, 1);
+    CST_VAL_TYPE(v) = CST_VAL_TYPE_STRING;
+    CST_VAL_REFCOUNT(v) = -1;
+    CST_VAL_STRING_LVAL(v) = cst_strdup(s);
+    val_intern_store(h, v);
+    val_num_interned++;
+
+    return v;
+}
+
+static cst_val *val_intern(const char *s)
+{
+    unsigned int h = 2166136261u;       /* FNV-1a */
+    const unsigned char *c;
+    cst_val *v;
+
+    for (c = (const unsigned char *) s; *c; c++)
+    {
+        if (c - (const unsigned char *) s >= CST_VAL_INTERN_MAXLEN)
+            return NULL;
+        h = (h ^ *c) * 16777619u;
+    }
+
+#ifdef CST_VAL_INTERN_ATOMIC
+    if ((v = val_intern_find(s, h, FALSE)) != NULL)
+        return v;
+#endif
+    val_lock();
+    v = val_intern_find(s, h, TRUE);
+    val_unlock();
+
+    return v;
+}
+#else
 static cst_val *new_val()
 {
     return cst_alloc(struct cst_val_struct, 1);
 }
 
+#define free_val(v) cst_free(v)
+#define val_intern(s) NULL
+#endif
+
 cst_val *int_val(int i)
 {
-    cst_val *v = new_val();
+    cst_val *v;
+
+    if ((i >= CST_VAL_SMALL_INT_MIN) && (i <= CST_VAL_SMALL_INT_MAX))
+        return CST_VAL_SMALL_INT(i);
+    v = new_val();
     CST_VAL_TYPE(v) = CST_VAL_TYPE_INT;
     CST_VAL_INT(v) = i;
     return v;
@@ -66,7 +289,11 @@ cst_val *float_val(float f)
 
 cst_val *string_val(const char *s)
 {
-    cst_val *v = new_val();
+    cst_val *v;
+
+    if (s && ((v = val_intern(s)) != NULL))
+        return v;
+    v = new_val();
     CST_VAL_TYPE(v) = CST_VAL_TYPE_STRING;
     /* would be nice to note if this is a deletable string or not */
     CST_VAL_STRING_LVAL(v) = cst_strdup(s);
@@ -98,7 +325,7 @@ void delete_val_list(cst_val *v)
         if (cst_val_consp(v))
         {
             delete_val_list(CST_VAL_CDR(v));
-            cst_free(v);
+            free_val(v);
         }
         else
             delete_val(v);
@@ -113,7 +340,7 @@ void delete_val(cst_val *v)
         {
             delete_val(CST_VAL_CAR(v));
             delete_val(CST_VAL_CDR(v));
-            cst_free(v);
+            free_val(v);
         }
         else if (val_dec_refcount(v) == 0)
         {
@@ -125,7 +352,7 @@ void delete_val(cst_val *v)
                     (cst_val_defs[CST_VAL_TYPE(v) / 2].delete_function)
                         (CST_VAL_VOID(v));
             }
-            cst_free(v);
+            free_val(v);
         }
     }
 }
@@ -159,6 +159,18 @@ const cst_val *val_int_n(int n)
         return val_int_const[val_int_const_max - 1];
 }
 
+#define SI1(n) CST_CONST_VAL_INT_INIT(n)
+#define SI4(n) SI1(n), SI1((n) + 1), SI1((n) + 2), SI1((n) + 3)
+#define SI16(n) SI4(n), SI4((n) + 4), SI4((n) + 8), SI4((n) + 12)
+#define SI64(n) SI16(n), SI16((n) + 16), SI16((n) + 32), SI16((n) + 48)
+#define SI256(n) SI64(n), SI64((n) + 64), SI64((n) + 128), SI64((n) + 192)
+
+/* CST_VAL_SMALL_INT_MIN to CST_VAL_SMALL_INT_MAX */
+const cst_val_small_int cst_val_small_ints[] = {
+    SI64(-128), SI64(-64),
+    SI256(0), SI256(256), SI256(512), SI256(768)
+};
+
 /* carts are pretty confused about strings/ints, and some features */
 /* are actually used as floats and as int/strings                  */
 const cst_val *val_string_n(int n)
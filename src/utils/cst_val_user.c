@@ -67,6 +67,8 @@ CST_VAL_REG_TD_TYPE(cg_db, cst_cg_db, 49);
 CST_VAL_REG_TD_TYPE(voice, cst_voice, 51);
 CST_VAL_REG_TD_TYPE(audio_streaming_info, cst_audio_streaming_info, 53);
 CST_VAL_REG_TD_TYPE(flitehtsengine, Flite_HTS_Engine, 55);
+CST_VAL_REG_TD_TYPE_NODEL(wave_cache, cst_wave_cache, 57);
+CST_VAL_REG_TD_TYPE_NODEL(cg_param_cache, cst_cg_param_cache, 59);
 const cst_val_def cst_val_defs[] = {
     /* These ones are never called */
     {"int", NULL},         /* 1 INT */
@@ -98,5 +100,7 @@ const cst_val_def cst_val_defs[] = {
     {"voice", val_delete_voice},   /* 51 cst_voice */
     {"audio_streaming_info", val_delete_audio_streaming_info},     /* 53 asi */
     {"flitehtsengine", val_delete_flitehtsengine},     /* 55 flitehtsengine */
+    {"wave_cache", val_delete_wave_cache},     /* 57 wave_cache */
+    {"cg_param_cache", val_delete_cg_param_cache},     /* 59 cg_param_cache */
     {NULL, NULL}           /* NULLs at end of list */
 };
@@ -258,6 +258,7 @@ cst_wave *lpc_resynth_fixedpoint(cst_lpcres *lpcres)
         }
         if (lpcres->asi && (r - stream_mark > lpcres->asi->min_buffsize))
         {
+            audio_stream_stats_chunk(lpcres->asi);
             rc = (*lpcres->asi->asc) (w, stream_mark, r - stream_mark, 0,
                                       lpcres->asi);
             stream_mark = r;
@@ -265,7 +266,10 @@ cst_wave *lpc_resynth_fixedpoint(cst_lpcres *lpcres)
     }
 
     if ((lpcres->asi) && (rc == CST_AUDIO_STREAM_CONT))
+    {
+        audio_stream_stats_chunk(lpcres->asi);
         (*lpcres->asi->asc) (w, stream_mark, r - stream_mark, 1, lpcres->asi);
+    }
 
     cst_free(outbuf);
     cst_free(lpccoefs);
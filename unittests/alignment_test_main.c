@@ -0,0 +1,225 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Alignment output tests: json and MALN records for each line of a     */
+/*  batch of files, against the segments of the same text                */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "mimic.h"
+
+#include "cutest.h"
+
+#ifndef HTS_VOICE
+  #define HTS_VOICE "../voices/cmu_us_slt_hts.htsvoice"
+#endif
+
+cst_voice *register_cmu_us_slt_hts(const char *voxdir);
+void unregister_cmu_us_slt_hts(cst_voice *vox);
+
+#define TEST_NUM_FILES 3
+
+/* Line 2 is empty, so there is no record for it */
+static const char *const test_lines[] = {
+    "Hello world.", "", "Three \"quoted\" words, and a pause.", NULL
+};
+
+static const char *const test_files[TEST_NUM_FILES] = {
+    "alignment_test_1.txt", "alignment_test_2.txt", "alignment_test_3.txt"
+};
+
+static cst_voice *test_voice(void)
+{
+    cst_voice *v;
+
+    mimic_init();
+    v = register_cmu_us_slt_hts(NULL);
+    feat_set_string(v->features, "htsvoice_file", HTS_VOICE);
+    return v;
+}
+
+static void write_inputs(void)
+{
+    FILE *fd;
+    int i, j;
+
+    for (i = 0; i < TEST_NUM_FILES; i++)
+    {
+        fd = fopen(test_files[i], "w");
+        for (j = 0; test_lines[j]; j++)
+            fprintf(fd, "%s\n", test_lines[j]);
+        fclose(fd);
+    }
+}
+
+static void remove_files(const char *ext)
+{
+    char name[64];
+    int i;
+
+    for (i = 0; i < TEST_NUM_FILES; i++)
+    {
+        cst_sprintf(name, "%s%s", test_files[i], ext);
+        remove(name);
+    }
+}
+
+/* The record for a line, as documented in cst_alignment.c */
+static void expected_json(cst_voice *v, int line, char *buf)
+{
+    cst_utterance *u = mimic_text_to_alignment(test_lines[line - 1], v);
+    const cst_item *s;
+    float start = 0.0, end;
+
+    buf += cst_sprintf(buf, "{\"line\":%d,\"phones\":[", line);
+    for (s = relation_head(utt_relation(u, "Segment")); s; s = item_next(s))
+    {
+        end = item_feat_float(s, "end");
+        buf += cst_sprintf(buf, "%s[\"%s\",%.3f,%.3f]", item_prev(s) ? "," : "",
+                           item_feat_string(s, "name"), start, end);
+        start = end;
+    }
+    cst_sprintf(buf, "]}\n");
+    delete_utterance(u);
+}
+
+void test_json(void)
+{
+    cst_voice *v = test_voice();
+    static char want[8192], got[8192];
+    char name[64];
+    FILE *fd;
+    int i;
+
+    write_inputs();
+    TEST_CHECK(mimic_files_to_alignments(test_files, TEST_NUM_FILES, v,
+                                         MIMIC_ALIGN_JSON, 2) == 0);
+    for (i = 0; i < TEST_NUM_FILES; i++)
+    {
+        cst_sprintf(name, "%s.align.json", test_files[i]);
+        fd = fopen(name, "rb");
+        TEST_CHECK_(fd != NULL, "%s", name);
+        if (fd == NULL)
+            continue;
+        expected_json(v, 1, want);
+        TEST_CHECK(fgets(got, sizeof(got), fd) != NULL);
+        TEST_CHECK_(cst_streq(got, want), "got %s", got);
+        TEST_CHECK(strstr(got, "[\"pau\",0.000,") != NULL);
+        expected_json(v, 3, want);
+        TEST_CHECK(fgets(got, sizeof(got), fd) != NULL);
+        TEST_CHECK_(cst_streq(got, want), "got %s", got);
+        TEST_CHECK(fgets(got, sizeof(got), fd) == NULL);
+        fclose(fd);
+    }
+    remove_files(".align.json");
+    remove_files("");
+    unregister_cmu_us_slt_hts(v);
+}
+
+static unsigned int get_u32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24);
+}
+
+/* Checks the record at p against the segments of the line's text, */
+/* returns where the next one starts                                */
+static const unsigned char *check_binary(cst_voice *v, int line,
+                                         const unsigned char *p)
+{
+    cst_utterance *u = mimic_text_to_alignment(test_lines[line - 1], v);
+    const cst_item *s;
+    unsigned int end, last = 0;
+    int n, len;
+
+    TEST_CHECK(get_u32(p) == (unsigned int) line);
+    n = get_u32(p + 4);
+    p += 8;
+    for (s = relation_head(utt_relation(u, "Segment")); s && n > 0;
+         s = item_next(s), n--)
+    {
+        len = *p++;
+        TEST_CHECK_(len == cst_strlen(item_feat_string(s, "name")) &&
+                    memcmp(p, item_feat_string(s, "name"), len) == 0,
+                    "line %d phone %.*s", line, len, (const char *) p);
+        p += len;
+        end = get_u32(p);
+        p += 4;
+        TEST_CHECK(end >= last);
+        TEST_CHECK_(fabs(end - item_feat_float(s, "end") * 1000000.0) <= 1,
+                    "line %d end %u", line, end);
+        last = end;
+    }
+    TEST_CHECK(s == NULL && n == 0);
+    delete_utterance(u);
+    return p;
+}
+
+void test_binary(void)
+{
+    cst_voice *v = test_voice();
+    static unsigned char buf[8192];
+    const unsigned char *p;
+    char name[64];
+    FILE *fd;
+    int i, size;
+
+    write_inputs();
+    TEST_CHECK(mimic_files_to_alignments(test_files, TEST_NUM_FILES, v,
+                                         MIMIC_ALIGN_BINARY, 2) == 0);
+    for (i = 0; i < TEST_NUM_FILES; i++)
+    {
+        cst_sprintf(name, "%s.align", test_files[i]);
+        fd = fopen(name, "rb");
+        TEST_CHECK_(fd != NULL, "%s", name);
+        if (fd == NULL)
+            continue;
+        size = fread(buf, 1, sizeof(buf), fd);
+        fclose(fd);
+        TEST_CHECK(size > 8 && memcmp(buf, "MALN", 4) == 0);
+        TEST_CHECK(get_u32(buf + 4) == 1);
+        p = check_binary(v, 1, buf + 8);
+        p = check_binary(v, 3, p);
+        TEST_CHECK(p == buf + size);
+    }
+    remove_files(".align");
+    remove_files("");
+    unregister_cmu_us_slt_hts(v);
+}
+
+TEST_LIST =
+{
+    {"json alignments", test_json},
+    {"binary alignments", test_binary},
+    {0}
+};
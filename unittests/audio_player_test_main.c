@@ -0,0 +1,129 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Buffered player tests: the device gets back exactly what was         */
+/*  written, in whole frames, however often the ring wraps              */
+/*                                                                       */
+/*************************************************************************/
+#include <string.h>
+#include "cutest.h"
+
+/* The player plays into this file's device rather than a real one */
+#define mimic_audio_open test_audio_open
+#define mimic_audio_close test_audio_close
+#define mimic_audio_write test_audio_write
+#define mimic_audio_flush test_audio_flush
+#include "../src/audio/au_player.c"
+
+#define TEST_CHANNELS 3         /* 6 byte frames, not a power of two */
+#define TEST_FRAME_BYTES (TEST_CHANNELS * 2)
+#define TEST_BYTES (TEST_FRAME_BYTES * 50000)
+
+static unsigned char played[TEST_BYTES];
+static int played_bytes = 0;
+static int split_frames = 0;
+
+cst_audiodev *test_audio_open(int sps, int channels, cst_audiofmt fmt)
+{
+    cst_audiodev *ad = cst_alloc(cst_audiodev, 1);
+
+    ad->sps = ad->real_sps = sps;
+    ad->channels = ad->real_channels = channels;
+    ad->fmt = ad->real_fmt = fmt;
+    return ad;
+}
+
+int test_audio_close(cst_audiodev *ad)
+{
+    cst_free(ad);
+    return 0;
+}
+
+int test_audio_write(cst_audiodev *ad, void *buff, int num_bytes)
+{
+    if (num_bytes % TEST_FRAME_BYTES)
+        split_frames++;
+    if (played_bytes + num_bytes <= TEST_BYTES)
+        memmove(played + played_bytes, buff, num_bytes);
+    played_bytes += num_bytes;
+    return num_bytes;
+}
+
+int test_audio_flush(cst_audiodev *ad)
+{
+    return 0;
+}
+
+void test_wraparound(void)
+{
+    static unsigned char data[TEST_BYTES];
+    /* Frame counts per write, chosen to land all over the ring */
+    static const int chunks[] = { 7, 333, 1021, 4096, 1, 2500, 64 };
+    cst_audio_player *ap;
+    cst_audio_player_stats stats;
+    int i, n, pos;
+
+    for (i = 0; i < TEST_BYTES; i++)
+        data[i] = (unsigned char) ((i * 7) + (i / 251));
+
+    ap = mimic_audio_player_open(16000, TEST_CHANNELS,
+                                 CST_AUDIO_LINEAR16, 0);
+    TEST_CHECK(ap != NULL);
+    TEST_CHECK(ap->ring != NULL);
+    /* Whole frames, and much less than what goes through it */
+    TEST_CHECK(ap->size % TEST_FRAME_BYTES == 0);
+    TEST_CHECK(ap->size * 4 < TEST_BYTES);
+
+    for (pos = 0, i = 0; pos < TEST_BYTES; pos += n, i++)
+    {
+        n = chunks[i % (sizeof(chunks) / sizeof(chunks[0]))] *
+            TEST_FRAME_BYTES;
+        if (n > TEST_BYTES - pos)
+            n = TEST_BYTES - pos;
+        TEST_CHECK(mimic_audio_player_write(ap, data + pos, n) == n);
+    }
+    mimic_audio_player_drain(ap);
+    mimic_audio_player_get_stats(ap, &stats);
+    TEST_CHECK(stats.frames_written == TEST_BYTES / TEST_FRAME_BYTES);
+    TEST_CHECK(stats.frames_played == stats.frames_written);
+    TEST_CHECK(stats.capacity * TEST_FRAME_BYTES == (int) ap->size);
+    mimic_audio_player_close(ap);
+
+    TEST_CHECK(played_bytes == TEST_BYTES);
+    TEST_CHECK(split_frames == 0);
+    TEST_CHECK(memcmp(played, data, TEST_BYTES) == 0);
+}
+
+TEST_LIST =
+{
+    {"ring wraparound", test_wraparound},
+    {0}
+};
@@ -0,0 +1,342 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Audio sink tests: samples written in any pieces come out of flush in */
+/*  whole buffers, converted to the sink's format and channels, into     */
+/*  whichever buffer flush left in place, with one last flush at the end */
+/*                                                                       */
+/*************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "mimic.h"
+
+#include "cutest.h"
+#include "slt_vectors.h"
+
+cst_voice *register_cmu_us_slt(const char *voxdir);
+void unregister_cmu_us_slt(cst_voice *vox);
+
+#define MAX_FLUSHES 1024
+
+/* What flush was given, the first channel as float and the second, */
+/* if any, as how far it was from the first                         */
+typedef struct {
+    float *frames;
+    long num_frames;
+    int channel_diffs;
+    int flushes;
+    int sizes[MAX_FLUSHES];
+    int lasts[MAX_FLUSHES];
+    void *buffs[MAX_FLUSHES];
+    void *swap[2];              /* alternated between, if set */
+    int stop_at;                /* flush number to stop at, if set */
+} sink_got;
+
+static int sink_collect(cst_audio_sink *sink, int num_frames, int last)
+{
+    sink_got *got = (sink_got *) sink->userdata;
+    const short *s = (const short *) sink->buff;
+    const float *f = (const float *) sink->buff;
+    float v0, v1;
+    int i, nc = sink->channels;
+
+    TEST_CHECK(num_frames <= sink->buff_frames);
+    got->frames = cst_realloc(got->frames, float,
+                              got->num_frames + num_frames + 1);
+    for (i = 0; i < num_frames; i++)
+    {
+        if (sink->fmt == CST_AUDIO_SINK_INT16)
+        {
+            v0 = s[i * nc];
+            v1 = s[i * nc + nc - 1];
+        }
+        else
+        {
+            v0 = f[i * nc];
+            v1 = f[i * nc + nc - 1];
+        }
+        got->frames[got->num_frames + i] = v0;
+        if (v1 != v0)
+            got->channel_diffs++;
+    }
+    got->num_frames += num_frames;
+    if (got->flushes < MAX_FLUSHES)
+    {
+        got->sizes[got->flushes] = num_frames;
+        got->lasts[got->flushes] = last;
+        got->buffs[got->flushes] = sink->buff;
+    }
+    got->flushes++;
+    if (got->swap[0])
+        sink->buff = (sink->buff == got->swap[0]) ? got->swap[1] :
+            got->swap[0];
+    if (got->stop_at && got->flushes == got->stop_at)
+        return CST_AUDIO_STREAM_STOP;
+    return CST_AUDIO_STREAM_CONT;
+}
+
+/* A wave that goes from full scale negative to full scale positive */
+static cst_wave *test_wave(int num_samples)
+{
+    cst_wave *w = new_wave();
+    int i;
+
+    cst_wave_resize(w, num_samples, 1);
+    w->sample_rate = 16000;
+    for (i = 0; i < num_samples; i++)
+        w->samples[i] = -32768 + (int) ((65535L * i) / (num_samples - 1));
+    return w;
+}
+
+/* The frames got are the wave's, converted as fmt would be */
+static int same_frames(const sink_got *got, const cst_wave *w, int fmt)
+{
+    int i;
+    float v;
+
+    if (got->num_frames != w->num_samples)
+        return FALSE;
+    for (i = 0; i < w->num_samples; i++)
+    {
+        v = w->samples[i];
+        if (fmt == CST_AUDIO_SINK_FLOAT32)
+            v = w->samples[i] / 32768.0f;
+        if (got->frames[i] != v)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/* Writes w in uneven pieces, the last one marked */
+static void write_pieces(cst_audio_sink *sink, const cst_wave *w)
+{
+    static const int pieces[] = { 7, 993, 1, 1499, 0 };
+    int i, start = 0, n;
+
+    for (i = 0; start < w->num_samples; i++)
+    {
+        n = pieces[i % 5];
+        if (start + n > w->num_samples)
+            n = w->num_samples - start;
+        TEST_CHECK(audio_sink_write(sink, &w->samples[start], n,
+                                    start + n == w->num_samples) ==
+                   CST_AUDIO_STREAM_CONT);
+        start += n;
+    }
+}
+
+static void check_format(int fmt, int channels)
+{
+    cst_wave *w = test_wave(2500);
+    cst_audio_sink *sink;
+    sink_got got;
+    void *buff;
+
+    buff = cst_alloc(float, 1000 * channels);
+    memset(&got, 0, sizeof(got));
+    sink = new_audio_sink(buff, 1000, fmt, channels, sink_collect, &got);
+    TEST_CHECK(sink != NULL);
+    write_pieces(sink, w);
+
+    /* Two full buffers, then what is left with last set */
+    TEST_CHECK_(got.flushes == 3, "%d flushes", got.flushes);
+    TEST_CHECK(got.sizes[0] == 1000 && !got.lasts[0]);
+    TEST_CHECK(got.sizes[1] == 1000 && !got.lasts[1]);
+    TEST_CHECK(got.sizes[2] == 500 && got.lasts[2]);
+    TEST_CHECK(sink->total_frames == 2500);
+    TEST_CHECK_(same_frames(&got, w, fmt), "fmt %d, %d channels",
+                fmt, channels);
+    TEST_CHECK(got.channel_diffs == 0);
+    if (fmt == CST_AUDIO_SINK_FLOAT32)
+        TEST_CHECK(got.frames[0] == -1.0f && got.frames[2499] < 1.0f);
+
+    delete_audio_sink(sink);
+    cst_free(got.frames);
+    cst_free(buff);
+    delete_wave(w);
+}
+
+void test_int16_mono(void)
+{
+    check_format(CST_AUDIO_SINK_INT16, 1);
+}
+
+void test_int16_stereo(void)
+{
+    check_format(CST_AUDIO_SINK_INT16, 2);
+}
+
+void test_float32_mono(void)
+{
+    check_format(CST_AUDIO_SINK_FLOAT32, 1);
+}
+
+void test_float32_stereo(void)
+{
+    check_format(CST_AUDIO_SINK_FLOAT32, 2);
+}
+
+void test_boundaries(void)
+{
+    cst_wave *w = test_wave(2000);
+    cst_audio_sink *sink;
+    short buff[1000];
+    sink_got got;
+
+    /* Ending exactly on a full buffer, that is the last flush */
+    memset(&got, 0, sizeof(got));
+    sink = new_audio_sink(buff, 1000, CST_AUDIO_SINK_INT16, 1,
+                          sink_collect, &got);
+    TEST_CHECK(audio_sink_write(sink, w->samples, 2000, 1) ==
+               CST_AUDIO_STREAM_CONT);
+    TEST_CHECK(got.flushes == 2);
+    TEST_CHECK(got.sizes[1] == 1000 && got.lasts[1] && !got.lasts[0]);
+    TEST_CHECK(same_frames(&got, w, CST_AUDIO_SINK_INT16));
+    delete_audio_sink(sink);
+    cst_free(got.frames);
+
+    /* Not known to be the end until an empty last write */
+    memset(&got, 0, sizeof(got));
+    sink = new_audio_sink(buff, 1000, CST_AUDIO_SINK_INT16, 1,
+                          sink_collect, &got);
+    audio_sink_write(sink, w->samples, 2000, 0);
+    TEST_CHECK(got.flushes == 2 && !got.lasts[1]);
+    TEST_CHECK(audio_sink_write(sink, NULL, 0, 1) == CST_AUDIO_STREAM_CONT);
+    TEST_CHECK(got.flushes == 3 && got.sizes[2] == 0 && got.lasts[2]);
+    TEST_CHECK(same_frames(&got, w, CST_AUDIO_SINK_INT16));
+    delete_audio_sink(sink);
+    cst_free(got.frames);
+
+    /* flush stopping stops the write */
+    memset(&got, 0, sizeof(got));
+    got.stop_at = 1;
+    sink = new_audio_sink(buff, 1000, CST_AUDIO_SINK_INT16, 1,
+                          sink_collect, &got);
+    TEST_CHECK(audio_sink_write(sink, w->samples, 2000, 1) ==
+               CST_AUDIO_STREAM_STOP);
+    TEST_CHECK(got.flushes == 1);
+    delete_audio_sink(sink);
+    cst_free(got.frames);
+
+    /* Bad descriptions */
+    TEST_CHECK(new_audio_sink(NULL, 1000, CST_AUDIO_SINK_INT16, 1,
+                              sink_collect, NULL) == NULL);
+    TEST_CHECK(new_audio_sink(buff, 1000, 7, 1, sink_collect, NULL) == NULL);
+    TEST_CHECK(new_audio_sink(buff, 1000, CST_AUDIO_SINK_INT16, 3,
+                              sink_collect, NULL) == NULL);
+
+    delete_wave(w);
+}
+
+void test_swap(void)
+{
+    cst_wave *w = test_wave(3500);
+    cst_audio_sink *sink;
+    float a[2 * 1000], b[2 * 1000];
+    sink_got got;
+    int i;
+
+    /* flush hands the full buffer on and gives the sink the other */
+    memset(&got, 0, sizeof(got));
+    got.swap[0] = a;
+    got.swap[1] = b;
+    sink = new_audio_sink(a, 1000, CST_AUDIO_SINK_FLOAT32, 2,
+                          sink_collect, &got);
+    write_pieces(sink, w);
+    TEST_CHECK(got.flushes == 4);
+    for (i = 0; i < got.flushes; i++)
+        TEST_CHECK_(got.buffs[i] == ((i & 1) ? (void *) b : (void *) a),
+                    "flush %d", i);
+    TEST_CHECK(same_frames(&got, w, CST_AUDIO_SINK_FLOAT32));
+    TEST_CHECK(got.channel_diffs == 0);
+    delete_audio_sink(sink);
+    cst_free(got.frames);
+    delete_wave(w);
+}
+
+void test_vocoder(void)
+{
+    const char *text = "The sink gets what the wave would have had.";
+    cst_audio_streaming_info *asi;
+    cst_audio_sink *sink;
+    cst_voice *v;
+    cst_wave *w;
+    float a[2 * 256], b[2 * 256];
+    sink_got got;
+    int i;
+
+    slt_fill_vectors();
+    mimic_init();
+    v = register_cmu_us_slt(NULL);
+
+    /* The excitation noise comes from rand() */
+    srand(1);
+    w = mimic_text_to_wave(text, v);
+    TEST_CHECK(w && w->num_samples > 0);
+
+    memset(&got, 0, sizeof(got));
+    got.swap[0] = a;
+    got.swap[1] = b;
+    sink = new_audio_sink(a, 256, CST_AUDIO_SINK_FLOAT32, 2,
+                          sink_collect, &got);
+    asi = new_audio_streaming_info();
+    asi->sink = sink;
+    feat_set(v->features, "streaming_info", audio_streaming_info_val(asi));
+    srand(1);
+    delete_wave(mimic_text_to_wave(text, v));
+
+    TEST_CHECK(sink->sample_rate == w->sample_rate);
+    TEST_CHECK(same_frames(&got, w, CST_AUDIO_SINK_FLOAT32));
+    TEST_CHECK(got.channel_diffs == 0);
+    TEST_CHECK(got.flushes == (w->num_samples + 255) / 256);
+    for (i = 0; i + 1 < got.flushes && i < MAX_FLUSHES; i++)
+        TEST_CHECK_(got.sizes[i] == 256 && !got.lasts[i], "flush %d", i);
+    TEST_CHECK(got.lasts[got.flushes - 1]);
+
+    feat_remove(v->features, "streaming_info");
+    delete_audio_sink(sink);
+    cst_free(got.frames);
+    delete_wave(w);
+    unregister_cmu_us_slt(v);
+}
+
+TEST_LIST =
+{
+    {"int16 mono", test_int16_mono},
+    {"int16 stereo", test_int16_stereo},
+    {"float32 mono", test_float32_mono},
+    {"float32 stereo", test_float32_stereo},
+    {"flush boundaries", test_boundaries},
+    {"buffer swapping", test_swap},
+    {"from the vocoder", test_vocoder},
+    {0}
+};
@@ -0,0 +1,270 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Phrase parameter cache tests.  The slt voice is built with its real  */
+/*  trees but synthetic model vectors (see slt_vectors.h), which is      */
+/*  enough to check which phrases hit and that reused phrases sound the  */
+/*  same.                                                                */
+/*                                                                       */
+/*************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "mimic.h"
+#include "cst_cg.h"
+#include "cst_cg_cache.h"
+
+#include "cutest.h"
+#include "slt_vectors.h"
+
+cst_voice *register_cmu_us_slt(const char *voxdir);
+void unregister_cmu_us_slt(cst_voice *vox);
+
+static cst_voice *slt = NULL;
+static cst_cg_param_cache *cache = NULL;
+
+static void slt_init(void)
+{
+    if (slt)
+        return;
+    slt_fill_vectors();
+    mimic_init();
+    slt = register_cmu_us_slt(NULL);
+}
+
+static void slt_set_cache(long max_bytes)
+{
+    if (cache)
+    {
+        feat_remove(slt->features, "cg_param_cache");
+        delete_cg_param_cache(cache);
+        cache = NULL;
+    }
+    if (max_bytes > 0)
+    {
+        cache = new_cg_param_cache(max_bytes);
+        feat_set(slt->features, "cg_param_cache", cg_param_cache_val(cache));
+    }
+}
+
+static void slt_done(void)
+{
+    slt_set_cache(0);
+    unregister_cmu_us_slt(slt);
+    slt = NULL;
+}
+
+static cst_wave *slt_wave(const char *text)
+{
+    /* The mixed excitation noise comes from rand() */
+    srand(1);
+    return mimic_text_to_wave(text, slt);
+}
+
+/* The phrases of text found in the cache, and its wave if wanted */
+static long slt_hits(const char *text, cst_wave **w)
+{
+    cst_cg_param_cache_stats before, after;
+    cst_wave *w1;
+
+    cg_param_cache_get_stats(cache, &before);
+    w1 = slt_wave(text);
+    cg_param_cache_get_stats(cache, &after);
+    if (w)
+        *w = w1;
+    else
+        delete_wave(w1);
+    return after.hits - before.hits;
+}
+
+static int max_diff(const cst_wave *a, const cst_wave *b)
+{
+    int i, d, m = 0;
+
+    if (a->num_samples != b->num_samples)
+        return 65536;
+    for (i = 0; i < a->num_samples; i++)
+    {
+        d = abs(a->samples[i] - b->samples[i]);
+        if (d > m)
+            m = d;
+    }
+    return m;
+}
+
+void test_splice_key(void)
+{
+    slt_init();
+    slt_set_cache(CST_CG_PARAM_CACHE_DEFAULT);
+
+    TEST_CHECK(slt_hits("Your balance is ten dollars. "
+                        "Thank you for calling.", NULL) == 0);
+    TEST_CHECK(slt_hits("Your balance is ten dollars. "
+                        "Thank you for calling.", NULL) == 2);
+    /* Only the unchanged phrase, it has the same neighbours */
+    TEST_CHECK(slt_hits("Your balance is five dollars. "
+                        "Thank you for calling.", NULL) == 1);
+    /* Not at the same place in the utterance */
+    TEST_CHECK(slt_hits("Thank you for calling.", NULL) == 0);
+    /* Not after the same segments */
+    TEST_CHECK(slt_hits("Please hold. Thank you for calling.", NULL) == 0);
+
+    slt_done();
+}
+
+void test_cold_warm(void)
+{
+    const char *text = "Press one for sales. Press two for support.";
+    cst_wave *cold, *warm;
+    cst_cg_param_cache_stats stats;
+
+    slt_init();
+    slt_set_cache(CST_CG_PARAM_CACHE_DEFAULT);
+    TEST_CHECK(slt_hits(text, &cold) == 0);
+    TEST_CHECK(slt_hits(text, &warm) == 2);
+    cg_param_cache_get_stats(cache, &stats);
+    TEST_CHECK(stats.frames_reused > 0);
+    TEST_CHECK(stats.frames_reused == stats.frames_predicted);
+    TEST_CHECK(max_diff(cold, warm) == 0);
+    delete_wave(cold);
+    delete_wave(warm);
+    slt_done();
+}
+
+void test_cross_utterance(void)
+{
+    const char *texts[][2] = {
+        {"Your balance is ten dollars. Thank you for calling.",
+         "Your balance is five dollars. Thank you for calling."},
+        {"Hello there. Goodbye now, see you soon.",
+         "Hello there. Goodbye then, see you tomorrow."},
+    };
+    cst_wave *spliced, *fresh;
+    int i;
+
+    slt_init();
+    for (i = 0; i < 2; i++)
+    {
+        slt_set_cache(CST_CG_PARAM_CACHE_DEFAULT);
+        TEST_CHECK(slt_hits(texts[i][0], NULL) == 0);
+        TEST_CHECK(slt_hits(texts[i][1], &spliced) == 1);
+        /* Again, but with nothing to reuse */
+        cg_param_cache_clear(cache);
+        TEST_CHECK(slt_hits(texts[i][1], &fresh) == 0);
+        TEST_CHECK(max_diff(spliced, fresh) <= 1);
+        delete_wave(spliced);
+        delete_wave(fresh);
+    }
+    slt_done();
+}
+
+static cg_span *test_span(int num_frames, float v)
+{
+    cg_span *s = new_cg_span(num_frames, 4, 0, 0);
+    int i;
+
+    for (i = 0; i < num_frames * 4; i++)
+        s->params[i] = v;
+    for (i = 0; i < num_frames; i++)
+        s->param_frame[i] = i;
+    return s;
+}
+
+void test_lru(void)
+{
+    /* Only compared, never looked into */
+    static int dbs[2];
+    const cst_cg_db *db1 = (const cst_cg_db *) &dbs[0];
+    const cst_cg_db *db2 = (const cst_cg_db *) &dbs[1];
+    cst_cg_param_cache *c;
+    cst_cg_param_cache_stats stats;
+    cg_span *s, *got;
+    long span_bytes;
+
+    /* Room for three of these */
+    s = test_span(10, 1.0);
+    c = new_cg_param_cache(1000000);
+    cg_param_cache_put(c, db1, "a", s);
+    cg_param_cache_get_stats(c, &stats);
+    span_bytes = stats.bytes;
+    delete_cg_param_cache(c);
+    c = new_cg_param_cache((span_bytes * 3) + 2);
+
+    cg_param_cache_put(c, db1, "a", s);
+    cg_param_cache_put(c, db1, "b", s);
+    cg_param_cache_put(c, db1, "c", s);
+    /* a becomes the newest, so d pushes out b */
+    delete_cg_span(cg_param_cache_get(c, db1, "a"));
+    cg_param_cache_put(c, db1, "d", s);
+    cg_param_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.entries == 3);
+    TEST_CHECK(stats.evictions == 1);
+    TEST_CHECK(stats.bytes <= stats.max_bytes);
+    TEST_CHECK(cg_param_cache_get(c, db1, "b") == NULL);
+    got = cg_param_cache_get(c, db1, "a");
+    TEST_CHECK(got != NULL);
+    TEST_CHECK(got && got->num_frames == 10 && got->params[39] == 1.0 &&
+               got->param_frame[9] == 9);
+    delete_cg_span(got);
+
+    /* Keys are per voice */
+    TEST_CHECK(cg_param_cache_get(c, db2, "a") == NULL);
+
+    /* Storing a key again replaces it */
+    delete_cg_span(s);
+    s = test_span(10, 2.0);
+    cg_param_cache_put(c, db1, "c", s);
+    got = cg_param_cache_get(c, db1, "c");
+    TEST_CHECK(got && got->params[0] == 2.0);
+    delete_cg_span(got);
+    cg_param_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.entries == 3);
+
+    /* Too big to ever fit, and nothing is thrown out for it */
+    delete_cg_span(s);
+    s = test_span(1000, 3.0);
+    cg_param_cache_put(c, db1, "e", s);
+    TEST_CHECK(cg_param_cache_get(c, db1, "e") == NULL);
+    cg_param_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.entries == 3);
+
+    delete_cg_span(s);
+    delete_cg_param_cache(c);
+}
+
+TEST_LIST =
+{
+    {"param cache lru", test_lru},
+    {"splice key", test_splice_key},
+    {"cold and warm cache", test_cold_warm},
+    {"reuse across utterances", test_cross_utterance},
+    {0}
+};
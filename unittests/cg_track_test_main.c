@@ -0,0 +1,333 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  CG parameter track tests.  The slt voice is built with its real      */
+/*  trees but synthetic model vectors (see slt_vectors.h).  TEST_FILE    */
+/*  holds the F0 and the summed mcep channels of every frame as they     */
+/*  were before the frame generation was moved out of the mcep relation, */
+/*  new runs must reproduce them.  The frame features are checked        */
+/*  against their old per-item definitions, and the output against the   */
+/*  one with the mcep relation still built.                              */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "mimic.h"
+#include "cst_ffeatures.h"
+
+#include "cutest.h"
+#include "slt_vectors.h"
+
+cst_voice *register_cmu_us_slt(const char *voxdir);
+
+static cst_voice *slt = NULL;
+
+static void slt_init(void)
+{
+    if (slt)
+        return;
+    slt_fill_vectors();
+    mimic_init();
+    slt = register_cmu_us_slt(NULL);
+}
+
+/* Token relation built by hand so the SSML prosody overrides (pitch,  */
+/* range and rate on "how are") go through the F0 and duration models */
+static cst_utterance *synth_tokens(int overrides, int mcep_relation)
+{
+    static const char *const words[] = {
+        "Hello", "there", "how", "are", "you", "today", NULL
+    };
+    static const char *const puncs[] = { "", ",", "", "", "", "?" };
+    cst_utterance *u = new_utterance();
+    cst_relation *r;
+    cst_item *t;
+    int i;
+
+    utt_init(u, slt);
+    utt_set_feat_int(u, "noise_seed", 1);
+    if (mcep_relation)
+        utt_set_feat_int(u, "cg_mcep_relation", 1);
+    r = utt_relation_create(u, "Token");
+    for (i = 0; words[i]; i++)
+    {
+        t = relation_append(r, NULL);
+        item_set_string(t, "name", words[i]);
+        item_set_string(t, "whitespace", i ? " " : "");
+        item_set_string(t, "prepunctuation", "");
+        item_set_string(t, "punc", puncs[i]);
+        if (overrides && (i == 2 || i == 3))
+        {
+            item_set_float(t, "local_f0_mean", 180.0);
+            item_set_float(t, "local_f0_range", 31.0);
+            item_set_float(t, "local_duration_stretch", 1.5);
+        }
+    }
+    return utt_synth_tokens(u);
+}
+
+static int close_to(double a, double b)
+{
+    return fabs(a - b) <= 1e-4 * (1.0 + fabs(b));
+}
+
+void test_track_golden(void)
+{
+    FILE *fd;
+    cst_utterance *u;
+    cst_track *t;
+    int n, num_frames, num_channels, i, j, bad;
+    double f0, sum, s;
+
+    slt_init();
+    fd = fopen(TEST_FILE, "r");
+    TEST_CHECK(fd != NULL);
+    if (fd == NULL)
+        return;
+    while (fscanf(fd, " utterance %d %d %d", &n, &num_frames,
+                  &num_channels) == 3)
+    {
+        u = synth_tokens(n, 0);
+        t = val_track(utt_feat_val(u, "param_track"));
+        TEST_CHECK_(t->num_frames == num_frames,
+                    "utterance %d: %d frames, expected %d", n,
+                    t->num_frames, num_frames);
+        TEST_CHECK(t->num_channels == num_channels);
+        bad = 0;
+        for (i = 0; i < num_frames; i++)
+        {
+            if (fscanf(fd, "%lf %lf", &f0, &sum) != 2)
+                break;
+            if (i >= t->num_frames || t->num_channels != num_channels)
+                continue;
+            for (s = 0, j = 1; j < t->num_channels; j++)
+                s += t->frames[i][j];
+            if (!close_to(t->frames[i][0], f0) || !close_to(s, sum))
+            {
+                if (bad++ == 0)
+                    TEST_CHECK_(0, "utterance %d frame %d: f0 %f sum %f, "
+                                "expected %f %f", n, i,
+                                t->frames[i][0], s, f0, sum);
+            }
+        }
+        TEST_CHECK_(i == num_frames, "utterance %d: short data file", n);
+        TEST_CHECK_(bad == 0, "utterance %d: %d frames differ", n, bad);
+        delete_utterance(u);
+    }
+    TEST_CHECK(feof(fd));
+    fclose(fd);
+}
+
+void test_mcep_relation(void)
+{
+    cst_utterance *u1, *u2;
+    cst_track *t1, *t2;
+    cst_wave *w1, *w2;
+    int n, i;
+
+    slt_init();
+    for (n = 0; n < 2; n++)
+    {
+        u1 = synth_tokens(n, 0);
+        u2 = synth_tokens(n, 1);
+        TEST_CHECK(!utt_relation_present(u1, "mcep"));
+        TEST_CHECK(utt_relation_present(u2, "mcep"));
+        t1 = val_track(utt_feat_val(u1, "param_track"));
+        t2 = val_track(utt_feat_val(u2, "param_track"));
+        TEST_CHECK(t1->num_frames == t2->num_frames);
+        TEST_CHECK(t1->num_channels == t2->num_channels);
+        if (t1->num_frames == t2->num_frames &&
+            t1->num_channels == t2->num_channels)
+        {
+            for (i = 0; i < t1->num_frames; i++)
+                if (memcmp(t1->frames[i], t2->frames[i],
+                           t1->num_channels * sizeof(float)) != 0)
+                    break;
+            TEST_CHECK_(i == t1->num_frames,
+                        "utterance %d: frame %d differs", n, i);
+        }
+        w1 = utt_wave(u1);
+        w2 = utt_wave(u2);
+        TEST_CHECK(w1->num_samples == w2->num_samples);
+        if (w1->num_samples == w2->num_samples)
+            TEST_CHECK(memcmp(w1->samples, w2->samples,
+                              w1->num_samples * sizeof(short)) == 0);
+        delete_utterance(u1);
+        delete_utterance(u2);
+    }
+}
+
+/* The frame features as they were when every frame was an item in */
+/* mcep, its neighbours and the first and last daughters of states  */
+/* and segments found through the relations                         */
+static const char *old_state_pos(const cst_item *p)
+{
+    const char *name;
+    name = item_feat_string(p, "name");
+    if (!cst_streq(name, ffeature_string(p, "p.name")))
+        return "b";
+    if (cst_streq(name, ffeature_string(p, "n.name")))
+        return "m";
+    else
+        return "e";
+}
+
+#define OLD_STATE_START "R:mcep_link.parent.daughter1.frame_number"
+#define OLD_STATE_END "R:mcep_link.parent.daughtern.frame_number"
+#define OLD_PHONE_START \
+    "R:mcep_link.parent.R:segstate.parent.daughter1.R:mcep_link.daughter1.frame_number"
+#define OLD_PHONE_END \
+    "R:mcep_link.parent.R:segstate.parent.daughtern.R:mcep_link.daughtern.frame_number"
+
+static float old_place(const cst_item *p, const char *s, const char *e)
+{
+    float start, end;
+    start = (float) ffeature_int(p, s);
+    end = (float) ffeature_int(p, e);
+    if ((end - start) == 0.0)
+        return 0.0;
+    return (item_feat_int(p, "frame_number") - start) / (end - start);
+}
+
+static float old_index(const cst_item *p, const char *s)
+{
+    return item_feat_int(p, "frame_number") - (float) ffeature_int(p, s);
+}
+
+static float old_rindex(const cst_item *p, const char *e)
+{
+    return (float) ffeature_int(p, e) - item_feat_int(p, "frame_number");
+}
+
+#define NUM_FRAME_FEATS 6
+
+typedef struct frame_feats_struct {
+    const char *pos;
+    float f[NUM_FRAME_FEATS];
+} frame_feats;
+
+static void new_frame_feats(const cst_item *p, frame_feats *ff)
+{
+    const cst_val *(*const fn[NUM_FRAME_FEATS])(const cst_item *) = {
+        cg_state_place, cg_state_index, cg_state_rindex,
+        cg_phone_place, cg_phone_index, cg_phone_rindex
+    };
+    const cst_val *v;
+    int i;
+
+    ff->pos = val_string(cg_state_pos(p));
+    for (i = 0; i < NUM_FRAME_FEATS; i++)
+    {
+        v = fn[i](p);
+        ff->f[i] = val_float(v);
+        delete_val((cst_val *) v);
+    }
+}
+
+static int same_frame_feats(const frame_feats *a, const frame_feats *b)
+{
+    return cst_streq(a->pos, b->pos) &&
+        memcmp(a->f, b->f, sizeof(a->f)) == 0;
+}
+
+void test_frame_feats(void)
+{
+    cst_utterance *u;
+    cst_item *m, *s, *view;
+    frame_feats *ref, ff, old;
+    int n, num_frames, f, bad, checked;
+
+    slt_init();
+    for (n = 0; n < 2; n++)
+    {
+        /* Every frame an item: new definitions against the old ones */
+        u = synth_tokens(n, 1);
+        num_frames = utt_feat_int(u, "param_track_num_frames");
+        ref = cst_alloc(frame_feats, num_frames);
+        bad = 0;
+        for (f = 0, m = utt_rel_head(u, "mcep"); m; m = item_next(m), f++)
+        {
+            TEST_CHECK(item_feat_int(m, "frame_number") == f);
+            new_frame_feats(m, &ref[f]);
+            old.pos = old_state_pos(m);
+            old.f[0] = old_place(m, OLD_STATE_START, OLD_STATE_END);
+            old.f[1] = old_index(m, OLD_STATE_START);
+            old.f[2] = old_rindex(m, OLD_STATE_END);
+            old.f[3] = old_place(m, OLD_PHONE_START, OLD_PHONE_END);
+            old.f[4] = old_index(m, OLD_PHONE_START);
+            old.f[5] = old_rindex(m, OLD_PHONE_END);
+            if (!same_frame_feats(&ref[f], &old) && bad++ == 0)
+                TEST_CHECK_(0, "utterance %d frame %d: %s %f %f %f %f %f %f,"
+                            " was %s %f %f %f %f %f %f", n, f, ref[f].pos,
+                            ref[f].f[0], ref[f].f[1], ref[f].f[2],
+                            ref[f].f[3], ref[f].f[4], ref[f].f[5], old.pos,
+                            old.f[0], old.f[1], old.f[2], old.f[3],
+                            old.f[4], old.f[5]);
+        }
+        TEST_CHECK(f == num_frames);
+        TEST_CHECK_(bad == 0, "utterance %d: %d frames differ", n, bad);
+        delete_utterance(u);
+
+        /* One view item per state, moved along its frames */
+        u = synth_tokens(n, 0);
+        TEST_CHECK(utt_feat_int(u, "param_track_num_frames") == num_frames);
+        bad = checked = 0;
+        for (s = utt_rel_head(u, "mcep_link"); s; s = item_next(s))
+        {
+            if (!item_feat_present(s, "first_frame"))
+                continue;
+            view = item_daughter(s);
+            for (f = item_feat_int(s, "first_frame");
+                 f <= item_feat_int(s, "last_frame") && f < num_frames; f++)
+            {
+                item_set_int(view, "frame_number", f);
+                new_frame_feats(view, &ff);
+                checked++;
+                if (!same_frame_feats(&ff, &ref[f]) && bad++ == 0)
+                    TEST_CHECK_(0, "utterance %d view frame %d differs", n, f);
+            }
+        }
+        TEST_CHECK(checked == num_frames);
+        TEST_CHECK_(bad == 0, "utterance %d: %d view frames differ", n, bad);
+        delete_utterance(u);
+        cst_free(ref);
+    }
+}
+
+TEST_LIST =
+{
+    {"param track against saved values", test_track_golden},
+    {"with and without the mcep relation", test_mcep_relation},
+    {"frame features", test_frame_feats},
+    {0}
+};
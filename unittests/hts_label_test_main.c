@@ -0,0 +1,529 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  HTS label and question tests: structured labels come out as the      */
+/*  label strings did, and the questions compiled when the voice loads   */
+/*  give the same answers as matching their patterns against them, for   */
+/*  labels of the slt HTS voice                                          */
+/*                                                                       */
+/*************************************************************************/
+#include "mimic.h"
+
+/* For hts_labels() and the label format */
+#include "../src/hts/flite_hts_engine.c"
+/* For the models' questions and their compiled tests */
+#include "../src/hts/hts_engine_API/lib/HTS_model.c"
+
+#include "cutest.h"
+
+#ifndef HTS_VOICE
+  #define HTS_VOICE "../voices/cmu_us_slt_hts.htsvoice"
+#endif
+
+cst_voice *register_cmu_us_slt_hts(const char *voxdir);
+void unregister_cmu_us_slt_hts(cst_voice *vox);
+
+/* Statements, questions and exclamations, for each kind of endtone */
+static const char *const test_texts[] = {
+    "Hello world, this is a test of the label questions.",
+    "Is this a question? Are you sure?",
+    "Wow! Twenty three thousand, four hundred and five dollars.",
+    "My name is Doctor Smith, I live at 1200 Pennsylvania Avenue.",
+    NULL
+};
+
+/* The voice's model set and the labels of all of test_texts */
+static HTS_ModelSet ms;
+static HTS_Label labels;
+static char **label_fields;
+static size_t num_labels;
+
+static void labels_load(void)
+{
+    const char *delimiters[HTS_LABEL_NUM_FIELDS + 1];
+    char *voice = HTS_VOICE;
+    cst_utterance *u;
+    cst_voice *v;
+    const char **fields;
+    size_t i, j, n;
+
+    HTS_ModelSet_initialize(&ms);
+    TEST_CHECK(HTS_ModelSet_load(&ms, &voice, 1) == TRUE);
+    for (i = 0; i < HTS_LABEL_NUM_FIELDS; i++)
+        delimiters[i] = hts_label_fields[i].delimiter;
+    delimiters[HTS_LABEL_NUM_FIELDS] = "";
+    HTS_ModelSet_set_label_format(&ms, delimiters, HTS_LABEL_NUM_FIELDS);
+
+    mimic_init();
+    v = register_cmu_us_slt_hts(NULL);
+    feat_set_string(v->features, "htsvoice_file", HTS_VOICE);
+    label_fields = NULL;
+    num_labels = 0;
+    for (i = 0; test_texts[i]; i++)
+    {
+        u = mimic_synth_text(test_texts[i], v);
+        fields = hts_labels(u, &n);
+        label_fields = cst_realloc(label_fields, char *,
+                                   (num_labels + n) * HTS_LABEL_NUM_FIELDS);
+        for (j = 0; j < n * HTS_LABEL_NUM_FIELDS; j++)
+            label_fields[num_labels * HTS_LABEL_NUM_FIELDS + j] =
+                cst_strdup(fields[j]);
+        num_labels += n;
+        cst_free(fields);
+        delete_utterance(u);
+    }
+    unregister_cmu_us_slt_hts(v);
+
+    HTS_Label_initialize(&labels);
+    HTS_Label_load_from_fields(&labels, &ms.label_format,
+                               (const char *const *) label_fields,
+                               num_labels);
+}
+
+static void labels_done(void)
+{
+    size_t i;
+
+    HTS_Label_clear(&labels);
+    HTS_ModelSet_clear(&ms);
+    for (i = 0; i < num_labels * HTS_LABEL_NUM_FIELDS; i++)
+        cst_free(label_fields[i]);
+    cst_free(label_fields);
+}
+
+/* The answer to question as HTS_Tree_search_node() gets it, from the */
+/* model's match set and any patterns that weren't compiled           */
+static HTS_Boolean compiled_answer(HTS_Model *model, HTS_Question *question,
+                                   HTS_LabelString *label, HTS_Boolean format)
+{
+    HTS_Pattern *pattern;
+
+    if ((model->match_set[question->index / 8] >> (question->index % 8)) & 1)
+        return TRUE;
+    if (format ? question->format_compiled : question->compiled)
+        return FALSE;
+    for (pattern = question->head; pattern; pattern = pattern->next)
+        if (!(format ? pattern->format_compiled : pattern->compiled) &&
+            HTS_pattern_match(HTS_LabelString_get_name(label),
+                              pattern->string))
+            return TRUE;
+    return FALSE;
+}
+
+/* Checks every question of model against every label, through the */
+/* label string and, where the label is regular, its fields         */
+static void check_model(HTS_Model *model, const char *what,
+                        long *checks, long *yes)
+{
+    HTS_LabelString *label;
+    HTS_Question *question;
+    HTS_Boolean want, got;
+    const char *name;
+    size_t i;
+
+    if (model->match_set == NULL)
+        return;
+    for (i = 0; i < labels.size; i++)
+    {
+        label = HTS_Label_get_label_string(&labels, i);
+        name = HTS_LabelString_get_name(label);
+
+        HTS_Model_match_label(model, name);
+        for (question = model->question; question; question = question->next)
+        {
+            want = HTS_Question_match(question, name);
+            got = compiled_answer(model, question, label, FALSE);
+            TEST_CHECK_(got == want, "%s %s on %s", what, question->string,
+                        name);
+            (*checks)++;
+            if (want)
+                (*yes)++;
+        }
+
+        if (!label->regular || model->format_test == NULL)
+            continue;
+        HTS_Model_match_fields(model, label);
+        for (question = model->question; question; question = question->next)
+        {
+            want = HTS_Question_match(question, name);
+            got = compiled_answer(model, question, label, TRUE);
+            TEST_CHECK_(got == want, "%s %s on fields of %s", what,
+                        question->string, name);
+            (*checks)++;
+        }
+    }
+}
+
+/* The label string as hts_synth() made it before labels were built */
+/* as fields, kept as it was to check the fields against            */
+static void create_label(cst_item *item, char *label)
+{
+    const char *p1 = ffeature_string(item, "p.p.name");
+    const char *p2 = ffeature_string(item, "p.name");
+    const char *p3 = ffeature_string(item, "name");
+    const char *p4 = ffeature_string(item, "n.name");
+    const char *p5 = ffeature_string(item, "n.n.name");
+
+    if (strcmp(p3, "pau") == 0)
+    {
+        /* for pause */
+        int a3 =
+            ffeature_int(item,
+                         "p.R:SylStructure.parent.R:Syllable.syl_numphones");
+        int c3 =
+            ffeature_int(item,
+                         "n.R:SylStructure.parent.R:Syllable.syl_numphones");
+        int d2 =
+            ffeature_int(item,
+                         "p.R:SylStructure.parent.parent.R:Word.word_numsyls");
+        int f2 =
+            ffeature_int(item,
+                         "n.R:SylStructure.parent.parent.R:Word.word_numsyls");
+        int g1 =
+            ffeature_int(item,
+                         "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_syls_in_phrase");
+        int g2 =
+            ffeature_int(item,
+                         "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_words_in_phrase");
+        int i1 =
+            ffeature_int(item,
+                         "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_syls_in_phrase");
+        int i2 =
+            ffeature_int(item,
+                         "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_words_in_phrase");
+        int j1, j2, j3;
+        if (item_next(item) != NULL)
+        {
+            j1 = ffeature_int(item,
+                              "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_syls");
+            j2 = ffeature_int(item,
+                              "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_words");
+            j3 = ffeature_int(item,
+                              "n.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_phrases");
+        }
+        else
+        {
+            j1 = ffeature_int(item,
+                              "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_syls");
+            j2 = ffeature_int(item,
+                              "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_words");
+            j3 = ffeature_int(item,
+                              "p.R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_phrases");
+        }
+        sprintf(label, "%s^%s-%s+%s=%s@xx_xx/A:%s_%s_%s/B:xx-xx-xx@xx-xx&xx-xx#xx-xx$xx-xx!xx-xx;xx-xx|xx/C:%s+%s+%s/D:%s_%s/E:xx+xx@xx+xx&xx+xx#xx+xx/F:%s_%s/G:%s_%s/H:xx=xx^xx=xx|xx/I:%s=%s/J:%d+%d-%d",    /* */
+                strcmp(p1, "0") == 0 ? "xx" : p1,       /* p1 */
+                strcmp(p2, "0") == 0 ? "xx" : p2,       /* p2 */
+                p3,             /* p3 */
+                strcmp(p4, "0") == 0 ? "xx" : p4,       /* p4 */
+                strcmp(p5, "0") == 0 ? "xx" : p5,       /* p5 */
+                a3 == 0 ? "xx" : ffeature_string(item, "p.R:SylStructure.parent.R:Syllable.stress"),    /* a1 */
+                a3 == 0 ? "xx" : ffeature_string(item, "p.R:SylStructure.parent.R:Syllable.accented"),  /* a2 */
+                a3 == 0 ? "xx" : val_string(val_string_n(a3)),  /* a3 */
+                c3 == 0 ? "xx" : ffeature_string(item, "n.R:SylStructure.parent.R:Syllable.stress"),    /* c1 */
+                c3 == 0 ? "xx" : ffeature_string(item, "n.R:SylStructure.parent.R:Syllable.accented"),  /* c2 */
+                c3 == 0 ? "xx" : val_string(val_string_n(c3)),  /* c3 */
+                d2 == 0 ? "xx" : ffeature_string(item, "p.R:SylStructure.parent.parent.R:Word.gpos"),   /* d1 */
+                d2 == 0 ? "xx" : val_string(val_string_n(d2)),  /* d2 */
+                f2 == 0 ? "xx" : ffeature_string(item, "n.R:SylStructure.parent.parent.R:Word.gpos"),   /* f1 */
+                f2 == 0 ? "xx" : val_string(val_string_n(f2)),  /* f2 */
+                g1 == 0 ? "xx" : val_string(val_string_n(g1)),  /* g1 */
+                g2 == 0 ? "xx" : val_string(val_string_n(g2)),  /* g2 */
+                i1 == 0 ? "xx" : val_string(val_string_n(i1)),  /* i1 */
+                i2 == 0 ? "xx" : val_string(val_string_n(i2)),  /* i2 */
+                j1,             /* j1 */
+                j2,             /* j2 */
+                j3);            /* j3 */
+    }
+    else
+    {
+        /* for no pause */
+        int p6 = ffeature_int(item, "R:SylStructure.pos_in_syl") + 1;
+        int a3 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.p.syl_numphones");
+        int b3 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.syl_numphones");
+        int b4 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.pos_in_word") + 1;
+        int b12 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.lisp_distance_to_p_stress");
+        int b13 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.lisp_distance_to_n_stress");
+        int b14 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.lisp_distance_to_p_accent");
+        int b15 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.lisp_distance_to_n_accent");
+        int c3 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.n.syl_numphones");
+        int d2 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Word.p.word_numsyls");
+        int e2 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Word.word_numsyls");
+        int e3 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Word.pos_in_phrase")
+            + 1;
+        int e7 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Word.lisp_distance_to_p_content");
+        int e8 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Word.lisp_distance_to_n_content");
+        int f2 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Word.n.word_numsyls");
+        int g1 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Phrase.parent.p.lisp_num_syls_in_phrase");
+        int g2 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Phrase.parent.p.lisp_num_words_in_phrase");
+        int h2 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_words_in_phrase");
+        int h3 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.R:Syllable.sub_phrases") + 1;
+        const char *h5 =
+            ffeature_string(item,
+                            "R:SylStructure.parent.parent.R:Phrase.parent.daughtern.R:SylStructure.daughtern.endtone");
+        int i1 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Phrase.parent.n.lisp_num_syls_in_phrase");
+        int i2 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Phrase.parent.n.lisp_num_words_in_phrase");
+        int j1 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_syls");
+        int j2 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_words");
+        int j3 =
+            ffeature_int(item,
+                         "R:SylStructure.parent.parent.R:Phrase.parent.lisp_total_phrases");
+        sprintf(label, "%s^%s-%s+%s=%s@%d_%d/A:%s_%s_%s/B:%d-%d-%d@%d-%d&%d-%d#%d-%d$%d-%d!%s-%s;%s-%s|%s/C:%s+%s+%s/D:%s_%s/E:%s+%d@%d+%d&%d+%d#%s+%s/F:%s_%s/G:%s_%s/H:%d=%d^%d=%d|%s/I:%s=%s/J:%d+%d-%d",    /* */
+                strcmp(p1, "0") == 0 ? "xx" : p1,       /* p1 */
+                strcmp(p2, "0") == 0 ? "xx" : p2,       /* p2 */
+                p3,             /* p3 */
+                strcmp(p4, "0") == 0 ? "xx" : p4,       /* p4 */
+                strcmp(p5, "0") == 0 ? "xx" : p5,       /* p5 */
+                p6,             /* p6 */
+                b3 - p6 + 1,    /* p7 */
+                a3 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.R:Syllable.p.stress"),    /* a1 */
+                a3 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.R:Syllable.p.accented"),  /* a2 */
+                a3 == 0 ? "xx" : val_string(val_string_n(a3)),  /* a3 */
+                ffeature_int(item, "R:SylStructure.parent.R:Syllable.stress"),  /* b1 */
+                ffeature_int(item, "R:SylStructure.parent.R:Syllable.accented"),        /* b2 */
+                b3,             /* b3 */
+                b4,             /* b4 */
+                e2 - b4 + 1,    /* b5 */
+                ffeature_int(item, "R:SylStructure.parent.R:Syllable.syl_in") + 1,      /* b6 */
+                ffeature_int(item, "R:SylStructure.parent.R:Syllable.syl_out") + 1,     /* b7 */
+                ffeature_int(item, "R:SylStructure.parent.R:Syllable.ssyl_in"), /* b8 */
+                ffeature_int(item, "R:SylStructure.parent.R:Syllable.ssyl_out"),        /* b9 */
+                ffeature_int(item, "R:SylStructure.parent.R:Syllable.asyl_in"), /* b10 */
+                ffeature_int(item, "R:SylStructure.parent.R:Syllable.asyl_out"),        /* b11 */
+                b12 == 0 ? "xx" : val_string(val_string_n(b12)),        /* b12 */
+                b13 == 0 ? "xx" : val_string(val_string_n(b13)),        /* b13 */
+                b14 == 0 ? "xx" : val_string(val_string_n(b14)),        /* b14 */
+                b15 == 0 ? "xx" : val_string(val_string_n(b15)),        /* b15 */
+                ffeature_string(item, "R:SylStructure.parent.R:Syllable.syl_vowel"),    /* b16 */
+                c3 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.R:Syllable.n.stress"),    /* c1 */
+                c3 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.R:Syllable.n.accented"),  /* c2 */
+                c3 == 0 ? "xx" : val_string(val_string_n(c3)),  /* c3 */
+                d2 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.parent.R:Word.p.gpos"),   /* d1 */
+                d2 == 0 ? "xx" : val_string(val_string_n(d2)),  /* d2 */
+                ffeature_string(item, "R:SylStructure.parent.parent.R:Word.gpos"),      /* e1 */
+                e2,             /* e2 */
+                e3,             /* e3 */
+                h2 - e3 + 1,    /* e4 */
+                ffeature_int(item, "R:SylStructure.parent.parent.R:Word.content_words_in"),     /* e5 */
+                ffeature_int(item, "R:SylStructure.parent.parent.R:Word.content_words_out"),    /* e6 */
+                e7 == 0 ? "xx" : val_string(val_string_n(e7)),  /* e7 */
+                e8 == 0 ? "xx" : val_string(val_string_n(e8)),  /* e8 */
+                f2 == 0 ? "xx" : ffeature_string(item, "R:SylStructure.parent.parent.R:Word.n.gpos"),   /* f1 */
+                f2 == 0 ? "xx" : val_string(val_string_n(f2)),  /* f2 */
+                g1 == 0 ? "xx" : val_string(val_string_n(g1)),  /* g1 */
+                g2 == 0 ? "xx" : val_string(val_string_n(g2)),  /* g2 */
+                ffeature_int(item, "R:SylStructure.parent.parent.R:Phrase.parent.lisp_num_syls_in_phrase"),     /* h1 */
+                h2,             /* h2 */
+                h3,             /* h3 */
+                j3 - h3 + 1,    /* h4 */
+                strcmp(h5, "0") == 0 ? "NONE" : h5,     /* h5 */
+                i1 == 0 ? "xx" : val_string(val_string_n(i1)),  /* i1 */
+                i2 == 0 ? "xx" : val_string(val_string_n(i2)),  /* i2 */
+                j1,             /* j1 */
+                j2,             /* j2 */
+                j3);            /* j3 */
+    }
+}
+
+void test_label_strings(void)
+{
+    const char *delimiters[HTS_LABEL_NUM_FIELDS + 1];
+    HTS_LabelFormat format;
+    HTS_Label label;
+    HTS_LabelString *ls;
+    cst_utterance *u;
+    cst_voice *v;
+    cst_item *s;
+    const char **fields, *h5;
+    char old[1024];
+    size_t i, j, n, total = 0, pauses = 0, endtones = 0, h5_field = 0;
+
+    for (j = 0; j < HTS_LABEL_NUM_FIELDS; j++)
+    {
+        delimiters[j] = hts_label_fields[j].delimiter;
+        if (hts_label_fields[j].offset == offsetof(hts_label, h5))
+            h5_field = j;
+    }
+    delimiters[HTS_LABEL_NUM_FIELDS] = "";
+    format.num_fields = HTS_LABEL_NUM_FIELDS;
+    format.delimiter = (char **) delimiters;
+
+    mimic_init();
+    v = register_cmu_us_slt_hts(NULL);
+    feat_set_string(v->features, "htsvoice_file", HTS_VOICE);
+    for (i = 0; test_texts[i]; i++)
+    {
+        u = mimic_synth_text(test_texts[i], v);
+        fields = hts_labels(u, &n);
+        HTS_Label_initialize(&label);
+        HTS_Label_load_from_fields(&label, &format, fields, n);
+        TEST_CHECK(label.size == n);
+        for (j = 0, s = relation_head(utt_relation(u, "Segment")); s;
+             s = item_next(s), j++)
+        {
+            create_label(s, old);
+            ls = HTS_Label_get_label_string(&label, j);
+            TEST_CHECK_(ls && cst_streq(HTS_LabelString_get_name(ls), old),
+                        "%s\n not %s", ls ? HTS_LabelString_get_name(ls) :
+                        "nothing", old);
+            if (cst_streq(item_feat_string(s, "name"), "pau"))
+                pauses++;
+            /* the phrase's endtone */
+            h5 = fields[j * HTS_LABEL_NUM_FIELDS + h5_field];
+            if (strchr(h5, '%'))
+            {
+                endtones++;
+                TEST_CHECK(!ls->regular);
+                TEST_CHECK(strstr(old, h5) != NULL);
+            }
+            total++;
+        }
+        TEST_CHECK(j == n);
+        HTS_Label_clear(&label);
+        cst_free(fields);
+        delete_utterance(u);
+    }
+    unregister_cmu_us_slt_hts(v);
+
+    TEST_CHECK(total > 100 && pauses > 4);
+    TEST_CHECK_(endtones > 0, "%d labels with endtones like L-L%%",
+                (int) endtones);
+}
+
+void test_compiled_questions(void)
+{
+    HTS_Question *question;
+    HTS_Pattern *pattern;
+    long checks = 0, yes = 0;
+    size_t i, j, compiled = 0, format_compiled = 0, num = 0, irregular = 0;
+    char what[64];
+
+    labels_load();
+    TEST_CHECK(num_labels > 100);
+
+    check_model(&ms.duration[0], "duration", &checks, &yes);
+    for (i = 0; i < ms.num_streams; i++)
+    {
+        sprintf(what, "stream %d", (int) i);
+        check_model(&ms.stream[0][i], what, &checks, &yes);
+        if (ms.gv != NULL)
+        {
+            sprintf(what, "gv %d", (int) i);
+            check_model(&ms.gv[0][i], what, &checks, &yes);
+        }
+    }
+    TEST_CHECK(checks > 100000);
+    TEST_CHECK(yes > 0 && yes < checks);
+
+    /* Nearly all of them take the compiled path */
+    for (j = 0; j < ms.num_streams; j++)
+        for (question = ms.stream[0][j].question; question;
+             question = question->next, num++)
+        {
+            compiled += question->compiled;
+            format_compiled += question->format_compiled;
+        }
+    TEST_CHECK_(compiled > num * 9 / 10, "%d of %d compiled",
+                (int) compiled, (int) num);
+    TEST_CHECK_(format_compiled > num * 9 / 10, "%d of %d compiled to fields",
+                (int) format_compiled, (int) num);
+
+    /* The GV switch the same way */
+    for (i = 0; i < labels.size; i++)
+    {
+        HTS_LabelString *label = HTS_Label_get_label_string(&labels, i);
+        HTS_Boolean off = FALSE;
+
+        if (!label->regular)
+            irregular++;
+        if (ms.gv_off_context)
+            for (pattern = ms.gv_off_context->head; pattern && !off;
+                 pattern = pattern->next)
+                off = HTS_pattern_match(HTS_LabelString_get_name(label),
+                                        pattern->string);
+        TEST_CHECK_(HTS_ModelSet_get_gv_flag(&ms, label) == !off,
+                    "gv flag of %s", HTS_LabelString_get_name(label));
+    }
+    /* Endtones such as L-L% are outside the field alphabet */
+    TEST_CHECK(irregular > 0 && irregular < labels.size);
+
+    labels_done();
+}
+
+TEST_LIST =
+{
+    {"label strings", test_label_strings},
+    {"compiled questions", test_compiled_questions},
+    {0}
+};
@@ -0,0 +1,113 @@
+/*************************************************************************/
+/*                                                                       */
+/*                  Language Technologies Institute                      */
+/*                     Carnegie Mellon University                        */
+/*                        Copyright (c) 1999                             */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  CARNEGIE MELLON UNIVERSITY AND THE CONTRIBUTORS TO THIS WORK         */
+/*  DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING      */
+/*  ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT   */
+/*  SHALL CARNEGIE MELLON UNIVERSITY NOR THE CONTRIBUTORS BE LIABLE      */
+/*  FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES    */
+/*  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN   */
+/*  AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,          */
+/*  ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF       */
+/*  THIS SOFTWARE.                                                       */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  MLSA filter kernel tests: each SIMD version of the Pade stages must  */
+/*  give exactly what the scalar reference gives                         */
+/*                                                                       */
+/*************************************************************************/
+#include <math.h>
+#include <string.h>
+#include "cutest.h"
+#include "../src/filter/bb_mlsacore.c"
+
+#define TEST_M 44
+#define TEST_D2SIZE (BELL_PORDER * (TEST_M + 5))
+
+static unsigned int test_seed = 1;
+
+static double test_rand(void)
+{
+    test_seed = test_seed * 1103515245 + 12345;
+    return ((double) ((test_seed >> 16) & RANDMAX) / RANDMAX) - 0.5;
+}
+
+/* Runs fn against the reference over a few hundred random ranges, */
+/* the history terms carrying over from one call to the next       */
+static void check_stages(mlsadf2_stages_fn fn)
+{
+    double d2_ref[TEST_D2SIZE], d2[TEST_D2SIZE];
+    double p_ref[BELL_PORDER], p[BELL_PORDER];
+    double c[TEST_M + 1];
+    int i, n, start, end, j, j_ref;
+
+    test_seed = 1;
+    for (i = 0; i < TEST_D2SIZE; i++)
+        d2_ref[i] = d2[i] = test_rand();
+    for (n = 0; n < 500; n++)
+    {
+        for (i = 0; i <= TEST_M; i++)
+            c[i] = test_rand();
+        for (i = 0; i < BELL_PORDER; i++)
+            p_ref[i] = p[i] = test_rand();
+        start = BELL_PORDER * (2 + n % 3);
+        end = BELL_PORDER * (TEST_M + 2 - n % 7);
+        j = 1 + n % 2;
+        j_ref = mlsadf2_stages_ref(d2_ref, start, end, 0.42, c, j, p_ref);
+        j = fn(d2, start, end, 0.42, c, j, p);
+        TEST_CHECK(j == j_ref);
+        TEST_CHECK(memcmp(d2, d2_ref, sizeof(d2)) == 0);
+        TEST_CHECK(memcmp(p, p_ref, sizeof(p)) == 0);
+    }
+
+    /* An empty range leaves everything alone */
+    TEST_CHECK(fn(d2, 2 * BELL_PORDER, BELL_PORDER, 0.42, c, 3, p) == 3);
+    TEST_CHECK(memcmp(d2, d2_ref, sizeof(d2)) == 0);
+    TEST_CHECK(memcmp(p, p_ref, sizeof(p)) == 0);
+}
+
+void test_stages_sse2(void)
+{
+#ifdef MLSA_SSE2
+    check_stages(mlsadf2_stages_sse2);
+#endif
+}
+
+void test_stages_avx(void)
+{
+#ifdef MLSA_AVX_DISPATCH
+    if (__builtin_cpu_supports("avx"))
+        check_stages(mlsadf2_stages_avx);
+#endif
+}
+
+void test_stages_select(void)
+{
+    check_stages(mlsadf2_stages_select());
+}
+
+TEST_LIST = {
+    {"mlsa stages sse2", test_stages_sse2},
+    {"mlsa stages avx", test_stages_avx},
+    {"mlsa stages selected", test_stages_select},
+    {0}
+};
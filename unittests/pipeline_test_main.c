@@ -0,0 +1,173 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Synthesis pipeline tests: with worker threads the utterances come    */
+/*  out in the same order, and the same, as with none.  The CG voice is  */
+/*  slt with synthetic model vectors (see slt_vectors.h).                */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mimic.h"
+
+#include "cutest.h"
+#include "slt_vectors.h"
+
+#ifndef HTS_VOICE
+  #define HTS_VOICE "../voices/cmu_us_slt_hts.htsvoice"
+#endif
+
+cst_voice *register_cmu_us_slt_hts(const char *voxdir);
+void unregister_cmu_us_slt_hts(cst_voice *vox);
+cst_voice *register_cmu_us_slt(const char *voxdir);
+void unregister_cmu_us_slt(cst_voice *vox);
+
+/* Short and long sentences, so later ones can finish first */
+static const char *const test_text =
+    "One. "
+    "The second sentence is quite a lot longer than the first one was. "
+    "Three. "
+    "Four is short too. "
+    "Sentence five goes on for a while, with a pause or two, before it "
+    "finally gets to the end. "
+    "Six. "
+    "Seven and eight. "
+    "Nine.";
+
+static const char *const test_ssml =
+    "<speak>One. <prosody rate=\"slow\">Two is slow.</prosody> Three. "
+    "<break/> Four, <prosody volume=\"50\">five</prosody> and six. "
+    "Seven. <sub alias=\"eight\">8</sub>.</speak>";
+
+static cst_voice *test_voice(void)
+{
+    cst_voice *v;
+
+    mimic_init();
+    v = register_cmu_us_slt_hts(NULL);
+    feat_set_string(v->features, "htsvoice_file", HTS_VOICE);
+    return v;
+}
+
+/* Whole contents of filename, which is removed */
+static char *slurp(const char *filename, long *size)
+{
+    FILE *fd;
+    char *buf;
+
+    *size = 0;
+    if ((fd = fopen(filename, "rb")) == NULL)
+        return NULL;
+    fseek(fd, 0, SEEK_END);
+    *size = ftell(fd);
+    fseek(fd, 0, SEEK_SET);
+    buf = cst_alloc(char, *size + 1);
+    if (fread(buf, 1, *size, fd) != (size_t) *size)
+        *size = -1;
+    fclose(fd);
+    remove(filename);
+    return buf;
+}
+
+/* Synthesizes into a file with each number of threads and checks they */
+/* are all the same as with one                                         */
+static void check_threads(cst_voice *v, int ssml, const char *text)
+{
+    static const int threads[] = { 1, 2, 4, 7 };
+    char *one = NULL, *n;
+    long one_size = 0, size;
+    float dur;
+    int i, rv;
+
+    for (i = 0; i < 4; i++)
+    {
+        feat_set_int(v->features, "synth_threads", threads[i]);
+        /* Each utterance's CG excitation noise is seeded from rand() */
+        srand(1);
+        if (ssml)
+            rv = mimic_ssml_text_to_speech(text, v, "pipeline_test.wav", &dur);
+        else
+            rv = mimic_text_to_speech(text, v, "pipeline_test.wav", &dur);
+        TEST_CHECK(rv == 0);
+        n = slurp("pipeline_test.wav", &size);
+        TEST_CHECK(n != NULL && size > 44);
+        if (i == 0)
+        {
+            one = n;
+            one_size = size;
+            continue;
+        }
+        TEST_CHECK_(size == one_size, "%d threads, %ld bytes not %ld",
+                    threads[i], size, one_size);
+        TEST_CHECK_(size == one_size && memcmp(n, one, size) == 0,
+                    "%d threads, same samples", threads[i]);
+        cst_free(n);
+    }
+    cst_free(one);
+    feat_remove(v->features, "synth_threads");
+}
+
+void test_text_threads(void)
+{
+    cst_voice *v = test_voice();
+
+    check_threads(v, FALSE, test_text);
+    unregister_cmu_us_slt_hts(v);
+}
+
+void test_ssml_threads(void)
+{
+    cst_voice *v = test_voice();
+
+    check_threads(v, TRUE, test_ssml);
+    unregister_cmu_us_slt_hts(v);
+}
+
+void test_cg_threads(void)
+{
+    cst_voice *v;
+
+    slt_fill_vectors();
+    mimic_init();
+    v = register_cmu_us_slt(NULL);
+    check_threads(v, FALSE, test_text);
+    unregister_cmu_us_slt(v);
+}
+
+TEST_LIST =
+{
+    {"text with threads", test_text_threads},
+    {"ssml with threads", test_ssml_threads},
+    {"cg voice with threads", test_cg_threads},
+    {0}
+};
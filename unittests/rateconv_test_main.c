@@ -0,0 +1,182 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Resampler tests: exact ratios, how long the output is and that a     */
+/*  constant comes through at the filter's gain                          */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "cst_wave.h"
+
+#include "cutest.h"
+
+#define TEST_IN 20000
+#define TEST_DC 10000
+
+static const int test_rates[][4] = {
+    /* in, out, up, down */
+    {16000, 8000, 1, 2},
+    {8000, 16000, 2, 1},
+    {48000, 16000, 1, 3},
+    {44100, 16000, 160, 441},
+    {16000, 44100, 441, 160},
+    {22050, 16000, 320, 441},
+    {11025, 16000, 640, 441},
+};
+
+#define TEST_NUM_RATES (int) (sizeof(test_rates) / sizeof(test_rates[0]))
+
+static short in[2 * TEST_IN];
+
+/* Converts in, a chunk at a time, returns the output size */
+static int test_run(cst_rateconv *rc, int insize, int chunk, short **out)
+{
+    int n, done, total = 0;
+    int outsize = cst_rateconv_max_out(rc, insize);
+
+    *out = cst_alloc(short, outsize);
+    for (done = 0; done < insize; done += n)
+    {
+        n = (insize - done < chunk) ? insize - done : chunk;
+        total += cst_rateconv_run(rc, in + done, n, *out + total,
+                                  outsize - total, done + n == insize);
+    }
+    return total;
+}
+
+void test_ratios(void)
+{
+    cst_rateconv *rc;
+    int i;
+
+    for (i = 0; i < TEST_NUM_RATES; i++)
+    {
+        rc = new_rateconv_rates(test_rates[i][0], test_rates[i][1], 1);
+        TEST_CHECK_(rc->up == test_rates[i][2] &&
+                    rc->down == test_rates[i][3], "%d to %d is %d/%d",
+                    test_rates[i][0], test_rates[i][1], rc->up, rc->down);
+        delete_rateconv(rc);
+    }
+    TEST_CHECK(new_rateconv_rates(0, 16000, 1) == NULL);
+}
+
+void test_length_and_gain(void)
+{
+    cst_rateconv *rc;
+    short *out;
+    long long expect;
+    int i, j, n, lo, hi;
+
+    for (i = 0; i < TEST_IN; i++)
+        in[i] = TEST_DC;
+
+    for (i = 0; i < TEST_NUM_RATES; i++)
+    {
+        rc = new_rateconv_rates(test_rates[i][0], test_rates[i][1], 1);
+        n = test_run(rc, TEST_IN, TEST_IN, &out);
+
+        /* The input and the filter's tail, at the new rate */
+        expect = ((long long) (TEST_IN + rc->len - 1) * rc->up +
+                  rc->down - 1) / rc->down;
+        TEST_CHECK_(n == expect, "%d to %d: %d samples not %lld",
+                    test_rates[i][0], test_rates[i][1], n, expect);
+
+        /* Away from the ends, gain 0.8 give or take 0.2% */
+        for (lo = hi = out[n / 2], j = n / 4; j < 3 * n / 4; j++)
+        {
+            lo = (out[j] < lo) ? out[j] : lo;
+            hi = (out[j] > hi) ? out[j] : hi;
+        }
+        TEST_CHECK_(lo > 8000 - 16 && hi < 8000 + 16, "%d to %d: %d..%d",
+                    test_rates[i][0], test_rates[i][1], lo, hi);
+        cst_free(out);
+        delete_rateconv(rc);
+    }
+}
+
+void test_chunks(void)
+{
+    cst_rateconv *rc;
+    short *whole, *chunked;
+    int i, n, n2;
+
+    for (i = 0; i < TEST_IN; i++)
+        in[i] = (short) ((i * 131) % 16000 - 8000);
+
+    /* Block boundaries anywhere give the same output */
+    for (i = 0; i < TEST_NUM_RATES; i++)
+    {
+        rc = new_rateconv_rates(test_rates[i][0], test_rates[i][1], 1);
+        n = test_run(rc, TEST_IN, TEST_IN, &whole);
+        delete_rateconv(rc);
+        rc = new_rateconv_rates(test_rates[i][0], test_rates[i][1], 1);
+        n2 = test_run(rc, TEST_IN, 333, &chunked);
+        delete_rateconv(rc);
+        TEST_CHECK_(n == n2 && memcmp(whole, chunked, n * sizeof(short)) == 0,
+                    "%d to %d", test_rates[i][0], test_rates[i][1]);
+        cst_free(whole);
+        cst_free(chunked);
+    }
+}
+
+void test_stereo(void)
+{
+    cst_rateconv *rc;
+    short *out;
+    int i, n;
+
+    for (i = 0; i < TEST_IN; i++)
+    {
+        in[2 * i] = TEST_DC;
+        in[2 * i + 1] = -TEST_DC;
+    }
+    rc = new_rateconv_rates(44100, 16000, 2);
+    n = test_run(rc, 2 * TEST_IN, 1000, &out);
+    TEST_CHECK(n % 2 == 0);
+    TEST_CHECK(n / 2 == ((TEST_IN + rc->len - 1) * 160 + 440) / 441);
+    for (i = (n / 4) & ~1; i < 3 * n / 4; i += 2)
+        if (out[i] < 8000 - 16 || out[i] > 8000 + 16 ||
+            out[i + 1] > -8000 + 16 || out[i + 1] < -8000 - 16)
+            break;
+    TEST_CHECK_(i >= 3 * n / 4, "sample %d is %d %d", i, out[i], out[i + 1]);
+    cst_free(out);
+    delete_rateconv(rc);
+}
+
+TEST_LIST =
+{
+    {"exact ratios", test_ratios},
+    {"length and dc gain", test_length_and_gain},
+    {"chunked", test_chunks},
+    {"stereo", test_stereo},
+    {0}
+};
@@ -149,7 +149,24 @@ void test_match_commaint(void)
     delete_cst_regex(commaint);
 }
 
+// match several regexes in one pass
+void test_match_dfa_set(void)
+{
+    int i;
+    const cst_regex *rxs[] = { cst_rx_int, cst_rx_alpha, cst_rx_commaint };
+    unsigned int expected[] = { 1, 0, 2, 2, 0, 2, 0, 1, 1, 4, 0 };
+    cst_regex_dfa *dfa;
+
+    dfa = new_cst_regex_dfa(rxs, 3);
+    TEST_CHECK(dfa != NULL);
+    for (i = 0; rtests[i] != NULL; i++)
+        TEST_CHECK(cst_regex_dfa_match(dfa, rtests[i], 1) == expected[i]);
+
+    delete_cst_regex_dfa(dfa);
+}
+
 TEST_LIST = {
+    {"regex match dfa set", test_match_dfa_set},
     {"regex match commaint", test_match_commaint},
     {"regex match double", test_match_double},
     {"regex match integer", test_match_int},
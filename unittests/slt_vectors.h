@@ -0,0 +1,37 @@
+/*************************************************************************/
+/*                                                                       */
+/*  Synthetic model vectors for the slt CG voice, for tests that build   */
+/*  it from lang/cmu_us_slt without cmu_us_slt_single_model_vectors.c    */
+/*  (the real ones are too big to carry around).  Only include it in     */
+/*  one file of a test.                                                  */
+/*                                                                       */
+/*************************************************************************/
+#ifndef _SLT_VECTORS_H__
+#define _SLT_VECTORS_H__
+
+#include <stdint.h>
+
+#define SLT_NUM_FRAMES 8873
+#define SLT_NUM_CHANNELS 114
+
+uint16_t *cmu_us_slt_single_model_vectors[SLT_NUM_FRAMES];
+static uint16_t slt_vectors[SLT_NUM_FRAMES][SLT_NUM_CHANNELS];
+
+/* Values near the middle of each channel's range, the same every time */
+static void slt_fill_vectors(void)
+{
+    unsigned int seed = 1;
+    int i, j;
+
+    for (i = 0; i < SLT_NUM_FRAMES; i++)
+    {
+        for (j = 0; j < SLT_NUM_CHANNELS; j++)
+        {
+            seed = seed * 1103515245 + 12345;
+            slt_vectors[i][j] = 28672 + ((seed >> 16) % 8192);
+        }
+        cmu_us_slt_single_model_vectors[i] = slt_vectors[i];
+    }
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  SSML parser tests: the tokens and tags the handler is given          */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "cutest.h"
+#include "../src/synth/cst_ssml.c"
+
+/* What the parser handed over, as "token [NAME type attr=val ...] ..." */
+static char test_log[2048];
+
+static void test_log_add(const char *s)
+{
+    strncat(test_log, s, sizeof(test_log) - strlen(test_log) - 1);
+}
+
+static int test_token(ssml_handler *h, cst_tokenstream *ts,
+                      const char *token)
+{
+    if (cst_strlen(token) == 0)
+        return 0;
+    test_log_add(token);
+    test_log_add(" ");
+    return 0;
+}
+
+static int test_tag(ssml_handler *h, const ssml_tag *tag)
+{
+    char b[64];
+    int i;
+
+    cst_sprintf(b, "[%s %d", tag->name, tag->type);
+    test_log_add(b);
+    for (i = 0; i < tag->num_attrs; i++)
+    {
+        test_log_add(" ");
+        test_log_add(tag->attr[i]);
+        test_log_add("=");
+        test_log_add(tag->val[i]);
+    }
+    test_log_add("] ");
+    return 0;
+}
+
+/* Parses text, returning what ssml_parse() does */
+static int test_parse(const char *text)
+{
+    cst_tokenstream *ts;
+    ssml_handler h;
+    int rv;
+
+    test_log[0] = '\0';
+    ts = ts_open_string(text, " \t\n\r", ssml_singlecharsymbols_general,
+                        "", "", 0);
+    h.token = test_token;
+    h.tag = test_tag;
+    h.userdata = NULL;
+    rv = ssml_parse(ts, &h);
+    ts_close(ts);
+    return rv;
+}
+
+void test_tags(void)
+{
+    TEST_CHECK(test_parse("Hello <prosody rate=\"slow\" volume=\"50\">big"
+                          "</prosody> <break size=\"2\"/> "
+                          "<audio src=\"x.wav\">alt text</audio> "
+                          "<!-- a comment --> bye") == 0);
+    TEST_CHECK_(cst_streq(test_log,
+                         "Hello [PROSODY 0 rate=slow volume=50] big "
+                         "[PROSODY 1] [BREAK 2 size=2] "
+                         "[AUDIO 0 src=x.wav] alt text [AUDIO 1] bye "),
+                "got \"%s\"", test_log);
+
+    /* Quoted values may have spaces and quotes in them */
+    TEST_CHECK(test_parse("<sub alias=\"World \\\"Wide\\\" Web\">W3</sub>")
+               == 0);
+    TEST_CHECK_(cst_streq(test_log,
+                         "[SUB 0 alias=World \"Wide\" Web] W3 [SUB 1] "),
+                "got \"%s\"", test_log);
+}
+
+void test_many_attrs(void)
+{
+    /* Only the first SSML_MAX_ATTRS are kept, the rest are skipped */
+    TEST_CHECK(test_parse("<prosody a=\"1\" b=\"2\" c=\"3\" d=\"4\" e=\"5\" "
+                          "f=\"6\" g=\"7\" h=\"8\" i=\"9\" j=\"10\" "
+                          "k=\"11\" l=\"12\">x</prosody> y") == 0);
+    TEST_CHECK(SSML_MAX_ATTRS == 8);
+    TEST_CHECK_(cst_streq(test_log,
+                         "[PROSODY 0 a=1 b=2 c=3 d=4 e=5 f=6 g=7 h=8] x "
+                         "[PROSODY 1] y "),
+                "got \"%s\"", test_log);
+}
+
+void test_eof(void)
+{
+    /* The tokens before the broken tag are still handed over */
+    TEST_CHECK(test_parse("Hello <prosody rate=\"slow\"") < 0);
+    TEST_CHECK_(cst_streq(test_log, "Hello "),
+                "got \"%s\"", test_log);
+
+    TEST_CHECK(test_parse("Hi there <break size=\"2") < 0);
+    TEST_CHECK_(cst_streq(test_log, "Hi there "),
+                "got \"%s\"", test_log);
+
+    TEST_CHECK(test_parse("<") < 0);
+    TEST_CHECK(test_log[0] == '\0');
+}
+
+TEST_LIST =
+{
+    {"ssml tags", test_tags},
+    {"ssml many attributes", test_many_attrs},
+    {"ssml unexpected eof", test_eof},
+    {0}
+};
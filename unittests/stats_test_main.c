@@ -0,0 +1,339 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Stage timing stats tests: histogram buckets and quantiles at their   */
+/*  boundaries, timers and counters, a full table and the JSON dump      */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* For stat_bucket() */
+#include "../src/utils/cst_stats.c"
+
+#include "cutest.h"
+
+#define US (1.0 / 1000000.0)
+
+void test_buckets(void)
+{
+    /* Bucket b holds [2^(b-1), 2^b) microseconds, b 0 anything less */
+    TEST_CHECK(stat_bucket(0.0) == 0);
+    TEST_CHECK(stat_bucket(0.999 * US) == 0);
+    TEST_CHECK(stat_bucket(1.0 * US) == 1);
+    TEST_CHECK(stat_bucket(1.999 * US) == 1);
+    TEST_CHECK(stat_bucket(2.0 * US) == 2);
+    TEST_CHECK(stat_bucket(3.999 * US) == 2);
+    TEST_CHECK(stat_bucket(4.0 * US) == 3);
+    TEST_CHECK(stat_bucket(1024.0 * US) == 11);
+    TEST_CHECK(stat_bucket(1023.0 * US) == 10);
+    /* The last one takes everything longer */
+    TEST_CHECK(stat_bucket((double) (1UL << 30) * US) ==
+               CST_STATS_BUCKETS - 1);
+    TEST_CHECK(stat_bucket(3600.0 * 24) == CST_STATS_BUCKETS - 1);
+}
+
+void test_quantiles(void)
+{
+    cst_stat s;
+    int i;
+
+    cst_stats_reset();
+    TEST_CHECK(cst_stats_find("t", &s) == -1);
+
+    /* Ten in [2,4)us and ten in [64,128)us */
+    for (i = 0; i < 10; i++)
+        cst_stats_add_time("t", 3.0 * US);
+    for (i = 0; i < 10; i++)
+        cst_stats_add_time("t", 100.0 * US);
+    TEST_CHECK(cst_stats_find("t", &s) == 0);
+    TEST_CHECK(s.type == CST_STATS_TIMER && s.count == 20);
+    TEST_CHECK(s.hist[2] == 10 && s.hist[7] == 10);
+    TEST_CHECK(s.min == 3.0 * US && s.max == 100.0 * US);
+    /* The upper bound of the bucket the quantile falls in */
+    TEST_CHECK(cst_stats_quantile(&s, 0.0) == 4.0 * US);
+    TEST_CHECK(cst_stats_quantile(&s, 0.5) == 4.0 * US);
+    /* but never more than the longest seen */
+    TEST_CHECK(cst_stats_quantile(&s, 0.55) == s.max);
+    TEST_CHECK(cst_stats_quantile(&s, 1.0) == s.max);
+    /* which isn't the limit once there's a longer one */
+    cst_stats_add_time("t", 200.0 * US);
+    cst_stats_find("t", &s);
+    TEST_CHECK(cst_stats_quantile(&s, 0.55) == 128.0 * US);
+    TEST_CHECK(cst_stats_quantile(&s, 1.0) == 200.0 * US);
+
+    /* Exactly on a boundary goes in the bucket above */
+    cst_stats_add_time("b", 4.0 * US);
+    cst_stats_find("b", &s);
+    TEST_CHECK(s.hist[3] == 1);
+    TEST_CHECK(cst_stats_quantile(&s, 0.5) == 4.0 * US);
+
+    /* Negative times count as none */
+    cst_stats_add_time("n", -1.0);
+    cst_stats_find("n", &s);
+    TEST_CHECK(s.hist[0] == 1 && s.min == 0.0);
+
+    memset(&s, 0, sizeof(s));
+    TEST_CHECK(cst_stats_quantile(&s, 0.5) == 0.0);
+    cst_stats_reset();
+}
+
+void test_counters(void)
+{
+    cst_stat s;
+    int i;
+
+    cst_stats_reset();
+    cst_stats_add_count("c", 2.0);
+    cst_stats_add_count("c", 3.5);
+    TEST_CHECK(cst_stats_find("c", &s) == 0);
+    TEST_CHECK(s.type == CST_STATS_COUNTER);
+    TEST_CHECK(s.count == 2 && s.total == 5.5);
+    for (i = 0; i < CST_STATS_BUCKETS; i++)
+        TEST_CHECK(s.hist[i] == 0);
+
+    /* A timer of the same name is another stat */
+    cst_stats_add_time("c", 10.0 * US);
+    TEST_CHECK(cst_stats_num() == 2);
+    TEST_CHECK(cst_stats_get(0, &s) == 0);
+    TEST_CHECK(s.type == CST_STATS_COUNTER && s.total == 5.5);
+    TEST_CHECK(cst_stats_get(1, &s) == 0);
+    TEST_CHECK(s.type == CST_STATS_TIMER && s.count == 1 &&
+               s.hist[4] == 1);
+    TEST_CHECK(cst_stats_get(2, &s) == -1);
+    TEST_CHECK(cst_stats_get(-1, &s) == -1);
+    cst_stats_reset();
+    TEST_CHECK(cst_stats_num() == 0);
+}
+
+void test_full(void)
+{
+    char name[32];
+    cst_stat s;
+    int i;
+
+    cst_stats_reset();
+    for (i = 0; i < CST_STATS_MAX; i++)
+    {
+        sprintf(name, "s%d", i);
+        cst_stats_add_count(name, 1.0);
+    }
+    TEST_CHECK(cst_stats_num() == CST_STATS_MAX);
+
+    /* New names are dropped, the ones there still count */
+    cst_stats_add_count("one more", 1.0);
+    cst_stats_add_time("and another", 1.0);
+    TEST_CHECK(cst_stats_num() == CST_STATS_MAX);
+    TEST_CHECK(cst_stats_find("one more", &s) == -1);
+    TEST_CHECK(cst_stats_find("and another", &s) == -1);
+    cst_stats_add_count("s0", 1.0);
+    TEST_CHECK(cst_stats_find("s0", &s) == 0 && s.total == 2.0);
+    sprintf(name, "s%d", CST_STATS_MAX - 1);
+    TEST_CHECK(cst_stats_find(name, &s) == 0 && s.total == 1.0);
+
+    /* and after a reset there's room again */
+    cst_stats_reset();
+    cst_stats_add_count("one more", 1.0);
+    TEST_CHECK(cst_stats_find("one more", &s) == 0);
+    cst_stats_reset();
+}
+
+/* Just enough of a JSON parser to say if text is JSON */
+
+static int json_value(const char **p);
+
+static void json_ws(const char **p)
+{
+    while (**p && strchr(" \t\r\n", **p))
+        (*p)++;
+}
+
+static int json_string(const char **p)
+{
+    int i;
+
+    if (**p != '"')
+        return FALSE;
+    for ((*p)++; **p != '"'; (*p)++)
+    {
+        if ((unsigned char) **p < 0x20)
+            return FALSE;
+        if (**p == '\\')
+        {
+            (*p)++;
+            if (**p == 'u')
+            {
+                for (i = 0; i < 4; i++)
+                    if (!isxdigit((unsigned char) *++(*p)))
+                        return FALSE;
+            }
+            else if (!**p || !strchr("\"\\/bfnrt", **p))
+                return FALSE;
+        }
+    }
+    (*p)++;
+    return TRUE;
+}
+
+static int json_number(const char **p)
+{
+    char *end;
+
+    if (**p != '-' && !isdigit((unsigned char) **p))
+        return FALSE;
+    strtod(*p, &end);
+    if (end == *p)
+        return FALSE;
+    *p = end;
+    return TRUE;
+}
+
+static int json_list(const char **p, char close, int members)
+{
+    /* after the opening bracket */
+    json_ws(p);
+    if (**p == close)
+    {
+        (*p)++;
+        return TRUE;
+    }
+    for (;;)
+    {
+        json_ws(p);
+        if (members)
+        {
+            if (!json_string(p))
+                return FALSE;
+            json_ws(p);
+            if (*(*p)++ != ':')
+                return FALSE;
+        }
+        if (!json_value(p))
+            return FALSE;
+        json_ws(p);
+        if (**p == close)
+        {
+            (*p)++;
+            return TRUE;
+        }
+        if (*(*p)++ != ',')
+            return FALSE;
+    }
+}
+
+static int json_value(const char **p)
+{
+    json_ws(p);
+    if (**p == '{')
+    {
+        (*p)++;
+        return json_list(p, '}', TRUE);
+    }
+    if (**p == '[')
+    {
+        (*p)++;
+        return json_list(p, ']', FALSE);
+    }
+    if (**p == '"')
+        return json_string(p);
+    return json_number(p);
+}
+
+static int is_json(const char *text)
+{
+    const char *p = text;
+
+    if (!json_value(&p))
+        return FALSE;
+    json_ws(&p);
+    return *p == '\0';
+}
+
+static char *dump_json(void)
+{
+    cst_file fd;
+    char *buf;
+    long size;
+
+    fd = cst_fopen("stats_test.json", CST_OPEN_WRITE);
+    TEST_CHECK(cst_stats_dump_json(fd) == 0);
+    cst_fclose(fd);
+    fd = cst_fopen("stats_test.json", CST_OPEN_READ);
+    size = cst_filesize(fd);
+    buf = cst_alloc(char, size + 1);
+    cst_fread(fd, buf, 1, size);
+    cst_fclose(fd);
+    remove("stats_test.json");
+    return buf;
+}
+
+void test_json(void)
+{
+    char *j;
+
+    TEST_CHECK(is_json("{\"a\":[1,-2.5e3,{}],\"b\\\"\":\"\\u00e9\"}"));
+    TEST_CHECK(!is_json("{\"a\":1,}"));
+    TEST_CHECK(!is_json("{\"a\":nan}"));
+    TEST_CHECK(!is_json("{\"a\"\"b\":1}"));
+
+    cst_stats_reset();
+    j = dump_json();
+    TEST_CHECK_(is_json(j), "empty: %s", j);
+    cst_free(j);
+
+    cst_stats_add_time("synth", 0.25);
+    cst_stats_add_time("synth", 1.5);
+    cst_stats_add_time("first_chunk", 0.0);
+    cst_stats_add_time("say \"hi\"\\\n", 1.0 * US);
+    cst_stats_add_count("utterances", 2.0);
+    cst_stats_add_count("synth", 7.0);
+    cst_stats_add_count("tab\there", 1.0);
+    j = dump_json();
+    TEST_CHECK_(is_json(j), "%s", j);
+    TEST_CHECK(strstr(j, "\"say \\\"hi\\\"\\\\\\u000a\":{\"count\":1,") != NULL);
+    TEST_CHECK(strstr(j, "\"synth\":{\"count\":2,") != NULL);
+    TEST_CHECK(strstr(j, "\"synth\":7.000000") != NULL);
+    TEST_CHECK(strstr(j, "\"tab\\u0009here\":1.000000") != NULL);
+    cst_free(j);
+    cst_stats_reset();
+}
+
+TEST_LIST =
+{
+    {"histogram buckets", test_buckets},
+    {"quantiles", test_quantiles},
+    {"counters and timers", test_counters},
+    {"full table", test_full},
+    {"json", test_json},
+    {0}
+};
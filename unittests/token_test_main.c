@@ -97,6 +97,40 @@ void test_token_utf8(void)
     ts_close(fd);
 }
 
+void test_token_read(void)
+{
+    /* Binary data straight after a header, as in EST track files */
+    cst_tokenstream *fd;
+    FILE *f;
+    int i, vals[3] = { 7, -2, 1 << 20 }, got[3];
+    char big[70000];
+
+    f = fopen("token_test_read.tmp", "wb");
+    TEST_CHECK(f != NULL);
+    fprintf(f, "Header two\n");
+    fwrite(vals, sizeof(int), 3, f);
+    /* more than a block, so the rest comes from the file */
+    memset(big, 'x', sizeof(big));
+    fwrite(big, 1, sizeof(big), f);
+    fwrite(vals, sizeof(int), 3, f);
+    fclose(f);
+
+    fd = ts_open("token_test_read.tmp", NULL, NULL, NULL, NULL, 0);
+    TEST_CHECK(fd != NULL);
+    TEST_CHECK(strcmp(ts_get(fd), "Header") == 0);
+    TEST_CHECK(strcmp(ts_get(fd), "two") == 0);
+    TEST_CHECK(ts_read(got, sizeof(int), 3, fd) == 3);
+    TEST_CHECK(memcmp(got, vals, sizeof(vals)) == 0);
+    for (i = 0; i < (int) sizeof(big); i += 1000)
+        TEST_CHECK(ts_read(big, 1, 1000, fd) == 1000);
+    TEST_CHECK(ts_read(got, sizeof(int), 3, fd) == 3);
+    TEST_CHECK(memcmp(got, vals, sizeof(vals)) == 0);
+    TEST_CHECK(ts_read(got, sizeof(int), 1, fd) == 0);
+    TEST_CHECK(ts_eof(fd));
+    ts_close(fd);
+    remove("token_test_read.tmp");
+}
+
 TEST_LIST =
 {
     {
@@ -104,5 +138,7 @@ TEST_LIST =
     {
     "tokens_utf8", test_token_utf8},
     {
+    "raw read", test_token_read},
+    {
     0}
 };
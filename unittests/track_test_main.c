@@ -0,0 +1,166 @@
+#include <stdio.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "cst_track.h"
+
+#include "cutest.h"
+
+static void fill(cst_track *t)
+{
+    int i, j;
+
+    for (i = 0; i < t->num_frames; i++)
+    {
+        t->times[i] = i * 0.005;
+        for (j = 0; j < t->num_channels; j++)
+            cst_track_val(t, i, j) = (i * 100) + j;
+    }
+}
+
+static int check(const cst_track *t, int first_frame, int first_channel)
+{
+    int i, j;
+
+    for (i = 0; i < t->num_frames; i++)
+        for (j = 0; j < t->num_channels; j++)
+            if (cst_track_val(t, i, j) !=
+                ((i + first_frame) * 100) + j + first_channel)
+                return 0;
+    return 1;
+}
+
+void test_resize(void)
+{
+    cst_track *t = new_track();
+    int i;
+
+    cst_track_resize(t, 10, 5);
+    TEST_CHECK(t->num_frames == 10);
+    TEST_CHECK(t->num_channels == 5);
+    TEST_CHECK(((uintptr_t) t->data % CST_TRACK_ALIGN) == 0);
+    for (i = 0; i < t->num_frames; i++)
+        TEST_CHECK(((uintptr_t) t->frames[i] % CST_TRACK_ALIGN) == 0);
+    fill(t);
+    TEST_CHECK(t->frames[3][4] == 304);
+
+    cst_track_resize(t, 20, 3);
+    TEST_CHECK(t->frames[9][2] == 902);
+    TEST_CHECK(t->frames[15][0] == 0);
+    TEST_CHECK(t->times[9] == (float) (9 * 0.005));
+    delete_track(t);
+}
+
+void test_layout(void)
+{
+    cst_track *t = new_track();
+    cst_track *t2;
+    float *c;
+
+    cst_track_resize(t, 7, 4);
+    fill(t);
+    cst_track_set_layout(t, CST_TRACK_CHANNEL_MAJOR);
+    TEST_CHECK(t->layout == CST_TRACK_CHANNEL_MAJOR);
+    TEST_CHECK(t->frames == NULL);
+    TEST_CHECK(check(t, 0, 0));
+    c = cst_track_channel(t, 2);
+    TEST_CHECK(((uintptr_t) c % CST_TRACK_ALIGN) == 0);
+    TEST_CHECK(c[0] == 2 && c[6] == 602);
+
+    cst_track_resize(t, 9, 4);
+    TEST_CHECK(cst_track_val(t, 6, 3) == 603);
+    TEST_CHECK(cst_track_val(t, 8, 3) == 0);
+
+    t2 = cst_track_copy(t);
+    TEST_CHECK(t2->layout == CST_TRACK_CHANNEL_MAJOR);
+    TEST_CHECK(t2->data != t->data);
+    TEST_CHECK(cst_track_val(t2, 6, 3) == 603);
+
+    cst_track_set_layout(t, CST_TRACK_ROW_MAJOR);
+    TEST_CHECK(t->frames[6][3] == 603);
+    delete_track(t);
+    delete_track(t2);
+}
+
+void test_view(void)
+{
+    cst_track *t = new_track();
+    cst_track *v, *v2;
+
+    cst_track_resize(t, 10, 6);
+    fill(t);
+    v = cst_track_view(t, 2, 5, 1, 3);
+    TEST_CHECK(v->num_frames == 5);
+    TEST_CHECK(v->num_channels == 3);
+    TEST_CHECK(v->times == t->times + 2);
+    TEST_CHECK(check(v, 2, 1));
+    v->frames[0][0] = -1;
+    TEST_CHECK(t->frames[2][1] == -1);
+
+    /* a copy of a view, and a resized view, have their own storage */
+    v2 = cst_track_copy(v);
+    TEST_CHECK(v2->frames[0][0] == -1);
+    TEST_CHECK(v2->frames[4][2] == 603);
+    cst_track_resize(v, 5, 3);
+    v->frames[1][1] = -2;
+    TEST_CHECK(t->frames[3][2] == 302);
+    delete_track(v);
+    delete_track(v2);
+    delete_track(t);
+}
+
+/* Saves t as it is laid out and loads it back into a track laid out */
+/* the other way round, and the same way                             */
+static void check_save_load(int binary, int layout)
+{
+    cst_track *t = new_track();
+    cst_track *t2;
+    int i, load_layout, rv;
+
+    cst_track_resize(t, 40, 6);
+    fill(t);
+    cst_track_set_layout(t, layout);
+    if (binary)
+        rv = cst_track_save_est_binary(t, "track_test.est");
+    else
+        rv = cst_track_save_est(t, "track_test.est");
+    TEST_CHECK(rv == 0);
+
+    for (load_layout = CST_TRACK_ROW_MAJOR;
+         load_layout <= CST_TRACK_CHANNEL_MAJOR; load_layout++)
+    {
+        t2 = new_track();
+        cst_track_set_layout(t2, load_layout);
+        TEST_CHECK(cst_track_load_est(t2, "track_test.est") == 0);
+        TEST_CHECK(t2->layout == load_layout);
+        TEST_CHECK(t2->num_frames == 40 && t2->num_channels == 6);
+        TEST_CHECK(check(t2, 0, 0));
+        for (i = 0; i < t->num_frames; i++)
+            TEST_CHECK(fabs(t2->times[i] - t->times[i]) < 0.000001);
+        delete_track(t2);
+    }
+    remove("track_test.est");
+    delete_track(t);
+}
+
+void test_save_load_ascii(void)
+{
+    check_save_load(0, CST_TRACK_ROW_MAJOR);
+    check_save_load(0, CST_TRACK_CHANNEL_MAJOR);
+}
+
+void test_save_load_binary(void)
+{
+    check_save_load(1, CST_TRACK_ROW_MAJOR);
+    check_save_load(1, CST_TRACK_CHANNEL_MAJOR);
+}
+
+TEST_LIST =
+{
+    {"resize track", test_resize},
+    {"track layout", test_layout},
+    {"track view", test_view},
+    {"ascii track save and load", test_save_load_ascii},
+    {"binary track save and load", test_save_load_binary},
+    {0}
+};
@@ -0,0 +1,213 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Token to words cache tests: hits, LRU eviction and dropping entries  */
+/*  when lexicon addenda are loaded                                      */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include "mimic.h"
+#include "cst_synth.h"
+
+#include "cutest.h"
+
+extern cst_lexicon cmu_lex;
+void cmu_lex_init();
+
+static const char *const test_context[] = { "name", "n.name", NULL };
+static const char *const test_token_feats[] = { "expanded", NULL };
+
+/* Says each token twice, and notes that it was asked */
+static int test_calls = 0;
+
+static cst_val *test_ttw(cst_item *token)
+{
+    const char *name = item_feat_string(token, "name");
+
+    test_calls++;
+    item_set_string(token, "expanded", name);
+    return cons_val(string_val(name), cons_val(string_val(name), NULL));
+}
+
+static cst_utterance *test_utt(const char *const *names)
+{
+    cst_utterance *u = new_utterance();
+    cst_relation *r = utt_relation_create(u, "Token");
+    int i;
+
+    feat_set(u->features, "lexicon", lexicon_val(&cmu_lex));
+    for (i = 0; names[i]; i++)
+        item_set_string(relation_append(r, NULL), "name", names[i]);
+    return u;
+}
+
+/* Expands the tokens of u through c, returns how many came out right */
+static int test_expand(cst_ttw_cache *c, cst_utterance *u)
+{
+    cst_item *t;
+    cst_val *words;
+    const char *name;
+    int right = 0;
+
+    for (t = relation_head(utt_relation(u, "Token")); t; t = item_next(t))
+    {
+        words = ttw_cache_tokentowords(c, t, test_ttw);
+        name = item_feat_string(t, "name");
+        if (val_length(words) == 2 &&
+            cst_streq(val_string(val_car(words)), name) &&
+            cst_streq(val_string(val_car(val_cdr(words))), name) &&
+            cst_streq(item_feat_string(t, "expanded"), name))
+            right++;
+        delete_val(words);
+    }
+    return right;
+}
+
+void test_hits(void)
+{
+    static const char *const names[] = { "the", "12", "dollars", "12",
+        "dollars", "12", "cents", NULL
+    };
+    cst_ttw_cache *c;
+    cst_ttw_cache_stats stats;
+    cst_utterance *u;
+
+    cmu_lex_init();
+    c = new_ttw_cache(16, test_context, test_token_feats);
+    u = test_utt(names);
+    test_calls = 0;
+    TEST_CHECK(test_expand(c, u) == 7);
+    /* The second "12 dollars", the last 12 has other neighbours */
+    TEST_CHECK(test_calls == 5);
+    ttw_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.hits == 2 && stats.misses == 5);
+    TEST_CHECK(stats.entries == 5);
+
+    /* All again, all from the cache, features set as before */
+    delete_utterance(u);
+    u = test_utt(names);
+    TEST_CHECK(test_expand(c, u) == 7);
+    TEST_CHECK(test_calls == 5);
+    ttw_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.hits == 9);
+
+    ttw_cache_clear(c);
+    ttw_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.entries == 0);
+    delete_utterance(u);
+    delete_ttw_cache(c);
+}
+
+void test_eviction(void)
+{
+    static const char *const a[] = { "a", NULL };
+    static const char *const b[] = { "b", NULL };
+    static const char *const c3[] = { "c", NULL };
+    cst_ttw_cache *c;
+    cst_ttw_cache_stats stats;
+    cst_utterance *ua, *ub, *uc;
+
+    cmu_lex_init();
+    c = new_ttw_cache(2, test_context, test_token_feats);
+    ua = test_utt(a);
+    ub = test_utt(b);
+    uc = test_utt(c3);
+    test_calls = 0;
+    test_expand(c, ua);
+    test_expand(c, ub);
+    /* a becomes the newest, so c pushes out b */
+    test_expand(c, ua);
+    test_expand(c, uc);
+    TEST_CHECK(test_calls == 3);
+    ttw_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.entries == 2 && stats.evictions == 1);
+    test_expand(c, ua);
+    TEST_CHECK(test_calls == 3);
+    test_expand(c, ub);
+    TEST_CHECK(test_calls == 4);
+    ttw_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.entries == 2 && stats.evictions == 2);
+
+    delete_utterance(ua);
+    delete_utterance(ub);
+    delete_utterance(uc);
+    delete_ttw_cache(c);
+}
+
+void test_addenda(void)
+{
+    static const char *const names[] = { "mimic", NULL };
+    cst_ttw_cache *c;
+    cst_ttw_cache_stats stats;
+    cst_utterance *u;
+    cst_voice *v;
+    FILE *fd;
+
+    mimic_init();
+    cmu_lex_init();
+    c = new_ttw_cache(16, test_context, test_token_feats);
+    u = test_utt(names);
+    test_calls = 0;
+    test_expand(c, u);
+    test_expand(c, u);
+    TEST_CHECK(test_calls == 1);
+
+    fd = fopen("ttw_cache_test.lex", "w");
+    fprintf(fd, "mimic nn : m ih1 m ih0 k\n");
+    fclose(fd);
+    v = new_voice();
+    feat_set(v->features, "lexicon", lexicon_val(&cmu_lex));
+    TEST_CHECK(mimic_voice_add_lex_addenda(v, "ttw_cache_test.lex") == 0);
+    remove("ttw_cache_test.lex");
+
+    /* Made with the old addenda, so expanded again, once */
+    TEST_CHECK(test_expand(c, u) == 1);
+    TEST_CHECK(test_calls == 2);
+    test_expand(c, u);
+    TEST_CHECK(test_calls == 2);
+    ttw_cache_get_stats(c, &stats);
+    TEST_CHECK(stats.invalidated == 1);
+    TEST_CHECK(stats.entries == 1);
+
+    delete_val(cmu_lex.lex_addenda);
+    cmu_lex.lex_addenda = NULL;
+    delete_voice(v);
+    delete_utterance(u);
+    delete_ttw_cache(c);
+}
+
+TEST_LIST =
+{
+    {"ttw cache hits", test_hits},
+    {"ttw cache eviction", test_eviction},
+    {"ttw cache addenda", test_addenda},
+    {0}
+};
@@ -0,0 +1,195 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  cst_val tests: pooled cells, interned strings and the shared small   */
+/*  ints                                                                 */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "cutest.h"
+#include "../src/utils/cst_val.c"
+
+void test_small_ints(void)
+{
+    cst_val *v = int_val(7);
+    cst_val *v2;
+
+    TEST_CHECK(v == int_val(7));
+    TEST_CHECK(v == CST_VAL_SMALL_INT(7));
+    TEST_CHECK(int_val(CST_VAL_SMALL_INT_MIN) ==
+               (cst_val *) &cst_val_small_ints[0]);
+    TEST_CHECK(val_int(int_val(CST_VAL_SMALL_INT_MIN)) ==
+               CST_VAL_SMALL_INT_MIN);
+    TEST_CHECK(val_int(int_val(CST_VAL_SMALL_INT_MAX)) ==
+               CST_VAL_SMALL_INT_MAX);
+
+    /* Immortal, and in the text segment so the count is never written */
+    TEST_CHECK(CST_VAL_REFCOUNT(v) == -1);
+    TEST_CHECK(val_inc_refcount(v) == v);
+    TEST_CHECK(val_dec_refcount(v) == -1);
+    delete_val(v);
+    delete_val(v);
+    TEST_CHECK(val_int(v) == 7);
+
+    /* Just outside the range they are allocated as before */
+    v = int_val(CST_VAL_SMALL_INT_MAX + 1);
+    v2 = int_val(CST_VAL_SMALL_INT_MAX + 1);
+    TEST_CHECK(v != v2);
+    TEST_CHECK(CST_VAL_REFCOUNT(v) == 0);
+    TEST_CHECK(val_int(v) == CST_VAL_SMALL_INT_MAX + 1);
+    delete_val(v);
+    delete_val(v2);
+}
+
+#ifndef CST_NO_VAL_POOL
+
+void test_interned(void)
+{
+    cst_val *v = string_val("ax");
+    cst_val *v2;
+
+    TEST_CHECK(v == string_val("ax"));
+    TEST_CHECK(cst_streq(val_string(v), "ax"));
+    TEST_CHECK(CST_VAL_REFCOUNT(v) == -1);
+    TEST_CHECK(val_inc_refcount(v) == v);
+    TEST_CHECK(CST_VAL_REFCOUNT(v) == -1);
+    delete_val(v);
+    TEST_CHECK(string_val("ax") == v);
+    TEST_CHECK(cst_streq(val_string(v), "ax"));
+
+    /* Too long to intern, each is its own */
+    v = string_val("a rather long string");
+    v2 = string_val("a rather long string");
+    TEST_CHECK(v != v2);
+    TEST_CHECK(CST_VAL_REFCOUNT(v) == 0);
+    delete_val(v);
+    delete_val(v2);
+}
+
+void test_intern_full(void)
+{
+    cst_val *v, *v2, *first;
+    char s[16];
+    int i;
+
+    first = string_val("full0");
+    for (i = 1; val_num_interned < CST_VAL_INTERN_MAX; i++)
+    {
+        cst_sprintf(s, "full%d", i);
+        TEST_CHECK(CST_VAL_REFCOUNT(string_val(s)) == -1);
+    }
+    TEST_CHECK(val_num_interned == CST_VAL_INTERN_MAX);
+
+    /* What is there is still found, new strings are copied */
+    TEST_CHECK(string_val("full0") == first);
+    cst_sprintf(s, "full%d", i - 1);
+    TEST_CHECK(string_val(s) == string_val(s));
+    v = string_val("notinthere");
+    v2 = string_val("notinthere");
+    TEST_CHECK(v != v2);
+    TEST_CHECK(CST_VAL_REFCOUNT(v) == 0);
+    TEST_CHECK(cst_streq(val_string(v), "notinthere"));
+    TEST_CHECK(val_num_interned == CST_VAL_INTERN_MAX);
+    delete_val(v);
+    delete_val(v2);
+}
+
+#ifdef HAVE_PTHREAD_H
+#define TEST_NUM_VALS (4 * CST_VAL_POOL_BATCH)
+
+static cst_val *made[TEST_NUM_VALS];
+static cst_val *remade[3 * CST_VAL_POOL_BATCH];
+
+static void *test_make(void *arg)
+{
+    cst_val **vals = (cst_val **) arg;
+    int i, n;
+
+    n = (vals == made) ? TEST_NUM_VALS : 3 * CST_VAL_POOL_BATCH;
+    for (i = 0; i < n; i++)
+        vals[i] = float_val((float) i);
+    return NULL;
+}
+
+static int test_was_made(const cst_val *v)
+{
+    int i;
+
+    for (i = 0; i < TEST_NUM_VALS; i++)
+        if (made[i] == v)
+            return 1;
+    return 0;
+}
+
+void test_pool_threads(void)
+{
+    pthread_t t;
+    cst_val *slabs;
+    int i, reused;
+
+    /* Made on one thread, and deleted on this one */
+    pthread_create(&t, NULL, test_make, made);
+    pthread_join(t, NULL);
+    for (i = 0; i < TEST_NUM_VALS; i++)
+        TEST_CHECK(val_float(made[i]) == (float) i);
+    for (i = 0; i < TEST_NUM_VALS; i++)
+        delete_val(made[i]);
+
+    /* What this thread gave back goes to the next one, with no new slab */
+    slabs = val_slabs;
+    pthread_create(&t, NULL, test_make, remade);
+    pthread_join(t, NULL);
+    TEST_CHECK(val_slabs == slabs);
+    for (reused = 0, i = 0; i < 3 * CST_VAL_POOL_BATCH; i++)
+    {
+        TEST_CHECK(val_float(remade[i]) == (float) i);
+        reused += test_was_made(remade[i]);
+    }
+    TEST_CHECK_(reused == 3 * CST_VAL_POOL_BATCH, "%d reused", reused);
+    for (i = 0; i < 3 * CST_VAL_POOL_BATCH; i++)
+        delete_val(remade[i]);
+}
+#endif
+#endif
+
+TEST_LIST =
+{
+    {"small ints", test_small_ints},
+#ifndef CST_NO_VAL_POOL
+    {"interned strings", test_interned},
+#ifdef HAVE_PTHREAD_H
+    {"pool across threads", test_pool_threads},
+#endif
+    {"intern table full", test_intern_full},
+#endif
+    {0}
+};
@@ -0,0 +1,483 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Wave cache tests: memory LRU, the disk tier across runs, its write   */
+/*  then rename, keys that hash the same, warmup and streaming of hits.  */
+/*  The voice is slt CG with synthetic model vectors (slt_vectors.h).    */
+/*                                                                       */
+/*************************************************************************/
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "mimic.h"
+#include "cst_cg_cache.h"
+
+/* For wc_hash(), wc_path() and wc_mem_put() */
+#include "../src/synth/cst_wave_cache.c"
+
+#include "cutest.h"
+#include "slt_vectors.h"
+
+cst_voice *register_cmu_us_slt(const char *voxdir);
+void unregister_cmu_us_slt(cst_voice *vox);
+
+#define TEST_DIR "wave_cache_test.d"
+
+static cst_wave *test_wave(int num_samples, short v)
+{
+    cst_wave *w = new_wave();
+    int i;
+
+    cst_wave_resize(w, num_samples, 1);
+    w->sample_rate = 16000;
+    for (i = 0; i < num_samples; i++)
+        w->samples[i] = v + i;
+    return w;
+}
+
+static int same_wave(const cst_wave *a, const cst_wave *b)
+{
+    return a && b && a->num_samples == b->num_samples &&
+        a->num_channels == b->num_channels &&
+        a->sample_rate == b->sample_rate &&
+        memcmp(a->samples, b->samples,
+               a->num_samples * a->num_channels * sizeof(short)) == 0;
+}
+
+/* Number of files in TEST_DIR, and of those temporary ones */
+static int dir_files(int *tmps)
+{
+    DIR *d;
+    struct dirent *de;
+    int n = 0;
+
+    *tmps = 0;
+    if ((d = opendir(TEST_DIR)) == NULL)
+        return -1;
+    while ((de = readdir(d)) != NULL)
+    {
+        if (cst_streq(de->d_name, ".") || cst_streq(de->d_name, ".."))
+            continue;
+        n++;
+        if (strstr(de->d_name, ".tmp"))
+            (*tmps)++;
+    }
+    closedir(d);
+    return n;
+}
+
+static void clear_dir(void)
+{
+    DIR *d;
+    struct dirent *de;
+    char path[1024];
+
+    if ((d = opendir(TEST_DIR)) != NULL)
+    {
+        while ((de = readdir(d)) != NULL)
+        {
+            if (cst_streq(de->d_name, ".") || cst_streq(de->d_name, ".."))
+                continue;
+            cst_sprintf(path, "%s/%s", TEST_DIR, de->d_name);
+            if (remove(path) != 0)
+                rmdir(path);
+        }
+        closedir(d);
+    }
+    mkdir(TEST_DIR, 0755);
+}
+
+/* Path of key's file in TEST_DIR */
+static char *key_path(const char *key, const char *suffix)
+{
+    cst_wave_cache wc;
+
+    memset(&wc, 0, sizeof(wc));
+    wc.dir = TEST_DIR;
+    return wc_path(&wc, wc_hash(key), suffix);
+}
+
+void test_mem_lru(void)
+{
+    cst_wave_cache *wc;
+    cst_wave_cache_stats stats;
+    cst_wave *w, *big, *got;
+
+    /* Each entry is 200 bytes of samples and its one byte key */
+    w = test_wave(100, 1);
+    wc = new_wave_cache(3 * 201, NULL, 0);
+    wave_cache_put(wc, "a", w);
+    wave_cache_put(wc, "b", w);
+    wave_cache_put(wc, "c", w);
+    /* a becomes the newest, so d pushes out b */
+    delete_wave(wave_cache_get(wc, "a"));
+    wave_cache_put(wc, "d", w);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.mem_entries == 3);
+    TEST_CHECK(stats.mem_evictions == 1);
+    TEST_CHECK(stats.mem_bytes == 3 * 201);
+    TEST_CHECK(stats.mem_bytes <= 3 * 201);
+    TEST_CHECK(wave_cache_get(wc, "b") == NULL);
+    got = wave_cache_get(wc, "a");
+    TEST_CHECK(same_wave(got, w));
+    delete_wave(got);
+
+    /* Too big to ever fit, and nothing is thrown out for it */
+    big = test_wave(1000, 2);
+    wave_cache_put(wc, "e", big);
+    TEST_CHECK(wave_cache_get(wc, "e") == NULL);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.mem_entries == 3);
+    TEST_CHECK(stats.mem_evictions == 1);
+    TEST_CHECK(stats.mem_hits == 2);
+    TEST_CHECK(stats.misses == 2);
+
+    delete_wave(big);
+    delete_wave(w);
+    delete_wave_cache(wc);
+}
+
+void test_disk_reopen(void)
+{
+    cst_wave_cache *wc;
+    cst_wave_cache_stats stats;
+    cst_wave *w1, *w2, *got;
+    long file_bytes;
+
+    clear_dir();
+    w1 = test_wave(1000, 1);
+    w2 = test_wave(3000, 2);
+    w2->sample_rate = 8000;
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR,
+                        CST_WAVE_CACHE_DEFAULT_DISK);
+    wave_cache_put(wc, "first", w1);
+    wave_cache_put(wc, "second", w2);
+    delete_wave_cache(wc);
+
+    /* A new cache, as in the next run, finds both on disk */
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR,
+                        CST_WAVE_CACHE_DEFAULT_DISK);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.disk_entries == 2);
+    TEST_CHECK(stats.mem_entries == 0);
+    got = wave_cache_get(wc, "second");
+    TEST_CHECK(same_wave(got, w2));
+    delete_wave(got);
+    /* and then has it in memory */
+    got = wave_cache_get(wc, "second");
+    TEST_CHECK(same_wave(got, w2));
+    delete_wave(got);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.disk_hits == 1);
+    TEST_CHECK(stats.mem_hits == 1);
+    TEST_CHECK(stats.misses == 0);
+    delete_wave_cache(wc);
+
+    /* Reopened with room for only one file, the older goes */
+    file_bytes = wc_file_bytes(cst_strlen("second"), 3000);
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR, file_bytes);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.disk_entries == 1);
+    TEST_CHECK(stats.disk_evictions == 1);
+    TEST_CHECK(stats.disk_bytes == file_bytes);
+    delete_wave_cache(wc);
+
+    delete_wave(w1);
+    delete_wave(w2);
+    clear_dir();
+    rmdir(TEST_DIR);
+}
+
+void test_disk_rename(void)
+{
+    cst_wave_cache *wc;
+    cst_wave_cache_stats stats;
+    cst_wave *w;
+    struct stat st;
+    char *path, *tmp;
+    FILE *fd;
+    int tmps;
+
+    clear_dir();
+    w = test_wave(500, 1);
+
+    /* Only the finished file is left, under the key's name */
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR,
+                        CST_WAVE_CACHE_DEFAULT_DISK);
+    wave_cache_put(wc, "the key", w);
+    delete_wave_cache(wc);
+    path = key_path("the key", WAVE_CACHE_SUFFIX);
+    TEST_CHECK(dir_files(&tmps) == 1 && tmps == 0);
+    TEST_CHECK(stat(path, &st) == 0 &&
+               st.st_size == wc_file_bytes(cst_strlen("the key"), 500));
+
+    /* A half written file under the final name is a miss */
+    TEST_CHECK(truncate(path, st.st_size - 2) == 0);
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR,
+                        CST_WAVE_CACHE_DEFAULT_DISK);
+    TEST_CHECK(wave_cache_get(wc, "the key") == NULL);
+    delete_wave_cache(wc);
+    cst_free(path);
+
+    /* A writer that died leaves a temporary file, which isn't indexed */
+    clear_dir();
+    tmp = key_path("the key", ".99.1.tmp");
+    fd = fopen(tmp, "wb");
+    TEST_CHECK(fd != NULL);
+    if (fd)
+    {
+        fputs("partial", fd);
+        fclose(fd);
+    }
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR,
+                        CST_WAVE_CACHE_DEFAULT_DISK);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.disk_entries == 0);
+    TEST_CHECK(wave_cache_get(wc, "the key") == NULL);
+    delete_wave_cache(wc);
+    cst_free(tmp);
+
+    /* When the rename fails nothing is left behind or indexed */
+    clear_dir();
+    path = key_path("the key", WAVE_CACHE_SUFFIX);
+    mkdir(path, 0755);
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR,
+                        CST_WAVE_CACHE_DEFAULT_DISK);
+    wave_cache_put(wc, "the key", w);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.disk_entries == 0);
+    TEST_CHECK(dir_files(&tmps) == 1 && tmps == 0);
+    delete_wave_cache(wc);
+    cst_free(path);
+
+    delete_wave(w);
+    clear_dir();
+    rmdir(TEST_DIR);
+}
+
+void test_hash_collision(void)
+{
+    cst_wave_cache *wc;
+    cst_wave *w;
+    char *one, *two;
+
+    w = test_wave(100, 1);
+
+    /* In memory, stored as if "key one" hashed as "key two" does */
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, NULL, 0);
+    wc_mem_put(wc, "key one", wc_hash("key two"), w);
+    TEST_CHECK(wave_cache_get(wc, "key two") == NULL);
+    delete_wave_cache(wc);
+
+    /* On disk, "key one"'s file under "key two"'s name */
+    clear_dir();
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR,
+                        CST_WAVE_CACHE_DEFAULT_DISK);
+    wave_cache_put(wc, "key one", w);
+    delete_wave_cache(wc);
+    one = key_path("key one", WAVE_CACHE_SUFFIX);
+    two = key_path("key two", WAVE_CACHE_SUFFIX);
+    TEST_CHECK(rename(one, two) == 0);
+    wc = new_wave_cache(CST_WAVE_CACHE_DEFAULT_MEM, TEST_DIR,
+                        CST_WAVE_CACHE_DEFAULT_DISK);
+    TEST_CHECK(wave_cache_get(wc, "key two") == NULL);
+    TEST_CHECK(wave_cache_get(wc, "key one") == NULL);
+    delete_wave_cache(wc);
+    cst_free(one);
+    cst_free(two);
+
+    delete_wave(w);
+    clear_dir();
+    rmdir(TEST_DIR);
+}
+
+void test_key(void)
+{
+    cst_voice *v = new_voice();
+    cst_cg_param_cache *pc = new_cg_param_cache(CST_CG_PARAM_CACHE_DEFAULT);
+    char *k[6];
+    int i, j;
+
+    v->name = "test";
+    k[0] = wave_cache_key(v, "Hello.");
+    feat_set_string(v->features, "htsvoice_file", "a.htsvoice");
+    k[1] = wave_cache_key(v, "Hello.");
+    feat_set_string(v->features, "htsvoice_file", "b.htsvoice");
+    k[2] = wave_cache_key(v, "Hello.");
+    feat_set_string(v->features, "pathname", "voices/a.flitevox");
+    k[3] = wave_cache_key(v, "Hello.");
+    feat_set(v->features, "cg_param_cache", cg_param_cache_val(pc));
+    k[4] = wave_cache_key(v, "Hello.");
+    /* Only the ends are trimmed */
+    k[5] = wave_cache_key(v, " \r\nHello.\r\n\t");
+    for (i = 0; i < 5; i++)
+        for (j = i + 1; j < 5; j++)
+            TEST_CHECK_(!cst_streq(k[i], k[j]), "keys %d and %d", i, j);
+    TEST_CHECK(cst_streq(k[4], k[5]));
+
+    for (i = 0; i < 6; i++)
+        cst_free(k[i]);
+    delete_voice(v);
+    delete_cg_param_cache(pc);
+}
+
+/* Where the streaming callback puts the samples it is given */
+typedef struct {
+    short *samples;
+    int num_samples;
+    int chunks;
+    int short_chunks;
+    int lasts;
+} stream_got;
+
+static int stream_collect(const cst_wave *w, int start, int size, int last,
+                          cst_audio_streaming_info *asi)
+{
+    stream_got *got = (stream_got *) asi->userdata;
+
+    got->samples = cst_realloc(got->samples, short, got->num_samples + size);
+    memmove(got->samples + got->num_samples, w->samples + start,
+            size * sizeof(short));
+    got->num_samples += size;
+    got->chunks++;
+    if (size != asi->min_buffsize && !last)
+        got->short_chunks++;
+    if (last)
+        got->lasts++;
+    return CST_AUDIO_STREAM_CONT;
+}
+
+static cst_voice *slt_voice(long max_mem_bytes, cst_wave_cache **wc)
+{
+    cst_voice *v;
+
+    slt_fill_vectors();
+    mimic_init();
+    v = register_cmu_us_slt(NULL);
+    *wc = new_wave_cache(max_mem_bytes, NULL, 0);
+    feat_set(v->features, "wave_cache", wave_cache_val(*wc));
+    return v;
+}
+
+void test_warmup(void)
+{
+    cst_wave_cache *wc;
+    cst_wave_cache_stats stats;
+    cst_voice *v;
+    cst_wave *w;
+    FILE *fd;
+
+    fd = fopen("wave_cache_test.txt", "wb");
+    TEST_CHECK(fd != NULL);
+    if (fd == NULL)
+        return;
+    fputs("Hello there.\n\n   \nGoodbye now.\r\n", fd);
+    fclose(fd);
+
+    v = slt_voice(CST_WAVE_CACHE_DEFAULT_MEM, &wc);
+    TEST_CHECK(mimic_wave_cache_warmup(v, "wave_cache_test.txt") == 2);
+    TEST_CHECK(mimic_wave_cache_warmup(v, "wave_cache_test.none") == -EIO);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.stores == 2);
+    TEST_CHECK(stats.misses == 2);
+
+    w = mimic_text_to_wave("Goodbye now.", v);
+    TEST_CHECK(w && w->num_samples > 0);
+    delete_wave(w);
+    w = mimic_text_to_wave("  Hello there.", v);
+    delete_wave(w);
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.mem_hits == 2);
+    TEST_CHECK(stats.stores == 2);
+
+    feat_remove(v->features, "wave_cache");
+    TEST_CHECK(mimic_wave_cache_warmup(v, "wave_cache_test.txt") == -EINVAL);
+    remove("wave_cache_test.txt");
+    unregister_cmu_us_slt(v);
+    delete_wave_cache(wc);
+}
+
+void test_stream_hit(void)
+{
+    const char *text = "Your call is important to us.";
+    cst_audio_streaming_info *asi;
+    cst_wave_cache *wc;
+    cst_wave_cache_stats stats;
+    stream_got miss, hit;
+    cst_voice *v;
+    cst_wave *w1, *w2;
+
+    v = slt_voice(CST_WAVE_CACHE_DEFAULT_MEM, &wc);
+    asi = new_audio_streaming_info();
+    asi->asc = stream_collect;
+    asi->min_buffsize = 1000;
+    feat_set(v->features, "streaming_info", audio_streaming_info_val(asi));
+
+    memset(&miss, 0, sizeof(miss));
+    asi->userdata = &miss;
+    w1 = mimic_text_to_wave(text, v);
+    memset(&hit, 0, sizeof(hit));
+    asi->userdata = &hit;
+    w2 = mimic_text_to_wave(text, v);
+
+    wave_cache_get_stats(wc, &stats);
+    TEST_CHECK(stats.misses == 1 && stats.mem_hits == 1);
+    TEST_CHECK(same_wave(w1, w2));
+    /* The hit streams what the miss did, in whole chunks, last once */
+    TEST_CHECK(miss.num_samples == w1->num_samples);
+    TEST_CHECK(hit.num_samples == w2->num_samples);
+    TEST_CHECK(hit.num_samples == miss.num_samples &&
+               memcmp(hit.samples, miss.samples,
+                      hit.num_samples * sizeof(short)) == 0);
+    TEST_CHECK(hit.chunks == (w2->num_samples + 999) / 1000);
+    TEST_CHECK(hit.short_chunks == 0);
+    TEST_CHECK(hit.lasts == 1);
+
+    cst_free(miss.samples);
+    cst_free(hit.samples);
+    delete_wave(w1);
+    delete_wave(w2);
+    unregister_cmu_us_slt(v);
+    delete_wave_cache(wc);
+}
+
+TEST_LIST =
+{
+    {"memory lru", test_mem_lru},
+    {"disk across runs", test_disk_reopen},
+    {"disk write then rename", test_disk_rename},
+    {"keys with the same hash", test_hash_collision},
+    {"key", test_key},
+    {"warmup", test_warmup},
+    {"streamed hit", test_stream_hit},
+    {0}
+};
@@ -0,0 +1,190 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Telephony encoder tests: G.711 against the reference values, G.721   */
+/*  against the reference coder, and the encoder against both            */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "cst_wave.h"
+#include "../src/speech/g72x.h"
+
+#include "cutest.h"
+
+/* What an encoder wrote */
+static unsigned char enc_out[65536 * 2];
+static int enc_bytes = 0;
+
+static int test_write(cst_wave_encoder *enc, const unsigned char *bytes,
+                      int num_bytes)
+{
+    if (enc_bytes + num_bytes <= (int) sizeof(enc_out))
+        memmove(enc_out + enc_bytes, bytes, num_bytes);
+    enc_bytes += num_bytes;
+    return 0;
+}
+
+/* Every 16 bit value once, in order */
+static short *all_samples(void)
+{
+    short *s = cst_alloc(short, 65536);
+    int i;
+
+    for (i = 0; i < 65536; i++)
+        s[i] = (short) (i - 32768);
+    return s;
+}
+
+void test_ulaw(void)
+{
+    short *s;
+    cst_wave_encoder *enc;
+    int i;
+
+    /* G.711 mu-law, with the zero code trapped to 0x02 */
+    TEST_CHECK(cst_short_to_ulaw(0) == 0xFF);
+    TEST_CHECK(cst_short_to_ulaw(-1) == 0x7F);
+    TEST_CHECK(cst_short_to_ulaw(32767) == 0x80);
+    TEST_CHECK(cst_short_to_ulaw(-32768) == 0x02);
+    TEST_CHECK(cst_short_to_ulaw(1000) == 0xCE);
+    TEST_CHECK(cst_ulaw_to_short(0xFF) == 0);
+    TEST_CHECK(cst_ulaw_to_short(0x80) == 32124);
+    TEST_CHECK(cst_ulaw_to_short(0x00) == -32124);
+    TEST_CHECK(cst_ulaw_to_short(0xCE) == 988);
+
+    /* Each code decodes to a value that codes back to it */
+    for (i = 1; i < 256; i++)
+        if (i != 0x7F)
+            TEST_CHECK_(cst_short_to_ulaw(cst_ulaw_to_short(i)) == i,
+                        "code 0x%02x", i);
+
+    /* The encoder's table is the same as the function */
+    s = all_samples();
+    enc_bytes = 0;
+    enc = new_wave_encoder(CST_WAVE_ENC_ULAW, 0, test_write, NULL);
+    TEST_CHECK(cst_wave_encoder_write(enc, s, 65536, 8000, 1) == 0);
+    TEST_CHECK(enc_bytes == 65536);
+    for (i = 0; i < 65536; i++)
+        if (enc_out[i] != cst_short_to_ulaw(s[i]))
+            break;
+    TEST_CHECK_(i == 65536, "sample %d", i - 32768);
+    delete_wave_encoder(enc);
+    cst_free(s);
+}
+
+void test_alaw(void)
+{
+    short *s;
+    cst_wave_encoder *enc;
+    int i;
+
+    /* G.711 A-law, even bits inverted */
+    TEST_CHECK(cst_short_to_alaw(0) == 0xD5);
+    TEST_CHECK(cst_short_to_alaw(-8) == 0x55);
+    TEST_CHECK(cst_short_to_alaw(32767) == 0xAA);
+    TEST_CHECK(cst_short_to_alaw(-32768) == 0x2A);
+    TEST_CHECK(cst_alaw_to_short(0xD5) == 8);
+    TEST_CHECK(cst_alaw_to_short(0x55) == -8);
+    TEST_CHECK(cst_alaw_to_short(0xAA) == 32256);
+    TEST_CHECK(cst_alaw_to_short(0x2A) == -32256);
+
+    for (i = 0; i < 256; i++)
+        TEST_CHECK_(cst_short_to_alaw(cst_alaw_to_short(i)) == i,
+                    "code 0x%02x", i);
+
+    s = all_samples();
+    enc_bytes = 0;
+    enc = new_wave_encoder(CST_WAVE_ENC_ALAW, 0, test_write, NULL);
+    TEST_CHECK(cst_wave_encoder_write(enc, s, 65536, 8000, 1) == 0);
+    TEST_CHECK(enc_bytes == 65536);
+    for (i = 0; i < 65536; i++)
+        if (enc_out[i] != cst_short_to_alaw(s[i]))
+            break;
+    TEST_CHECK_(i == 65536, "sample %d", i - 32768);
+    delete_wave_encoder(enc);
+    cst_free(s);
+}
+
+#define TEST_G721_SAMPLES 401   /* odd, so the last byte is half full */
+
+void test_g721(void)
+{
+    /* The reference coder's first codes for the tone below */
+    static const int codes[] = {
+        15, 7, 7, 7, 7, 7, 7, 7, 7, 15, 8, 11,
+        11, 10, 11, 12, 13, 15, 2, 4, 5, 5, 5, 4
+    };
+    short s[TEST_G721_SAMPLES];
+    struct g72x_state st;
+    cst_wave_encoder *enc;
+    double signal = 0, noise = 0;
+    int i, code, y;
+
+    for (i = 0; i < TEST_G721_SAMPLES; i++)
+        s[i] = (short) (8000 * sin(2 * M_PI * 440 * i / 8000.0));
+
+    enc_bytes = 0;
+    enc = new_wave_encoder(CST_WAVE_ENC_G721, 0, test_write, NULL);
+    TEST_CHECK(cst_wave_encoder_write(enc, s, 100, 8000, 0) == 0);
+    TEST_CHECK(cst_wave_encoder_write(enc, s + 100, TEST_G721_SAMPLES - 100,
+                                      8000, 1) == 0);
+    TEST_CHECK(enc_bytes == (TEST_G721_SAMPLES + 1) / 2);
+    delete_wave_encoder(enc);
+
+    /* Two codes a byte, high nibble first, decoded back to the tone */
+    g72x_init_state(&st);
+    for (i = 0; i < TEST_G721_SAMPLES; i++)
+    {
+        code = (i % 2) ? (enc_out[i / 2] & 0x0F) : (enc_out[i / 2] >> 4);
+        if (i < (int) (sizeof(codes) / sizeof(codes[0])))
+            TEST_CHECK_(code == codes[i], "code %d is %d", i, code);
+        y = g721_decoder(code, AUDIO_ENCODING_LINEAR, &st);
+        /* after the predictor has settled */
+        if (i >= 100)
+        {
+            signal += (double) s[i] * s[i];
+            noise += (double) (s[i] - y) * (s[i] - y);
+        }
+    }
+    TEST_CHECK((enc_out[TEST_G721_SAMPLES / 2] & 0x0F) == 0);
+    TEST_CHECK_(10 * log10(signal / noise) > 30, "snr %f",
+                10 * log10(signal / noise));
+}
+
+TEST_LIST =
+{
+    {"mu-law", test_ulaw},
+    {"A-law", test_alaw},
+    {"G.721", test_g721},
+    {0}
+};
@@ -0,0 +1,200 @@
+/*************************************************************************/
+/*                                                                       */
+/*                              Mimic                                    */
+/*                  Copyright (c) 2026 mimic developers                  */
+/*                        All Rights Reserved.                           */
+/*                                                                       */
+/*  Permission is hereby granted, free of charge, to use and distribute  */
+/*  this software and its documentation without restriction, including   */
+/*  without limitation the rights to use, copy, modify, merge, publish,  */
+/*  distribute, sublicense, and/or sell copies of this work, and to      */
+/*  permit persons to whom this work is furnished to do so, subject to   */
+/*  the following conditions:                                            */
+/*   1. The code must retain the above copyright notice, this list of    */
+/*      conditions and the following disclaimer.                         */
+/*   2. Any modifications must be clearly marked as such.                */
+/*   3. Original authors' names are not deleted.                         */
+/*   4. The authors' names are not used to endorse or promote products   */
+/*      derived from this software without specific prior written        */
+/*      permission.                                                      */
+/*                                                                       */
+/*  THE MIMIC DEVELOPERS AND THE CONTRIBUTORS TO THIS WORK DISCLAIM ALL  */
+/*  WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING ALL IMPLIED       */
+/*  WARRANTIES OF MERCHANTABILITY AND FITNESS, IN NO EVENT SHALL THE     */
+/*  MIMIC DEVELOPERS NOR THE CONTRIBUTORS BE LIABLE FOR ANY SPECIAL,     */
+/*  INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER          */
+/*  RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION    */
+/*  OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR  */
+/*  IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.          */
+/*                                                                       */
+/*************************************************************************/
+/*                                                                       */
+/*  Incremental wave writer tests: the riff sizes patched in at close    */
+/*  match what was written                                               */
+/*                                                                       */
+/*************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "cst_wave.h"
+
+#include "cutest.h"
+
+#define TEST_FILE "wave_writer_test.wav"
+/* More than the writer buffers, so some writes go straight through */
+#define TEST_BIG (CST_WAVE_WRITER_BUFFSIZE / 2 + 1000)
+
+static unsigned char file[4 * TEST_BIG];
+static long file_size;
+
+static void read_file(void)
+{
+    FILE *fd;
+
+    file_size = -1;
+    if ((fd = fopen(TEST_FILE, "rb")) == NULL)
+        return;
+    file_size = fread(file, 1, sizeof(file), fd);
+    fclose(fd);
+}
+
+static long get_le32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((long) p[3] << 24);
+}
+
+static int get_le16(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static void fill(short *s, int n, int start)
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+        s[i] = (short) (((start + i) * 37) % 20000 - 10000);
+}
+
+void test_linear16(void)
+{
+    static short s[TEST_BIG];
+    static const int chunks[] = { 1, 999, TEST_BIG, 4096, 3 };
+    cst_wave_writer *ww;
+    cst_wave *w;
+    int i, n = 0;
+
+    ww = cst_wave_writer_open(TEST_FILE, CST_WAVE_ENC_LINEAR16, 0, TRUE);
+    TEST_CHECK(ww != NULL);
+    for (i = 0; i < 5; i++)
+    {
+        fill(s, chunks[i], n);
+        TEST_CHECK(cst_wave_writer_write(ww, s, chunks[i], 16000) == 0);
+        n += chunks[i];
+    }
+    TEST_CHECK(cst_wave_writer_close(ww) == 0);
+
+    read_file();
+    TEST_CHECK(file_size == 44 + 2 * n);
+    TEST_CHECK(memcmp(file, "RIFF", 4) == 0);
+    TEST_CHECK(get_le32(file + 4) == file_size - 8);
+    TEST_CHECK(memcmp(file + 8, "WAVEfmt ", 8) == 0);
+    TEST_CHECK(get_le16(file + 20) == RIFF_FORMAT_PCM);
+    TEST_CHECK(get_le16(file + 22) == 1);
+    TEST_CHECK(get_le32(file + 24) == 16000);
+    TEST_CHECK(get_le32(file + 28) == 32000);
+    TEST_CHECK(get_le16(file + 34) == 16);
+    TEST_CHECK(memcmp(file + 36, "data", 4) == 0);
+    TEST_CHECK(get_le32(file + 40) == 2 * n);
+
+    /* And the loader agrees, sample for sample */
+    w = new_wave();
+    TEST_CHECK(cst_wave_load_riff(w, TEST_FILE) == 0);
+    TEST_CHECK(w->num_samples == n && w->sample_rate == 16000);
+    fill(s, 1000, 0);
+    TEST_CHECK(w->num_samples == n && memcmp(w->samples, s, 2000) == 0);
+    delete_wave(w);
+    remove(TEST_FILE);
+}
+
+void test_rates(void)
+{
+    static short s[8000];
+    cst_wave_writer *ww;
+    cst_rateconv *rc;
+    short *out;
+    int i, n;
+
+    /* The first rate is the file's, later ones are converted to it */
+    fill(s, 8000, 0);
+    ww = cst_wave_writer_open(TEST_FILE, CST_WAVE_ENC_LINEAR16, 0, TRUE);
+    TEST_CHECK(cst_wave_writer_write(ww, s, 8000, 8000) == 0);
+    TEST_CHECK(cst_wave_writer_write(ww, s, 8000, 16000) == 0);
+    TEST_CHECK(cst_wave_writer_close(ww) == 0);
+    read_file();
+    TEST_CHECK(get_le32(file + 24) == 8000);
+    TEST_CHECK(get_le32(file + 4) == file_size - 8);
+    TEST_CHECK(get_le32(file + 40) == file_size - 44);
+    /* As much as the same converter on its own makes */
+    rc = new_rateconv_rates(16000, 8000, 1);
+    out = cst_alloc(short, cst_rateconv_max_out(rc, 8000));
+    n = cst_rateconv_run(rc, s, 8000, out, cst_rateconv_max_out(rc, 8000), 1);
+    TEST_CHECK(n > 4000);
+    TEST_CHECK_(file_size - 44 == 2 * (8000 + n), "%ld bytes, not %d",
+                file_size - 44, 2 * (8000 + n));
+    for (i = 0; i < n; i++)
+        if ((short) get_le16(file + 44 + 16000 + 2 * i) != out[i])
+            break;
+    TEST_CHECK(i == n);
+    cst_free(out);
+    delete_rateconv(rc);
+    remove(TEST_FILE);
+
+    /* Nothing written at all */
+    ww = cst_wave_writer_open(TEST_FILE, CST_WAVE_ENC_LINEAR16, 0, TRUE);
+    TEST_CHECK(cst_wave_writer_close(ww) == 0);
+    read_file();
+    TEST_CHECK(file_size == 44);
+    TEST_CHECK(get_le32(file + 4) == 36);
+    TEST_CHECK(get_le32(file + 40) == 0);
+    remove(TEST_FILE);
+}
+
+void test_encoded(void)
+{
+    static short s[1001];
+    cst_wave_writer *ww;
+
+    fill(s, 1001, 0);
+    ww = cst_wave_writer_open(TEST_FILE, CST_WAVE_ENC_ULAW, 8000, TRUE);
+    TEST_CHECK(cst_wave_writer_write(ww, s, 500, 8000) == 0);
+    TEST_CHECK(cst_wave_writer_write(ww, s + 500, 501, 8000) == 0);
+    TEST_CHECK(cst_wave_writer_close(ww) == 0);
+    read_file();
+    TEST_CHECK(file_size == 44 + 1001);
+    TEST_CHECK(get_le32(file + 4) == file_size - 8);
+    TEST_CHECK(get_le16(file + 20) == RIFF_FORMAT_MULAW);
+    TEST_CHECK(get_le32(file + 28) == 8000);
+    TEST_CHECK(get_le16(file + 32) == 1);
+    TEST_CHECK(get_le32(file + 40) == 1001);
+    TEST_CHECK(file[44 + 600] == cst_short_to_ulaw(s[600]));
+    remove(TEST_FILE);
+
+    /* Headerless, the odd G.721 code gets its byte at close */
+    ww = cst_wave_writer_open(TEST_FILE, CST_WAVE_ENC_G721, 8000, FALSE);
+    TEST_CHECK(cst_wave_writer_write(ww, s, 1001, 8000) == 0);
+    TEST_CHECK(cst_wave_writer_close(ww) == 0);
+    read_file();
+    TEST_CHECK(file_size == 501);
+    remove(TEST_FILE);
+
+    TEST_CHECK(cst_wave_writer_open(TEST_FILE, CST_WAVE_ENC_G721, 8000,
+                                    TRUE) == NULL);
+}
+
+TEST_LIST =
+{
+    {"linear16 riff sizes", test_linear16},
+    {"riff sizes across rates", test_rates},
+    {"encoded riff sizes", test_encoded},
+    {0}
+};